@@ -20,10 +20,13 @@ HEADERS += \
     $$PWD/bitmaptextfont_p.h \
     $$PWD/events.h \
     $$PWD/events_p.h \
+    $$PWD/eventqueue_p.h \
     $$PWD/gputimer_p.h \
+    $$PWD/histogram_p.h \
     $$PWD/logger.h \
     $$PWD/logger_p.h \
     $$PWD/overlay_p.h \
+    $$PWD/span.h \
     $$PWD/ubuntumetricsglobal.h \
     $$PWD/ubuntumetricsglobal_p.h \
 
@@ -31,9 +34,12 @@ SOURCES += \
     $$PWD/applicationmonitor.cpp \
     $$PWD/bitmaptext.cpp \
     $$PWD/events.cpp \
+    $$PWD/eventqueue.cpp \
     $$PWD/gputimer.cpp \
+    $$PWD/histogram.cpp \
     $$PWD/logger.cpp \
     $$PWD/overlay.cpp \
+    $$PWD/span.cpp \
     $$PWD/ubuntumetricsglobal.cpp
 
 load(ubuntu_qt_module)
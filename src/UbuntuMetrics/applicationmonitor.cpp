@@ -19,25 +19,30 @@
 
 #include <QtCore/QTimer>
 #include <QtGui/QGuiApplication>
+#include <QtGui/QScreen>
 #include <QtQuick/QQuickWindow>
 
 // FIXME(loicm) When a monitored window is destroyed and if there's a window
 //     that's not monitored because the max count was reached, enable monitoring
 //     on it if possible.
 
-const int logQueueSize = 16;
-const int logQueueAlignment = 64;
+Q_STATIC_ASSERT(static_cast<int>(UMApplicationMonitor::DropOldest) == EventQueue::DropOldest);
+Q_STATIC_ASSERT(static_cast<int>(UMApplicationMonitor::DropNewest) == EventQueue::DropNewest);
+Q_STATIC_ASSERT(static_cast<int>(UMApplicationMonitor::Block) == EventQueue::Block);
 
-LoggingThread::LoggingThread()
-    : m_loggerCount(0)
+// Max number of events popped from a queue and passed to the loggers at once,
+// a whole queue can be drained in one go.
+const int logBatchSize = EventQueue::size;
+
+LoggingThread::LoggingThread(UMApplicationMonitor::OverflowPolicy policy)
+    : m_queueCount(0)
+    , m_loggerCount(0)
     , m_refCount(1)
-    , m_queueIndex(0)
-    , m_queueSize(0)
+    , m_waiting(0)
+    , m_overflowPolicy(policy)
+    , m_droppedEventCount(0)
     , m_flags(0)
 {
-    m_queue = static_cast<UMEvent*>(
-        alignedAlloc(logQueueAlignment, logQueueSize * sizeof(UMEvent)));
-
 #if !defined(QT_NO_DEBUG)
     setObjectName(QStringLiteral("UbuntuMetrics logging"));  // Thread name.
 #endif
@@ -48,76 +53,128 @@ LoggingThread::~LoggingThread()
 {
     m_mutex.lock();
     m_flags |= JoinRequested;
-    if (m_flags & Waiting) {
-        m_condition.wakeOne();
-    }
+    m_condition.wakeOne();
     m_mutex.unlock();
     wait();
 
-    free(m_queue);
-}
-
-#define BREAK_ON_JOIN_REQUEST()                \
-    if (Q_UNLIKELY(m_flags & JoinRequested)) { \
-        m_mutex.unlock();                      \
-        break;                                 \
+    for (int i = 0; i < m_queueCount; ++i) {
+        delete m_queues[i];
     }
+}
 
 // Logging thread entry point.
 void LoggingThread::run()
 {
     DLOG("Entering logging thread.");
+    UMEvent events[logBatchSize];
+    EventQueue* queues[maxQueues];
+    UMLogger* loggers[UMApplicationMonitorPrivate::maxLoggers];
+
     while (true) {
-        // Wait for new events in the log queue.
         m_mutex.lock();
-        DASSERT(m_queueSize >= 0);
-        if (m_queueSize == 0) {
-            BREAK_ON_JOIN_REQUEST();
-            m_flags |= Waiting;
-            m_condition.wait(&m_mutex);
-            if (m_queueSize == 0) {
-                BREAK_ON_JOIN_REQUEST();
-            }
-            m_flags &= ~Waiting;
-        }
-
-        // Unqueue oldest events from the log queue.
-        DASSERT(m_queueSize > 0);
-        UMEvent event;
-        memcpy(&event, &m_queue[m_queueIndex], sizeof(UMEvent));
-        m_queueIndex = (m_queueIndex + 1) % logQueueSize;
-        m_queueSize--;
-
-        // Log.
+        const int queueCount = m_queueCount;
+        memcpy(queues, m_queues, queueCount * sizeof(EventQueue*));
         const int loggerCount = m_loggerCount;
-        UMLogger* loggers[UMApplicationMonitorPrivate::maxLoggers];
         memcpy(loggers, m_loggers, loggerCount * sizeof(UMLogger*));
         m_mutex.unlock();
-        for (int i = 0; i < loggerCount; ++i) {
-            loggers[i]->log(event);
+
+        // Drain the queues and pass contiguous spans of events to the loggers.
+        // A released queue is checked before being drained so that it can't
+        // receive new events once found empty.
+        int eventCount = 0;
+        for (int i = 0; i < queueCount; ++i) {
+            const bool released = queues[i]->isReleased();
+            int count;
+            while ((count = queues[i]->pop(events, logBatchSize)) > 0) {
+                for (int j = 0; j < loggerCount; ++j) {
+                    loggers[j]->logBatch(events, count);
+                }
+                eventCount += count;
+            }
+            if (released) {
+                QMutexLocker locker(&m_mutex);
+                for (int j = 0; j < m_queueCount; ++j) {
+                    if (m_queues[j] == queues[i]) {
+                        m_queues[j] = m_queues[--m_queueCount];
+                        break;
+                    }
+                }
+                delete queues[i];
+            }
+        }
+
+        // Wait for new events. The waiting flag is set before checking the
+        // queues one last time so that a producer pushing concurrently either
+        // gets its event popped at next iteration or wakes us up.
+        if (eventCount == 0) {
+            m_mutex.lock();
+            if (Q_UNLIKELY(m_flags & JoinRequested)) {
+                m_mutex.unlock();
+                break;
+            }
+            m_waiting.fetchAndStoreOrdered(1);
+            bool empty = true;
+            for (int i = 0; i < m_queueCount; ++i) {
+                if (!m_queues[i]->isEmpty() || m_queues[i]->isReleased()) {
+                    empty = false;
+                    break;
+                }
+            }
+            if (empty) {
+                m_condition.wait(&m_mutex);
+            }
+            m_waiting.storeRelease(0);
+            m_mutex.unlock();
         }
     }
     DLOG("Leaving logging thread.");
 }
 
-void LoggingThread::push(const UMEvent* event)
+void LoggingThread::push(EventQueue* queue, const UMEvent* event)
+{
+    if (Q_LIKELY(queue)) {
+        const int dropped = queue->push(
+            event, static_cast<EventQueue::OverflowPolicy>(m_overflowPolicy.loadAcquire()));
+        if (dropped) {
+            m_droppedEventCount.fetchAndAddRelaxed(dropped);
+        }
+        // The lock is only taken if the logging thread is actually sleeping.
+        if (m_waiting.fetchAndStoreOrdered(0)) {
+            wakeUp();
+        }
+    } else {
+        m_droppedEventCount.fetchAndAddRelaxed(1);
+    }
+}
+
+void LoggingThread::wakeUp()
 {
-    // Ensure the log queue is not full.
     m_mutex.lock();
-    DASSERT(m_queueSize <= logQueueSize);
-    while (m_queueSize == logQueueSize) {
-        m_mutex.unlock();
-        QThread::yieldCurrentThread();
-        m_mutex.lock();
+    m_condition.wakeOne();
+    m_mutex.unlock();
+}
+
+EventQueue* LoggingThread::createQueue()
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_queueCount < maxQueues) {
+        EventQueue* queue = new EventQueue;
+        m_queues[m_queueCount++] = queue;
+        return queue;
+    } else {
+        WARN("ApplicationMonitor: Can't create more than %d event queues.", maxQueues);
+        return nullptr;
     }
+}
 
-    // Push event to the log queue.
-    DASSERT(m_queueSize < logQueueSize);
-    memcpy(&m_queue[(m_queueIndex + m_queueSize++) % logQueueSize], event, sizeof(UMEvent));
-    if (m_flags & Waiting) {
-        m_condition.wakeOne();
+void LoggingThread::releaseQueue(EventQueue* queue)
+{
+    if (queue) {
+        queue->release();
+        if (m_waiting.fetchAndStoreOrdered(0)) {
+            wakeUp();
+        }
     }
-    m_mutex.unlock();
 }
 
 void LoggingThread::setLoggers(UMLogger** loggers, int count)
@@ -163,10 +220,13 @@ UMApplicationMonitorPrivate::UMApplicationMonitorPrivate(UMApplicationMonitor* a
     , m_loggers{}
 #endif
     , m_loggingThread(nullptr)
+    , m_eventQueue(nullptr)
     , m_monitorCount(0)
     , m_loggerCount(0)
-    , m_updateInterval{1000, -1, -1}
+    , m_updateInterval{1000, -1, -1, -1, -1, -1}
+    , m_droppedEventCount(0)
     , m_flags(UMApplicationMonitor::AllEvents)
+    , m_overflowPolicy(UMApplicationMonitor::DropOldest)
 {
     Q_Q(UMApplicationMonitor);
 
@@ -181,6 +241,7 @@ UMApplicationMonitorPrivate::UMApplicationMonitorPrivate(UMApplicationMonitor* a
     QObject::connect(application, SIGNAL(lastWindowClosed()), q, SLOT(closeDown()));
     QObject::connect(application, SIGNAL(aboutToQuit()), q, SLOT(closeDown()));
     QObject::connect(&m_processTimer, SIGNAL(timeout()), q, SLOT(processTimeout()));
+    QObject::connect(&m_frameSummaryTimer, SIGNAL(timeout()), q, SLOT(frameSummaryTimeout()));
 
     m_processTimer.setInterval(m_updateInterval[UMEvent::Process]);
 }
@@ -215,7 +276,8 @@ void UMApplicationMonitor::setOverlay(bool overlay)
             }
         } else {
             d->m_flags &= ~UMApplicationMonitorPrivate::Overlay;
-            if (!(d->m_flags & UMApplicationMonitorPrivate::Logging)) {
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Logging
+                                | UMApplicationMonitorPrivate::Statistics))) {
                 d->stop();
             } else {
                 d->setMonitoringFlags(d->m_flags);
@@ -245,7 +307,8 @@ void UMApplicationMonitor::setLogging(bool logging)
             }
         } else {
             d->m_flags &= ~UMApplicationMonitorPrivate::Logging;
-            if (!(d->m_flags & UMApplicationMonitorPrivate::Overlay)) {
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Overlay
+                                | UMApplicationMonitorPrivate::Statistics))) {
                 d->stop();
             } else {
                 d->setMonitoringFlags(d->m_flags);
@@ -260,6 +323,70 @@ bool UMApplicationMonitor::logging()
     return !!(d_func()->m_flags & UMApplicationMonitorPrivate::Logging);
 }
 
+void UMApplicationMonitor::setFrameStatistics(bool frameStatistics)
+{
+    Q_D(UMApplicationMonitor);
+
+    if (!!(d->m_flags & UMApplicationMonitorPrivate::Statistics) != frameStatistics) {
+        if (frameStatistics) {
+            d->m_flags |= UMApplicationMonitorPrivate::Statistics;
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Started
+                                | UMApplicationMonitorPrivate::ClosingDown))) {
+                d->start();
+            } else {
+                d->setMonitoringFlags(d->m_flags);
+            }
+        } else {
+            d->m_flags &= ~UMApplicationMonitorPrivate::Statistics;
+            if (!(d->m_flags & (UMApplicationMonitorPrivate::Overlay
+                                | UMApplicationMonitorPrivate::Logging))) {
+                d->stop();
+            } else {
+                d->setMonitoringFlags(d->m_flags);
+            }
+        }
+        Q_EMIT frameStatisticsChanged();
+    }
+}
+
+bool UMApplicationMonitor::frameStatistics()
+{
+    return !!(d_func()->m_flags & UMApplicationMonitorPrivate::Statistics);
+}
+
+bool UMApplicationMonitor::windowFrameStatistics(
+    QQuickWindow* window, UMFrameStatistics* statistics)
+{
+    Q_D(UMApplicationMonitor);
+
+    if (!(d->m_flags & UMApplicationMonitorPrivate::Statistics) || !window || !statistics) {
+        return false;
+    }
+
+    d->m_monitorsMutex.lock();
+    for (int i = 0; i < d->m_monitorCount; ++i) {
+        if (d->m_monitors[i]->window() == window) {
+            statistics->window = d->m_monitors[i]->id();
+            d->m_monitors[i]->frameStatistics(statistics);
+            d->m_monitorsMutex.unlock();
+            return true;
+        }
+    }
+    d->m_monitorsMutex.unlock();
+    return false;
+}
+
+void UMApplicationMonitor::resetFrameStatistics()
+{
+    Q_D(UMApplicationMonitor);
+
+    d->m_monitorsMutex.lock();
+    for (int i = 0; i < d->m_monitorCount; ++i) {
+        d->m_monitors[i]->resetFrameStatistics();
+    }
+    d->m_monitorsMutex.unlock();
+}
+
 void UMApplicationMonitorPrivate::startMonitoring(QQuickWindow* window)
 {
     DASSERT(window);
@@ -282,8 +409,9 @@ void UMApplicationMonitorPrivate::start()
     DASSERT(!(m_flags & Started));
     DASSERT(!m_loggingThread);
 
-    m_loggingThread = new LoggingThread;
+    m_loggingThread = new LoggingThread(m_overflowPolicy);
     m_loggingThread->setLoggers(m_loggers, m_loggerCount);
+    m_eventQueue = m_loggingThread->createQueue();
 
     QWindowList windows = QGuiApplication::allWindows();
     const int size = windows.size();
@@ -301,12 +429,16 @@ void UMApplicationMonitorPrivate::start()
 
     // Doing it here so that processTimeout can assert the monitoring started.
     m_flags |= Started;
+    updateSpanLogging();
 
     memset(&m_processEvent, 0, sizeof(UMEvent));
     processTimeout();
     if (m_updateInterval[UMEvent::Process] >= 0) {
         m_processTimer.start();
     }
+    if (m_updateInterval[UMEvent::FrameSummary] >= 0) {
+        m_frameSummaryTimer.start();
+    }
 }
 
 bool UMApplicationMonitorPrivate::removeMonitor(WindowMonitor* monitor)
@@ -377,9 +509,19 @@ void UMApplicationMonitorPrivate::stop()
 {
     DASSERT(m_flags & Started);
 
+    // Spans still running are dropped by pushSpan() once the queue released.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    UMSpan::s_enabled.storeRelaxed(0);
+#else
+    UMSpan::s_enabled.store(0);
+#endif
+
     if (m_updateInterval[UMEvent::Process] >= 0) {
         m_processTimer.stop();
     }
+    if (m_updateInterval[UMEvent::FrameSummary] >= 0) {
+        m_frameSummaryTimer.stop();
+    }
 
     QGuiApplication::instance()->removeEventFilter(q_func());
 
@@ -390,6 +532,11 @@ void UMApplicationMonitorPrivate::stop()
     m_monitorsMutex.unlock();
 
     DASSERT(m_loggingThread);
+    m_eventQueueMutex.lock();
+    m_loggingThread->releaseQueue(m_eventQueue);
+    m_eventQueue = nullptr;
+    m_eventQueueMutex.unlock();
+    m_droppedEventCount += m_loggingThread->droppedEventCount();
     m_loggingThread->deref();
     m_loggingThread = nullptr;
 
@@ -439,6 +586,8 @@ WindowMonitorFlagSetter::~WindowMonitorFlagSetter()
 
 void UMApplicationMonitorPrivate::setMonitoringFlags(quint32 flags)
 {
+    updateSpanLogging();
+
     m_monitorsMutex.lock();
     for (int i = 0; i < m_monitorCount; ++i) {
         DASSERT(m_monitors[i]);
@@ -455,6 +604,42 @@ void UMApplicationMonitorPrivate::setMonitoringFlags(quint32 flags)
     m_monitorsMutex.unlock();
 }
 
+void WindowMonitorFrameFlusher::run()
+{
+    // run() guarantees a valid context. Make sure the monitor's not been
+    // removed (window going hidden) after this runnable was scheduled.
+    if (m_applicationMonitor == UMApplicationMonitor::instance()
+        && UMApplicationMonitorPrivate::get(m_applicationMonitor)->hasMonitor(m_monitor)
+        && m_monitor->gpuResourcesInitialized()) {
+        if (m_monitor->m_flags & WindowMonitor::GpuTimerAvailable) {
+            m_monitor->takeGpuTimes();
+        }
+        m_monitor->flushPendingFrames(false);
+    }
+}
+
+// Called at each process and frame summary update so that the last frames
+// rendered before a window goes idle don't wait for the next frame to be
+// recorded.
+void UMApplicationMonitorPrivate::flushPendingFrames()
+{
+    m_monitorsMutex.lock();
+    for (int i = 0; i < m_monitorCount; ++i) {
+        DASSERT(m_monitors[i]);
+        if (m_monitors[i]->hasPendingFrames()) {
+            m_monitors[i]->window()->scheduleRenderJob(
+                new WindowMonitorFrameFlusher(m_monitors[i]),
+#if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
+                QQuickWindow::NoStage);
+#else
+                QQuickWindow::BeforeSynchronizingStage);
+            m_monitors[i]->window()->update();  // Wake up the render loop.
+#endif
+        }
+    }
+    m_monitorsMutex.unlock();
+}
+
 void UMApplicationMonitor::setLoggingFilter(UMApplicationMonitor::LoggingFilters filter)
 {
     Q_D(UMApplicationMonitor);
@@ -572,7 +757,7 @@ bool UMApplicationMonitor::logGenericEvent(quint32 id, const char* string, quint
         // if used in qMin(); force type to satisfy it
         event.generic.stringSize = qMin(size, quint32(UMGenericEvent::maxStringSize));
         memcpy(event.generic.string, string, event.generic.stringSize);
-        d->m_loggingThread->push(&event);
+        d->push(&event);
         return true;
     } else {
         return false;
@@ -592,26 +777,97 @@ bool UMApplicationMonitor::logEvent(Event event)
     };
 }
 
+void UMApplicationMonitorPrivate::push(const UMEvent* event)
+{
+    DASSERT(m_loggingThread);
+
+    // The application monitor queue can be fed from different threads (generic
+    // events), producers are serialised to keep it single-producer.
+    m_eventQueueMutex.lock();
+    m_loggingThread->push(m_eventQueue, event);
+    m_eventQueueMutex.unlock();
+}
+
+void UMApplicationMonitorPrivate::pushSpan(const UMEvent* event)
+{
+    // Spans can end on any thread, possibly after the monitoring stopped.
+    m_eventQueueMutex.lock();
+    if (m_eventQueue) {
+        DASSERT(m_loggingThread);
+        m_loggingThread->push(m_eventQueue, event);
+    }
+    m_eventQueueMutex.unlock();
+}
+
+void UMApplicationMonitorPrivate::updateSpanLogging()
+{
+    const quint32 flags = Started | Logging | UMApplicationMonitor::SpanEvent;
+    const int enabled = (m_flags & flags) == flags ? 1 : 0;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    UMSpan::s_enabled.storeRelaxed(enabled);
+#else
+    UMSpan::s_enabled.store(enabled);
+#endif
+}
+
+void UMApplicationMonitor::setOverflowPolicy(OverflowPolicy policy)
+{
+    Q_D(UMApplicationMonitor);
+
+    if (policy != d->m_overflowPolicy) {
+        d->m_overflowPolicy = policy;
+        if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+            DASSERT(d->m_loggingThread);
+            d->m_loggingThread->setOverflowPolicy(policy);
+        }
+        Q_EMIT overflowPolicyChanged();
+    }
+}
+
+UMApplicationMonitor::OverflowPolicy UMApplicationMonitor::overflowPolicy()
+{
+    return d_func()->m_overflowPolicy;
+}
+
+quint32 UMApplicationMonitor::droppedEventCount()
+{
+    Q_D(UMApplicationMonitor);
+
+    if (d->m_flags & UMApplicationMonitorPrivate::Started) {
+        DASSERT(d->m_loggingThread);
+        return d->m_droppedEventCount + d->m_loggingThread->droppedEventCount();
+    } else {
+        return d->m_droppedEventCount;
+    }
+}
+
 void UMApplicationMonitor::setUpdateInterval(UMEvent::Type type, int interval)
 {
     Q_D(UMApplicationMonitor);
 
+    QTimer* timer;
     if (type == UMEvent::Process) {
+        timer = &d->m_processTimer;
+    } else if (type == UMEvent::FrameSummary) {
+        timer = &d->m_frameSummaryTimer;
+    } else {
         // Other types (like UMEvent::Frame) are ignored for now.
-        if (interval != d->m_updateInterval[UMEvent::Process]) {
-            if (interval >= 0) {
-                d->m_processTimer.setInterval(interval);
-                if ((d->m_flags & UMApplicationMonitorPrivate::Started)
-                    && (d->m_updateInterval[UMEvent::Process] < 0)) {
-                    d->m_processTimer.start();
-                }
-            } else if ((d->m_flags & UMApplicationMonitorPrivate::Started)
-                       && (d->m_updateInterval[UMEvent::Process] >= 0)) {
-                d->m_processTimer.stop();
+        return;
+    }
+
+    if (interval != d->m_updateInterval[type]) {
+        if (interval >= 0) {
+            timer->setInterval(interval);
+            if ((d->m_flags & UMApplicationMonitorPrivate::Started)
+                && (d->m_updateInterval[type] < 0)) {
+                timer->start();
             }
-            d->m_updateInterval[UMEvent::Process] = interval;
-            Q_EMIT updateIntervalChanged(UMEvent::Process);
+        } else if ((d->m_flags & UMApplicationMonitorPrivate::Started)
+                   && (d->m_updateInterval[type] >= 0)) {
+            timer->stop();
         }
+        d->m_updateInterval[type] = interval;
+        Q_EMIT updateIntervalChanged(type);
     }
 }
 
@@ -640,6 +896,8 @@ void UMApplicationMonitorPrivate::processTimeout()
     DASSERT(m_flags & Started);
     DASSERT(m_loggingThread);
 
+    flushPendingFrames();
+
     const bool processLogging =
         (m_flags & Logging) && (m_flags & UMApplicationMonitor::ProcessEvent);
     const bool overlay = m_flags & Overlay;
@@ -647,7 +905,7 @@ void UMApplicationMonitorPrivate::processTimeout()
     if (processLogging || overlay) {
         m_eventUtils.updateProcessEvent(&m_processEvent);
         if (processLogging) {
-            m_loggingThread->push(&m_processEvent);
+            push(&m_processEvent);
         }
         if (overlay) {
             // FIXME(loicm) We've got two choices here, locking all the monitors
@@ -667,6 +925,35 @@ void UMApplicationMonitorPrivate::processTimeout()
     }
 }
 
+void UMApplicationMonitor::frameSummaryTimeout()
+{
+    d_func()->frameSummaryTimeout();
+}
+
+void UMApplicationMonitorPrivate::frameSummaryTimeout()
+{
+    DASSERT(m_flags & Started);
+    DASSERT(m_loggingThread);
+
+    flushPendingFrames();
+
+    if ((m_flags & Statistics) && (m_flags & Logging)
+        && (m_flags & UMApplicationMonitor::FrameSummaryEvent)) {
+        UMEvent event;
+        memset(&event, 0, sizeof(UMEvent));
+        event.type = UMEvent::FrameSummary;
+        event.timeStamp = UMEventUtils::timeStamp();
+        m_monitorsMutex.lock();
+        for (int i = 0; i < m_monitorCount; ++i) {
+            DASSERT(m_monitors[i]);
+            event.frameSummary.window = m_monitors[i]->id();
+            m_monitors[i]->takeFrameSummary(&event.frameSummary);
+            push(&event);
+        }
+        m_monitorsMutex.unlock();
+    }
+}
+
 bool UMApplicationMonitor::eventFilter(QObject* object, QEvent* event)
 {
     if (event->type() == QEvent::Show) {
@@ -695,6 +982,7 @@ static const char* const defaultOverlayText =
     "     Total : %9totalTime ms\r"
     "  VSZ mem. : %9vszMemory kB\n"
     "  RSS mem. : %9rssMemory kB\n"
+    "  PSS mem. : %9pssMemory kB\n"
     "   Threads : %9threadCount   \n"
     " CPU usage : %9cpuUsage %% ";
 
@@ -703,17 +991,43 @@ WindowMonitor::WindowMonitor(
     quint32 flags, quint32 id)
     : m_applicationMonitor(applicationMonitor)
     , m_loggingThread(loggingThread)
+    , m_eventQueue(loggingThread->createQueue())
     , m_window(window)
     , m_overlay(defaultOverlayText, id)
     , m_id(id)
     , m_flags(flags)
     , m_frameSize(window->width(), window->height())
+    , m_gpuTime(0)
+    , m_pendingFrameHead(0)
+    , m_pendingFrameCount(0)
+    , m_hasPendingFrames(0)
 {
+    const qreal refreshRate = window->screen() ? window->screen()->refreshRate() : 0.0;
+    m_vsyncInterval = refreshRate > 0.0 ? static_cast<quint64>(1000000000.0 / refreshRate) : 0;
+
     DASSERT(applicationMonitor == UMApplicationMonitor::instance());
     DASSERT(m_applicationMonitor);
     DASSERT(window);
     DASSERT(loggingThread);
 
+    memset(&m_frameEvent, 0, sizeof(m_frameEvent));
+    m_frameEvent.type = UMEvent::Frame;
+    m_frameEvent.frame.window = id;
+
+    // Pushed before connecting to the window signals since the render thread
+    // is the only producer of the event queue afterwards.
+    if ((flags & UMApplicationMonitorPrivate::Logging)
+        && (flags & UMApplicationMonitor::WindowEvent)) {
+        UMEvent event;
+        event.type = UMEvent::Window;
+        event.timeStamp = UMEventUtils::timeStamp();
+        event.window.id = id;
+        event.window.width = m_frameSize.width();
+        event.window.height = m_frameSize.height();
+        event.window.state = UMWindowEvent::Shown;
+        loggingThread->push(m_eventQueue, &event);
+    }
+
     moveToThread(nullptr);
 
     QObject::connect(window, SIGNAL(sceneGraphInitialized()), this,
@@ -732,22 +1046,6 @@ WindowMonitor::WindowMonitor(
                      Qt::DirectConnection);
     QObject::connect(window, SIGNAL(sceneGraphAboutToStop()), this,
                      SLOT(windowSceneGraphAboutToStop()), Qt::DirectConnection);
-
-    memset(&m_frameEvent, 0, sizeof(m_frameEvent));
-    m_frameEvent.type = UMEvent::Frame;
-    m_frameEvent.frame.window = id;
-
-    if ((flags & UMApplicationMonitorPrivate::Logging)
-        && (flags & UMApplicationMonitor::WindowEvent)) {
-        UMEvent event;
-        event.type = UMEvent::Window;
-        event.timeStamp = UMEventUtils::timeStamp();
-        event.window.id = id;
-        event.window.width = m_frameSize.width();
-        event.window.height = m_frameSize.height();
-        event.window.state = UMWindowEvent::Shown;
-        loggingThread->push(&event);
-    }
 }
 
 WindowMonitor::~WindowMonitor()
@@ -763,9 +1061,10 @@ WindowMonitor::~WindowMonitor()
         event.window.width = m_frameSize.width();
         event.window.height = m_frameSize.height();
         event.window.state = UMWindowEvent::Hidden;
-        m_loggingThread->push(&event);
+        m_loggingThread->push(m_eventQueue, &event);
     }
 
+    m_loggingThread->releaseQueue(m_eventQueue);
     m_loggingThread->deref();
 }
 
@@ -777,6 +1076,9 @@ void WindowMonitor::initializeGpuResources()
     //     that behavior programmatically.
     static bool noGpuTimer = qEnvironmentVariableIsSet("UM_NO_GPU_TIMER");
 
+    // Called on the render thread.
+    UMApplicationMonitorPrivate::get(m_applicationMonitor)->m_eventUtils.setRenderThread();
+
     m_overlay.initialize();
     m_gpuTimer.initialize();
     m_frameEvent.frame.number = 0;
@@ -795,12 +1097,20 @@ void WindowMonitor::finalizeGpuResources()
     DASSERT(m_flags & GpuResourcesInitialized);
 
     if (m_flags & GpuTimerAvailable) {
+        if (m_gpuTimer.lostCount() > 0) {
+            DLOG("GPUTimer lost the GPU time of %u frames on window %u",
+                 m_gpuTimer.lostCount(), m_id);
+        }
         m_gpuTimer.finalize();
     }
     m_overlay.finalize();
+    // The results still pending are dropped with the timer.
+    flushPendingFrames(true);
 
     m_frameEvent.frame.number = 0;
-    m_flags &= ~(GpuResourcesInitialized | GpuTimerAvailable);
+    m_frameEvent.frame.gpuTime = 0;
+    m_flags &= ~(GpuResourcesInitialized | GpuTimerAvailable | GpuTimeMeasured | GpuTimeSet
+                 | GpuTimeLost);
 }
 
 void WindowMonitor::windowSceneGraphInvalidated()
@@ -838,14 +1148,20 @@ void WindowMonitor::windowBeforeRendering()
             event.window.width = frameSize.width();
             event.window.height = frameSize.height();
             event.window.state = UMWindowEvent::Resized;
-            m_loggingThread->push(&event);
+            m_loggingThread->push(m_eventQueue, &event);
         }
     }
 
     if (m_flags & GpuResourcesInitialized) {
         m_sceneGraphTimer.start();
-        if (m_flags & GpuTimerAvailable) {
-            m_gpuTimer.start();
+        // The frame isn't measured if too many results are still pending, it
+        // is then recorded without GPU time and counted as lost.
+        if ((m_flags & GpuTimerAvailable) && m_gpuTimer.start(m_frameEvent.frame.number + 1)) {
+            m_flags = (m_flags & ~(GpuTimeSet | GpuTimeLost)) | GpuTimeMeasured;
+        } else {
+            m_flags = (m_flags & ~(GpuTimeMeasured | GpuTimeLost)) | GpuTimeSet
+                | (m_flags & GpuTimerAvailable ? GpuTimeLost : 0);
+            m_gpuTime = 0;
         }
     }
 }
@@ -854,8 +1170,13 @@ void WindowMonitor::windowAfterRendering()
 {
     if (m_flags & GpuResourcesInitialized) {
         m_frameEvent.frame.renderTime = m_sceneGraphTimer.nsecsElapsed();
-        m_frameEvent.frame.gpuTime = (m_flags & GpuTimerAvailable) ? m_gpuTimer.stop() : 0;
         m_frameEvent.frame.number++;
+        if (m_flags & GpuTimeMeasured) {
+            m_gpuTimer.stop();
+        }
+        if (m_flags & GpuTimerAvailable) {
+            takeGpuTimes();
+        }
         if (m_flags & UMApplicationMonitorPrivate::Overlay) {
             m_mutex.lock();
             m_overlay.render(m_frameEvent, m_frameSize);
@@ -870,11 +1191,20 @@ void WindowMonitor::windowFrameSwapped()
     if (m_flags & GpuResourcesInitialized) {
         m_frameEvent.frame.deltaTime = m_deltaTimer.isValid() ? m_deltaTimer.nsecsElapsed() : 0;
         m_deltaTimer.start();
-        if ((m_flags & UMApplicationMonitorPrivate::Logging) &&
-            (m_flags & UMApplicationMonitor::FrameEvent)) {
+        const bool logging = (m_flags & UMApplicationMonitorPrivate::Logging) &&
+            (m_flags & UMApplicationMonitor::FrameEvent);
+        const bool statistics = m_flags & UMApplicationMonitorPrivate::Statistics;
+        if (logging || statistics) {
             m_frameEvent.frame.swapTime = m_sceneGraphTimer.nsecsElapsed();
-            m_frameEvent.timeStamp = UMEventUtils::timeStamp();
-            m_loggingThread->push(&m_frameEvent);
+            const quint64 timeStamp = logging ? UMEventUtils::timeStamp() : 0;
+            if ((m_flags & GpuTimeSet) && m_pendingFrameCount == 0) {
+                UMFrameEvent frame = m_frameEvent.frame;
+                frame.gpuTime = m_gpuTime;
+                recordFrame(frame, timeStamp, m_flags & GpuTimeLost);
+            } else {
+                pushPendingFrame(timeStamp);
+                flushPendingFrames(false);
+            }
         }
     } else {
         initializeGpuResources();  // Get everything ready for the next frame.
@@ -884,6 +1214,96 @@ void WindowMonitor::windowFrameSwapped()
     }
 }
 
+// Retrieves the GPU times available and attaches them to their frames.
+void WindowMonitor::takeGpuTimes()
+{
+    quint32 frame;
+    quint64 time;
+    GPUTimer::Status status;
+    while ((status = m_gpuTimer.takeResult(&frame, &time)) == GPUTimer::Ready
+           || status == GPUTimer::Lost) {
+        const bool lost = status == GPUTimer::Lost;
+        if (!lost) {
+            m_frameEvent.frame.gpuTime = time;
+        } else {
+            time = 0;
+        }
+        // The frame last rendered is already pending when the results are
+        // taken while the window is idle.
+        bool found = false;
+        for (int i = 0; i < m_pendingFrameCount; i++) {
+            PendingFrame& pending = m_pendingFrames[(m_pendingFrameHead + i) % maxPendingFrames];
+            if (pending.frame.number == frame) {
+                pending.frame.gpuTime = time;
+                pending.gpuTimeSet = true;
+                pending.gpuTimeLost = lost;
+                found = true;
+                break;
+            }
+        }
+        if (!found && frame == m_frameEvent.frame.number) {
+            m_gpuTime = time;
+            m_flags = (m_flags & ~GpuTimeLost) | GpuTimeSet | (lost ? GpuTimeLost : 0);
+        }
+        // Other frames have been flushed without waiting for their result.
+    }
+}
+
+void WindowMonitor::pushPendingFrame(quint64 timeStamp)
+{
+    // Don't wait any longer for the GPU time of the oldest frame if full.
+    if (m_pendingFrameCount == maxPendingFrames) {
+        const PendingFrame& oldest = m_pendingFrames[m_pendingFrameHead];
+        recordFrame(oldest.frame, oldest.timeStamp, oldest.gpuTimeLost || !oldest.gpuTimeSet);
+        m_pendingFrameHead = (m_pendingFrameHead + 1) % maxPendingFrames;
+        m_pendingFrameCount--;
+    }
+    PendingFrame& pending =
+        m_pendingFrames[(m_pendingFrameHead + m_pendingFrameCount) % maxPendingFrames];
+    pending.frame = m_frameEvent.frame;
+    pending.timeStamp = timeStamp;
+    pending.gpuTimeSet = m_flags & GpuTimeSet;
+    pending.gpuTimeLost = pending.gpuTimeSet && (m_flags & GpuTimeLost);
+    pending.frame.gpuTime = pending.gpuTimeSet ? m_gpuTime : 0;
+    m_pendingFrameCount++;
+    m_hasPendingFrames.storeRelease(1);
+}
+
+// Records the pending frames in order, up to the first one still waiting for
+// its GPU time, or all of them if force is true. Frames recorded without their
+// GPU time are counted as lost.
+void WindowMonitor::flushPendingFrames(bool force)
+{
+    while (m_pendingFrameCount > 0) {
+        const PendingFrame& pending = m_pendingFrames[m_pendingFrameHead];
+        if (!pending.gpuTimeSet && !force) {
+            break;
+        }
+        recordFrame(pending.frame, pending.timeStamp, pending.gpuTimeLost || !pending.gpuTimeSet);
+        m_pendingFrameHead = (m_pendingFrameHead + 1) % maxPendingFrames;
+        m_pendingFrameCount--;
+    }
+    m_hasPendingFrames.storeRelease(m_pendingFrameCount > 0);
+}
+
+void WindowMonitor::recordFrame(const UMFrameEvent& frame, quint64 timeStamp, bool gpuTimeLost)
+{
+    if (m_flags & UMApplicationMonitorPrivate::Statistics) {
+        m_frameStatisticsMutex.lock();
+        m_frameStatistics.record(frame, m_vsyncInterval, gpuTimeLost);
+        m_frameSummaryStatistics.record(frame, m_vsyncInterval, gpuTimeLost);
+        m_frameStatisticsMutex.unlock();
+    }
+    if ((m_flags & UMApplicationMonitorPrivate::Logging)
+        && (m_flags & UMApplicationMonitor::FrameEvent)) {
+        UMEvent event;
+        event.type = UMEvent::Frame;
+        event.timeStamp = timeStamp;
+        event.frame = frame;
+        m_loggingThread->push(m_eventQueue, &event);
+    }
+}
+
 void WindowMonitor::windowSceneGraphAboutToStop()
 {
 #if !defined(QT_NO_DEBUG)
@@ -910,3 +1330,29 @@ void WindowMonitor::setProcessEvent(const UMEvent& event)
         m_window->update();
     }
 }
+
+void WindowMonitor::frameStatistics(UMFrameStatistics* statistics)
+{
+    DASSERT(statistics);
+
+    m_frameStatisticsMutex.lock();
+    m_frameStatistics.fillStatistics(statistics);
+    m_frameStatisticsMutex.unlock();
+}
+
+void WindowMonitor::resetFrameStatistics()
+{
+    m_frameStatisticsMutex.lock();
+    m_frameStatistics.reset();
+    m_frameStatisticsMutex.unlock();
+}
+
+void WindowMonitor::takeFrameSummary(UMFrameSummaryEvent* event)
+{
+    DASSERT(event);
+
+    m_frameStatisticsMutex.lock();
+    m_frameSummaryStatistics.fillSummaryEvent(event);
+    m_frameSummaryStatistics.reset();
+    m_frameStatisticsMutex.unlock();
+}
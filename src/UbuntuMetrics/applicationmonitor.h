@@ -22,9 +22,34 @@
 
 #include <UbuntuMetrics/logger.h>
 #include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/span.h>
 #include <UbuntuMetrics/ubuntumetricsglobal.h>
 
 class UMApplicationMonitorPrivate;
+class QQuickWindow;
+
+// Frame statistics of a monitored window. Times are in nanoseconds.
+struct UBUNTU_METRICS_EXPORT UMFrameStatistics
+{
+    // Window id, as logged in window and frame events.
+    quint32 window;
+
+    // Number of frames aggregated.
+    quint32 frameCount;
+
+    // Number of vertical syncs missed, deduced from the frame delta times and
+    // the screen refresh rate.
+    quint32 missedVsyncCount;
+
+    // 50th, 90th and 99th percentiles and max value of the frame metrics (as
+    // defined in UMFrameEvent), indexed by UMFrameSummaryEvent::Metric.
+    struct {
+        quint64 p50;
+        quint64 p90;
+        quint64 p99;
+        quint64 max;
+    } metrics[UMFrameSummaryEvent::MetricCount];
+};
 
 // Monitor a QtQuick application by automatically tracking QtQuick windows and
 // process metrics. The metrics gathered can be logged and displayed by an
@@ -43,11 +68,26 @@ public:
         FrameEvent   = (1 << 2),
         // Allow generic events logging.
         GenericEvent = (1 << 3),
+        // Allow frame summary events logging.
+        FrameSummaryEvent = (1 << 4),
+        // Allow span events logging (see UMSpan).
+        SpanEvent    = (1 << 5),
         // Allow all events logging.
-        AllEvents    = (ProcessEvent | WindowEvent | FrameEvent | GenericEvent)
+        AllEvents    = (ProcessEvent | WindowEvent | FrameEvent | GenericEvent | FrameSummaryEvent
+                        | SpanEvent)
     };
     Q_DECLARE_FLAGS(LoggingFilters, LoggingFilter)
 
+    enum OverflowPolicy {
+        // Drop the oldest queued events to make room for the new ones.
+        DropOldest = 0,
+        // Drop the new events.
+        DropNewest = 1,
+        // Wait for the logging thread to make room. Might add jitter to the
+        // monitored windows if the loggers are slow.
+        Block      = 2
+    };
+
     enum Event {
         // Application defined event indicating that the initialisation is done
         // and the UI ready. It can be used by tools to measure the time needed
@@ -67,6 +107,16 @@ public:
     void setLogging(bool logging);
     bool logging();
 
+    // Aggregate the frame metrics of the monitored windows in histograms.
+    // windowFrameStatistics() fills the statistics of a window aggregated since
+    // the last reset and returns false if the window isn't monitored or if the
+    // aggregation is disabled. A summary of the frames rendered in between is
+    // logged every updateInterval(UMEvent::FrameSummary) milliseconds.
+    void setFrameStatistics(bool frameStatistics);
+    bool frameStatistics();
+    bool windowFrameStatistics(QQuickWindow* window, UMFrameStatistics* statistics);
+    void resetFrameStatistics();
+
     // Set the logging filter. All events are logged by default.
     void setLoggingFilter(LoggingFilters filter);
     LoggingFilters loggingFilter();
@@ -77,6 +127,13 @@ public:
     bool removeLogger(UMLogger* logger, bool free = true);
     void clearLoggers(bool free = true);
 
+    // Set the policy applied when events are logged faster than the loggers
+    // can handle them. Default is DropOldest. droppedEventCount() returns the
+    // number of events dropped since the application monitor creation.
+    void setOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy overflowPolicy();
+    quint32 droppedEventCount();
+
     // Generic event system allowing to log application specific
     // events. registerGenericEvent() returns a unique integer id to be used as
     // first argument to logGenericEvent(). logGenericEvent() logs a generic
@@ -93,22 +150,26 @@ public:
     bool logEvent(Event event);
 
     // Set the time in milliseconds between two updates of events of a given
-    // type. -1 to disable updates. Only UMEvent::Process is accepted so far as
-    // event type, default value is 1000. Note that when the overlay is enabled,
-    // a process update triggers a frame update.
+    // type. -1 to disable updates. Only UMEvent::Process (default value is
+    // 1000) and UMEvent::FrameSummary (default value is -1) are accepted so far
+    // as event types. Note that when the overlay is enabled, a process update
+    // triggers a frame update.
     void setUpdateInterval(UMEvent::Type type, int interval);
     int updateInterval(UMEvent::Type type);
 
 Q_SIGNALS:
     void overlayChanged();
     void loggingChanged();
+    void frameStatisticsChanged();
     void loggingFilterChanged();
     void loggersChanged();
+    void overflowPolicyChanged();
     void updateIntervalChanged(UMEvent::Type type);
 
 private Q_SLOTS:
     void closeDown();
     void processTimeout();
+    void frameSummaryTimeout();
 
 private:
     static UMApplicationMonitor* self;
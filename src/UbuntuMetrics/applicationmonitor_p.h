@@ -28,6 +28,8 @@
 #include <QtCore/QRunnable>
 #include <QtCore/QAtomicInteger>
 
+#include <UbuntuMetrics/private/eventqueue_p.h>
+#include <UbuntuMetrics/private/histogram_p.h>
 #include <UbuntuMetrics/private/overlay_p.h>
 #include <UbuntuMetrics/private/gputimer_p.h>
 #include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
@@ -52,6 +54,7 @@ public:
         Logging     = (1 << 9),
         Started     = (1 << 10),
         ClosingDown = (1 << 11),
+        Statistics  = (1 << 12),
         // Higher bit allowed is (1 << 15).
         FilterMask             = 0x000000ff,
         ApplicationMonitorMask = 0x0000ff00,
@@ -69,6 +72,11 @@ public:
     bool hasMonitor(WindowMonitor* monitor);
     void setMonitoringFlags(quint32 flags);
     void processTimeout();
+    void frameSummaryTimeout();
+    void flushPendingFrames();
+    void push(const UMEvent* event);
+    void pushSpan(const UMEvent* event);
+    void updateSpanLogging();
 
     UMApplicationMonitor* const q_ptr;
     Q_DECLARE_PUBLIC(UMApplicationMonitor)
@@ -76,46 +84,74 @@ public:
     WindowMonitor* m_monitors[maxMonitors];
     UMLogger* m_loggers[maxLoggers];
     LoggingThread* m_loggingThread;
+    EventQueue* m_eventQueue;
 #if !defined(QT_NO_DEBUG)
     QGuiApplication* m_application;
 #endif
     UMEventUtils m_eventUtils;
     QTimer m_processTimer;
+    QTimer m_frameSummaryTimer;
     QMutex m_monitorsMutex;
+    QMutex m_eventQueueMutex;
     int m_monitorCount;
     int m_loggerCount;
     int m_updateInterval[UMEvent::TypeCount];
+    quint32 m_droppedEventCount;
     quint32 m_flags;
+    UMApplicationMonitor::OverflowPolicy m_overflowPolicy;
     alignas(64) UMEvent m_processEvent;
 };
 
+// The logging thread drains the event queues of the monitored windows and of
+// the application monitor, and passes the events to the installed loggers.
+// Each queue has a single producer, pushing never takes a lock except to wake
+// up the logging thread when it's sleeping.
 class UBUNTU_METRICS_PRIVATE_EXPORT LoggingThread : public QThread
 {
 public:
-    LoggingThread();
+    // One queue per window monitor plus one for the application monitor,
+    // doubled since released queues stay alive until drained.
+    static const int maxQueues = 2 * (UMApplicationMonitorPrivate::maxMonitors + 1);
+
+    LoggingThread(UMApplicationMonitor::OverflowPolicy policy);
 
     void run() override;
-    void push(const UMEvent* event);
+    void push(EventQueue* queue, const UMEvent* event);
     void setLoggers(UMLogger** loggers, int count);
     LoggingThread* ref();
     void deref();
 
+    // Creates a new event queue drained by the logging thread. The queue must
+    // be released by its producer once done with it, it's then deleted by the
+    // logging thread once drained. Returns nullptr if the max number of queues
+    // is reached.
+    EventQueue* createQueue();
+    void releaseQueue(EventQueue* queue);
+
+    void setOverflowPolicy(UMApplicationMonitor::OverflowPolicy policy) {
+        m_overflowPolicy.storeRelease(policy);
+    }
+    quint32 droppedEventCount() const { return m_droppedEventCount.loadAcquire(); }
+
 private:
     enum {
-        Waiting       = (1 << 0),
-        JoinRequested = (1 << 1)
+        JoinRequested = (1 << 0)
     };
 
     ~LoggingThread();
 
-    UMEvent* m_queue;
+    void wakeUp();
+
+    EventQueue* m_queues[maxQueues];
     UMLogger* m_loggers[UMApplicationMonitorPrivate::maxLoggers];
+    int m_queueCount;
     int m_loggerCount;
     QMutex m_mutex;
     QWaitCondition m_condition;
     QAtomicInteger<quint32> m_refCount;
-    qint8 m_queueIndex;
-    qint8 m_queueSize;
+    QAtomicInteger<quint32> m_waiting;
+    QAtomicInteger<quint32> m_overflowPolicy;
+    QAtomicInteger<quint32> m_droppedEventCount;
     quint8 m_flags;
 };
 
@@ -158,6 +194,25 @@ private:
     quint32 m_flags;
 };
 
+// Records the frames of an idle window still waiting for their GPU time, since
+// results are otherwise only retrieved when the next frame is rendered.
+class UBUNTU_METRICS_PRIVATE_EXPORT WindowMonitorFrameFlusher : public QRunnable
+{
+public:
+    WindowMonitorFrameFlusher(WindowMonitor* monitor)
+        : m_applicationMonitor(UMApplicationMonitor::instance())
+        , m_monitor(monitor) {
+        DASSERT(m_applicationMonitor);
+        DASSERT(monitor);
+    }
+
+    void run() override;
+
+private:
+    UMApplicationMonitor* m_applicationMonitor;
+    WindowMonitor* m_monitor;
+};
+
 class UBUNTU_METRICS_PRIVATE_EXPORT WindowMonitor : public QObject
 {
     Q_OBJECT
@@ -169,7 +224,15 @@ public:
     ~WindowMonitor();
 
     QQuickWindow* window() const { return m_window; }
+    quint32 id() const { return m_id; }
     void setProcessEvent(const UMEvent& event);
+    // Can be called from any thread.
+    bool hasPendingFrames() const { return m_hasPendingFrames.loadAcquire(); }
+
+    // Frame statistics accessors, can be called from any thread.
+    void frameStatistics(UMFrameStatistics* statistics);
+    void resetFrameStatistics();
+    void takeFrameSummary(UMFrameSummaryEvent* event);
 
 private Q_SLOTS:
     void windowSceneGraphInitialized();
@@ -186,32 +249,62 @@ private:
         // Lower bit allowed is (1 << 16).
         GpuResourcesInitialized = (1 << 16),
         GpuTimerAvailable       = (1 << 17),
-        SizeChanged             = (1 << 18)
+        SizeChanged             = (1 << 18),
+        GpuTimeMeasured         = (1 << 19),
+        GpuTimeSet              = (1 << 20),
+        GpuTimeLost             = (1 << 21)
         // Higher bit allowed is (1 << 31).
     };
 
+    // Frames swapped but whose GPU time hasn't been retrieved yet. Results of
+    // pipelined GPU timers come a few frames late, frames are held back until
+    // then to be recorded and logged with the right GPU time.
+    struct PendingFrame {
+        UMFrameEvent frame;
+        quint64 timeStamp;
+        bool gpuTimeSet;
+        bool gpuTimeLost;
+    };
+    static const int maxPendingFrames = GPUTimer::ringSize * 2;
+
     bool gpuResourcesInitialized() const { return m_flags & GpuResourcesInitialized; }
     void setFlags(quint32 flags) {
         m_flags = (m_flags & UMApplicationMonitorPrivate::WindowMonitorMask) | flags;
     }
     void initializeGpuResources();
     void finalizeGpuResources();
+    void takeGpuTimes();
+    void pushPendingFrame(quint64 timeStamp);
+    void flushPendingFrames(bool force);
+    void recordFrame(const UMFrameEvent& frame, quint64 timeStamp, bool gpuTimeLost);
 
     UMApplicationMonitor* m_applicationMonitor;
     LoggingThread* m_loggingThread;
+    EventQueue* m_eventQueue;
     QQuickWindow* m_window;
     GPUTimer m_gpuTimer;
     Overlay m_overlay;  // Accessed from different threads (needs locking).
     QMutex m_mutex;
+    // Aggregated since the last reset and since the last summary.
+    FrameStatistics m_frameStatistics;  // Accessed from different threads (needs locking).
+    FrameStatistics m_frameSummaryStatistics;  // Accessed from different threads (needs locking).
+    QMutex m_frameStatisticsMutex;
     QElapsedTimer m_sceneGraphTimer;
     QElapsedTimer m_deltaTimer;
+    quint64 m_vsyncInterval;
     quint32 m_id;
     quint32 m_flags;
     QSize m_frameSize;
-    UMEvent m_frameEvent;
+    UMEvent m_frameEvent;  // gpuTime holds the latest GPU time retrieved.
+    quint64 m_gpuTime;  // GPU time of the frame being rendered if GpuTimeSet.
+    PendingFrame m_pendingFrames[maxPendingFrames];
+    int m_pendingFrameHead;
+    int m_pendingFrameCount;
+    QAtomicInteger<quint32> m_hasPendingFrames;  // Mirrors m_pendingFrameCount > 0.
 
     friend class WindowMonitorDeleter;
     friend class WindowMonitorFlagSetter;
+    friend class WindowMonitorFrameFlusher;
 };
 
 #endif  // APPLICATIONMONITOR_P_H
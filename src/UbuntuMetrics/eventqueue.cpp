@@ -0,0 +1,115 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#include "eventqueue_p.h"
+
+#include <string.h>
+
+#include <QtCore/QThread>
+
+const int eventQueueAlignment = 64;
+const quint32 eventQueueMask = EventQueue::size - 1;
+Q_STATIC_ASSERT(IS_POWER_OF_TWO(EventQueue::size));
+
+EventQueue::EventQueue()
+    : m_head(0)
+    , m_tail(0)
+    , m_released(0)
+{
+    m_events = static_cast<UMEvent*>(alignedAlloc(eventQueueAlignment, size * sizeof(UMEvent)));
+}
+
+EventQueue::~EventQueue()
+{
+    free(m_events);
+}
+
+int EventQueue::push(const UMEvent* event, OverflowPolicy policy)
+{
+    DASSERT(event);
+
+    // Head and tail are free running counters, the unsigned difference gives
+    // the number of queued events even after wrapping around.
+    const quint32 head = m_head.loadAcquire();
+    quint32 tail = m_tail.loadAcquire();
+    int dropped = 0;
+
+    if (Q_UNLIKELY(head - tail == size)) {
+        switch (policy) {
+        case DropOldest:
+            // Steal the oldest slot. If the consumer popped events in the
+            // meantime, the test-and-set fails but there's room anyway. The
+            // consumer detects the steal when committing its pop and discards
+            // the copy it might have made of the overwritten slot.
+            if (m_tail.testAndSetOrdered(tail, tail + 1)) {
+                dropped = 1;
+            }
+            break;
+
+        case DropNewest:
+            return 1;
+
+        case Block:
+            // Might add jitter to the producer, only meant to be used when no
+            // event must be lost.
+            do {
+                QThread::yieldCurrentThread();
+                tail = m_tail.loadAcquire();
+            } while (head - tail == size);
+            break;
+
+        default:
+            DNOT_REACHED();
+            return 1;
+        }
+    }
+
+    memcpy(&m_events[head & eventQueueMask], event, sizeof(UMEvent));
+    m_head.storeRelease(head + 1);
+    return dropped;
+}
+
+int EventQueue::pop(UMEvent* events, int maxCount)
+{
+    DASSERT(events);
+    DASSERT(maxCount > 0);
+
+    quint32 tail = m_tail.loadAcquire();
+    while (true) {
+        const quint32 head = m_head.loadAcquire();
+        const quint32 count = qMin(head - tail, static_cast<quint32>(maxCount));
+        if (count == 0) {
+            return 0;
+        }
+
+        // Copy in at most two chunks to handle wrapping around.
+        const quint32 index = tail & eventQueueMask;
+        const quint32 firstCount = qMin(count, size - index);
+        memcpy(events, &m_events[index], firstCount * sizeof(UMEvent));
+        if (firstCount < count) {
+            memcpy(&events[firstCount], m_events, (count - firstCount) * sizeof(UMEvent));
+        }
+
+        // Commit. Fails if the producer dropped the oldest events while we
+        // were copying, the copied events might then be corrupted so we retry
+        // from the new tail.
+        if (m_tail.testAndSetOrdered(tail, tail + count)) {
+            return count;
+        }
+        tail = m_tail.loadAcquire();
+    }
+}
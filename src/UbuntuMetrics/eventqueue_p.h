@@ -0,0 +1,71 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EVENTQUEUE_P_H
+#define EVENTQUEUE_P_H
+
+#include <QtCore/QAtomicInteger>
+
+#include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
+
+// Bounded lock-free single-producer/single-consumer queue of events. The
+// producer (usually a render thread) pushes events without ever taking a lock
+// and the consumer (the logging thread) pops them in batches. The producer and
+// consumer indices live on different cache lines to avoid false sharing.
+class UBUNTU_METRICS_PRIVATE_EXPORT EventQueue
+{
+public:
+    // Must be a power-of-two.
+    static const quint32 size = 64;
+
+    enum OverflowPolicy { DropOldest = 0, DropNewest = 1, Block = 2 };
+
+    EventQueue();
+    ~EventQueue();
+
+    // Pushes an event to the queue, must only be called by the producer. When
+    // the queue is full, the event is handled depending on the given overflow
+    // policy. Returns the number of events dropped (0 or 1).
+    int push(const UMEvent* event, OverflowPolicy policy);
+
+    // Pops at most maxCount events from the queue into the given array, must
+    // only be called by the consumer. Returns the number of events popped.
+    int pop(UMEvent* events, int maxCount);
+
+    // Gets whether the queue is empty or not. Exact from the consumer, only a
+    // hint from other threads.
+    bool isEmpty() const { return m_head.loadAcquire() == m_tail.loadAcquire(); }
+
+    // Marks the queue as released by its producer, the consumer is then
+    // allowed to delete it once it's been drained.
+    void release() { m_released.storeRelease(1); }
+    bool isReleased() const { return m_released.loadAcquire(); }
+
+private:
+    Q_DISABLE_COPY(EventQueue)
+
+    // Incremented by the producer.
+    alignas(64) QAtomicInteger<quint32> m_head;
+    // Incremented by the consumer and, when dropping the oldest events, by the
+    // producer.
+    alignas(64) QAtomicInteger<quint32> m_tail;
+    alignas(64) UMEvent* m_events;
+    QAtomicInteger<quint32> m_released;
+};
+
+#endif  // EVENTQUEUE_P_H
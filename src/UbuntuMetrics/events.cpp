@@ -18,33 +18,95 @@
 #include "events_p.h"
 
 #include <string.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <cstdio>
 
 #include <QtCore/QElapsedTimer>
 
 #include "ubuntumetricsglobal_p.h"
 
-const int bufferSize = 128;
+// Big enough for /proc/self/status, the biggest of the files read.
+const int bufferSize = 4096;
 const int bufferAlignment = 64;
 
+static const char* const procFileName[] = {
+    "/proc/self/stat", "/proc/self/status", "/proc/self/smaps_rollup", "/proc/self/io"
+};
+Q_STATIC_ASSERT(ARRAY_SIZE(procFileName) == EventUtilsPrivate::ProcFileCount);
+
+static quint64 cpuTime(clockid_t clock)
+{
+    struct timespec time;
+    if (clock_gettime(clock, &time) == 0) {
+        return time.tv_sec * Q_UINT64_C(1000000000) + time.tv_nsec;
+    } else {
+        return 0;
+    }
+}
+
+// Returns the value following the given key in a null-terminated buffer of
+// "key: value" lines, 0 if the key can't be found. Keys must start with a new
+// line char to not match the end of other keys.
+static quint64 findValue(const char* buffer, const char* key)
+{
+    const char* value = strstr(buffer, key);
+    return value ? strtoull(value + strlen(key), nullptr, 10) : 0;
+}
+
 UMEventUtils::UMEventUtils()
     : d_ptr(new EventUtilsPrivate)
 {
 }
 
 EventUtilsPrivate::EventUtilsPrivate()
+    : m_processCpuTime(cpuTime(CLOCK_PROCESS_CPUTIME_ID))
+    , m_minorFaults(0)
+    , m_majorFaults(0)
+    , m_voluntaryContextSwitches(0)
+    , m_involuntaryContextSwitches(0)
+    , m_readBytes(0)
+    , m_writeBytes(0)
 {
 #if !defined(QT_NO_DEBUG)
     ASSERT(m_buffer = static_cast<char*>(alignedAlloc(bufferAlignment, bufferSize)));
 #else
     m_buffer = static_cast<char*>(alignedAlloc(bufferAlignment, bufferSize));
 #endif
+    // Files not available on the running kernel are left closed, the metrics
+    // they provide are then reported as 0.
+    for (int i = 0; i < ProcFileCount; ++i) {
+        m_fd[i] = open(procFileName[i], O_RDONLY | O_CLOEXEC);
+        if (m_fd[i] == -1) {
+            DWARN("EventUtils: can't open '%s'", procFileName[i]);
+        }
+    }
+
+    // The GUI thread is the one creating the instance, it's also the render
+    // thread until another one is set.
+    if (pthread_getcpuclockid(pthread_self(), &m_guiThreadClock) != 0) {
+        m_guiThreadClock = CLOCK_THREAD_CPUTIME_ID;
+    }
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    m_renderThreadClock.storeRelaxed(m_guiThreadClock);
+#else
+    m_renderThreadClock.store(m_guiThreadClock);
+#endif
+    m_previousRenderThreadClock = m_guiThreadClock;
+    m_guiThreadCpuTime = cpuTime(m_guiThreadClock);
+    m_renderThreadCpuTime = m_guiThreadCpuTime;
     m_cpuTimer.start();
-    m_cpuTicks = times(&m_cpuTimes);
     m_cpuOnlineCores = sysconf(_SC_NPROCESSORS_ONLN);
     m_pageSize = sysconf(_SC_PAGESIZE);
+
+    // Initialise the counters so that the first event gets the differences
+    // since the creation.
+    UMEvent event;
+    updateProcStatMetrics(&event);
+    updateProcStatusMetrics(&event);
+    updateProcIoMetrics(&event);
 }
 
 UMEventUtils::~UMEventUtils()
@@ -54,6 +116,11 @@ UMEventUtils::~UMEventUtils()
 
 EventUtilsPrivate::~EventUtilsPrivate()
 {
+    for (int i = 0; i < ProcFileCount; ++i) {
+        if (m_fd[i] != -1) {
+            close(m_fd[i]);
+        }
+    }
     free(m_buffer);
 }
 
@@ -66,83 +133,159 @@ void UMEventUtils::updateProcessEvent(UMEvent* event)
     event->timeStamp = UMEventUtils::timeStamp();
     d->updateCpuUsage(event);
     d->updateProcStatMetrics(event);
+    d->updateProcStatusMetrics(event);
+    d->updateProcSmapsMetrics(event);
+    d->updateProcIoMetrics(event);
 }
 
-void EventUtilsPrivate::updateCpuUsage(UMEvent* event)
+void UMEventUtils::setRenderThread()
 {
-    // times() is a Linux syscall giving CPU times used by the process. The
-    // granularity of the unit returned by the (some?) kernel (clock ticks)
-    // prevents us from getting precise timings at a high frequency, so we have
-    // to throttle to 200 ms (5 Hz).
-    const qint64 throttlingFrequency = 200;
-    if (m_cpuTimer.elapsed() > throttlingFrequency) {
-        struct tms newCpuTimes;
-        const clock_t newTicks = times(&newCpuTimes);
-        const clock_t ticks = newTicks - m_cpuTicks;
-        const clock_t userTime = newCpuTimes.tms_utime - m_cpuTimes.tms_utime;
-        const clock_t systemTime = newCpuTimes.tms_stime - m_cpuTimes.tms_stime;
-        event->process.cpuUsage = ((userTime + systemTime) * 100) / (ticks * m_cpuOnlineCores);
-        m_cpuTimer.start();
-        memcpy(&m_cpuTimes, &newCpuTimes, sizeof(struct tms));
-        m_cpuTicks = newTicks;
+    Q_D(EventUtils);
+
+    clockid_t clock;
+    if (pthread_getcpuclockid(pthread_self(), &clock) == 0) {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        d->m_renderThreadClock.storeRelaxed(clock);
+#else
+        d->m_renderThreadClock.store(clock);
+#endif
     }
 }
 
-void EventUtilsPrivate::updateProcStatMetrics(UMEvent* event)
+void EventUtilsPrivate::updateCpuUsage(UMEvent* event)
 {
-    int fd = open("/proc/self/stat", O_RDONLY);
-    if (fd == -1) {
-        DWARN("EventUtils: can't open '/proc/self/stat'");
+    // The CPU-time clocks have a nanosecond resolution, as opposed to the
+    // clock ticks returned by times(), so that there's no need to throttle.
+    const quint64 elapsed = m_cpuTimer.nsecsElapsed();
+    if (elapsed == 0) {
         return;
     }
-    int readSize;
-    if ((readSize = read(fd, m_buffer, bufferSize)) == 0) {
-        DWARN("EventUtils: can't read '/proc/self/stat'");
-        close(fd);
-        return;
+    m_cpuTimer.start();
+
+    const quint64 processCpuTime = cpuTime(CLOCK_PROCESS_CPUTIME_ID);
+    const quint64 guiThreadCpuTime = cpuTime(m_guiThreadClock);
+    event->process.cpuUsage =
+        ((processCpuTime - m_processCpuTime) * 100) / (elapsed * m_cpuOnlineCores);
+    event->process.guiThreadCpuUsage = ((guiThreadCpuTime - m_guiThreadCpuTime) * 100) / elapsed;
+    m_processCpuTime = processCpuTime;
+    m_guiThreadCpuTime = guiThreadCpuTime;
+
+    // The render thread might have changed (or exited, in which case its clock
+    // isn't valid anymore and the time is 0) since the last update.
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const clockid_t renderThreadClock = m_renderThreadClock.loadRelaxed();
+#else
+    const clockid_t renderThreadClock = m_renderThreadClock.load();
+#endif
+    const quint64 renderThreadCpuTime = cpuTime(renderThreadClock);
+    if (renderThreadClock == m_previousRenderThreadClock
+        && renderThreadCpuTime >= m_renderThreadCpuTime) {
+        event->process.renderThreadCpuUsage =
+            ((renderThreadCpuTime - m_renderThreadCpuTime) * 100) / elapsed;
+    } else {
+        event->process.renderThreadCpuUsage = 0;
+        m_previousRenderThreadClock = renderThreadClock;
     }
+    m_renderThreadCpuTime = renderThreadCpuTime;
+}
 
-    // Entries starting from 1 (as listed by 'man proc').
-    const int numThreadsEntry = 20;
-    const int vsizeEntry = 23;
-    const int rssEntry = 24;
-    const int lastEntry = rssEntry;
-
-    // Get the indices of num_threads, vsize and rss entries and check if
-    // the buffer is big enough.
-    int sourceIndex = 0, spaceCount = 0;
-    quint16 entryIndices[lastEntry + 1];
-    entryIndices[sourceIndex] = 0;
-    while (spaceCount < lastEntry) {
-        if (sourceIndex < readSize) {
-            if (m_buffer[sourceIndex++] == ' ') {
-                entryIndices[++spaceCount] = sourceIndex;
-            }
-        } else {
-            DASSERT(readSize == bufferSize); // Missing entries in /proc/self/stat.
-            DNOT_REACHED();  // Consider increasing bufferSize.
-            close(fd);
-            return;
-        }
+// Reads a whole procfs file in the null-terminated buffer. The content is
+// generated again at each read from offset 0, so the file is kept open.
+bool EventUtilsPrivate::readProcFile(ProcFile file)
+{
+    if (m_fd[file] == -1) {
+        return false;
+    }
+    const ssize_t readSize = pread(m_fd[file], m_buffer, bufferSize - 1, 0);
+    if (readSize <= 0) {
+        DWARN("EventUtils: can't read '%s'", procFileName[file]);
+        return false;
+    }
+    // Consider increasing bufferSize if that fails.
+    DASSERT(readSize < bufferSize - 1);
+    m_buffer[readSize] = '\0';
+    return true;
+}
+
+void EventUtilsPrivate::updateProcStatMetrics(UMEvent* event)
+{
+    if (!readProcFile(Stat)) {
+        return;
     }
 
-    unsigned long vsize;
+    // The second entry is the executable name in parentheses, which can
+    // contain spaces and parentheses, the other ones start after the last
+    // closing parenthesis. Entries from 3 to 24 (as listed by 'man proc') are
+    // state, ppid, pgrp, session, tty_nr, tpgid, flags, minflt, cminflt,
+    // majflt, cmajflt, utime, stime, cutime, cstime, priority, nice,
+    // num_threads, itrealvalue, starttime, vsize and rss.
+    const char* entries = strrchr(m_buffer, ')');
+    if (!entries) {
+        DNOT_REACHED();
+        return;
+    }
+    unsigned long minorFaults, majorFaults, vsize;
     long threadCount, rss;
-#if !defined(QT_NO_DEBUG)
-    int value =  sscanf(&m_buffer[entryIndices[numThreadsEntry-1]], "%ld", &threadCount);
-    ASSERT(value == 1);
-    value =  sscanf(&m_buffer[entryIndices[vsizeEntry-1]], "%lu %ld", &vsize, &rss);
-    ASSERT(value == 2);
-#else
-    sscanf(&m_buffer[entryIndices[numThreadsEntry-1]], "%ld", &threadCount);
-    sscanf(&m_buffer[entryIndices[vsizeEntry-1]], "%lu %ld", &vsize, &rss);
-#endif
+    const int value = sscanf(
+        entries + 1, " %*c %*d %*d %*d %*d %*d %*u %lu %*u %lu %*u %*u %*u %*d %*d %*d %*d %ld "
+        "%*d %*u %lu %ld", &minorFaults, &majorFaults, &threadCount, &vsize, &rss);
+    if (value != 5) {
+        DNOT_REACHED();
+        return;
+    }
 
     event->process.vszMemory = vsize >> 10;
     event->process.rssMemory = (rss * m_pageSize) >> 10;
     event->process.threadCount = threadCount;
+    event->process.minorFaults = minorFaults - m_minorFaults;
+    event->process.majorFaults = majorFaults - m_majorFaults;
+    m_minorFaults = minorFaults;
+    m_majorFaults = majorFaults;
+}
+
+void EventUtilsPrivate::updateProcStatusMetrics(UMEvent* event)
+{
+    if (!readProcFile(Status)) {
+        return;
+    }
+
+    const quint64 voluntary = findValue(m_buffer, "\nvoluntary_ctxt_switches:");
+    const quint64 involuntary = findValue(m_buffer, "\nnonvoluntary_ctxt_switches:");
+    event->process.voluntaryContextSwitches = voluntary - m_voluntaryContextSwitches;
+    event->process.involuntaryContextSwitches = involuntary - m_involuntaryContextSwitches;
+    m_voluntaryContextSwitches = voluntary;
+    m_involuntaryContextSwitches = involuntary;
+}
+
+void EventUtilsPrivate::updateProcSmapsMetrics(UMEvent* event)
+{
+    // smaps_rollup sums the metrics of all the mappings, which is way cheaper
+    // than parsing smaps. Values are in kilobytes.
+    if (!readProcFile(SmapsRollup)) {
+        event->process.pssMemory = 0;
+        event->process.ussMemory = 0;
+        return;
+    }
+
+    event->process.pssMemory = findValue(m_buffer, "\nPss:");
+    event->process.ussMemory =
+        findValue(m_buffer, "\nPrivate_Clean:") + findValue(m_buffer, "\nPrivate_Dirty:");
+}
+
+void EventUtilsPrivate::updateProcIoMetrics(UMEvent* event)
+{
+    if (!readProcFile(Io)) {
+        event->process.readBytes = 0;
+        event->process.writeBytes = 0;
+        return;
+    }
 
-    close(fd);
+    const quint64 readBytes = findValue(m_buffer, "\nread_bytes:");
+    const quint64 writeBytes = findValue(m_buffer, "\nwrite_bytes:");
+    event->process.readBytes = readBytes - m_readBytes;
+    event->process.writeBytes = writeBytes - m_writeBytes;
+    m_readBytes = readBytes;
+    m_writeBytes = writeBytes;
 }
 
 // static.
@@ -39,9 +39,39 @@ struct UBUNTU_METRICS_EXPORT UMProcessEvent
     // Number of threads at buffer swap.
     quint16 threadCount;
 
+    // Proportional set size (PSS) of the process in kilobytes, shared pages
+    // being divided by the number of processes mapping them. 0 if not
+    // available (requires /proc/self/smaps_rollup, Linux 4.14).
+    quint32 pssMemory;
+
+    // Unique set size (USS) of the process in kilobytes, the memory that would
+    // be freed if the process exited. 0 if not available.
+    quint32 ussMemory;
+
+    // Number of minor and major page faults since the previous process event.
+    quint32 minorFaults;
+    quint32 majorFaults;
+
+    // Number of voluntary and involuntary context switches since the previous
+    // process event.
+    quint32 voluntaryContextSwitches;
+    quint32 involuntaryContextSwitches;
+
+    // CPU usage of the GUI thread and of the render thread as a percentage of
+    // one core. The render thread is the one that last initialised a monitored
+    // window, it's the GUI thread with a non-threaded QtQuick render loop.
+    quint16 guiThreadCpuUsage;
+    quint16 renderThreadCpuUsage;
+
+    // Number of bytes read from and written to the storage layer since the
+    // previous process event. 0 if not available (requires task I/O
+    // accounting).
+    quint64 readBytes;
+    quint64 writeBytes;
+
     // The whole struct must take 112 bytes to allow future additions and best
     // memory alignment, don't forget to update when adding new metrics.
-    quint8 __reserved[/*12 bytes taken,*/ 100 /*bytes free*/];
+    quint8 __reserved[/*56 bytes taken,*/ 56 /*bytes free*/];
 };
 Q_STATIC_ASSERT(sizeof(UMProcessEvent) == 112);
 
@@ -118,9 +148,80 @@ struct UBUNTU_METRICS_EXPORT UMGenericEvent
 };
 Q_STATIC_ASSERT(sizeof(UMGenericEvent) == 112);
 
+struct UBUNTU_METRICS_EXPORT UMFrameSummaryEvent
+{
+    enum Metric {
+        DeltaTime = 0, SyncTime = 1, RenderTime = 2, GpuTime = 3, SwapTime = 4, MetricCount = 5
+    };
+
+    // The id of the window on which the frames have been rendered.
+    quint32 window;
+
+    // Number of frames rendered during the summary interval.
+    quint32 frameCount;
+
+    // Number of vertical syncs missed during the summary interval, deduced
+    // from the frame delta times and the screen refresh rate.
+    quint32 missedVsyncCount;
+
+    // 50th, 90th and 99th percentiles and max value in microseconds of the
+    // frame metrics (as defined in UMFrameEvent) rendered during the summary
+    // interval, indexed by Metric.
+    struct {
+        quint32 p50;
+        quint32 p90;
+        quint32 p99;
+        quint32 max;
+    } metrics[MetricCount];
+
+    // Number of frames whose GPU time couldn't be measured during the summary
+    // interval. Their GPU time is left out of the GpuTime metric.
+    quint32 gpuTimeLostCount;
+
+    // The whole struct must take 112 bytes to allow future additions and best
+    // memory alignment, don't forget to update when adding new metrics.
+    quint8 __reserved[/*96 bytes taken,*/ 16 /*bytes free*/];
+};
+Q_STATIC_ASSERT(sizeof(UMFrameSummaryEvent) == 112);
+
+struct UBUNTU_METRICS_EXPORT UMSpanEvent
+{
+    static const quint32 maxNameSize = 48;
+
+    // Unique id of the span, never 0.
+    quint32 id;
+
+    // Id of the span in which this span is nested, 0 if it isn't nested.
+    quint32 parent;
+
+    // Nesting depth, 0 if it isn't nested.
+    quint32 depth;
+
+    // Id of the thread on which the span began. Threads are numbered from 1 in
+    // the order in which they begin their first span.
+    quint32 thread;
+
+    // Time in nanoseconds between the beginning and the end of the span. The
+    // event time stamp is the time at which the span began.
+    quint64 duration;
+
+    // Size of the name (including the null-terminating char).
+    quint32 nameSize;
+
+    // Null-terminated name of the span.
+    char name[maxNameSize];
+
+    // The whole struct must take 112 bytes to allow future additions and best
+    // memory alignment, don't forget to update when adding new metrics.
+    quint8 __reserved[/*76 bytes taken,*/ 36 /*bytes free*/];
+};
+Q_STATIC_ASSERT(sizeof(UMSpanEvent) == 112);
+
 struct UBUNTU_METRICS_EXPORT UMEvent
 {
-    enum Type { Process = 0, Window = 1, Frame = 2, Generic = 3, TypeCount = 4 };
+    enum Type {
+        Process = 0, Window = 1, Frame = 2, Generic = 3, FrameSummary = 4, Span = 5, TypeCount = 6
+    };
 
     // Event type.
     Type type;
@@ -133,6 +234,8 @@ struct UBUNTU_METRICS_EXPORT UMEvent
         UMWindowEvent window;
         UMFrameEvent frame;
         UMGenericEvent generic;
+        UMFrameSummaryEvent frameSummary;
+        UMSpanEvent span;
     };
 };
 Q_STATIC_ASSERT(sizeof(UMEvent) == 128);
@@ -146,9 +249,14 @@ public:
     UMEventUtils();
     ~UMEventUtils();
 
-    // Fill the given event with updated process metrics.
+    // Fill the given event with updated process metrics. Counters are
+    // relative to the previous call.
     void updateProcessEvent(UMEvent* event);
 
+    // Set the calling thread as the render thread whose CPU usage is reported
+    // in process events. Can be called from any thread.
+    void setRenderThread();
+
     // Get a time stamp in nanoseconds. The timer is started at the first call,
     // returning 0.
     static quint64 timeStamp();
@@ -20,8 +20,9 @@
 
 #include <UbuntuMetrics/events.h>
 
-#include <sys/times.h>
+#include <time.h>
 
+#include <QtCore/QAtomicInteger>
 #include <QtCore/QElapsedTimer>
 
 #include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
@@ -29,18 +30,36 @@
 class UBUNTU_METRICS_PRIVATE_EXPORT EventUtilsPrivate
 {
 public:
+    // procfs files kept open and re-read with pread() at each update.
+    enum ProcFile { Stat = 0, Status = 1, SmapsRollup = 2, Io = 3, ProcFileCount = 4 };
+
     EventUtilsPrivate();
     ~EventUtilsPrivate();
 
     void updateCpuUsage(UMEvent* event);
     void updateProcStatMetrics(UMEvent* event);
+    void updateProcStatusMetrics(UMEvent* event);
+    void updateProcSmapsMetrics(UMEvent* event);
+    void updateProcIoMetrics(UMEvent* event);
+    bool readProcFile(ProcFile file);
 
     char* m_buffer;
+    int m_fd[ProcFileCount];
     QElapsedTimer m_cpuTimer;
-    struct tms m_cpuTimes;
-    clock_t m_cpuTicks;
+    clockid_t m_guiThreadClock;
+    QAtomicInteger<clockid_t> m_renderThreadClock;
+    clockid_t m_previousRenderThreadClock;
+    quint64 m_processCpuTime;
+    quint64 m_guiThreadCpuTime;
+    quint64 m_renderThreadCpuTime;
+    quint64 m_minorFaults;
+    quint64 m_majorFaults;
+    quint64 m_voluntaryContextSwitches;
+    quint64 m_involuntaryContextSwitches;
+    quint64 m_readBytes;
+    quint64 m_writeBytes;
     quint16 m_cpuOnlineCores;
-    quint16 m_pageSize;
+    quint32 m_pageSize;
 };
 
 #endif  // EVENTS_P_H
@@ -21,9 +21,25 @@
 
 #include "ubuntumetricsglobal_p.h"
 
-#if !defined(QT_OPENGL_ES) && !defined(GL_TIME_ELAPSED)
+#if defined(QT_OPENGL_ES)
+// For GL_EXT_disjoint_timer_query.
+#if !defined(GL_QUERY_RESULT_EXT)
+#define GL_QUERY_RESULT_EXT 0x8866
+#endif
+#if !defined(GL_QUERY_RESULT_AVAILABLE_EXT)
+#define GL_QUERY_RESULT_AVAILABLE_EXT 0x8867
+#endif
+#if !defined(GL_TIMESTAMP_EXT)
+#define GL_TIMESTAMP_EXT 0x8E28
+#endif
+#if !defined(GL_GPU_DISJOINT_EXT)
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+#else
+#if !defined(GL_TIME_ELAPSED)
 #define GL_TIME_ELAPSED 0x88BF  // For GL_EXT_timer_query.
 #endif
+#endif
 
 void GPUTimer::initialize()
 {
@@ -33,6 +49,9 @@ void GPUTimer::initialize()
 #if !defined QT_NO_DEBUG
     m_context = QOpenGLContext::currentContext();
 #endif
+    m_head = 0;
+    m_count = 0;
+    m_lostCount = 0;
 
 #if defined(QT_OPENGL_ES)
     QList<QByteArray> eglExtensions = QByteArray(
@@ -41,8 +60,31 @@ void GPUTimer::initialize()
     QList<QByteArray> glExtensions = QByteArray(
         reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS))).split(' ');
 
+    // EXTDisjointTimerQuery.
+    if (glExtensions.contains("GL_EXT_disjoint_timer_query")) {
+        m_timerQuery.genQueries = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLsizei, GLuint*)>(
+            eglGetProcAddress("glGenQueriesEXT"));
+        m_timerQuery.deleteQueries =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLsizei, const GLuint*)>(
+                eglGetProcAddress("glDeleteQueriesEXT"));
+        m_timerQuery.queryCounter = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum)>(
+            eglGetProcAddress("glQueryCounterEXT"));
+        m_timerQuery.getQueryObjectuiv =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint*)>(
+                eglGetProcAddress("glGetQueryObjectuivEXT"));
+        m_timerQuery.getQueryObjectui64v =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, quint64*)>(
+                eglGetProcAddress("glGetQueryObjectui64vEXT"));
+        m_timerQuery.genQueries(ringSize * 2, m_timer);
+        m_disjointCount = 0;
+        // Reset the disjoint state set by operations happening before.
+        GLint disjoint;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        m_type = EXTDisjointTimerQuery;
+        DLOG("GPUTimer is based on GL_EXT_disjoint_timer_query");
+
     // KHRFence.
-    if (eglExtensions.contains("EGL_KHR_fence_sync")
+    } else if (eglExtensions.contains("EGL_KHR_fence_sync")
         && (glExtensions.contains("GL_OES_EGL_sync")
             || glExtensions.contains("GL_OES_egl_sync") /*PowerVR fix*/)) {
         m_fenceSyncKHR.createSyncKHR = reinterpret_cast<
@@ -54,6 +96,7 @@ void GPUTimer::initialize()
         m_fenceSyncKHR.clientWaitSyncKHR = reinterpret_cast<
             EGLint (QOPENGLF_APIENTRYP)(EGLDisplay, EGLSyncKHR, EGLint, EGLTimeKHR)>(
                 eglGetProcAddress("eglClientWaitSyncKHR"));
+        m_beforeSync = EGL_NO_SYNC_KHR;
         m_type = KHRFence;
         DLOG("GPUTimer is based on GL_OES_EGL_sync");
 
@@ -81,20 +124,25 @@ void GPUTimer::initialize()
     QOpenGLContext* context = QOpenGLContext::currentContext();
     QSurfaceFormat format = context->format();
 
-    // ARBTimerQuery.
-    if (qMakePair(format.majorVersion(), format.minorVersion()) >= qMakePair(3, 2)
-        && context->hasExtension(QByteArrayLiteral("GL_ARB_timer_query"))) {
+    // ARBTimerQuery. Timer queries are core since OpenGL 3.3, the extension
+    // is exposed by compatibility contexts of lower versions too (Mesa's
+    // llvmpipe for instance).
+    if (qMakePair(format.majorVersion(), format.minorVersion()) >= qMakePair(3, 3)
+        || context->hasExtension(QByteArrayLiteral("GL_ARB_timer_query"))) {
         m_timerQuery.genQueries = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLsizei, GLuint*)>(
             context->getProcAddress("glGenQueries"));
         m_timerQuery.deleteQueries =
             reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLsizei, const GLuint*)>(
                 context->getProcAddress("glDeleteQueries"));
+        m_timerQuery.getQueryObjectiv =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLint*)>(
+                context->getProcAddress("glGetQueryObjectiv"));
         m_timerQuery.getQueryObjectui64v =
             reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint64*)>(
                 context->getProcAddress("glGetQueryObjectui64v"));
         m_timerQuery.queryCounter = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum)>(
             context->getProcAddress("glQueryCounter"));
-        m_timerQuery.genQueries(2, m_timer);
+        m_timerQuery.genQueries(ringSize * 2, m_timer);
         m_type = ARBTimerQuery;
         DLOG("GPUTimer is based on GL_ARB_timer_query");
 
@@ -109,10 +157,13 @@ void GPUTimer::initialize()
             context->getProcAddress("glBeginQuery"));
         m_timerQuery.endQuery = reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLenum)>(
             context->getProcAddress("glEndQuery"));
+        m_timerQuery.getQueryObjectiv =
+            reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLint*)>(
+                context->getProcAddress("glGetQueryObjectiv"));
         m_timerQuery.getQueryObjectui64vExt =
             reinterpret_cast<void (QOPENGLF_APIENTRYP)(GLuint, GLenum, GLuint64EXT*)>(
                 context->getProcAddress("glGetQueryObjectui64vEXT"));
-        m_timerQuery.genQueries(1, m_timer);
+        m_timerQuery.genQueries(ringSize * 2, m_timer);
         m_type = EXTTimerQuery;
         DLOG("GPUTimer is based on GL_EXT_timer_query");
     }
@@ -132,10 +183,17 @@ void GPUTimer::finalize()
 #if !defined QT_NO_DEBUG
     m_context = nullptr;
 #endif
+    m_head = 0;
+    m_count = 0;
 
 #if defined(QT_OPENGL_ES)
+    // EXTDisjointTimerQuery.
+    if (m_type == EXTDisjointTimerQuery) {
+        m_timerQuery.deleteQueries(ringSize * 2, m_timer);
+        m_type = Unset;
+
     // KHRFence.
-    if (m_type == KHRFence) {
+    } else if (m_type == KHRFence) {
         if (m_beforeSync != EGL_NO_SYNC_KHR) {
             m_fenceSyncKHR.destroySyncKHR(eglGetCurrentDisplay(), m_beforeSync);
         }
@@ -147,32 +205,43 @@ void GPUTimer::finalize()
         m_type = Unset;
     }
 #else
-    // ARBTimerQuery.
-    if (m_type == ARBTimerQuery) {
-        m_timerQuery.deleteQueries(2, m_timer);
+    // ARBTimerQuery and EXTTimerQuery.
+    if (m_type == ARBTimerQuery || m_type == EXTTimerQuery) {
+        m_timerQuery.deleteQueries(ringSize * 2, m_timer);
         m_type = Unset;
+    }
+#endif
 
-    // EXTTimerQuery.
-    } else if (m_type == EXTTimerQuery) {
-        m_timerQuery.deleteQueries(1, m_timer);
+    else {
         m_type = Unset;
     }
-#endif
 }
 
-void GPUTimer::start()
+bool GPUTimer::start(quint32 frame)
 {
     DASSERT(m_context == QOpenGLContext::currentContext());
     DASSERT(m_type != Unset);
     DASSERT(!m_started);
 
+    if (m_count == ringSize) {
+        m_lostCount++;
+        return false;
+    }
+
 #if !defined QT_NO_DEBUG
     m_started = true;
 #endif
 
+    const int index = (m_head + m_count) % ringSize;
+    m_frame[index] = frame;
+
 #if defined(QT_OPENGL_ES)
+    // EXTDisjointTimerQuery.
+    if (m_type == EXTDisjointTimerQuery) {
+        m_timerQuery.queryCounter(m_timer[index * 2], GL_TIMESTAMP_EXT);
+
     // KHRFence.
-    if (m_type == KHRFence) {
+    } else if (m_type == KHRFence) {
         m_beforeSync = m_fenceSyncKHR.createSyncKHR(
             eglGetCurrentDisplay(), EGL_SYNC_FENCE_KHR, NULL);
 
@@ -183,29 +252,162 @@ void GPUTimer::start()
 #else
     // ARBTimerQuery.
     if (m_type == ARBTimerQuery) {
-        m_timerQuery.queryCounter(m_timer[0], GL_TIMESTAMP);
+        m_timerQuery.queryCounter(m_timer[index * 2], GL_TIMESTAMP);
 
     // EXTTimerQuery.
     } else if (m_type == EXTTimerQuery) {
-        m_timerQuery.beginQuery(GL_TIME_ELAPSED, m_timer[0]);
+        m_timerQuery.beginQuery(GL_TIME_ELAPSED, m_timer[index * 2]);
     }
 #endif
+
+    return true;
 }
 
-quint64 GPUTimer::stop()
+void GPUTimer::stop()
 {
     DASSERT(m_context == QOpenGLContext::currentContext());
     DASSERT(m_type != Unset);
     DASSERT(m_started);
+    DASSERT(m_count < ringSize);
 
 #if !defined QT_NO_DEBUG
     m_started = false;
 #endif
 
+    const int index = (m_head + m_count) % ringSize;
+    m_count++;
+
+#if defined(QT_OPENGL_ES)
+    // EXTDisjointTimerQuery.
+    if (m_type == EXTDisjointTimerQuery) {
+        m_timerQuery.queryCounter(m_timer[index * 2 + 1], GL_TIMESTAMP_EXT);
+        return;
+    }
+#else
+    // ARBTimerQuery.
+    if (m_type == ARBTimerQuery) {
+        m_timerQuery.queryCounter(m_timer[index * 2 + 1], GL_TIMESTAMP);
+        return;
+
+    // EXTTimerQuery.
+    } else if (m_type == EXTTimerQuery) {
+        m_timerQuery.endQuery(GL_TIME_ELAPSED);
+        return;
+    }
+#endif
+
+    m_time[index] = synchronousStop();
+}
+
+GPUTimer::Status GPUTimer::takeResult(quint32* frame, quint64* time)
+{
+    DASSERT(m_context == QOpenGLContext::currentContext());
+    DASSERT(m_type != Unset);
+    DASSERT(frame);
+    DASSERT(time);
+
+    if (m_count == 0) {
+        return NoResult;
+    }
+
+    Status status;
+    if (isPipelined()) {
+        status = queryResult(m_head, time);
+        if (status == Pending) {
+            return Pending;
+        }
+    } else {
+        *time = m_time[m_head];
+        status = *time > 0 ? Ready : Lost;
+    }
+
+    *frame = m_frame[m_head];
+    m_head = (m_head + 1) % ringSize;
+    m_count--;
+    if (status == Lost) {
+        m_lostCount++;
+    }
+    return status;
+}
+
+GPUTimer::Status GPUTimer::queryResult(int index, quint64* time)
+{
+#if defined(QT_OPENGL_ES)
+    DASSERT(m_type == EXTDisjointTimerQuery);
+
+    // A disjoint operation (frequency change, context loss, ...) happening
+    // while measuring invalidates all the measures waiting for their results.
+    if (m_disjointCount == 0) {
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        if (disjoint) {
+            m_disjointCount = m_count;
+        }
+    }
+    if (m_disjointCount > 0) {
+        m_disjointCount--;
+        return Lost;
+    }
+
+    // Queries complete in order, the second one being available implies the
+    // first one is too.
+    GLuint available = GL_FALSE;
+    m_timerQuery.getQueryObjectuiv(m_timer[index * 2 + 1], GL_QUERY_RESULT_AVAILABLE_EXT,
+                                   &available);
+    if (!available) {
+        return Pending;
+    }
+    quint64 timeStamp[2] = { 0, 0 };
+    m_timerQuery.getQueryObjectui64v(m_timer[index * 2], GL_QUERY_RESULT_EXT, &timeStamp[0]);
+    m_timerQuery.getQueryObjectui64v(m_timer[index * 2 + 1], GL_QUERY_RESULT_EXT, &timeStamp[1]);
+    if (timeStamp[0] == 0 || timeStamp[1] < timeStamp[0]) {
+        return Lost;
+    }
+    *time = timeStamp[1] - timeStamp[0];
+    return Ready;
+#else
+    // ARBTimerQuery. Queries complete in order, the second one being available
+    // implies the first one is too.
+    if (m_type == ARBTimerQuery) {
+        GLint available = GL_FALSE;
+        m_timerQuery.getQueryObjectiv(m_timer[index * 2 + 1], GL_QUERY_RESULT_AVAILABLE,
+                                      &available);
+        if (!available) {
+            return Pending;
+        }
+        GLuint64 timeStamp[2] = { 0, 0 };
+        m_timerQuery.getQueryObjectui64v(m_timer[index * 2], GL_QUERY_RESULT, &timeStamp[0]);
+        m_timerQuery.getQueryObjectui64v(m_timer[index * 2 + 1], GL_QUERY_RESULT, &timeStamp[1]);
+        if (timeStamp[0] == 0 || timeStamp[1] < timeStamp[0]) {
+            return Lost;
+        }
+        *time = timeStamp[1] - timeStamp[0];
+        return Ready;
+    }
+
+    // EXTTimerQuery.
+    DASSERT(m_type == EXTTimerQuery);
+    GLint available = GL_FALSE;
+    m_timerQuery.getQueryObjectiv(m_timer[index * 2], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        return Pending;
+    }
+    GLuint64EXT elapsed = 0;
+    m_timerQuery.getQueryObjectui64vExt(m_timer[index * 2], GL_QUERY_RESULT, &elapsed);
+    *time = elapsed;
+    return Ready;
+#endif
+}
+
+// Blocks until the GPU is done and returns the time elapsed in nanoseconds
+// since the call to start(), or 0 if it can't be determined.
+quint64 GPUTimer::synchronousStop()
+{
 #if defined(QT_OPENGL_ES)
     // KHRFence.
     if (m_type == KHRFence) {
         QElapsedTimer timer;
+        timer.start();
         EGLDisplay dpy = eglGetCurrentDisplay();
         EGLSyncKHR afterSync = m_fenceSyncKHR.createSyncKHR(dpy, EGL_SYNC_FENCE_KHR, NULL);
         EGLint beforeSyncValue =
@@ -228,6 +430,7 @@ quint64 GPUTimer::stop()
     // NVFence.
     } else if (m_type == NVFence) {
         QElapsedTimer timer;
+        timer.start();
         m_fenceNV.setFenceNV(m_fence[1], GL_ALL_COMPLETED_NV);
         m_fenceNV.finishFenceNV(m_fence[0]);
         quint64 beforeTime = timer.nsecsElapsed();
@@ -235,29 +438,10 @@ quint64 GPUTimer::stop()
         quint64 afterTime = timer.nsecsElapsed();
         return afterTime - beforeTime;
     }
-#else
-    // ARBTimerQuery.
-    if (m_type == ARBTimerQuery) {
-        GLuint64 time[2] = { 0, 0 };
-        m_timerQuery.queryCounter(m_timer[1], GL_TIMESTAMP);
-        m_timerQuery.getQueryObjectui64v(m_timer[0], GL_QUERY_RESULT, &time[0]);
-        m_timerQuery.getQueryObjectui64v(m_timer[1], GL_QUERY_RESULT, &time[1]);
-        if (time[0] != 0 && time[1] != 0) {
-            return time[1] - time[0];
-        } else {
-            return -1;
-        }
-
-    // EXTTimerQuery.
-    } else if (m_type == EXTTimerQuery) {
-        GLuint64EXT time;
-        m_timerQuery.endQuery(GL_TIME_ELAPSED);
-        m_timerQuery.getQueryObjectui64vExt(m_timer[0], GL_QUERY_RESULT, &time);
-        return time;
-    }
 #endif
+
     // Finish.
-    else {
+    if (m_type == Finish) {
         QOpenGLFunctions* functions = QOpenGLContext::currentContext()->functions();
         QElapsedTimer timer;
         timer.start();
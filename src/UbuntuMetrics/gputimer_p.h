@@ -33,29 +33,65 @@
 // in the command buffer from the CPU, this timer pushes dedicated
 // synchronization commands to the command buffer, which the GPU signals
 // whenever completed. That allows to get accurate GPU timings.
+//
+// When timer queries are supported, the measures are pipelined: up to ringSize
+// frames can be measured before the first result is retrieved, results are
+// retrieved without blocking, a few frames later, once the GPU is done. Fences
+// can't timestamp GPU commands, the timer then falls back to synchronous
+// measures, blocking the render thread until the GPU is done, like glFinish
+// does when no synchronization mechanism is available at all.
 class UBUNTU_METRICS_PRIVATE_EXPORT GPUTimer
 {
 public:
+    // Maximum number of measures waiting for their results.
+    static const int ringSize = 8;
+
+    enum Status {
+        NoResult,  // No measure is waiting for its result.
+        Pending,   // The GPU hasn't completed the oldest measure yet.
+        Ready,     // The oldest measure is complete, its result is available.
+        Lost       // The result of the oldest measure can't be retrieved.
+    };
+
     GPUTimer() :
 #if !defined QT_NO_DEBUG
         m_context(nullptr), m_started(false),
 #endif
-        m_type(Unset) {}
+        m_type(Unset), m_head(0), m_count(0), m_lostCount(0) {}
 
     // Allocates/Deletes the OpenGL resources. finalize() is not called at
     // destruction, it must be explicitly called to free the resources at the
     // right time in a thread with the same OpenGL context bound than at
-    // initialize().
+    // initialize(). Measures waiting for their results are dropped.
     void initialize();
     void finalize();
 
-    // Starts/Stops the timer. stop() returns the time elapsed in nanoseconds
-    // since the call to start(). Calling start()/stop() two times in a row
+    // Starts/Stops the measure of the graphics commands rendering the given
+    // frame. start() returns false, and the frame is counted as lost, if
+    // ringSize measures are already waiting for their results, stop() must not
+    // be called in that case. Calling start()/stop() two times in a row
     // triggers an assertion in debug builds and leads to undefined results in
     // non-debug builds. Must be called in a thread with the same OpenGL context
     // bound than at initialize().
-    void start();
-    quint64 stop();
+    bool start(quint32 frame);
+    void stop();
+
+    // Retrieves, without blocking, the result of the oldest measure waiting for
+    // it. frame is set to the measured frame if Ready or Lost is returned, time
+    // is set to the time taken by the GPU in nanoseconds if Ready is returned.
+    // Results are retrieved in the order the measures were started. Must be
+    // called in a thread with the same OpenGL context bound than at
+    // initialize().
+    Status takeResult(quint32* frame, quint64* time);
+
+    // Whether results are retrieved frames after the measures or right after
+    // the calls to stop().
+    bool isPipelined() const { return m_type >= FirstQueryType; }
+
+    // Number of measures waiting for their results and number of frames whose
+    // measure has been lost since initialize().
+    int pendingCount() const { return m_count; }
+    quint32 lostCount() const { return m_lostCount; }
 
 private:
     enum Type {
@@ -64,18 +100,31 @@ private:
 #if defined(QT_OPENGL_ES)
         KHRFence,
         NVFence,
+        EXTDisjointTimerQuery,
+        FirstQueryType = EXTDisjointTimerQuery
 #else
         ARBTimerQuery,
-        EXTTimerQuery
+        EXTTimerQuery,
+        FirstQueryType = ARBTimerQuery
 #endif
     };
 
+    quint64 synchronousStop();
+    Status queryResult(int index, quint64* time);
+
 #if !defined QT_NO_DEBUG
     QOpenGLContext* m_context;
     bool m_started;
 #endif
     Type m_type;
 
+    // Ring of measures, m_head is the index of the oldest one.
+    int m_head;
+    int m_count;
+    quint32 m_lostCount;
+    quint32 m_frame[ringSize];
+    quint64 m_time[ringSize];  // Results of the synchronous measures.
+
 #if defined(QT_OPENGL_ES)
     struct {
         void (QOPENGLF_APIENTRYP genFencesNV)(GLsizei n, GLuint* fences);
@@ -94,19 +143,32 @@ private:
     } m_fenceSyncKHR;
     EGLSyncKHR m_beforeSync;
 
+    struct {
+        void (QOPENGLF_APIENTRYP genQueries)(GLsizei n, GLuint* ids);
+        void (QOPENGLF_APIENTRYP deleteQueries)(GLsizei n, const GLuint* ids);
+        void (QOPENGLF_APIENTRYP queryCounter)(GLuint id, GLenum target);
+        void (QOPENGLF_APIENTRYP getQueryObjectuiv)(GLuint id, GLenum pname, GLuint* params);
+        // GLuint64 isn't defined by OpenGL ES 2 headers.
+        void (QOPENGLF_APIENTRYP getQueryObjectui64v)(GLuint id, GLenum pname, quint64* params);
+    } m_timerQuery;
+    // Number of measures lost on a GPU disjoint operation, still to be taken.
+    int m_disjointCount;
 #else
     struct {
         void (QOPENGLF_APIENTRYP genQueries)(GLsizei n, GLuint* ids);
         void (QOPENGLF_APIENTRYP deleteQueries)(GLsizei n, const GLuint* ids);
         void (QOPENGLF_APIENTRYP beginQuery)(GLenum target, GLuint id);
         void (QOPENGLF_APIENTRYP endQuery)(GLenum target);
+        void (QOPENGLF_APIENTRYP getQueryObjectiv)(GLuint id, GLenum pname, GLint* params);
         void (QOPENGLF_APIENTRYP getQueryObjectui64v)(GLuint id, GLenum pname, GLuint64* params);
         void (QOPENGLF_APIENTRYP getQueryObjectui64vExt)(GLuint id, GLenum pname,
                                                          GLuint64EXT* params);
         void (QOPENGLF_APIENTRYP queryCounter)(GLuint id, GLenum target);
     } m_timerQuery;
-    GLuint m_timer[2];
 #endif
+    // Two timestamp queries per measure (only the first one is used by
+    // EXTTimerQuery).
+    GLuint m_timer[ringSize * 2];
 };
 
 #endif  // GPUTIMER_P_H
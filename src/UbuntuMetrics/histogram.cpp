@@ -0,0 +1,151 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#include "histogram_p.h"
+
+#include <string.h>
+
+// Values below that limit (in microseconds) are stored linearly.
+const quint32 linearLimit = 2 * Histogram::subBucketCount;
+
+// Gets the index of the bucket storing the given value in microseconds.
+static int bucketIndex(quint32 value)
+{
+    if (value < linearLimit) {
+        return value;
+    }
+    // Above the linear limit, each power of two range [2^k, 2^(k+1)) is split
+    // in 32 sub-buckets indexed by the 5 bits following the most significant.
+    const int k = 31 - __builtin_clz(value);
+    const int shift = k - 5;
+    return linearLimit + (k - 6) * Histogram::subBucketCount
+        + ((value >> shift) - Histogram::subBucketCount);
+}
+
+// Gets the highest value in microseconds stored by the bucket at index.
+static quint32 bucketHighestValue(int index)
+{
+    if (index < static_cast<int>(linearLimit)) {
+        return index;
+    }
+    const int k = (index - linearLimit) / Histogram::subBucketCount + 6;
+    const int shift = k - 5;
+    const quint32 lowestValue =
+        ((index - linearLimit) % Histogram::subBucketCount + Histogram::subBucketCount) << shift;
+    return lowestValue + ((1u << shift) - 1);
+}
+
+void Histogram::reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_max = 0;
+}
+
+void Histogram::record(quint64 value)
+{
+    const quint64 microseconds = qMin(value / 1000, static_cast<quint64>(0xffffffff));
+    const int index = bucketIndex(static_cast<quint32>(microseconds));
+    DASSERT(index < bucketCount);
+    m_buckets[index]++;
+    m_count++;
+    m_max = qMax(m_max, value);
+}
+
+quint64 Histogram::percentile(float fraction) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    // Rank of the value in the sorted set of recorded values, starting at 1.
+    const quint32 rank = qMax(static_cast<quint32>(fraction * m_count + 0.5f), 1u);
+    quint32 count = 0;
+    for (int i = 0; i < bucketCount; ++i) {
+        count += m_buckets[i];
+        if (count >= rank) {
+            // The max is exact and belongs to the last non-empty bucket.
+            if (count == m_count) {
+                return m_max;
+            }
+            return static_cast<quint64>(bucketHighestValue(i)) * 1000 + 999;
+        }
+    }
+    return m_max;
+}
+
+void FrameStatistics::reset()
+{
+    for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+        m_histograms[i].reset();
+    }
+    m_frameCount = 0;
+    m_missedVsyncCount = 0;
+    m_gpuTimeLostCount = 0;
+}
+
+void FrameStatistics::record(const UMFrameEvent& event, quint64 vsyncInterval, bool gpuTimeLost)
+{
+    // The delta time of the first frame after a pause is 0 and is meaningless.
+    if (event.deltaTime > 0) {
+        m_histograms[UMFrameSummaryEvent::DeltaTime].record(event.deltaTime);
+        // A frame is considered to have missed vertical syncs when it's been
+        // presented more than half an interval late.
+        if (vsyncInterval > 0 && event.deltaTime > vsyncInterval + vsyncInterval / 2) {
+            m_missedVsyncCount += (event.deltaTime + vsyncInterval / 2) / vsyncInterval - 1;
+        }
+    }
+    m_histograms[UMFrameSummaryEvent::SyncTime].record(event.syncTime);
+    m_histograms[UMFrameSummaryEvent::RenderTime].record(event.renderTime);
+    // A lost GPU time is 0 and would skew the percentiles.
+    if (!gpuTimeLost) {
+        m_histograms[UMFrameSummaryEvent::GpuTime].record(event.gpuTime);
+    } else {
+        m_gpuTimeLostCount++;
+    }
+    m_histograms[UMFrameSummaryEvent::SwapTime].record(event.swapTime);
+    m_frameCount++;
+}
+
+void FrameStatistics::fillStatistics(UMFrameStatistics* statistics) const
+{
+    DASSERT(statistics);
+
+    statistics->frameCount = m_frameCount;
+    statistics->missedVsyncCount = m_missedVsyncCount;
+    for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+        statistics->metrics[i].p50 = m_histograms[i].percentile(0.5f);
+        statistics->metrics[i].p90 = m_histograms[i].percentile(0.9f);
+        statistics->metrics[i].p99 = m_histograms[i].percentile(0.99f);
+        statistics->metrics[i].max = m_histograms[i].max();
+    }
+}
+
+void FrameStatistics::fillSummaryEvent(UMFrameSummaryEvent* event) const
+{
+    DASSERT(event);
+
+    event->frameCount = m_frameCount;
+    event->missedVsyncCount = m_missedVsyncCount;
+    event->gpuTimeLostCount = m_gpuTimeLostCount;
+    for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+        event->metrics[i].p50 = m_histograms[i].percentile(0.5f) / 1000;
+        event->metrics[i].p90 = m_histograms[i].percentile(0.9f) / 1000;
+        event->metrics[i].p99 = m_histograms[i].percentile(0.99f) / 1000;
+        event->metrics[i].max = qMin(m_histograms[i].max() / 1000, static_cast<quint64>(0xffffffff));
+    }
+}
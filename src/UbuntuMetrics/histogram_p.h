@@ -0,0 +1,78 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HISTOGRAM_P_H
+#define HISTOGRAM_P_H
+
+#include <UbuntuMetrics/applicationmonitor.h>
+#include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/private/ubuntumetricsglobal_p.h>
+
+// Log-linear histogram of durations, in the spirit of HDR histograms. Values
+// are recorded with a microsecond resolution and a relative precision of ~3%
+// (32 linear sub-buckets per power of two) up to ~71 minutes, in a fixed
+// amount of memory.
+class UBUNTU_METRICS_PRIVATE_EXPORT Histogram
+{
+public:
+    static const int subBucketCount = 32;
+    static const int bucketCount = 28 * subBucketCount;
+
+    Histogram() { reset(); }
+
+    void reset();
+
+    // Records a duration in nanoseconds.
+    void record(quint64 value);
+
+    // Gets the highest value in nanoseconds below which the given fraction
+    // (in the range [0, 1]) of the recorded values fall. Returns 0 if empty.
+    quint64 percentile(float fraction) const;
+
+    quint64 max() const { return m_max; }
+    quint32 count() const { return m_count; }
+
+private:
+    quint32 m_buckets[bucketCount];
+    quint32 m_count;
+    quint64 m_max;
+};
+
+// Aggregates the frame events of a window.
+class UBUNTU_METRICS_PRIVATE_EXPORT FrameStatistics
+{
+public:
+    FrameStatistics() { reset(); }
+
+    void reset();
+
+    // Records a frame event. vsyncInterval is the screen refresh interval in
+    // nanoseconds, used to count the missed vertical syncs. 0 disables it.
+    // gpuTimeLost tells that the GPU time of the frame couldn't be measured.
+    void record(const UMFrameEvent& event, quint64 vsyncInterval, bool gpuTimeLost = false);
+
+    void fillStatistics(UMFrameStatistics* statistics) const;
+    void fillSummaryEvent(UMFrameSummaryEvent* event) const;
+
+private:
+    Histogram m_histograms[UMFrameSummaryEvent::MetricCount];
+    quint32 m_frameCount;
+    quint32 m_missedVsyncCount;
+    quint32 m_gpuTimeLostCount;
+};
+
+#endif  // HISTOGRAM_P_H
@@ -19,6 +19,8 @@
 
 #include <dlfcn.h>
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
 #include <QtCore/QTime>
 
@@ -102,7 +104,24 @@ bool UMFileLogger::isOpen()
 
 void UMFileLogger::log(const UMEvent& event)
 {
-    d_func()->log(event);
+    Q_D(UMFileLogger);
+
+    if (d->m_flags & UMFileLoggerPrivate::Open) {
+        d->log(event);
+        d->m_textStream.flush();
+    }
+}
+
+void UMFileLogger::logBatch(const UMEvent* events, int count)
+{
+    Q_D(UMFileLogger);
+
+    if (d->m_flags & UMFileLoggerPrivate::Open) {
+        for (int i = 0; i < count; ++i) {
+            d->log(events[i]);
+        }
+        d->m_textStream.flush();
+    }
 }
 
 void UMFileLoggerPrivate::log(const UMEvent& event)
@@ -127,7 +146,17 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << event.process.cpuUsage << ' '
                     << event.process.vszMemory << ' '
                     << event.process.rssMemory << ' '
-                    << event.process.threadCount << '\n' << flush;
+                    << event.process.threadCount << ' '
+                    << event.process.pssMemory << ' '
+                    << event.process.ussMemory << ' '
+                    << event.process.minorFaults << ' '
+                    << event.process.majorFaults << ' '
+                    << event.process.voluntaryContextSwitches << ' '
+                    << event.process.involuntaryContextSwitches << ' '
+                    << event.process.guiThreadCpuUsage << ' '
+                    << event.process.renderThreadCpuUsage << ' '
+                    << event.process.readBytes << ' '
+                    << event.process.writeBytes << '\n';
             } else {
                 m_textStream
                     << (m_flags & Colored ? "\033[33mP\033[00m " : "P ")
@@ -135,8 +164,17 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << "CPU" << dimColon << event.process.cpuUsage << "% "
                     << "VSZ" << dimColon << event.process.vszMemory << "kB "
                     << "RSS" << dimColon << event.process.rssMemory << "kB "
-                    << "Threads" << dimColon << event.process.threadCount
-                    << '\n' << flush;
+                    << "PSS" << dimColon << event.process.pssMemory << "kB "
+                    << "USS" << dimColon << event.process.ussMemory << "kB "
+                    << "Threads" << dimColon << event.process.threadCount << ' '
+                    << "GUI" << dimColon << event.process.guiThreadCpuUsage << "% "
+                    << "Render" << dimColon << event.process.renderThreadCpuUsage << "% "
+                    << "Faults" << dimColon << event.process.minorFaults << '/'
+                    << event.process.majorFaults << ' '
+                    << "Switches" << dimColon << event.process.voluntaryContextSwitches << '/'
+                    << event.process.involuntaryContextSwitches << ' '
+                    << "IO" << dimColon << event.process.readBytes << '/'
+                    << event.process.writeBytes << "B\n";
             }
             break;
         }
@@ -152,7 +190,7 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << event.frame.syncTime << ' '
                     << event.frame.renderTime << ' '
                     << event.frame.gpuTime << ' '
-                    << event.frame.swapTime << '\n' << flush;
+                    << event.frame.swapTime << '\n';
             } else {
                 m_textStream
                     << (m_flags & Colored ? "\033[36mF\033[00m " : "F ")
@@ -163,7 +201,7 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << "Sync" << dimColon << event.frame.syncTime / 1000000.0f << "ms "
                     << "Render" << dimColon << event.frame.renderTime / 1000000.0f << "ms "
                     << "GPU" << dimColon << event.frame.gpuTime / 1000000.0f << "ms "
-                    << "Swap" << dimColon << event.frame.swapTime / 1000000.0f << "ms\n" << flush;
+                    << "Swap" << dimColon << event.frame.swapTime / 1000000.0f << "ms\n";
             }
             break;
 
@@ -175,7 +213,7 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << event.window.id << ' '
                     << event.window.state << ' '
                     << event.window.width << ' '
-                    << event.window.height << '\n' << flush;
+                    << event.window.height << '\n';
             } else {
                 const char* const stateString[] = { "Hidden", "Shown", "Resized" };
                 Q_STATIC_ASSERT(ARRAY_SIZE(stateString) == UMWindowEvent::StateCount);
@@ -185,7 +223,7 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << "Id" << dimColon << event.window.id << ' '
                     << "State" << dimColon << stateString[event.window.state] << ' '
                     << "Size" << dimColon << event.window.width << 'x' << event.window.height
-                    << '\n' << flush;
+                    << '\n';
             }
             break;
         }
@@ -196,14 +234,79 @@ void UMFileLoggerPrivate::log(const UMEvent& event)
                     << "G "
                     << event.timeStamp << ' '
                     << event.generic.id << ' '
-                    << event.generic.string << '\n' << flush;
+                    << event.generic.string << '\n';
             } else {
                 m_textStream
                     << (m_flags & Colored ? "\033[32mG\033[00m " : "G ")
                     << dim << timeString << reset << ' '
                     << "Id" << dimColon << event.generic.id << ' '
                     << "String" << dimColon << '"' << event.generic.string << '"'
-                    << '\n' << flush;
+                    << '\n';
+            }
+            break;
+        }
+
+        case UMEvent::FrameSummary: {
+            const char* const metricString[] = { "Delta", "Sync", "Render", "GPU", "Swap" };
+            Q_STATIC_ASSERT(ARRAY_SIZE(metricString) == UMFrameSummaryEvent::MetricCount);
+            if (m_flags & Parsable) {
+                m_textStream
+                    << "S "
+                    << event.timeStamp << ' '
+                    << event.frameSummary.window << ' '
+                    << event.frameSummary.frameCount << ' '
+                    << event.frameSummary.missedVsyncCount;
+                for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+                    m_textStream
+                        << ' ' << event.frameSummary.metrics[i].p50
+                        << ' ' << event.frameSummary.metrics[i].p90
+                        << ' ' << event.frameSummary.metrics[i].p99
+                        << ' ' << event.frameSummary.metrics[i].max;
+                }
+                m_textStream << ' ' << event.frameSummary.gpuTimeLostCount << '\n';
+            } else {
+                m_textStream
+                    << (m_flags & Colored ? "\033[34mS\033[00m " : "S ")
+                    << dim << timeString << reset << ' '
+                    << "Win" << dimColon << event.frameSummary.window << ' '
+                    << "Frames" << dimColon << event.frameSummary.frameCount << ' '
+                    << "Missed" << dimColon << event.frameSummary.missedVsyncCount << ' '
+                    << "Lost" << dimColon << event.frameSummary.gpuTimeLostCount;
+                // Percentiles 50, 90, 99 and max.
+                for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+                    m_textStream
+                        << ' ' << metricString[i] << dimColon
+                        << event.frameSummary.metrics[i].p50 / 1000.0f << '/'
+                        << event.frameSummary.metrics[i].p90 / 1000.0f << '/'
+                        << event.frameSummary.metrics[i].p99 / 1000.0f << '/'
+                        << event.frameSummary.metrics[i].max / 1000.0f << "ms";
+                }
+                m_textStream << '\n';
+            }
+            break;
+        }
+
+        case UMEvent::Span: {
+            if (m_flags & Parsable) {
+                m_textStream
+                    << "T "
+                    << event.timeStamp << ' '
+                    << event.span.thread << ' '
+                    << event.span.id << ' '
+                    << event.span.parent << ' '
+                    << event.span.depth << ' '
+                    << event.span.duration << ' '
+                    << event.span.name << '\n';
+            } else {
+                m_textStream
+                    << (m_flags & Colored ? "\033[31mT\033[00m " : "T ")
+                    << dim << timeString << reset << ' '
+                    << "Thread" << dimColon << event.span.thread << ' '
+                    << "Id" << dimColon << event.span.id << ' '
+                    << "Parent" << dimColon << event.span.parent << ' '
+                    << "Depth" << dimColon << event.span.depth << ' '
+                    << "Name" << dimColon << '"' << event.span.name << "\" "
+                    << "Duration" << dimColon << event.span.duration / 1000000.0f << "ms\n";
             }
             break;
         }
@@ -231,6 +334,494 @@ bool UMFileLogger::parsable()
     return !!(d_func()->m_flags & UMFileLoggerPrivate::Parsable);
 }
 
+UMBinaryLogger::UMBinaryLogger(const QString& fileName, quint32 maxEventCount)
+    : d_ptr(new UMBinaryLoggerPrivate(fileName, maxEventCount))
+{
+}
+
+UMBinaryLoggerPrivate::UMBinaryLoggerPrivate(const QString& fileName, quint32 maxEventCount)
+    : m_header(nullptr)
+    , m_events(nullptr)
+    , m_eventIndex(0)
+{
+    if (QDir::isRelativePath(fileName)) {
+        m_file.setFileName(QString(QDir::currentPath() + QDir::separator() + fileName));
+    } else {
+        m_file.setFileName(fileName);
+    }
+
+    // The whole file is allocated and mapped upfront so that logging an event
+    // is just a copy to memory, the kernel writing back the pages.
+    const quint32 eventCapacity = qMax(maxEventCount, 1u);
+    const qint64 size = sizeof(BinaryLogHeader) + eventCapacity * static_cast<qint64>(sizeof(UMEvent));
+    if (m_file.open(QIODevice::ReadWrite | QIODevice::Truncate) && m_file.resize(size)) {
+        if (uchar* data = m_file.map(0, size)) {
+            m_header = reinterpret_cast<BinaryLogHeader*>(data);
+            m_events = reinterpret_cast<UMEvent*>(data + sizeof(BinaryLogHeader));
+            memset(m_header, 0, sizeof(BinaryLogHeader));
+            m_header->magic = BinaryLogHeader::magicNumber;
+            m_header->version = BinaryLogHeader::currentVersion;
+            m_header->eventSize = sizeof(UMEvent);
+            m_header->eventCapacity = eventCapacity;
+            m_header->clockBase =
+                QDateTime::currentMSecsSinceEpoch() * Q_UINT64_C(1000000)
+                - UMEventUtils::timeStamp();
+            return;
+        }
+    }
+
+    WARN("BinaryLogger: Can't open file %s '%s'.", fileName.toLatin1().constData(),
+         m_file.errorString().toLatin1().constData());
+    m_file.close();
+}
+
+UMBinaryLogger::~UMBinaryLogger()
+{
+    delete d_ptr;
+}
+
+UMBinaryLoggerPrivate::~UMBinaryLoggerPrivate()
+{
+    if (m_header) {
+        m_file.unmap(reinterpret_cast<uchar*>(m_header));
+    }
+}
+
+bool UMBinaryLogger::isOpen()
+{
+    return !!d_func()->m_header;
+}
+
+void UMBinaryLogger::log(const UMEvent& event)
+{
+    d_func()->log(&event, 1);
+}
+
+void UMBinaryLogger::logBatch(const UMEvent* events, int count)
+{
+    d_func()->log(events, count);
+}
+
+void UMBinaryLoggerPrivate::log(const UMEvent* events, int count)
+{
+    DASSERT(count >= 0);
+
+    if (m_header) {
+        const quint32 capacity = m_header->eventCapacity;
+        int index = 0;
+        while (index < count) {
+            // Copy in contiguous chunks, wrapping around at the end of the file.
+            const int chunkCount = qMin(count - index, static_cast<int>(capacity - m_eventIndex));
+            memcpy(&m_events[m_eventIndex], &events[index], chunkCount * sizeof(UMEvent));
+            m_eventIndex += chunkCount;
+            if (m_eventIndex == capacity) {
+                m_eventIndex = 0;
+            }
+            index += chunkCount;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (events[i].type == UMEvent::Window) {
+                updateWindowTable(events[i].window);
+            }
+        }
+        // Updated last so that a decoder never sees an incomplete record.
+        m_header->eventCount += count;
+    }
+}
+
+void UMBinaryLoggerPrivate::updateWindowTable(const UMWindowEvent& event)
+{
+    DASSERT(m_header);
+
+    const quint32 count = m_header->windowCount;
+    quint32 index = 0;
+    while (index < count && m_header->windows[index].id != event.id) {
+        index++;
+    }
+    if (index == count) {
+        // Windows logged once the table is full are only available from the
+        // window events.
+        if (count == BinaryLogHeader::maxWindows) {
+            return;
+        }
+        m_header->windows[index].id = event.id;
+        m_header->windowCount++;
+    }
+    m_header->windows[index].width = event.width;
+    m_header->windows[index].height = event.height;
+    m_header->windows[index].state = event.state;
+}
+
+// static.
+UMBinaryLoggerPrivate::DecodeStatus UMBinaryLoggerPrivate::validate(const uchar* data, qint64 size)
+{
+    if (!data || size < static_cast<qint64>(sizeof(BinaryLogHeader))) {
+        return InvalidFile;
+    }
+    const BinaryLogHeader* header = reinterpret_cast<const BinaryLogHeader*>(data);
+    if (header->magic != BinaryLogHeader::magicNumber) {
+        return InvalidFile;
+    }
+    if (header->version != BinaryLogHeader::currentVersion
+        || header->eventSize != sizeof(UMEvent)) {
+        return UnsupportedVersion;
+    }
+    if (size < static_cast<qint64>(sizeof(BinaryLogHeader)
+                                   + header->eventCapacity * static_cast<qint64>(sizeof(UMEvent)))) {
+        return TruncatedFile;
+    }
+    return Decodable;
+}
+
+// static.
+void UMBinaryLoggerPrivate::decode(const uchar* data, UMLogger* logger)
+{
+    DASSERT(data);
+    DASSERT(logger);
+
+    // Events are stored in a ring, the oldest one follows the newest once the
+    // capacity has been exceeded. The ring is logged as at most two contiguous
+    // batches, from the oldest event to the end and from the start.
+    const BinaryLogHeader* header = reinterpret_cast<const BinaryLogHeader*>(data);
+    const UMEvent* events = reinterpret_cast<const UMEvent*>(data + sizeof(BinaryLogHeader));
+    const quint32 capacity = header->eventCapacity;
+    const quint64 eventCount = header->eventCount;
+    const quint32 count = eventCount > capacity ? capacity : static_cast<quint32>(eventCount);
+    const quint32 first = eventCount > capacity ? static_cast<quint32>(eventCount % capacity) : 0;
+    const quint32 tailCount = qMin(count, capacity - first);
+    if (tailCount > 0) {
+        logger->logBatch(&events[first], static_cast<int>(tailCount));
+    }
+    if (count > tailCount) {
+        logger->logBatch(events, static_cast<int>(count - tailCount));
+    }
+}
+
+// Initial capacity of the buffer in which a batch of events is formatted before
+// being written, it grows if needed.
+const int traceBufferSize = 64 * 1024;
+
+UMTraceEventLogger::UMTraceEventLogger(const QString& fileName)
+    : d_ptr(new UMTraceEventLoggerPrivate(fileName))
+{
+}
+
+UMTraceEventLoggerPrivate::UMTraceEventLoggerPrivate(const QString& fileName)
+    : m_pid(QByteArray::number(QCoreApplication::applicationPid()))
+    , m_namedTrackCount(0)
+{
+    if (QDir::isRelativePath(fileName)) {
+        m_file.setFileName(QString(QDir::currentPath() + QDir::separator() + fileName));
+    } else {
+        m_file.setFileName(fileName);
+    }
+
+    if (m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        // Events are streamed in a JSON array. Trace viewers accept a missing
+        // closing bracket, so a capture stays readable if the application
+        // doesn't exit cleanly.
+        m_buffer.reserve(traceBufferSize);
+        m_buffer.append("[\n{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":");
+        m_buffer.append(m_pid);
+        m_buffer.append(",\"tid\":0,\"args\":{\"name\":");
+        const QByteArray name = QCoreApplication::applicationName().toUtf8();
+        appendString(name.constData(), name.size());
+        m_buffer.append("}}");
+        flush();
+    } else {
+        WARN("TraceEventLogger: Can't open file %s '%s'.", fileName.toLatin1().constData(),
+             m_file.errorString().toLatin1().constData());
+    }
+}
+
+UMTraceEventLogger::~UMTraceEventLogger()
+{
+    delete d_ptr;
+}
+
+UMTraceEventLoggerPrivate::~UMTraceEventLoggerPrivate()
+{
+    if (m_file.isOpen()) {
+        m_buffer.append("\n]\n");
+        flush();
+    }
+}
+
+bool UMTraceEventLogger::isOpen()
+{
+    return d_func()->m_file.isOpen();
+}
+
+void UMTraceEventLogger::log(const UMEvent& event)
+{
+    Q_D(UMTraceEventLogger);
+
+    if (d->m_file.isOpen()) {
+        d->log(event);
+        d->flush();
+    }
+}
+
+void UMTraceEventLogger::logBatch(const UMEvent* events, int count)
+{
+    Q_D(UMTraceEventLogger);
+
+    if (d->m_file.isOpen()) {
+        for (int i = 0; i < count; ++i) {
+            d->log(events[i]);
+        }
+        d->flush();
+    }
+}
+
+void UMTraceEventLoggerPrivate::flush()
+{
+    m_file.write(m_buffer);
+    m_file.flush();
+    // Keeps the reserved capacity.
+    m_buffer.resize(0);
+}
+
+void UMTraceEventLoggerPrivate::log(const UMEvent& event)
+{
+    switch (event.type) {
+    case UMEvent::Process: {
+        beginEvent("C", "CPU", 0, event.timeStamp);
+        m_buffer.append(",\"args\":{\"usage\":");
+        appendNumber(event.process.cpuUsage);
+        m_buffer.append(",\"gui\":");
+        appendNumber(event.process.guiThreadCpuUsage);
+        m_buffer.append(",\"render\":");
+        appendNumber(event.process.renderThreadCpuUsage);
+        m_buffer.append("}}");
+        beginEvent("C", "Memory", 0, event.timeStamp);
+        m_buffer.append(",\"args\":{\"vsz\":");
+        appendNumber(event.process.vszMemory);
+        m_buffer.append(",\"rss\":");
+        appendNumber(event.process.rssMemory);
+        m_buffer.append(",\"pss\":");
+        appendNumber(event.process.pssMemory);
+        m_buffer.append(",\"uss\":");
+        appendNumber(event.process.ussMemory);
+        m_buffer.append("}}");
+        beginEvent("C", "Threads", 0, event.timeStamp);
+        m_buffer.append(",\"args\":{\"count\":");
+        appendNumber(event.process.threadCount);
+        m_buffer.append("}}");
+        beginEvent("C", "Faults", 0, event.timeStamp);
+        m_buffer.append(",\"args\":{\"minor\":");
+        appendNumber(event.process.minorFaults);
+        m_buffer.append(",\"major\":");
+        appendNumber(event.process.majorFaults);
+        m_buffer.append("}}");
+        beginEvent("C", "ContextSwitches", 0, event.timeStamp);
+        m_buffer.append(",\"args\":{\"voluntary\":");
+        appendNumber(event.process.voluntaryContextSwitches);
+        m_buffer.append(",\"involuntary\":");
+        appendNumber(event.process.involuntaryContextSwitches);
+        m_buffer.append("}}");
+        beginEvent("C", "IO", 0, event.timeStamp);
+        m_buffer.append(",\"args\":{\"read\":");
+        appendNumber(event.process.readBytes);
+        m_buffer.append(",\"write\":");
+        appendNumber(event.process.writeBytes);
+        m_buffer.append("}}");
+        break;
+    }
+
+    case UMEvent::Frame: {
+        // The time stamp is taken after the buffer swap, the passes are laid
+        // out contiguously before it.
+        const UMFrameEvent& frame = event.frame;
+        const quint64 duration = frame.syncTime + frame.renderTime + frame.swapTime;
+        const quint64 start = event.timeStamp > duration ? event.timeStamp - duration : 0;
+        const char* const passString[] = { "Sync", "Render", "Swap" };
+        const quint64 passTime[] = { frame.syncTime, frame.renderTime, frame.swapTime };
+        Q_STATIC_ASSERT(ARRAY_SIZE(passString) == ARRAY_SIZE(passTime));
+        nameTrack(frame.window);
+        beginEvent("X", "Frame", frame.window, start);
+        m_buffer.append(",\"dur\":");
+        appendTime(duration);
+        m_buffer.append(",\"args\":{\"number\":");
+        appendNumber(frame.number);
+        m_buffer.append(",\"deltaTime\":");
+        appendNumber(frame.deltaTime);
+        m_buffer.append(",\"gpuTime\":");
+        appendNumber(frame.gpuTime);
+        m_buffer.append("}}");
+        quint64 passStart = start;
+        for (int i = 0; i < static_cast<int>(ARRAY_SIZE(passString)); ++i) {
+            beginEvent("X", passString[i], frame.window, passStart);
+            m_buffer.append(",\"dur\":");
+            appendTime(passTime[i]);
+            m_buffer.append('}');
+            passStart += passTime[i];
+        }
+        break;
+    }
+
+    case UMEvent::Window: {
+        const char* const stateString[] = { "Hidden", "Shown", "Resized" };
+        Q_STATIC_ASSERT(ARRAY_SIZE(stateString) == UMWindowEvent::StateCount);
+        nameTrack(event.window.id);
+        beginEvent("i", stateString[event.window.state], event.window.id, event.timeStamp);
+        m_buffer.append(",\"s\":\"t\",\"args\":{\"width\":");
+        appendNumber(event.window.width);
+        m_buffer.append(",\"height\":");
+        appendNumber(event.window.height);
+        m_buffer.append("}}");
+        break;
+    }
+
+    case UMEvent::Generic: {
+        beginEvent("i", event.generic.string, 0, event.timeStamp,
+                   qMin(event.generic.stringSize, quint32(UMGenericEvent::maxStringSize)));
+        m_buffer.append(",\"s\":\"p\",\"args\":{\"id\":");
+        appendNumber(event.generic.id);
+        m_buffer.append("}}");
+        break;
+    }
+
+    case UMEvent::FrameSummary: {
+        const char* const metricString[] = { "delta", "sync", "render", "gpu", "swap" };
+        Q_STATIC_ASSERT(ARRAY_SIZE(metricString) == UMFrameSummaryEvent::MetricCount);
+        const UMFrameSummaryEvent& summary = event.frameSummary;
+        nameTrack(summary.window);
+        beginEvent("i", "FrameSummary", summary.window, event.timeStamp);
+        m_buffer.append(",\"s\":\"t\",\"args\":{\"frameCount\":");
+        appendNumber(summary.frameCount);
+        m_buffer.append(",\"missedVsyncCount\":");
+        appendNumber(summary.missedVsyncCount);
+        m_buffer.append(",\"gpuTimeLostCount\":");
+        appendNumber(summary.gpuTimeLostCount);
+        // Percentiles 50, 90, 99 and max in microseconds.
+        for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+            m_buffer.append(",\"");
+            m_buffer.append(metricString[i]);
+            m_buffer.append("\":[");
+            appendNumber(summary.metrics[i].p50);
+            m_buffer.append(',');
+            appendNumber(summary.metrics[i].p90);
+            m_buffer.append(',');
+            appendNumber(summary.metrics[i].p99);
+            m_buffer.append(',');
+            appendNumber(summary.metrics[i].max);
+            m_buffer.append(']');
+        }
+        m_buffer.append("}}");
+        break;
+    }
+
+    case UMEvent::Span: {
+        const quint32 track = spanTrackBase + event.span.thread;
+        nameTrack(track);
+        beginEvent("X", event.span.name, track, event.timeStamp,
+                   qMin(event.span.nameSize, quint32(UMSpanEvent::maxNameSize)));
+        m_buffer.append(",\"dur\":");
+        appendTime(event.span.duration);
+        m_buffer.append(",\"args\":{\"id\":");
+        appendNumber(event.span.id);
+        m_buffer.append(",\"parent\":");
+        appendNumber(event.span.parent);
+        m_buffer.append("}}");
+        break;
+    }
+
+    default:
+        DNOT_REACHED();
+        break;
+    }
+}
+
+void UMTraceEventLoggerPrivate::beginEvent(
+    const char* phase, const char* name, quint32 track, quint64 timeStamp, int nameSize)
+{
+    m_buffer.append(",\n{\"ph\":\"");
+    m_buffer.append(phase);
+    m_buffer.append("\",\"name\":");
+    appendString(name, nameSize);
+    m_buffer.append(",\"pid\":");
+    m_buffer.append(m_pid);
+    m_buffer.append(",\"tid\":");
+    appendNumber(track);
+    m_buffer.append(",\"ts\":");
+    appendTime(timeStamp);
+}
+
+// Emits the metadata event naming a track the first time it's used. Tracks
+// used once the table is full are left unnamed.
+void UMTraceEventLoggerPrivate::nameTrack(quint32 track)
+{
+    for (int i = 0; i < m_namedTrackCount; ++i) {
+        if (m_namedTracks[i] == track) {
+            return;
+        }
+    }
+    if (m_namedTrackCount == maxNamedTracks) {
+        return;
+    }
+    m_namedTracks[m_namedTrackCount++] = track;
+
+    m_buffer.append(",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":");
+    m_buffer.append(m_pid);
+    m_buffer.append(",\"tid\":");
+    appendNumber(track);
+    if (track >= spanTrackBase) {
+        m_buffer.append(",\"args\":{\"name\":\"Thread ");
+        appendNumber(track - spanTrackBase);
+    } else {
+        m_buffer.append(",\"args\":{\"name\":\"Window ");
+        appendNumber(track);
+    }
+    m_buffer.append("\"}}");
+}
+
+// Trace event times are in microseconds, nanoseconds are kept as decimals.
+void UMTraceEventLoggerPrivate::appendTime(quint64 time)
+{
+    const quint32 decimals = time % 1000;
+    appendNumber(time / 1000);
+    m_buffer.append('.');
+    m_buffer.append(static_cast<char>('0' + decimals / 100));
+    m_buffer.append(static_cast<char>('0' + (decimals / 10) % 10));
+    m_buffer.append(static_cast<char>('0' + decimals % 10));
+}
+
+void UMTraceEventLoggerPrivate::appendNumber(quint64 number)
+{
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number);
+    while (count > 0) {
+        m_buffer.append(digits[--count]);
+    }
+}
+
+// Appends a JSON string, stops at the null-terminating char or after size
+// chars if size isn't negative.
+void UMTraceEventLoggerPrivate::appendString(const char* string, int size)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    m_buffer.append('"');
+    for (int i = 0; (size < 0 || i < size) && string[i]; ++i) {
+        const char c = string[i];
+        if (c == '"' || c == '\\') {
+            m_buffer.append('\\');
+            m_buffer.append(c);
+        } else if (static_cast<uchar>(c) < 0x20) {
+            m_buffer.append("\\u00");
+            m_buffer.append(hexDigits[c >> 4]);
+            m_buffer.append(hexDigits[c & 0xf]);
+        } else {
+            m_buffer.append(c);
+        }
+    }
+    m_buffer.append('"');
+}
+
 #if defined(Q_OS_LINUX)
 
 UMLTTNGPlugin* UMLTTNGLogger::m_plugin = nullptr;
@@ -316,6 +907,26 @@ void UMLTTNGLogger::log(const UMEvent& event)
             break;
         }
 
+        case UMEvent::FrameSummary:
+            // FIXME(loicm) Not exposed through LTTng tracepoints yet, LTTng
+            //     users can aggregate the frame events themselves.
+            break;
+
+        case UMEvent::Span: {
+            Q_STATIC_ASSERT(sizeof(UMLTTNGSpanEvent::name) == UMSpanEvent::maxNameSize);
+            UMLTTNGSpanEvent spanEvent;
+            spanEvent.id = event.span.id;
+            spanEvent.parent = event.span.parent;
+            spanEvent.depth = event.span.depth;
+            spanEvent.thread = event.span.thread;
+            spanEvent.duration = event.span.duration * 0.000001f;
+            const quint32 nameSize = qMin(event.span.nameSize, quint32(UMSpanEvent::maxNameSize));
+            memcpy(spanEvent.name, event.span.name, nameSize);
+            spanEvent.name[UMSpanEvent::maxNameSize - 1] = '\0';
+            m_plugin->logSpanEvent(&spanEvent);
+            break;
+        }
+
         default:
             DNOT_REACHED();
             break;
@@ -23,6 +23,8 @@
 #include <UbuntuMetrics/ubuntumetricsglobal.h>
 
 class UMFileLoggerPrivate;
+class UMBinaryLoggerPrivate;
+class UMTraceEventLoggerPrivate;
 struct UMLTTNGPlugin;
 struct UMEvent;
 
@@ -35,6 +37,15 @@ public:
     // Log events.
     virtual void log(const UMEvent& event) = 0;
 
+    // Log count contiguous events. Called by the logging thread with all the
+    // events queued at once, loggers can reimplement it to amortise the cost
+    // of writing to the target device. Defaults to calling log() per event.
+    virtual void logBatch(const UMEvent* events, int count) {
+        for (int i = 0; i < count; ++i) {
+            log(events[i]);
+        }
+    }
+
     // Get whether the target device has been opened successfully or not.
     virtual bool isOpen() = 0;
 };
@@ -48,6 +59,7 @@ public:
     ~UMFileLogger();
 
     void log(const UMEvent& event) Q_DECL_OVERRIDE;
+    void logBatch(const UMEvent* events, int count) Q_DECL_OVERRIDE;
     bool isOpen() Q_DECL_OVERRIDE;
 
     void setParsable(bool parsable);
@@ -58,6 +70,47 @@ private:
     Q_DECLARE_PRIVATE(UMFileLogger)
 };
 
+// Log events to a binary file. Events are written as is to a preallocated and
+// memory-mapped file used as a ring buffer, the oldest events being overwritten
+// once maxEventCount events have been logged. The ubuntu-metrics-decoder tool
+// converts these files to the parsable text format of UMFileLogger.
+class UBUNTU_METRICS_EXPORT UMBinaryLogger : public UMLogger
+{
+public:
+    static const quint32 defaultMaxEventCount = 1024 * 1024;
+
+    UMBinaryLogger(const QString& fileName, quint32 maxEventCount = defaultMaxEventCount);
+    ~UMBinaryLogger();
+
+    void log(const UMEvent& event) Q_DECL_OVERRIDE;
+    void logBatch(const UMEvent* events, int count) Q_DECL_OVERRIDE;
+    bool isOpen() Q_DECL_OVERRIDE;
+
+private:
+    UMBinaryLoggerPrivate* const d_ptr;
+    Q_DECLARE_PRIVATE(UMBinaryLogger)
+};
+
+// Log events to a file in the Chrome trace event JSON format, which can be
+// opened directly by trace viewers (chrome://tracing, Perfetto UI). Each window
+// gets its own track on which frames are complete events with sync, render and
+// swap sub-slices. Process events are counters, generic events are instants
+// and spans are complete events on a track per thread.
+class UBUNTU_METRICS_EXPORT UMTraceEventLogger : public UMLogger
+{
+public:
+    UMTraceEventLogger(const QString& fileName);
+    ~UMTraceEventLogger();
+
+    void log(const UMEvent& event) Q_DECL_OVERRIDE;
+    void logBatch(const UMEvent* events, int count) Q_DECL_OVERRIDE;
+    bool isOpen() Q_DECL_OVERRIDE;
+
+private:
+    UMTraceEventLoggerPrivate* const d_ptr;
+    Q_DECLARE_PRIVATE(UMTraceEventLogger)
+};
+
 #if defined(Q_OS_LINUX)
 
 // Log events to LTTng.
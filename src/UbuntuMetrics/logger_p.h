@@ -38,6 +38,7 @@ public:
     UMFileLoggerPrivate(const QString& fileName, bool parsable);
     UMFileLoggerPrivate(FILE* fileHandle, bool parsable);
 
+    // Writes an event to the text stream without flushing it.
     void log(const UMEvent& event);
 
     QFile m_file;
@@ -45,4 +46,104 @@ public:
     quint8 m_flags;
 };
 
+// Header of the files written by UMBinaryLogger, followed by the event records.
+struct UBUNTU_METRICS_PRIVATE_EXPORT BinaryLogHeader
+{
+    static const quint32 magicNumber = 0x4c424d55;  // "UMBL" in little endian.
+    static const quint32 currentVersion = 1;
+    static const quint32 maxWindows = 16;
+
+    struct Window {
+        quint32 id;
+        quint16 width;
+        quint16 height;
+        quint32 state;
+        quint32 __reserved;
+    };
+
+    // Must be magicNumber.
+    quint32 magic;
+
+    // Version of the file format.
+    quint32 version;
+
+    // Size of an event record, must be sizeof(UMEvent).
+    quint32 eventSize;
+
+    // Number of event records allocated in the file.
+    quint32 eventCapacity;
+
+    // Number of events logged since the file creation. The oldest record is at
+    // index (eventCount % eventCapacity) once more than eventCapacity events
+    // have been logged.
+    quint64 eventCount;
+
+    // Time in nanoseconds since the Epoch corresponding to a null event time
+    // stamp, allows to retrieve the absolute time of events.
+    quint64 clockBase;
+
+    // Table of the windows logged, updated at window events.
+    quint32 windowCount;
+    quint32 __padding;
+    Window windows[maxWindows];
+
+    // The whole struct must take 512 bytes so that event records stay aligned.
+    quint8 __reserved[/*296 bytes taken,*/ 216 /*bytes free*/];
+};
+Q_STATIC_ASSERT(sizeof(BinaryLogHeader) == 512);
+
+class UBUNTU_METRICS_PRIVATE_EXPORT UMBinaryLoggerPrivate
+{
+public:
+    UMBinaryLoggerPrivate(const QString& fileName, quint32 maxEventCount);
+    ~UMBinaryLoggerPrivate();
+
+    enum DecodeStatus { Decodable, InvalidFile, UnsupportedVersion, TruncatedFile };
+
+    void log(const UMEvent* events, int count);
+    void updateWindowTable(const UMWindowEvent& event);
+
+    // Checks that the mapped binary log can be decoded.
+    static DecodeStatus validate(const uchar* data, qint64 size);
+
+    // Logs the events of a validated binary log, from the oldest one.
+    static void decode(const uchar* data, UMLogger* logger);
+
+    QFile m_file;
+    BinaryLogHeader* m_header;
+    UMEvent* m_events;
+    quint32 m_eventIndex;
+};
+
+class UBUNTU_METRICS_PRIVATE_EXPORT UMTraceEventLoggerPrivate
+{
+public:
+    // Window tracks are identified by the window id, span tracks by this base
+    // plus the span thread id, process wide events go to track 0.
+    static const quint32 spanTrackBase = 0x10000;
+    static const int maxNamedTracks = 64;
+
+    UMTraceEventLoggerPrivate(const QString& fileName);
+    ~UMTraceEventLoggerPrivate();
+
+    // Appends an event to the buffer without writing it.
+    void log(const UMEvent& event);
+    void flush();
+
+    // Appends the fields shared by all the events, the caller appends the
+    // other fields and closes the object.
+    void beginEvent(const char* phase, const char* name, quint32 track, quint64 timeStamp,
+                    int nameSize = -1);
+    void nameTrack(quint32 track);
+    void appendTime(quint64 time);
+    void appendNumber(quint64 number);
+    void appendString(const char* string, int size = -1);
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QByteArray m_pid;
+    quint32 m_namedTracks[maxNamedTracks];
+    int m_namedTrackCount;
+};
+
 #endif  // LOGGER_P_H
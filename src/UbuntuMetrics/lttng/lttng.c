@@ -38,9 +38,15 @@ static void logGenericEvent(UMLTTNGGenericEvent* event)
     tracepoint(UbuntuMetrics, generic, event);
 }
 
+static void logSpanEvent(UMLTTNGSpanEvent* event)
+{
+    tracepoint(UbuntuMetrics, span, event);
+}
+
 const struct UMLTTNGPlugin umLttngPlugin = {
     &logProcessEvent,
     &logFrameEvent,
     &logWindowEvent,
     &logGenericEvent,
+    &logSpanEvent,
 };
@@ -25,12 +25,14 @@ typedef struct _UMLTTNGProcessEvent UMLTTNGProcessEvent;
 typedef struct _UMLTTNGFrameEvent UMLTTNGFrameEvent;
 typedef struct _UMLTTNGWindowEvent UMLTTNGWindowEvent;
 typedef struct _UMLTTNGGenericEvent UMLTTNGGenericEvent;
+typedef struct _UMLTTNGSpanEvent UMLTTNGSpanEvent;
 
 struct UMLTTNGPlugin {
     void (*logProcessEvent)(UMLTTNGProcessEvent*);
     void (*logFrameEvent)(UMLTTNGFrameEvent*);
     void (*logWindowEvent)(UMLTTNGWindowEvent*);
     void (*logGenericEvent)(UMLTTNGGenericEvent*);
+    void (*logSpanEvent)(UMLTTNGSpanEvent*);
 };
 
 struct _UMLTTNGProcessEvent {
@@ -65,4 +67,14 @@ struct _UMLTTNGGenericEvent {
     char string[64];
 };
 
+struct _UMLTTNGSpanEvent {
+    uint32_t id;
+    uint32_t parent;
+    uint32_t depth;
+    uint32_t thread;
+    float duration;
+    // Keep the size in sync with UMSpanEvent::maxNameSize.
+    char name[48];
+};
+
 #endif  // LTTNG_P_H
@@ -79,5 +79,20 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    UbuntuMetrics, span,
+    TP_ARGS(
+        UMLTTNGSpanEvent*, spanEvent
+    ),
+    TP_FIELDS(
+        ctf_integer(uint32_t, id, spanEvent->id)
+        ctf_integer(uint32_t, parent, spanEvent->parent)
+        ctf_integer(uint32_t, depth, spanEvent->depth)
+        ctf_integer(uint32_t, thread, spanEvent->thread)
+        ctf_float(float, duration, spanEvent->duration)
+        ctf_string(name, spanEvent->name)
+    )
+)
+
 #endif  // TRACEPOINTS_P_H
 #include <lttng/tracepoint-event.h>
@@ -55,6 +55,8 @@ static const struct {
     { "threadCount", sizeof("threadCount") - 1, 3, UMEvent::Process },
     { "vszMemory",   sizeof("vszMemory") - 1,   8, UMEvent::Process },
     { "rssMemory",   sizeof("rssMemory") - 1,   8, UMEvent::Process },
+    { "pssMemory",   sizeof("pssMemory") - 1,   8, UMEvent::Process },
+    { "ussMemory",   sizeof("ussMemory") - 1,   8, UMEvent::Process },
     { "windowId",    sizeof("windowId") - 1,    2, UMEvent::Window  },
     { "windowSize",  sizeof("windowSize") - 1,  9, UMEvent::Window  },
     { "frameNumber", sizeof("frameNumber") - 1, 7, UMEvent::Frame   },
@@ -65,8 +67,8 @@ static const struct {
     { "totalTime",   sizeof("totalTime") - 1,   7, UMEvent::Frame   }
 };
 enum {
-    CpuUsage = 0, ThreadCount, VszMemory, RssMemory, WindowId, WindowSize, FrameNumber, DeltaTime,
-    SyncTime, RenderTime, GpuTime, TotalTime, MetricCount
+    CpuUsage = 0, ThreadCount, VszMemory, RssMemory, PssMemory, UssMemory, WindowId, WindowSize,
+    FrameNumber, DeltaTime, SyncTime, RenderTime, GpuTime, TotalTime, MetricCount
 };
 Q_STATIC_ASSERT(ARRAY_SIZE(metricInfo) == MetricCount);
 
@@ -343,6 +345,12 @@ void Overlay::updateProcessMetrics()
         case RssMemory:
             integerMetricToText(m_processEvent.process.rssMemory, text, textWidth);
             break;
+        case PssMemory:
+            integerMetricToText(m_processEvent.process.pssMemory, text, textWidth);
+            break;
+        case UssMemory:
+            integerMetricToText(m_processEvent.process.ussMemory, text, textWidth);
+            break;
         default:
             DNOT_REACHED();
             break;
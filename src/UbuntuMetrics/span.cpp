@@ -0,0 +1,85 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#include "span.h"
+#include "applicationmonitor_p.h"
+
+QAtomicInt UMSpan::s_enabled(0);
+
+// Nesting state of the spans begun on the current thread.
+static thread_local quint32 s_currentSpan = 0;
+static thread_local quint32 s_currentDepth = 0;
+static thread_local quint32 s_threadId = 0;
+
+static QAtomicInteger<quint32> s_spanCount(0);
+static QAtomicInteger<quint32> s_threadCount(0);
+
+void UMSpan::beginSpan(const char* name, Mode mode)
+{
+    DASSERT(name);
+
+    if (!s_threadId) {
+        s_threadId = s_threadCount.fetchAndAddRelaxed(1) + 1;
+    }
+    // 0 means not running, skip it on wrap around.
+    do {
+        m_id = s_spanCount.fetchAndAddRelaxed(1) + 1;
+    } while (Q_UNLIKELY(!m_id));
+
+    m_name = name;
+    m_parent = s_currentSpan;
+    m_depth = s_currentDepth;
+    m_thread = s_threadId;
+    m_mode = mode;
+    if (mode == Scoped) {
+        s_currentSpan = m_id;
+        s_currentDepth = m_depth + 1;
+    }
+    m_startTime = UMEventUtils::timeStamp();
+}
+
+void UMSpan::endSpan()
+{
+    DASSERT(m_id);
+
+    const quint64 endTime = UMEventUtils::timeStamp();
+    if (m_mode == Scoped) {
+        // Scoped spans must end on the thread they began, in reverse order.
+        DASSERT(s_currentSpan == m_id);
+        s_currentSpan = m_parent;
+        s_currentDepth = m_depth;
+    }
+
+    // Logging might have been disabled while the span was running.
+    if (enabled()) {
+        UMEvent event;
+        event.type = UMEvent::Span;
+        event.timeStamp = m_startTime;
+        event.span.id = m_id;
+        event.span.parent = m_parent;
+        event.span.depth = m_depth;
+        event.span.thread = m_thread;
+        event.span.duration = endTime - m_startTime;
+        // Truncate without formatting, the name is copied as is.
+        const quint32 size = qstrnlen(m_name, UMSpanEvent::maxNameSize - 1) + 1;
+        memcpy(event.span.name, m_name, size - 1);
+        event.span.name[size - 1] = '\0';
+        event.span.nameSize = size;
+        UMApplicationMonitorPrivate::get(UMApplicationMonitor::instance())->pushSpan(&event);
+    }
+    m_id = 0;
+}
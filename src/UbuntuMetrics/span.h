@@ -0,0 +1,91 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SPAN_H
+#define SPAN_H
+
+#include <QtCore/QAtomicInt>
+
+#include <UbuntuMetrics/ubuntumetricsglobal.h>
+
+// Time span logged as a UMEvent::Span event by the application monitor. A span
+// begins at construction (or at the first begin() call) and ends at
+// destruction (or at the end() call). Spans begun on a thread while another
+// span is running on that same thread are nested in it, their event has the id
+// of the running span as parent. Detached spans can be ended on the next
+// iterations of the event loop (asynchronous jobs for instance), they get a
+// parent but spans begun after them aren't nested in them.
+//
+// Spans are only logged when the application monitor is logging with a filter
+// containing UMApplicationMonitor::SpanEvent. When not, beginning a span costs
+// a relaxed atomic load. The name must be a null-terminated string that stays
+// valid until the span ends (string literals are expected), it's truncated to
+// UMSpanEvent::maxNameSize characters (including the null-terminating char).
+class UBUNTU_METRICS_EXPORT UMSpan
+{
+public:
+    enum Mode { Scoped = 0, Detached = 1 };
+
+    UMSpan() : m_id(0) {}
+    explicit UMSpan(const char* name, Mode mode = Scoped) : m_id(0) { begin(name, mode); }
+    ~UMSpan() { end(); }
+
+    // Begin the span. Does nothing if the span is already running.
+    void begin(const char* name, Mode mode = Scoped) {
+        if (Q_UNLIKELY(enabled()) && !m_id) {
+            beginSpan(name, mode);
+        }
+    }
+
+    // End the span and log it. Does nothing if the span isn't running.
+    void end() {
+        if (Q_UNLIKELY(m_id)) {
+            endSpan();
+        }
+    }
+
+    // Whether spans are currently logged.
+    static bool isEnabled() { return !!enabled(); }
+
+private:
+    Q_DISABLE_COPY(UMSpan)
+
+    void beginSpan(const char* name, Mode mode);
+    void endSpan();
+
+    static int enabled() {
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+        return s_enabled.loadRelaxed();
+#else
+        return s_enabled.load();
+#endif
+    }
+
+    static QAtomicInt s_enabled;
+
+    const char* m_name;
+    quint64 m_startTime;
+    quint32 m_id;
+    quint32 m_parent;
+    quint32 m_depth;
+    quint32 m_thread;
+    Mode m_mode;
+
+    friend class UMApplicationMonitorPrivate;
+};
+
+#endif  // SPAN_H
@@ -32,7 +32,9 @@ HEADERS += \
     $$PWD/exclusivegroup_p.h \
     $$PWD/filterbehavior_p.h \
     $$PWD/i18n_p.h \
+    $$PWD/indexranges_p.h \
     $$PWD/inversemouseareatype_p.h \
+    $$PWD/inversemousedispatcher_p.h \
     $$PWD/label_p.h \
     $$PWD/listener_p.h \
     $$PWD/livetimer_p.h \
@@ -50,8 +52,10 @@ HEADERS += \
     $$PWD/privates/listitemdraghandler_p.h \
     $$PWD/privates/listitemselection_p.h \
     $$PWD/privates/listviewextensions_p.h \
+    $$PWD/privates/pickerrangemodel_p.h \
     $$PWD/privates/splitviewhandler_p.h \
     $$PWD/privates/threelabelsslot_p.h \
+    $$PWD/privates/ucpagecache_p.h \
     $$PWD/privates/ucpagewrapper_p.h \
     $$PWD/privates/ucpagewrapper_p_p.h \
     $$PWD/privates/ucpagewrapperincubator_p.h \
@@ -95,6 +99,7 @@ HEADERS += \
     $$PWD/ucfontutils_p.h \
     $$PWD/uchaptics_p.h \
     $$PWD/ucheader_p.h \
+    $$PWD/ucicon_p.h \
     $$PWD/ucimportversionchecker_p.h \
     $$PWD/ucinversemouse_p.h \
     $$PWD/uclabel_p.h \
@@ -148,7 +153,9 @@ SOURCES += \
     $$PWD/exclusivegroup.cpp \
     $$PWD/filterbehavior.cpp \
     $$PWD/i18n.cpp \
+    $$PWD/indexranges.cpp \
     $$PWD/inversemouseareatype.cpp \
+    $$PWD/inversemousedispatcher.cpp \
     $$PWD/listener.cpp \
     $$PWD/livetimer.cpp \
     $$PWD/livetimer_p.cpp \
@@ -163,8 +170,10 @@ SOURCES += \
     $$PWD/privates/listitemexpansion.cpp \
     $$PWD/privates/listitemselection.cpp \
     $$PWD/privates/listviewextensions.cpp \
+    $$PWD/privates/pickerrangemodel.cpp \
     $$PWD/privates/splitviewhandler.cpp \
     $$PWD/privates/threelabelsslot_p.cpp \
+    $$PWD/privates/ucpagecache.cpp \
     $$PWD/privates/ucpagewrapper.cpp \
     $$PWD/privates/ucpagewrapperincubator.cpp \
     $$PWD/privates/ucscrollbarutils.cpp \
@@ -198,6 +207,7 @@ SOURCES += \
     $$PWD/ucfontutils.cpp \
     $$PWD/uchaptics.cpp \
     $$PWD/ucheader.cpp \
+    $$PWD/ucicon.cpp \
     $$PWD/ucimportversionchecker_p.cpp \
     $$PWD/uclabel.cpp \
     $$PWD/uclistitem.cpp \
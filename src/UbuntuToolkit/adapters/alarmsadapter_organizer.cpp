@@ -20,6 +20,7 @@
 
 #include <QtCore/QFile>
 #include <QtCore/QDir>
+#include <QtCore/QSaveFile>
 #include <QtCore/QTimeZone>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QJsonDocument>
@@ -32,6 +33,11 @@
 #include "ucalarm_p_p.h"
 
 static const QString alarmDatabase = QStringLiteral("%1/alarms.json");
+static const QString alarmJournal = QStringLiteral("%1/alarms.journal");
+
+// The journal is folded into the database when it grows bigger than this or
+// than the number of alarms, so that compacting costs O(1) per change.
+static const int journalCompactionThreshold = 256;
 
 // The main alarm manager engine used from Saucy onwards is EDS (Evolution Data
 // Server) based. Any previous release uses the generic "memory" manager engine
@@ -379,6 +385,19 @@ void AlarmDataAdapter::setData(const QOrganizerTodo &data)
 /*-----------------------------------------------------------------------------
  * Adaptation layer for Alarms.
  */
+// JSON data of an alarm, as stored by the fallback manager
+static QJsonObject alarmToJson(const UCAlarm *alarm)
+{
+    QJsonObject object;
+    object[QStringLiteral("message")] = alarm->message();
+    object[QStringLiteral("date")] = alarm->date().toString();
+    object[QStringLiteral("sound")] = alarm->sound().toString();
+    object[QStringLiteral("type")] = QJsonValue(alarm->type());
+    object[QStringLiteral("days")] = QJsonValue((int)alarm->daysOfWeek());
+    object[QStringLiteral("enabled")] = QJsonValue(alarm->enabled());
+    return object;
+}
+
 AlarmManagerPrivate * createAlarmsAdapter(AlarmManager *alarms)
 {
     return new AlarmsAdapter(alarms);
@@ -388,6 +407,8 @@ AlarmsAdapter::AlarmsAdapter(AlarmManager *qq)
     : QObject(qq)
     , AlarmManagerPrivate(qq)
     , manager(0)
+    , journalEntries(0)
+    , journalGeneration(0)
 {
     // register QOrganizerItemId comparators so QVariant == operator can compare them
     QMetaType::registerComparators<QOrganizerItemId>();
@@ -427,25 +448,38 @@ AlarmsAdapter::AlarmsAdapter(AlarmManager *qq)
 
 void AlarmsAdapter::alarmOperation(QList<QPair<QOrganizerItemId,QOrganizerManager::Operation> > list)
 {
+    const bool persistent = (manager->managerName() == alarmManagerFallback);
     typedef QPair<QOrganizerItemId,QOrganizerManager::Operation> OperationPair;
     Q_FOREACH(const OperationPair &op, list) {
         switch (op.second) {
-        case QOrganizerManager::Add: {
-            insertAlarm(op.first);
-            break;
-        }
+        case QOrganizerManager::Add:
         case QOrganizerManager::Change: {
-            updateAlarm(op.first);
+            int index = (op.second == QOrganizerManager::Add) ? insertAlarm(op.first) : updateAlarm(op.first);
+            if (persistent && index >= 0) {
+                const UCAlarm *alarm = alarmList[index];
+                QJsonObject entry = alarmToJson(alarm);
+                entry[QStringLiteral("id")] = alarm->cookie().value<QOrganizerItemId>().toString();
+                appendToJournal(entry);
+            }
             break;
         }
         case QOrganizerManager::Remove: {
-            removeAlarm(op.first);
-            // save alarm data
+            if (removeAlarm(op.first) && persistent) {
+                QJsonObject entry;
+                entry[QStringLiteral("id")] = op.first.toString();
+                entry[QStringLiteral("removed")] = true;
+                appendToJournal(entry);
+            }
             break;
         }
         }
     }
-    saveAlarms();
+    if (persistent && journal.isOpen()) {
+        journal.flush();
+        if (journalEntries > qMax(journalCompactionThreshold, alarmList.count())) {
+            saveAlarms();
+        }
+    }
 }
 
 void AlarmsAdapter::init()
@@ -469,24 +503,21 @@ UCAlarmPrivate * AlarmsAdapter::createAlarmData(UCAlarm *alarm)
     return new AlarmDataAdapter(alarm);
 }
 
-// load fallback manager data
-void AlarmsAdapter::loadAlarms()
+// converts alarm JSON data into organizer items; checked receives the data of
+// the items after the field checks
+QList<QOrganizerItem> AlarmsAdapter::alarmsFromJson(const QJsonArray &array, QJsonArray *checked)
 {
-    if (manager->managerName() != alarmManagerFallback) {
-        return;
-    }
-    QFile file(alarmDatabase.arg(QStandardPaths::writableLocation(QStandardPaths::DataLocation)));
-    if (!file.open(QFile::ReadOnly)) {
-        return;
-    }
-    QByteArray data = file.readAll();
-    QJsonDocument document(QJsonDocument::fromJson(data));
-    QJsonArray array = document.array();
+    QList<QOrganizerItem> items;
+    items.reserve(array.size());
+
+    // use a single UCAlarm to convert the JSON data
+    UCAlarm alarm;
+    AlarmDataAdapter *pAlarm = static_cast<AlarmDataAdapter*>(UCAlarmPrivate::get(&alarm));
     for (int i = 0; i < array.size(); i++) {
         QJsonObject object = array[i].toObject();
 
-        // use UCAlarm to save store JSON data
-        UCAlarm alarm;
+        pAlarm->reset();
+        pAlarm->setDefaults();
         alarm.setMessage(object[QStringLiteral("message")].toString());
         alarm.setDate(QDateTime::fromString(object[QStringLiteral("date")].toString()));
         alarm.setSound(object[QStringLiteral("sound")].toString());
@@ -495,46 +526,218 @@ void AlarmsAdapter::loadAlarms()
             static_cast<UCAlarm::DaysOfWeek>(object[QStringLiteral("days")].toInt()));
         alarm.setEnabled(object[QStringLiteral("enabled")].toBool());
 
-        AlarmDataAdapter *pAlarm = static_cast<AlarmDataAdapter*>(UCAlarmPrivate::get(&alarm));
         // call checkAlarm to complete field checks (i.e. type vs daysOfWeek, kick date, etc)
         pAlarm->checkAlarm();
-        QOrganizerTodo event = pAlarm->data();
-        manager->saveItem(&event);
+        items.append(pAlarm->data());
+        if (checked) {
+            checked->append(alarmToJson(&alarm));
+        }
     }
-    file.close();
+    return items;
 }
 
-// save fallback manager data only
-void AlarmsAdapter::saveAlarms()
+/*
+ * The fallback manager data is stored in a database holding all alarms as of
+ * the last compaction and in a journal, each line of it being the JSON data of
+ * an alarm saved or removed since then. Alarms are identified by their event
+ * id, which changes on every load, so the database is compacted on load.
+ * Each compaction increments the generation stored in the database and in the
+ * journal entries; entries of another generation are left over from a journal
+ * which couldn't be truncated after a compaction, and refer to stale ids, so
+ * they are skipped. Databases written as a plain array are of generation 0.
+ * readAlarms() returns the alarms stored in location, keyed by the event id
+ * they were stored with.
+ */
+QHash<QString, QJsonObject> AlarmsAdapter::readAlarms(const QString &location, int *generation)
+{
+    QHash<QString, QJsonObject> alarms;
+    int databaseGeneration = 0;
+
+    QFile file(alarmDatabase.arg(location));
+    if (file.open(QFile::ReadOnly)) {
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+        QJsonArray array;
+        if (document.isObject()) {
+            databaseGeneration = document.object()[QStringLiteral("generation")].toInt();
+            array = document.object()[QStringLiteral("alarms")].toArray();
+        } else {
+            array = document.array();
+        }
+        for (int i = 0; i < array.size(); i++) {
+            QJsonObject object = array[i].toObject();
+            // databases written before the journal existed have no ids
+            QString id = object.take(QStringLiteral("id")).toString();
+            alarms.insert(id.isEmpty() ? QString::number(i) : id, object);
+        }
+        file.close();
+    }
+
+    QFile journal(alarmJournal.arg(location));
+    if (journal.open(QFile::ReadOnly)) {
+        while (!journal.atEnd()) {
+            // skip entries which couldn't be completely written
+            QJsonObject entry = QJsonDocument::fromJson(journal.readLine()).object();
+            QString id = entry.take(QStringLiteral("id")).toString();
+            if (id.isEmpty()
+                || entry.take(QStringLiteral("generation")).toInt() != databaseGeneration) {
+                continue;
+            }
+            if (entry.contains(QStringLiteral("removed"))) {
+                alarms.remove(id);
+            } else {
+                alarms.insert(id, entry);
+            }
+        }
+        journal.close();
+    }
+    if (generation) {
+        *generation = databaseGeneration;
+    }
+    return alarms;
+}
+
+void AlarmsAdapter::loadAlarms()
 {
     if (manager->managerName() != alarmManagerFallback) {
         return;
     }
-    QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
-    if (!dir.exists()) {
-        dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+    const QString location = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+    QHash<QString, QJsonObject> alarms = readAlarms(location, &journalGeneration);
+
+    QJsonArray array;
+    Q_FOREACH(const QJsonObject &object, alarms) {
+        array.append(object);
+    }
+    QJsonArray checked;
+    QList<QOrganizerItem> items = alarmsFromJson(array, &checked);
+    if (!items.isEmpty()) {
+        manager->saveItems(&items);
+    }
+
+    // store the data with the ids of this session and start a new journal
+    QJsonArray data;
+    for (int i = 0; i < items.count(); i++) {
+        if (!items[i].id().isNull()) {
+            QJsonObject object = checked[i].toObject();
+            object[QStringLiteral("id")] = items[i].id().toString();
+            data.append(object);
+        }
     }
-    QFile file(alarmDatabase.arg(dir.path()));
-    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+    if (QFile::exists(alarmDatabase.arg(location)) || QFile::exists(alarmJournal.arg(location))) {
+        writeAlarms(data);
+    }
+}
+
+// compacts fallback manager data: stores all alarms and empties the journal;
+// if changedOnly is set, only when the alarms differ from the stored ones
+void AlarmsAdapter::saveAlarms(bool changedOnly)
+{
+    if (manager->managerName() != alarmManagerFallback) {
         return;
     }
     QJsonArray data;
+    QHash<QString, QJsonObject> alarms;
     for(int i = 0; i < alarmList.count(); i++) {
-        // create an UCAlarm and set its event to ease conversions
         const UCAlarm *alarm = alarmList[i];
-        QJsonObject object;
-        object[QStringLiteral("message")] = alarm->message();
-        object[QStringLiteral("date")] = alarm->date().toString();
-        object[QStringLiteral("sound")] = alarm->sound().toString();
-        object[QStringLiteral("type")] = QJsonValue(alarm->type());
-        object[QStringLiteral("days")] = QJsonValue((int)alarm->daysOfWeek());
-        object[QStringLiteral("enabled")] = QJsonValue(alarm->enabled());
+        QJsonObject object = alarmToJson(alarm);
+        const QString id = alarm->cookie().value<QOrganizerItemId>().toString();
+        alarms.insert(id, object);
+        object[QStringLiteral("id")] = id;
         data.append(object);
+    }
+    if (changedOnly && alarms == storedAlarms) {
+        return;
+    }
+    writeAlarms(data);
+}
+
+void AlarmsAdapter::writeAlarms(const QJsonArray &data)
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+    if (!dir.exists()) {
+        dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+    }
+    QSaveFile file(alarmDatabase.arg(dir.path()));
+    if (!file.open(QFile::WriteOnly)) {
+        return;
+    }
+    // the journal entries appended from now on belong to the new database
+    const int generation = journalGeneration + 1;
+    QJsonObject database;
+    database[QStringLiteral("generation")] = generation;
+    database[QStringLiteral("alarms")] = data;
+    file.write(QJsonDocument(database).toJson());
+    if (!file.commit()) {
+        return;
+    }
+    journalGeneration = generation;
+    storedAlarms.clear();
+    for (int i = 0; i < data.size(); i++) {
+        QJsonObject object = data[i].toObject();
+        const QString id = object.take(QStringLiteral("id")).toString();
+        storedAlarms.insert(id, object);
+    }
+
+    journal.close();
+    journal.setFileName(alarmJournal.arg(dir.path()));
+    if (journal.open(QFile::WriteOnly | QFile::Truncate)) {
+        journalEntries = 0;
+    }
+}
+
+// appends an entry to the fallback manager journal, one line per entry
+void AlarmsAdapter::appendToJournal(const QJsonObject &entry)
+{
+    if (!journal.isOpen()) {
+        QDir dir(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+        if (!dir.exists()) {
+            dir.mkpath(QStandardPaths::writableLocation(QStandardPaths::DataLocation));
+        }
+        journal.setFileName(alarmJournal.arg(dir.path()));
+        if (!journal.open(QFile::WriteOnly | QFile::Append)) {
+            return;
+        }
+    }
+    QJsonObject line = entry;
+    line[QStringLiteral("generation")] = journalGeneration;
+    journal.write(QJsonDocument(line).toJson(QJsonDocument::Compact));
+    journal.write("\n");
+    journalEntries++;
+
+    QJsonObject object = entry;
+    const QString id = object.take(QStringLiteral("id")).toString();
+    if (object.contains(QStringLiteral("removed"))) {
+        storedAlarms.remove(id);
+    } else {
+        storedAlarms.insert(id, object);
+    }
+}
+
+QJsonArray AlarmsAdapter::exportAlarms() const
+{
+    QJsonArray data;
+    for (int i = 0; i < alarmList.count(); i++) {
+        data.append(alarmToJson(alarmList[i]));
+    }
+    return data;
+}
 
+// the alarms are saved in one batch, the model gets updated when the manager
+// reports the changes
+int AlarmsAdapter::importAlarms(const QJsonArray &alarms)
+{
+    QList<QOrganizerItem> items = alarmsFromJson(alarms);
+    if (items.isEmpty()) {
+        return 0;
+    }
+    manager->saveItems(&items);
+    int count = 0;
+    Q_FOREACH(const QOrganizerItem &item, items) {
+        if (!item.id().isNull()) {
+            count++;
+        }
     }
-    QJsonDocument document(data);
-    file.write(document.toJson());
-    file.close();
+    return count;
 }
 
 /*-----------------------------------------------------------------------------
@@ -687,15 +890,16 @@ QOrganizerTodo AlarmsAdapter::todoItem(const QOrganizerItemId &id)
     return event;
 }
 
-void AlarmsAdapter::insertAlarm(const QOrganizerItemId &id)
+// inserts an alarm and returns its index, -1 if the alarm is not inserted
+int AlarmsAdapter::insertAlarm(const QOrganizerItemId &id)
 {
     QOrganizerTodo event = todoItem(id);
     if (event.isEmpty()) {
-        return;
+        return -1;
     }
     // if we have the alarm registered, leave
     if (alarmList.indexOf(event.id()) >= 0) {
-        return;
+        return -1;
     }
     // use UCAlarm to fix date
     UCAlarm alarm;
@@ -707,21 +911,22 @@ void AlarmsAdapter::insertAlarm(const QOrganizerItemId &id)
     int index = alarmList.insert(alarm);
     Q_EMIT q_ptr->alarmInsertStarted(index);
     Q_EMIT q_ptr->alarmInsertFinished();
+    return index;
 }
 
 // updates an alarm and returns the index, -1 on error
-void AlarmsAdapter::updateAlarm(const QOrganizerItemId &id)
+int AlarmsAdapter::updateAlarm(const QOrganizerItemId &id)
 {
     QOrganizerTodo event = todoItem(id);
     if (event.isEmpty()) {
-        return;
+        return -1;
     }
     // update alarm data
     int index = alarmList.indexOf(event.id());
     if (index < 0) {
         // it can be that the organizer item ID is not an alarm or it is an occurrence of
         // an organizer event
-        return;
+        return -1;
     }
     // use UCAlarm to ease conversions
     UCAlarm alarm;
@@ -735,24 +940,26 @@ void AlarmsAdapter::updateAlarm(const QOrganizerItemId &id)
         Q_EMIT q_ptr->alarmMoveStarted(index, newIndex);
         Q_EMIT q_ptr->alarmMoveFinished();
     }
+    return newIndex;
 }
 
-// removes an alarm from the list
-void AlarmsAdapter::removeAlarm(const QOrganizerItemId &id)
+// removes an alarm from the list, returns false if the alarm is not in the list
+bool AlarmsAdapter::removeAlarm(const QOrganizerItemId &id)
 {
     if (id.isNull()) {
-        return;
+        return false;
     }
     int index = alarmList.indexOf(id);
     if (index < 0) {
         // this may be an item we don't handle, organizer manager may report us
         // other calendar event removals as well.
-        return;
+        return false;
     }
     // emit removal start
     Q_EMIT q_ptr->alarmRemoveStarted(index);
     alarmList.removeAt(index);
     Q_EMIT q_ptr->alarmRemoveFinished();
+    return true;
 }
 
 void AlarmsAdapter::completeFetchAlarms()
@@ -787,6 +994,9 @@ void AlarmsAdapter::completeFetchAlarms()
         adjustAlarmOccurrence(*pAlarm);
         alarmList.insert(alarm);
     }
+    // the changes reported in bulk are not journaled, store the fetched list
+    // unless it is already
+    saveAlarms(true);
 
     completed = true;
     Q_EMIT q_ptr->alarmsRefreshed();
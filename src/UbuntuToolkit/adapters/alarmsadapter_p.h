@@ -19,6 +19,12 @@
 #ifndef ALARMSADAPTER_P_H
 #define ALARMSADAPTER_P_H
 
+#include <algorithm>
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QVector>
 #include <QtOrganizer/QOrganizerManager>
 #include <QtOrganizer/QOrganizerAbstractRequest>
 #include <QtOrganizer/QOrganizerItemFetchRequest>
@@ -85,7 +91,7 @@ protected:
     void startOperation(UCAlarm::Operation operation, const char *completionSlot);
 };
 
-// list of alarms
+// list of alarms, ordered by occurrence date + event id, ascending
 class AlarmList
 {
 public:
@@ -93,7 +99,9 @@ public:
 
     void clear()
     {
-        qDeleteAll(data);
+        for (int i = 0; i < data.count(); i++) {
+            delete data[i].alarm;
+        }
         data.clear();
         idHash.clear();
     }
@@ -103,8 +111,7 @@ public:
     }
     const UCAlarm *operator[](int index) const
     {
-        QPair<QDateTime, QOrganizerItemId> key = data.keys()[index];
-        return data.value(key);
+        return data[index].alarm;
     }
     // update event at index, returns the new event index
     int update(int index, const UCAlarm &alarm)
@@ -115,29 +122,25 @@ public:
         AlarmDataAdapter *pAlarm = static_cast<AlarmDataAdapter*>(AlarmDataAdapter::get(oldAlarm));
         pAlarm->copyAlarmData(alarm);
         // and insert it back
-        QDateTime dt = oldAlarm->date();
-        QOrganizerItemId id = oldAlarm->cookie().value<QOrganizerItemId>();
-        idHash.insert(id, dt);
-        data.insert(QPair<QDateTime, QOrganizerItemId>(dt, id), oldAlarm);
-        return indexOf(id);
+        return insertSorted(oldAlarm);
     }
     // insert an alarm event into the list
     int insert(const UCAlarm &alarm)
     {
-        QDateTime dt = alarm.date();
-        QOrganizerItemId id = alarm.cookie().value<QOrganizerItemId>();
-        idHash.insert(id, dt);
         UCAlarm *newAlarm = new UCAlarm;
         UCAlarmPrivate::get(newAlarm)->copyAlarmData(alarm);
-        data.insert(QPair<QDateTime, QOrganizerItemId>(dt, id), newAlarm);
-        return indexOf(id);
+        return insertSorted(newAlarm);
     }
     // returns the index of the alarm matching the id, -1 on error
-    int indexOf(const QOrganizerItemId &id)
+    int indexOf(const QOrganizerItemId &id) const
     {
-        QDateTime dt = idHash.value(id);
-        QPair<QDateTime, QOrganizerItemId> key(dt, id);
-        return data.keys().indexOf(key);
+        QHash<QOrganizerItemId, QDateTime>::const_iterator i = idHash.constFind(id);
+        if (i == idHash.constEnd()) {
+            return -1;
+        }
+        const Key key(i.value(), id);
+        QVector<Entry>::const_iterator entry = std::lower_bound(data.constBegin(), data.constEnd(), key, keyLessThan);
+        return (entry != data.constEnd() && entry->key == key) ? entry - data.constBegin() : -1;
     }
     // remove alarm at index
     void removeAt(int index)
@@ -147,19 +150,45 @@ public:
     }
 
 protected:
+    typedef QPair<QDateTime, QOrganizerItemId> Key;
+    struct Entry {
+        Key key;
+        UCAlarm *alarm;
+    };
+
+    static bool keyLessThan(const Entry &entry, const Key &key)
+    {
+        return entry.key < key;
+    }
+    static bool entryLessThan(const Key &key, const Entry &entry)
+    {
+        return key < entry.key;
+    }
+
+    // inserts the alarm after the alarms with the same key, returns its index
+    int insertSorted(UCAlarm *alarm)
+    {
+        Entry entry;
+        entry.key = Key(alarm->date(), alarm->cookie().value<QOrganizerItemId>());
+        entry.alarm = alarm;
+        idHash.insert(entry.key.second, entry.key.first);
+        QVector<Entry>::iterator i = std::upper_bound(data.begin(), data.end(), entry.key, entryLessThan);
+        int index = i - data.begin();
+        data.insert(index, entry);
+        return index;
+    }
     // removes alarm data at index and returns the alarm pointer
     UCAlarm *takeAt(int index)
     {
-        QPair<QDateTime, QOrganizerItemId> key = data.keys()[index];
-        UCAlarm *alarm = data.take(key);
-        idHash.remove(key.second);
-        return alarm;
+        Entry entry = data.takeAt(index);
+        idHash.remove(entry.key.second);
+        return entry.alarm;
     }
 
 private:
-    // ordered map by occurrence date + event id, ascending
-    QMap< QPair<QDateTime, QOrganizerItemId>, UCAlarm*> data;
-    // alarms ordered based on even id
+    // alarms sorted by key, looked up with a binary search
+    QVector<Entry> data;
+    // occurrence date of the alarms, hashed on event id
     QHash<QOrganizerItemId, QDateTime> idHash;
 };
 
@@ -190,15 +219,20 @@ public:
     bool findAlarm(const UCAlarm &alarm, const QVariant &cookie) const override;
     void adjustAlarmOccurrence(AlarmDataAdapter &alarm);
 
+    static QHash<QString, QJsonObject> readAlarms(const QString &location, int *generation = 0);
     void loadAlarms();
-    void saveAlarms();
+    void saveAlarms(bool changedOnly = false);
+    void writeAlarms(const QJsonArray &data);
+    void appendToJournal(const QJsonObject &entry);
+    QJsonArray exportAlarms() const override;
+    int importAlarms(const QJsonArray &alarms) override;
 
     bool verifyChange(UCAlarm *alarm, AlarmManager::Change change, const QVariant &value) override;
     UCAlarmPrivate *createAlarmData(UCAlarm *alarm) override;
 
-    void insertAlarm(const QOrganizerItemId &id);
-    void updateAlarm(const QOrganizerItemId &id);
-    void removeAlarm(const QOrganizerItemId &id);
+    int insertAlarm(const QOrganizerItemId &id);
+    int updateAlarm(const QOrganizerItemId &id);
+    bool removeAlarm(const QOrganizerItemId &id);
 
 private Q_SLOTS:
     void completeFetchAlarms();
@@ -208,7 +242,15 @@ private Q_SLOTS:
 protected:
     QPointer<QOrganizerItemFetchRequest> fetchRequest;
     AlarmList alarmList;
+    // fallback manager changes since the last snapshot
+    QFile journal;
+    int journalEntries;
+    // compaction count of the stored data, written with each journal entry
+    int journalGeneration;
+    // fallback manager data as stored, keyed by event id
+    QHash<QString, QJsonObject> storedAlarms;
     QOrganizerTodo todoItem(const QOrganizerItemId &id);
+    QList<QOrganizerItem> alarmsFromJson(const QJsonArray &array, QJsonArray *checked = 0);
 };
 
 UT_NAMESPACE_END
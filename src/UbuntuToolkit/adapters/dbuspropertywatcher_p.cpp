@@ -19,16 +19,155 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <QtCore/QHash>
+#include <QtDBus/QDBusPendingCallWatcher>
 #include <QtDBus/QDBusReply>
 #include <QtQml/QQmlInfo>
 
 #include "i18n_p.h"
 
-static const char dynamicProperty[] = "__q_property";
 static const QString dbusInterface = QStringLiteral("org.freedesktop.DBus.Properties");
 
 UT_NAMESPACE_BEGIN
 
+typedef QHash<QString, QWeakPointer<QDBusInterface> > InterfaceCache;
+Q_GLOBAL_STATIC(InterfaceCache, interfaceCache)
+typedef QHash<QString, QWeakPointer<DBusObjectProperties> > ObjectPropertiesCache;
+Q_GLOBAL_STATIC(ObjectPropertiesCache, objectPropertiesCache)
+
+static QString cacheKey(const QDBusConnection &connection, const QString &service,
+                        const QString &path, const QString &interface)
+{
+    return QStringList({connection.name(), service, path, interface}).join(QLatin1Char('\n'));
+}
+
+/*-----------------------------------------------------------------------------
+ * Property values shared among the watchers of an object.
+ */
+DBusObjectProperties::DBusObjectProperties(const QDBusConnection &connection, const QString &service,
+                                           const QString &path, const QString &adaptor, const QString &key)
+    : connection(connection)
+    , service(service)
+    , path(path)
+    , adaptor(adaptor)
+    , key(key)
+    , fetched(false)
+    , refetch(false)
+    , ownerKnown(false)
+{
+    this->connection.connect(service, path, dbusInterface, QStringLiteral("PropertiesChanged"),
+                             this, SLOT(updateProperties(QString,QVariantMap,QStringList)));
+}
+
+DBusObjectProperties::~DBusObjectProperties()
+{
+    connection.disconnect(service, path, dbusInterface, QStringLiteral("PropertiesChanged"),
+                          this, SLOT(updateProperties(QString,QVariantMap,QStringList)));
+    // the entry may already refer to a new instance
+    if (objectPropertiesCache()->value(key).isNull()) {
+        objectPropertiesCache()->remove(key);
+    }
+}
+
+QSharedPointer<DBusObjectProperties> DBusObjectProperties::get(const QDBusConnection &connection, const QString &service,
+                                                               const QString &path, const QString &adaptor)
+{
+    const QString key = cacheKey(connection, service, path, adaptor);
+    QSharedPointer<DBusObjectProperties> object = objectPropertiesCache()->value(key).toStrongRef();
+    if (!object) {
+        // watchers may release the object while handling its signals
+        object = QSharedPointer<DBusObjectProperties>(
+            new DBusObjectProperties(connection, service, path, adaptor, key), &QObject::deleteLater);
+        objectPropertiesCache()->insert(key, object);
+    }
+    return object;
+}
+
+QSharedPointer<QDBusInterface> DBusObjectProperties::interface(const QDBusConnection &connection, const QString &service,
+                                                               const QString &path, const QString &interface)
+{
+    const QString key = cacheKey(connection, service, path, interface);
+    QSharedPointer<QDBusInterface> iface = interfaceCache()->value(key).toStrongRef();
+    if (!iface) {
+        iface.reset(new QDBusInterface(service, path, interface, connection));
+        // the service may show up later, do not keep invalid proxies
+        if (iface->isValid()) {
+            interfaceCache()->insert(key, iface);
+        } else {
+            interfaceCache()->remove(key);
+        }
+    }
+    return iface;
+}
+
+void DBusObjectProperties::fetch()
+{
+    if (pendingFetch) {
+        // the values may have changed since the ongoing call was issued
+        refetch = true;
+        return;
+    }
+    QDBusMessage message = QDBusMessage::createMethodCall(service, path, dbusInterface, QStringLiteral("GetAll"));
+    message << adaptor;
+    pendingFetch = new QDBusPendingCallWatcher(connection.asyncCall(message), this);
+    QObject::connect(pendingFetch.data(), &QDBusPendingCallWatcher::finished,
+                     this, &DBusObjectProperties::completeFetch);
+}
+
+void DBusObjectProperties::changeOwner(const QString &newOwner)
+{
+    if (ownerKnown && newOwner == owner) {
+        // already handled for another watcher
+        return;
+    }
+    ownerKnown = true;
+    owner = newOwner;
+    fetched = false;
+    if (!owner.isEmpty()) {
+        fetch();
+    }
+}
+
+void DBusObjectProperties::completeFetch(QDBusPendingCallWatcher *call)
+{
+    QDBusPendingReply<QVariantMap> reply = *call;
+    call->deleteLater();
+    QString error;
+    if (reply.isError()) {
+        error = reply.error().message();
+    } else {
+        propertyValues = reply.value();
+        fetched = true;
+    }
+    if (refetch) {
+        refetch = false;
+        fetch();
+    }
+    Q_EMIT fetchFinished(error);
+}
+
+/*
+ * Slot called when the properties are changed in the service.
+ */
+void DBusObjectProperties::updateProperties(const QString &iface, const QVariantMap &changed, const QStringList &invalidated)
+{
+    if (iface != adaptor) {
+        return;
+    }
+    if (!changed.isEmpty()) {
+        for (QVariantMap::const_iterator i = changed.constBegin(); i != changed.constEnd(); ++i) {
+            propertyValues.insert(i.key(), i.value());
+        }
+        Q_EMIT propertiesChanged(changed);
+    }
+    if (!invalidated.isEmpty()) {
+        fetch();
+    }
+}
+
+/*-----------------------------------------------------------------------------
+ * Adaptation layer for ServiceProperties.
+ */
 UCServicePropertiesPrivate *createServicePropertiesAdapter(UCServiceProperties *owner)
 {
     return new DBusServiceProperties(owner);
@@ -38,7 +177,6 @@ DBusServiceProperties::DBusServiceProperties(UCServiceProperties *qq)
     : UCServicePropertiesPrivate(qq)
     , connection(QStringLiteral(""))
     , watcher(0)
-    , iface(0)
 {
 }
 
@@ -46,8 +184,11 @@ bool DBusServiceProperties::init()
 {
     // crear previous connections
     setStatus(UCServiceProperties::Inactive);
-    delete iface;
-    iface = 0;
+    if (object) {
+        QObject::disconnect(object.data(), 0, this, 0);
+        object.clear();
+    }
+    iface.clear();
     delete watcher;
     watcher = 0;
     setError(QString());
@@ -81,7 +222,7 @@ bool DBusServiceProperties::init()
     // connect dbus watcher to catch OwnerChanged
     watcher = new QDBusServiceWatcher(service, connection, QDBusServiceWatcher::WatchForOwnerChange, q);
     // connect interface
-    iface = new QDBusInterface(service, path, interface, connection, q);
+    iface = DBusObjectProperties::interface(connection, service, path, interface);
     if (!iface->isValid()) {
         setStatus(UCServiceProperties::ConnectionError);
         setError(iface->lastError().message());
@@ -94,8 +235,8 @@ bool DBusServiceProperties::init()
 }
 
 /*
- * Connect dbus signal identified by (service, path, iface, name) quaduple to a
- * slot to receive property changes.
+ * Looks up the user object and attaches to the values shared by the watchers
+ * of the same (service, path, adaptor) triplet.
  */
 bool DBusServiceProperties::setupInterface()
 {
@@ -103,13 +244,18 @@ bool DBusServiceProperties::setupInterface()
         iface->call(QStringLiteral("FindUserById"), qlonglong(getuid()));
     if (dbusObjectPath.isValid()) {
         objectPath = dbusObjectPath.value().path();
-        iface->connection().connect(
-            service,
-            objectPath,
-            dbusInterface,
-            QStringLiteral("PropertiesChanged"),
-            this,
-            SLOT(updateProperties(QString,QVariantMap,QStringList)));
+        QSharedPointer<DBusObjectProperties> userObject =
+            DBusObjectProperties::get(connection, service, objectPath, adaptor);
+        if (userObject != object) {
+            if (object) {
+                QObject::disconnect(object.data(), 0, this, 0);
+            }
+            object = userObject;
+            QObject::connect(object.data(), &DBusObjectProperties::fetchFinished,
+                             this, &DBusServiceProperties::completeFetch);
+            QObject::connect(object.data(), &DBusObjectProperties::propertiesChanged,
+                             this, &DBusServiceProperties::changeProperties);
+        }
         return true;
     }
 
@@ -120,41 +266,29 @@ bool DBusServiceProperties::setupInterface()
 
 bool DBusServiceProperties::fetchPropertyValues()
 {
-    scannedProperties = properties;
-    Q_FOREACH(QString property, properties) {
-        readProperty(property);
+    if (!object) {
+        return false;
+    }
+    if (object->isFetched()) {
+        // some other watcher already got the values
+        completeFetch(QString());
+    } else {
+        object->fetch();
     }
     return true;
 }
 
 /*
- * Reads a property value from the adaptorInterface asynchronously.
+ * Reads the property values from the adaptor interface asynchronously. All
+ * values are read in a single call.
  */
 bool DBusServiceProperties::readProperty(const QString &property)
 {
-    if ((status < UCServiceProperties::Synchronizing) || objectPath.isEmpty()) {
+    Q_UNUSED(property);
+    if ((status < UCServiceProperties::Synchronizing) || !object) {
         return false;
     }
-    Q_Q(UCServiceProperties);
-    QDBusInterface readIFace(iface->interface(), objectPath, dbusInterface, connection);
-    if (!readIFace.isValid()) {
-        // report invalid interface only if the property's first letter was with capital one!
-        if (property[0].isUpper()) {
-            warning(readIFace.lastError().message());
-        }
-        return false;
-    }
-    QDBusPendingCall pending = readIFace.asyncCall(QStringLiteral("Get"), adaptor, property);
-    if (pending.isError()) {
-        warning(pending.error().message());
-        return false;
-    }
-    QDBusPendingCallWatcher *callWatcher = new QDBusPendingCallWatcher(pending, q);
-    QObject::connect(callWatcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
-                     this, SLOT(readFinished(QDBusPendingCallWatcher*)));
-
-    // set a dynamic property so we know which property are we reading
-    callWatcher->setProperty(dynamicProperty, property);
+    object->fetch();
     return true;
 }
 
@@ -166,46 +300,58 @@ bool DBusServiceProperties::testProperty(const QString &property, const QVariant
     if (objectPath.isEmpty()) {
         return false;
     }
-    QDBusInterface writeIFace(iface->interface(), objectPath, dbusInterface, connection);
-    if (!writeIFace.isValid()) {
-        // invalid interface
-        return false;
-    }
-    QDBusMessage msg = writeIFace.call(
-        QStringLiteral("Set"), adaptor, property, QVariant::fromValue(QDBusVariant(value)));
+    QDBusMessage message = QDBusMessage::createMethodCall(service, objectPath, dbusInterface, QStringLiteral("Set"));
+    message << adaptor << property << QVariant::fromValue(QDBusVariant(value));
+    QDBusMessage msg = connection.call(message);
     return msg.type() == QDBusMessage::ReplyMessage;
 }
 
 /*
- * Slot called when the async read operation finishes.
+ * Updates the watched properties. Properties missing from the values are
+ * removed from being watched when reportMissing is set.
  */
-void DBusServiceProperties::readFinished(QDBusPendingCallWatcher *call)
+void DBusServiceProperties::updateValues(const QVariantMap &values, bool reportMissing)
 {
     Q_Q(UCServiceProperties);
-    QDBusPendingReply<QVariant> reply = *call;
-    QString property = call->property(dynamicProperty).toString();
-    scannedProperties.removeAll(property);
-    if (reply.isError()) {
-        // remove the property from being watched, as it has no property like that
-        properties.removeAll(property);
-        if (property[0].isUpper()) {
-            // report error!
-            warning(reply.error().message());
+    Q_FOREACH(QString property, properties) {
+        QVariantMap::const_iterator value = values.constFind(property);
+        if (value != values.constEnd()) {
+            // make sure we have lower case when the property value is updated
+            property[0] = property[0].toLower();
+            q->setProperty(property.toLocal8Bit().constData(), value.value());
+        } else if (reportMissing) {
+            properties.removeAll(property);
+            // report invalid property only if the property's first letter was with capital one!
+            if (property[0].isUpper()) {
+                warning(QStringLiteral("No such property '%1'").arg(property));
+            }
         }
+    }
+}
+
+/*
+ * Slot called when the shared values are fetched.
+ */
+void DBusServiceProperties::completeFetch(const QString &error)
+{
+    if (!error.isEmpty()) {
+        warning(error);
     } else {
-        // update watched property value
-        // make sure we have lower case when the property value is updated
-        property[0] = property[0].toLower();
-        q->setProperty(property.toLocal8Bit().constData(), reply.value());
+        updateValues(object->values(), status == UCServiceProperties::Synchronizing);
     }
 
-    if ((status == UCServiceProperties::Synchronizing) && scannedProperties.isEmpty()) {
+    if (status == UCServiceProperties::Synchronizing) {
         // set status to active
         setStatus(UCServiceProperties::Active);
     }
+}
 
-    // delete watcher
-    call->deleteLater();
+/*
+ * Slot called when the service reports changed property values.
+ */
+void DBusServiceProperties::changeProperties(const QVariantMap &changed)
+{
+    updateValues(changed, false);
 }
 
 /*
@@ -214,22 +360,13 @@ void DBusServiceProperties::readFinished(QDBusPendingCallWatcher *call)
 void DBusServiceProperties::changeServiceOwner(const QString &serviceName, const QString &oldOwner, const QString &newOwner)
 {
     Q_UNUSED(oldOwner);
-    Q_UNUSED(newOwner);
     if (serviceName != service) {
         return;
     }
     setupInterface();
-}
-
-/*
- * Slot called when the properties are changed in the service.
- */
-void DBusServiceProperties::updateProperties(const QString &onInterface, const QVariantMap &map, const QStringList &invalidated)
-{
-    Q_UNUSED(onInterface);
-    Q_UNUSED(map);
-    Q_FOREACH(const QString &property, invalidated) {
-        readProperty(property);
+    if (object) {
+        // the values fetched so far are the ones of the previous owner
+        object->changeOwner(newOwner);
     }
 }
 
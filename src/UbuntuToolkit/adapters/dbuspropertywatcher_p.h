@@ -18,6 +18,8 @@
 #define DBUSPROPERTYWATCHER_P_H
 
 #include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
 #include <QtDBus/QDBusConnection>
 #include <QtDBus/QDBusServiceWatcher>
 #include <QtDBus/QDBusInterface>
@@ -28,6 +30,62 @@ class QDBusPendingCallWatcher;
 
 UT_NAMESPACE_BEGIN
 
+/*
+ * Property values of a DBus object interface, shared by all ServiceProperties
+ * watching the same object. Values are fetched with a single GetAll call and
+ * kept up to date through one PropertiesChanged subscription.
+ */
+class DBusObjectProperties : public QObject
+{
+    Q_OBJECT
+public:
+    ~DBusObjectProperties();
+
+    static QSharedPointer<DBusObjectProperties> get(const QDBusConnection &connection, const QString &service,
+                                                    const QString &path, const QString &adaptor);
+    // process-wide cache of interface proxies, creating one introspects the service
+    static QSharedPointer<QDBusInterface> interface(const QDBusConnection &connection, const QString &service,
+                                                    const QString &path, const QString &interface);
+
+    bool isFetched() const
+    {
+        return fetched;
+    }
+    const QVariantMap &values() const
+    {
+        return propertyValues;
+    }
+    // starts a GetAll call unless there is one already ongoing
+    void fetch();
+    // drops the values of the previous owner of the service and fetches the
+    // ones of the new owner, once for all the watchers
+    void changeOwner(const QString &newOwner);
+
+Q_SIGNALS:
+    void fetchFinished(const QString &error);
+    void propertiesChanged(const QVariantMap &changed);
+
+private Q_SLOTS:
+    void completeFetch(QDBusPendingCallWatcher *call);
+    void updateProperties(const QString &iface, const QVariantMap &changed, const QStringList &invalidated);
+
+private:
+    DBusObjectProperties(const QDBusConnection &connection, const QString &service,
+                         const QString &path, const QString &adaptor, const QString &key);
+
+    QDBusConnection connection;
+    QString service;
+    QString path;
+    QString adaptor;
+    QString key;
+    QString owner;
+    QVariantMap propertyValues;
+    QPointer<QDBusPendingCallWatcher> pendingFetch;
+    bool fetched:1;
+    bool refetch:1;
+    bool ownerKnown:1;
+};
+
 class DBusServiceProperties : public QObject, public UCServicePropertiesPrivate
 {
     Q_OBJECT
@@ -41,18 +99,19 @@ public:
     // for testing purposes only!!!
     bool testProperty(const QString &property, const QVariant &value) override;
 
-    QStringList scannedProperties;
     QDBusConnection connection;
     QDBusServiceWatcher *watcher;
-    QDBusInterface *iface;
+    QSharedPointer<QDBusInterface> iface;
+    QSharedPointer<DBusObjectProperties> object;
     QString objectPath;
 
     bool setupInterface();
+    void updateValues(const QVariantMap &values, bool reportMissing);
 
 public Q_SLOTS:
-    void readFinished(QDBusPendingCallWatcher *watcher);
+    void completeFetch(const QString &error);
+    void changeProperties(const QVariantMap &changed);
     void changeServiceOwner(const QString &serviceName, const QString &oldOwner, const QString &newOwner);
-    void updateProperties(const QString &iface, const QVariantMap &map, const QStringList &invalidated);
 };
 
 UT_NAMESPACE_END
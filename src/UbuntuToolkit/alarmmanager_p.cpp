@@ -79,6 +79,19 @@ UCAlarm *AlarmManager::findAlarm(const QVariant &cookie) const
     return &alarm;
 }
 
+// returns the data of all alarms, in the format importAlarms() takes
+QJsonArray AlarmManager::exportAlarms() const
+{
+    return d_ptr->exportAlarms();
+}
+
+// saves the alarms in a single batch, returns the number of alarms saved; each
+// alarm is an object with message, date, sound, type, days and enabled fields
+int AlarmManager::importAlarms(const QJsonArray &alarms)
+{
+    return d_ptr->importAlarms(alarms);
+}
+
 bool AlarmManager::verifyChange(UCAlarm *alarm, Change change, const QVariant &newData)
 {
     return d_ptr->verifyChange(alarm, change, newData);
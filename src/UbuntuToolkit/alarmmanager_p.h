@@ -19,6 +19,7 @@
 #ifndef ALARMMANAGER_P_H
 #define ALARMMANAGER_P_H
 
+#include <QtCore/QJsonArray>
 #include <QtCore/QObject>
 #include <QtCore/QSet>
 #include <QtQml/QQmlListProperty>
@@ -102,6 +103,8 @@ public:
     int alarmCount();
     UCAlarm *alarmAt(int index);
     UCAlarm *findAlarm(const QVariant &cookie) const;
+    QJsonArray exportAlarms() const;
+    int importAlarms(const QJsonArray &alarms);
 
     bool verifyChange(UCAlarm *alarm, Change change, const QVariant &newData);
     static UCAlarmPrivate *createAlarmData(UCAlarm *alarm);
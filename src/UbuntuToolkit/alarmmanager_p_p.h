@@ -21,6 +21,7 @@
 
 #include <UbuntuToolkit/private/alarmmanager_p.h>
 
+#include <QtCore/QJsonArray>
 #include <QtCore/QUrl>
 
 #include <UbuntuToolkit/private/ucalarm_p.h>
@@ -50,6 +51,8 @@ public:
     virtual int alarmCount() = 0;
     virtual UCAlarm *getAlarmAt(int index) const = 0;
     virtual bool findAlarm(const UCAlarm &alarm, const QVariant &cookie) const = 0;
+    virtual QJsonArray exportAlarms() const = 0;
+    virtual int importAlarms(const QJsonArray &alarms) = 0;
 
     // function to verify whether the given alarm property has a given value set
     // used for testing purposes
@@ -62,6 +62,7 @@ void AsyncLoaderPrivate::statusChanged(Status status)
         }
     }
     if (status != QQmlIncubator::Loading) {
+        incubationSpan.end();
         detachComponent();
     }
     // we should emit the status change only after we do the cleanup
@@ -110,6 +111,7 @@ void AsyncLoaderPrivate::onComponentStatusChanged(QQmlComponent::Status status)
         return;
     }
     if (status == QQmlComponent::Ready) {
+        incubationSpan.begin("AsyncLoader.incubate", UMSpan::Detached);
         component->create(*this, context);
     }
 }
@@ -163,13 +165,14 @@ bool AsyncLoader::load(QQmlComponent *component, QQmlContext *context)
     d->component = component;
     d->context = context;
     if (d->component->isLoading()) {
-        d->emitStatus(Compiling);
         auto callback = [d] (QQmlComponent::Status status) {
             d->onComponentStatusChanged(status);
         };
 
         d->componentHandler.reset(new QMetaObject::Connection);
         *(d->componentHandler) = QObject::connect(d->component, &QQmlComponent::statusChanged, callback);
+        // connected first, listeners may reset the loader on this status
+        d->emitStatus(Compiling);
     } else {
         d->onComponentStatusChanged(d->component->status());
     }
@@ -180,20 +183,25 @@ bool AsyncLoader::load(QQmlComponent *component, QQmlContext *context)
  * \brief AsyncLoader::reset
  * \return bool
  * Clears the incubator and emits loadingStatus() signal with \c Reset status.
- * The loader can be reset only if the status passed \c Loading. Returns true
- * if the reset was successful, or when the loader status is \c Ready or
+ * A loading still waiting for its component to be compiled is aborted. Returns
+ * true if the reset was successful, or when the loader status is \c Ready or
  * \c Error.
  */
 bool AsyncLoader::reset()
 {
     Q_D(AsyncLoader);
-    if (d->status < Loading) {
+    if (d->status == Null) {
         return false;
     }
     if (d->status >= Ready) {
         return true;
     }
-    d->clear();
+    if (d->status == Compiling) {
+        // nothing is incubated yet, only stop waiting for the component
+        d->detachComponent();
+    } else {
+        d->clear();
+    }
     // make sure the listeners are getting the reset so they can delete the object
     d->emitStatus(Reset);
     return true;
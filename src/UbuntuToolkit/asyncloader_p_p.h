@@ -23,6 +23,7 @@
 
 #include <QtCore/private/qobject_p.h>
 #include <QtQml/QQmlIncubator>
+#include <UbuntuMetrics/span.h>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
 
@@ -40,6 +41,8 @@ public:
     QSharedPointer<QMetaObject::Connection> componentHandler;
     QQmlComponent *component = nullptr;
     QQmlContext *context = nullptr;
+    // from the creation request till the incubation completion
+    UMSpan incubationSpan;
     AsyncLoader::LoadingStatus status = AsyncLoader::Ready;
     bool ownComponent = false;
 
@@ -31,6 +31,11 @@ namespace C {
 #include "timeutils_p.h"
 
 UT_NAMESPACE_BEGIN
+
+// Translations are looked up from bindings, usually the same few hundreds
+// strings over and over when scrolling lists.
+static const int maxCachedTranslations = 2048;
+
 /*!
  * \qmltype i18n
  * \inqmlmodule Ubuntu.Components
@@ -57,7 +62,9 @@ UT_NAMESPACE_BEGIN
  */
 UbuntuI18n *UbuntuI18n::m_i18 = nullptr;
 
-UbuntuI18n::UbuntuI18n(QObject* parent) : QObject(parent)
+UbuntuI18n::UbuntuI18n(QObject* parent)
+    : QObject(parent)
+    , m_translations(maxCachedTranslations)
 {
     /*
      * setlocale
@@ -105,6 +112,7 @@ QString UbuntuI18n::language() const {
  */
 void UbuntuI18n::bindtextdomain(const QString& domain_name, const QString& dir_name) {
     C::bindtextdomain(domain_name.toUtf8(), dir_name.toUtf8());
+    flushTranslations();
     Q_EMIT domainChanged();
 }
 
@@ -125,6 +133,7 @@ void UbuntuI18n::setDomain(const QString &domain) {
     }
     QString localePath(QDir(appDir).filePath(QStringLiteral("share/locale")));
     C::bindtextdomain(domain.toUtf8(), localePath.toUtf8());
+    flushTranslations();
     Q_EMIT domainChanged();
 }
 
@@ -153,16 +162,53 @@ void UbuntuI18n::setLanguage(const QString &lang) {
      a valid locale string updates all category type defaults.
      */
     setlocale(LC_ALL, lang.toUtf8());
+    flushTranslations();
     Q_EMIT languageChanged();
 }
 
+/*
+ * Returns the translation of the key, looking it up with gettext only the first
+ * time. The catalogs can only change through bindtextdomain(), setDomain() and
+ * setLanguage() which flush the cache.
+ */
+QString UbuntuI18n::cachedTranslation(const TranslationKey &key)
+{
+    const QString *cached = m_translations.object(key);
+    if (cached) {
+        return *cached;
+    }
+
+    const QByteArray domain = key.domain.toUtf8();
+    const QByteArray msgid = key.msgid.toUtf8();
+    const char *domainName = (key.flags & TranslationKey::Domain) ? domain.constData() : NULL;
+    const char *translation;
+    if (key.flags & TranslationKey::Context) {
+        translation = C::g_dpgettext2(domainName, key.context.toUtf8(), msgid);
+    } else if (key.flags & TranslationKey::Plural) {
+        translation = C::dngettext(domainName, msgid, key.plural.toUtf8(), key.n);
+    } else {
+        translation = C::dgettext(domainName, msgid);
+    }
+
+    // gettext returns the message id itself when there's no translation, share
+    // the string instead of converting it back
+    const QString result = (translation == msgid.constData()) ? key.msgid : QString::fromUtf8(translation);
+    m_translations.insert(key, new QString(result));
+    return result;
+}
+
+void UbuntuI18n::flushTranslations()
+{
+    m_translations.clear();
+}
+
 /*!
  * \qmlmethod string i18n::tr(string text)
  * Translate \a text using gettext and return the translation.
  */
 QString UbuntuI18n::tr(const QString& text)
 {
-    return QString::fromUtf8(C::gettext(text.toUtf8()));
+    return cachedTranslation(TranslationKey(text));
 }
 
 /*!
@@ -175,7 +221,11 @@ QString UbuntuI18n::tr(const QString& text)
  */
 QString UbuntuI18n::tr(const QString &singular, const QString &plural, int n)
 {
-    return QString::fromUtf8(C::ngettext(singular.toUtf8(), plural.toUtf8(), n));
+    TranslationKey key(singular);
+    key.plural = plural;
+    key.n = n;
+    key.flags = TranslationKey::Plural;
+    return cachedTranslation(key);
 }
 
 /*!
@@ -184,11 +234,12 @@ QString UbuntuI18n::tr(const QString &singular, const QString &plural, int n)
  */
 QString UbuntuI18n::dtr(const QString& domain, const QString& text)
 {
-    if (domain.isNull()) {
-        return QString::fromUtf8(C::dgettext(NULL, text.toUtf8()));
-    } else {
-        return QString::fromUtf8(C::dgettext(domain.toUtf8(), text.toUtf8()));
+    TranslationKey key(text);
+    if (!domain.isNull()) {
+        key.domain = domain;
+        key.flags = TranslationKey::Domain;
     }
+    return cachedTranslation(key);
 }
 
 /*!
@@ -200,11 +251,15 @@ QString UbuntuI18n::dtr(const QString& domain, const QString& text)
  */
 QString UbuntuI18n::dtr(const QString& domain, const QString& singular, const QString& plural, int n)
 {
-    if (domain.isNull()) {
-        return QString::fromUtf8(C::dngettext(NULL, singular.toUtf8(), plural.toUtf8(), n));
-    } else {
-        return QString::fromUtf8(C::dngettext(domain.toUtf8(), singular.toUtf8(), plural.toUtf8(), n));
+    TranslationKey key(singular);
+    key.plural = plural;
+    key.n = n;
+    key.flags = TranslationKey::Plural;
+    if (!domain.isNull()) {
+        key.domain = domain;
+        key.flags |= TranslationKey::Domain;
     }
+    return cachedTranslation(key);
 }
 
 /*!
@@ -224,11 +279,14 @@ QString UbuntuI18n::ctr(const QString& context, const QString& text)
  */
 QString UbuntuI18n::dctr(const QString& domain, const QString& context, const QString& text)
 {
-    if (domain.isNull()) {
-        return QString::fromUtf8(C::g_dpgettext2(NULL, context.toUtf8(), text.toUtf8()));
-    } else {
-        return QString::fromUtf8(C::g_dpgettext2(domain.toUtf8(), context.toUtf8(), text.toUtf8()));
+    TranslationKey key(text);
+    key.context = context;
+    key.flags = TranslationKey::Context;
+    if (!domain.isNull()) {
+        key.domain = domain;
+        key.flags |= TranslationKey::Domain;
     }
+    return cachedTranslation(key);
 }
 
 /*!
@@ -19,6 +19,8 @@
 #ifndef I18N_P_H
 #define I18N_P_H
 
+#include <QtCore/QCache>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
@@ -74,9 +76,39 @@ Q_SIGNALS:
     void languageChanged();
 
 private:
+    // Identifies a lookup, the same message translated from different
+    // domains, contexts or plural counts gets different entries.
+    struct TranslationKey {
+        enum Flag { Domain = 0x1, Context = 0x2, Plural = 0x4 };
+
+        TranslationKey(const QString &msgid) : msgid(msgid), n(0), flags(0) {}
+
+        QString domain;
+        QString context;
+        QString msgid;
+        QString plural;
+        int n;
+        int flags;
+
+        bool operator==(const TranslationKey &other) const
+        {
+            return flags == other.flags && n == other.n && msgid == other.msgid
+                && domain == other.domain && context == other.context && plural == other.plural;
+        }
+        friend uint qHash(const TranslationKey &key, uint seed = 0)
+        {
+            return qHash(key.msgid, seed) ^ qHash(key.domain) ^ qHash(key.context)
+                ^ qHash(key.plural) ^ uint(key.n) ^ uint(key.flags << 24);
+        }
+    };
+
+    QString cachedTranslation(const TranslationKey &key);
+    void flushTranslations();
+
     static UbuntuI18n *m_i18;
     QString m_domain;
     QString m_language;
+    QCache<TranslationKey, QString> m_translations;
 };
 
 UT_NAMESPACE_END
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indexranges_p.h"
+
+#include <algorithm>
+
+UT_NAMESPACE_BEGIN
+
+static bool endsBefore(const IndexRange &range, int index)
+{
+    return range.last < index;
+}
+
+static bool startsAfter(int index, const IndexRange &range)
+{
+    return index < range.first;
+}
+
+static void appendRange(IndexRanges::RangeList *list, int first, int last)
+{
+    if (list) {
+        IndexRange range = { first, last };
+        list->append(range);
+    }
+}
+
+IndexRanges::IndexRanges()
+    : m_count(0)
+{
+}
+
+IndexRanges IndexRanges::fromList(const QList<int> &indices)
+{
+    QList<int> sorted(indices);
+    std::sort(sorted.begin(), sorted.end());
+
+    IndexRanges result;
+    Q_FOREACH(int index, sorted) {
+        if (!result.m_ranges.isEmpty() && index <= result.m_ranges.last().last + 1) {
+            if (index > result.m_ranges.last().last) {
+                result.m_ranges.last().last = index;
+                result.m_count++;
+            }
+        } else {
+            appendRange(&result.m_ranges, index, index);
+            result.m_count++;
+        }
+    }
+    return result;
+}
+
+QList<int> IndexRanges::toList() const
+{
+    QList<int> list;
+    list.reserve(m_count);
+    for (const Range &range : m_ranges) {
+        for (int i = range.first; i <= range.last; i++) {
+            list.append(i);
+        }
+    }
+    return list;
+}
+
+// every range is turned into a [first, last] array
+QVariantList IndexRanges::toVariantList(const RangeList &ranges)
+{
+    QVariantList list;
+    list.reserve(ranges.size());
+    for (const Range &range : ranges) {
+        list.append(QVariant(QVariantList() << range.first << range.last));
+    }
+    return list;
+}
+
+IndexRanges::RangeList::iterator IndexRanges::firstEndingFrom(int index)
+{
+    return std::lower_bound(m_ranges.begin(), m_ranges.end(), index, endsBefore);
+}
+
+bool IndexRanges::contains(int index) const
+{
+    RangeList::const_iterator i = std::lower_bound(m_ranges.constBegin(), m_ranges.constEnd(), index, endsBefore);
+    return i != m_ranges.constEnd() && i->first <= index;
+}
+
+bool IndexRanges::insert(int first, int last, RangeList *added)
+{
+    if (first > last) {
+        return false;
+    }
+    // ranges overlapping or adjacent to [first, last] get merged
+    int from = firstEndingFrom(first - 1) - m_ranges.begin();
+    int to = std::upper_bound(m_ranges.begin() + from, m_ranges.end(), last + 1, startsAfter) - m_ranges.begin();
+
+    Range merged = { first, last };
+    int cursor = first;
+    bool changed = false;
+    for (int i = from; i < to; i++) {
+        const Range &range = m_ranges[i];
+        if (range.first > cursor && cursor <= last) {
+            appendRange(added, cursor, qMin(range.first - 1, last));
+            changed = true;
+        }
+        cursor = qMax(cursor, range.last + 1);
+        merged.first = qMin(merged.first, range.first);
+        merged.last = qMax(merged.last, range.last);
+        m_count -= range.last - range.first + 1;
+    }
+    if (cursor <= last) {
+        appendRange(added, cursor, last);
+        changed = true;
+    }
+    m_count += merged.last - merged.first + 1;
+
+    if (from == to) {
+        m_ranges.insert(from, merged);
+    } else {
+        m_ranges[from] = merged;
+        m_ranges.remove(from + 1, to - from - 1);
+    }
+    return changed;
+}
+
+bool IndexRanges::remove(int first, int last, RangeList *removed)
+{
+    if (first > last) {
+        return false;
+    }
+    int from = firstEndingFrom(first) - m_ranges.begin();
+    int to = std::upper_bound(m_ranges.begin() + from, m_ranges.end(), last, startsAfter) - m_ranges.begin();
+    if (from == to) {
+        return false;
+    }
+
+    for (int i = from; i < to; i++) {
+        const Range &range = m_ranges[i];
+        int removedFirst = qMax(range.first, first);
+        int removedLast = qMin(range.last, last);
+        appendRange(removed, removedFirst, removedLast);
+        m_count -= removedLast - removedFirst + 1;
+    }
+
+    // keep the parts of the boundary ranges falling outside [first, last]
+    RangeList remains;
+    if (m_ranges[from].first < first) {
+        appendRange(&remains, m_ranges[from].first, first - 1);
+    }
+    if (m_ranges[to - 1].last > last) {
+        appendRange(&remains, last + 1, m_ranges[to - 1].last);
+    }
+    m_ranges.remove(from, to - from);
+    for (int i = 0; i < remains.size(); i++) {
+        m_ranges.insert(from + i, remains[i]);
+    }
+    return true;
+}
+
+void IndexRanges::clear()
+{
+    m_ranges.clear();
+    m_count = 0;
+}
+
+IndexRanges::RangeList IndexRanges::subtracted(const IndexRanges &other) const
+{
+    RangeList result;
+    int j = 0;
+    for (const Range &range : m_ranges) {
+        while (j < other.m_ranges.size() && other.m_ranges[j].last < range.first) {
+            j++;
+        }
+        int cursor = range.first;
+        for (int k = j; cursor <= range.last; k++) {
+            if (k >= other.m_ranges.size() || other.m_ranges[k].first > range.last) {
+                appendRange(&result, cursor, range.last);
+                break;
+            }
+            if (other.m_ranges[k].first > cursor) {
+                appendRange(&result, cursor, other.m_ranges[k].first - 1);
+            }
+            if (other.m_ranges[k].last >= range.last) {
+                break;
+            }
+            cursor = qMax(cursor, other.m_ranges[k].last + 1);
+        }
+    }
+    return result;
+}
+
+// count indices are inserted before index, the new indices are not part of the set
+void IndexRanges::shiftInserted(int index, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    int from = firstEndingFrom(index) - m_ranges.begin();
+    if (from < m_ranges.size() && m_ranges[from].first < index) {
+        Range tail = { index, m_ranges[from].last };
+        m_ranges[from].last = index - 1;
+        m_ranges.insert(++from, tail);
+    }
+    for (int i = from; i < m_ranges.size(); i++) {
+        m_ranges[i].first += count;
+        m_ranges[i].last += count;
+    }
+}
+
+// count indices are removed starting at index
+void IndexRanges::shiftRemoved(int index, int count)
+{
+    if (count <= 0) {
+        return;
+    }
+    remove(index, index + count - 1);
+    int from = firstEndingFrom(index) - m_ranges.begin();
+    for (int i = from; i < m_ranges.size(); i++) {
+        m_ranges[i].first -= count;
+        m_ranges[i].last -= count;
+    }
+    // the ranges around the removed indices may have become adjacent
+    if (from > 0 && from < m_ranges.size() && m_ranges[from - 1].last + 1 == m_ranges[from].first) {
+        m_ranges[from - 1].last = m_ranges[from].last;
+        m_ranges.remove(from);
+    }
+}
+
+// count indices moved from one position to an other, to being the position of
+// the first one after the move, same as ListModel.move()
+void IndexRanges::move(int from, int to, int count)
+{
+    if (from == to || count <= 0) {
+        return;
+    }
+    const int last = from + count - 1;
+    RangeList moved;
+    for (RangeList::iterator i = firstEndingFrom(from); i != m_ranges.end() && i->first <= last; ++i) {
+        appendRange(&moved, qMax(i->first, from) - from + to, qMin(i->last, last) - from + to);
+    }
+    shiftRemoved(from, count);
+    shiftInserted(to, count);
+    for (const Range &range : moved) {
+        insert(range.first, range.last);
+    }
+}
+
+UT_NAMESPACE_END
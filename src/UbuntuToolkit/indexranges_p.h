@@ -0,0 +1,103 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDEXRANGES_P_H
+#define INDEXRANGES_P_H
+
+#include <QtCore/QList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+UT_NAMESPACE_BEGIN
+
+struct IndexRange {
+    int first;
+    int last;
+    bool operator==(const IndexRange &other) const
+    {
+        return first == other.first && last == other.last;
+    }
+};
+
+UT_NAMESPACE_END
+
+Q_DECLARE_TYPEINFO(UT_PREPEND_NAMESPACE(IndexRange), Q_PRIMITIVE_TYPE);
+
+UT_NAMESPACE_BEGIN
+
+/*
+ * Set of indices stored as sorted, disjoint and non-adjacent closed ranges.
+ * Membership tests are done with a binary search, and selecting or removing
+ * a whole interval costs the same as a single index.
+ */
+class UBUNTUTOOLKIT_EXPORT IndexRanges
+{
+public:
+    typedef IndexRange Range;
+    typedef QVector<Range> RangeList;
+
+    IndexRanges();
+
+    static IndexRanges fromList(const QList<int> &indices);
+    QList<int> toList() const;
+    static QVariantList toVariantList(const RangeList &ranges);
+
+    bool contains(int index) const;
+    int count() const
+    {
+        return m_count;
+    }
+    bool isEmpty() const
+    {
+        return m_ranges.isEmpty();
+    }
+    const RangeList &ranges() const
+    {
+        return m_ranges;
+    }
+    bool operator==(const IndexRanges &other) const
+    {
+        return m_ranges == other.m_ranges;
+    }
+    bool operator!=(const IndexRanges &other) const
+    {
+        return !(*this == other);
+    }
+
+    // the optional lists receive the indices actually added or removed
+    bool insert(int first, int last, RangeList *added = Q_NULLPTR);
+    bool remove(int first, int last, RangeList *removed = Q_NULLPTR);
+    void clear();
+    // indices in this set and not in the other one
+    RangeList subtracted(const IndexRanges &other) const;
+
+    // follow the model changes
+    void shiftInserted(int index, int count);
+    void shiftRemoved(int index, int count);
+    void move(int from, int to, int count = 1);
+
+private:
+    RangeList::iterator firstEndingFrom(int index);
+
+    RangeList m_ranges;
+    int m_count;
+};
+
+UT_NAMESPACE_END
+
+#endif // INDEXRANGES_P_H
@@ -18,6 +18,7 @@
 
 #include <QtGui/QGuiApplication>
 
+#include "inversemousedispatcher_p.h"
 #include "quickutils_p.h"
 
 UT_NAMESPACE_BEGIN
@@ -251,26 +252,35 @@ InverseMouseAreaType::InverseMouseAreaType(QQuickItem *parent) :
 
 InverseMouseAreaType::~InverseMouseAreaType()
 {
+    updateEventFilter(false);
 }
 
+/*
+ * Topmost areas do not filter the window events on their own, the dispatcher of
+ * the window delivers them the events they may be concerned by.
+ */
 void InverseMouseAreaType::updateEventFilter(bool enable)
 {
     m_filteredEvent = false;
-    if (!enable && m_filterHost) {
-        m_filterHost->removeEventFilter(this);
-        m_filterHost.clear();
+    if (!enable && m_dispatcher) {
+        m_dispatcher->unregisterArea(this);
+        m_dispatcher.clear();
 
     } else if (enable) {
         QQuickWindow *currentWindow = window();
-        if (!currentWindow || (m_filterHost == currentWindow)) {
+        if (!currentWindow) {
+            return;
+        }
+        InverseMouseDispatcher *dispatcher = InverseMouseDispatcher::forWindow(currentWindow);
+        if (dispatcher == m_dispatcher) {
             return;
         }
 
-        if (m_filterHost) {
-            m_filterHost->removeEventFilter(this);
+        if (m_dispatcher) {
+            m_dispatcher->unregisterArea(this);
         }
-        currentWindow->installEventFilter(this);
-        m_filterHost = currentWindow;
+        m_dispatcher = dispatcher;
+        m_dispatcher->registerArea(this);
     }
 }
 
@@ -319,177 +329,147 @@ void InverseMouseAreaType::componentComplete()
 }
 
 /*
- * Translate mouse, wheel and hover event positions to component's local coordinates.
+ * Moves of a released pointer happening in the "hole" only matter to the areas
+ * following the hover state or the position of the pointer.
  */
-QEvent *InverseMouseAreaType::mapEventToArea(QObject *target, QEvent *event, QPoint &point)
+bool InverseMouseAreaType::tracksMoves() const
 {
-    QQuickItem *targetItem = qobject_cast<QQuickItem*>(target);
-    // target can be the QQuickView or QQuickWindow, then we need to get the root item from it
-    if (!targetItem) {
-        QQuickView *view = qobject_cast<QQuickView*>(target);
-        if (view) {
-            targetItem = view->rootObject();
-        } else {
-            QQuickWindow *window = qobject_cast<QQuickWindow*>(target);
-            if (window) {
-                targetItem = window->contentItem();
-            }
-        }
-    }
-    Q_ASSERT(target);
-    m_filteredEvent = true;
+    static const QMetaMethod positionChangedSignal = QMetaMethod::fromSignal(&QQuickMouseArea::positionChanged);
+    static const QMetaMethod mouseXChangedSignal = QMetaMethod::fromSignal(&QQuickMouseArea::mouseXChanged);
+    static const QMetaMethod mouseYChangedSignal = QMetaMethod::fromSignal(&QQuickMouseArea::mouseYChanged);
+    static const QMetaMethod enteredSignal = QMetaMethod::fromSignal(&QQuickMouseArea::entered);
+    static const QMetaMethod hoveredChangedSignal = QMetaMethod::fromSignal(&QQuickMouseArea::hoveredChanged);
+    return hoverEnabled() || hovered()
+            || isSignalConnected(positionChangedSignal)
+            || isSignalConnected(mouseXChangedSignal)
+            || isSignalConnected(mouseYChangedSignal)
+            || isSignalConnected(enteredSignal)
+            || isSignalConnected(hoveredChangedSignal);
+}
 
+void InverseMouseAreaType::sendMouseEvent(QMouseEvent *event)
+{
     switch (event->type()) {
     case QEvent::MouseButtonPress:
+        mousePressEvent(event);
+        break;
     case QEvent::MouseButtonRelease:
+        mouseReleaseEvent(event);
+        break;
     case QEvent::MouseButtonDblClick:
+        mouseDoubleClickEvent(event);
+        break;
     case QEvent::MouseMove:
-        if (targetItem != this) {
-            // translate coordinates to local
-            QMouseEvent *ev = static_cast<QMouseEvent*>(event);
-            QMouseEvent *mev = new QMouseEvent(ev->type(),
-                                   mapFromScene(ev->windowPos()),
-                                   ev->windowPos(),
-                                   ev->screenPos(),
-                                   ev->button(), ev->buttons(), ev->modifiers());
-            point = mev->pos();
-            return mev;
-        }
+        mouseMoveEvent(event);
         break;
-    case QEvent::Wheel:
-        if (targetItem != this) {
-            QWheelEvent *ev = static_cast<QWheelEvent*>(event);
+    default:
+        break;
+    }
+}
+
+/*
+ * Handles an event of the window delivered by the dispatcher. Mouse, wheel and
+ * hover event positions are translated to component's local coordinates, touch
+ * events are converted into mouse events. Returns true when the event is consumed.
+ */
+bool InverseMouseAreaType::filterWindowEvent(QEvent *event)
+{
+    bool captured = true;
+    QPoint point;
+    m_filteredEvent = true;
+
+    switch (event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove: {
+        QMouseEvent *ev = static_cast<QMouseEvent*>(event);
+        QMouseEvent mev(ev->type(),
+                        mapFromScene(ev->windowPos()),
+                        ev->windowPos(),
+                        ev->screenPos(),
+                        ev->button(), ev->buttons(), ev->modifiers());
+        point = mev.pos();
+        sendMouseEvent(&mev);
+        event->setAccepted(mev.isAccepted());
+        } break;
+    case QEvent::Wheel: {
+        QWheelEvent *ev = static_cast<QWheelEvent*>(event);
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-            QWheelEvent *wev = new QWheelEvent(mapFromScene(ev->position()), ev->globalPosition(),
-                                               ev->pixelDelta(), ev->angleDelta(), ev->buttons(), ev->modifiers(), ev->phase(), ev->inverted());
-            point = wev->position().toPoint();
+        QWheelEvent wev(mapFromScene(ev->position()), ev->globalPosition(),
+                        ev->pixelDelta(), ev->angleDelta(), ev->buttons(), ev->modifiers(), ev->phase(), ev->inverted());
+        point = wev.position().toPoint();
 #else
-            QWheelEvent *wev = new QWheelEvent(mapFromScene(ev->globalPos()), ev->globalPos(),
-                                               ev->delta(), ev->buttons(), ev->modifiers(), ev->orientation());
-            point = wev->pos();
+        QWheelEvent wev(mapFromScene(ev->globalPos()), ev->globalPos(),
+                        ev->delta(), ev->buttons(), ev->modifiers(), ev->orientation());
+        point = wev.pos();
 #endif
-            return wev;
-        }
-        break;
+        wheelEvent(&wev);
+        event->setAccepted(wev.isAccepted());
+        } break;
     case QEvent::HoverEnter:
     case QEvent::HoverLeave:
     case QEvent::HoverMove: {
-        if (targetItem && targetItem != this) {
-            QHoverEvent *ev = static_cast<QHoverEvent*>(event);
-            QPointF spos = targetItem->mapToScene(ev->posF());
-            QPointF sopos = targetItem->mapToScene(ev->oldPosF());
-            QHoverEvent *hev = new QHoverEvent(ev->type(),
-                                               mapFromScene(spos),
-                                               mapFromScene(sopos),
-                                               ev->modifiers());
-            point = hev->pos();
-            return hev;
+        // the window content item is at the scene origin
+        QHoverEvent *ev = static_cast<QHoverEvent*>(event);
+        QHoverEvent hev(ev->type(),
+                        mapFromScene(ev->posF()),
+                        mapFromScene(ev->oldPosF()),
+                        ev->modifiers());
+        point = hev.pos();
+        if (ev->type() == QEvent::HoverEnter) {
+            hoverEnterEvent(&hev);
+        } else if (ev->type() == QEvent::HoverLeave) {
+            hoverLeaveEvent(&hev);
+        } else {
+            hoverMoveEvent(&hev);
         }
+        event->setAccepted(hev.isAccepted());
         } break;
     // convert touch events into mouse events and continue handling as such
-    case QEvent::TouchBegin: {
-        QTouchEvent *tev = static_cast<QTouchEvent*>(event);
-        QList<QTouchEvent::TouchPoint> points = tev->touchPoints();
-        const QTouchEvent::TouchPoint &primaryPoint = points.first();
-        m_touchId = primaryPoint.id();
-        QPointF pos = targetItem->mapToScene(primaryPoint.pos());
-        QMouseEvent *mev = new QMouseEvent(QEvent::MouseButtonPress,
-                        mapFromScene(pos),
-                        primaryPoint.scenePos(),
-                        primaryPoint.screenPos(),
-                        Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
-        point = mev->pos();
-        return mev;
-        } break;
-    case QEvent::TouchUpdate: {
-        QTouchEvent *tev = static_cast<QTouchEvent*>(event);
-        QList<QTouchEvent::TouchPoint> points = tev->touchPoints();
-        const QTouchEvent::TouchPoint &primaryPoint = points.first();
-        QPointF pos = targetItem->mapToScene(primaryPoint.pos());
-        QMouseEvent *mev = new QMouseEvent(QEvent::MouseMove,
-                        mapFromScene(pos),
-                        primaryPoint.scenePos(),
-                        primaryPoint.screenPos(),
-                        Qt::NoButton, Qt::NoButton, Qt::NoModifier);
-        point = mev->pos();
-        return mev;
-        } break;
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
     case QEvent::TouchEnd: {
-        QMouseEvent *mev = 0;
         QTouchEvent *tev = static_cast<QTouchEvent*>(event);
-        QList<QTouchEvent::TouchPoint> points = tev->touchPoints();
-        for (int i = 0; i < points.count(); i++) {
-            const QTouchEvent::TouchPoint &point = points.at(i);
-            if (point.id() != m_touchId) {
-                continue;
+        const QList<QTouchEvent::TouchPoint> &points = tev->touchPoints();
+        const QTouchEvent::TouchPoint *touchPoint = &points.first();
+        QEvent::Type type = QEvent::MouseMove;
+        Qt::MouseButton button = Qt::NoButton;
+        if (event->type() == QEvent::TouchBegin) {
+            m_touchId = touchPoint->id();
+            type = QEvent::MouseButtonPress;
+            button = Qt::LeftButton;
+        } else if (event->type() == QEvent::TouchEnd) {
+            touchPoint = Q_NULLPTR;
+            for (int i = 0; i < points.count(); i++) {
+                if (points.at(i).id() == m_touchId) {
+                    touchPoint = &points.at(i);
+                    break;
+                }
             }
-            QPointF pos = targetItem->mapToScene(point.pos());
-            mev = new QMouseEvent(QEvent::MouseButtonRelease,
-                            mapFromScene(pos),
-                            point.scenePos(),
-                            point.screenPos(),
-                            Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+            type = QEvent::MouseButtonRelease;
+            button = Qt::LeftButton;
+        }
+        if (!touchPoint) {
+            captured = false;
             break;
         }
-        point = mev->pos();
-        return mev;
+        QMouseEvent mev(type,
+                        mapFromScene(touchPoint->scenePos()),
+                        touchPoint->scenePos(),
+                        touchPoint->screenPos(),
+                        button, button, Qt::NoModifier);
+        point = mev.pos();
+        sendMouseEvent(&mev);
+        event->setAccepted(mev.isAccepted());
         } break;
     default:
-        m_filteredEvent = false;
-        point = QPoint();
+        captured = false;
         break;
     }
-    return event;
-}
-
-bool InverseMouseAreaType::eventFilter(QObject *object, QEvent *event)
-{
-    if (object != this)
-    {
-        bool captured = true;
-        QPoint point;
-        QEvent *mappedEvent = mapEventToArea(object, event, point);
-
-        switch (mappedEvent->type()) {
-        case QEvent::MouseButtonPress:
-            mousePressEvent(static_cast<QMouseEvent*>(mappedEvent));
-            break;
-        case QEvent::MouseButtonRelease:
-            mouseReleaseEvent(static_cast<QMouseEvent*>(mappedEvent));
-            break;
-        case QEvent::MouseButtonDblClick:
-            mouseDoubleClickEvent(static_cast<QMouseEvent*>(mappedEvent));
-            break;
-        case QEvent::MouseMove:
-            mouseMoveEvent(static_cast<QMouseEvent*>(mappedEvent));
-            break;
-        case QEvent::Wheel:
-            wheelEvent(static_cast<QWheelEvent*>(mappedEvent));
-            break;
-        case QEvent::HoverEnter:
-            hoverEnterEvent(static_cast<QHoverEvent*>(mappedEvent));
-            break;
-        case QEvent::HoverLeave:
-            hoverLeaveEvent(static_cast<QHoverEvent*>(mappedEvent));
-            break;
-        case QEvent::HoverMove:
-            hoverMoveEvent(static_cast<QHoverEvent*>(mappedEvent));
-            break;
-        default:
-            captured = false;
-            break;
-        }
-        if (mappedEvent != event) {
-            event->setAccepted(mappedEvent->isAccepted());
-            delete mappedEvent;
-        }
-        m_filteredEvent = false;
-        if (captured && event->isAccepted() && contains(point)) {
-            // consume the event
-            return true;
-        }
-    }
-    return false;
+    m_filteredEvent = false;
+    // consume the event
+    return captured && event->isAccepted() && contains(point);
 }
 
 void InverseMouseAreaType::mousePressEvent(QMouseEvent *event)
@@ -26,6 +26,8 @@ class QQuickItem;
 
 UT_NAMESPACE_BEGIN
 
+class InverseMouseDispatcher;
+
 class UBUNTUTOOLKIT_EXPORT InverseMouseAreaType : public QQuickMouseArea
 {
     Q_OBJECT
@@ -40,7 +42,6 @@ public:
 protected:
     void itemChange(ItemChange, const ItemChangeData &) override;
     void componentComplete() override;
-    bool eventFilter(QObject *, QEvent *) override;
 
     // override mouse events
     void mousePressEvent(QMouseEvent *event) override;
@@ -52,7 +53,9 @@ private: // getter/setter
     void setSensingArea(QQuickItem *sensing);
     bool topmostItem() const;
     void setTopmostItem(bool value);
-    QEvent * mapEventToArea(QObject *target, QEvent *event, QPoint &point);
+    bool filterWindowEvent(QEvent *event);
+    bool tracksMoves() const;
+    void sendMouseEvent(QMouseEvent *event);
 
 Q_SIGNALS:
     void sensingAreaChanged();
@@ -66,11 +69,13 @@ private:
     bool m_ready:1;
     bool m_topmostItem:1;
     bool m_filteredEvent:1;
-    QPointer<QObject> m_filterHost;
+    QPointer<InverseMouseDispatcher> m_dispatcher;
     QPointer<QQuickItem> m_sensingArea;
     int m_touchId;
 
     void updateEventFilter(bool enable);
+
+    friend class InverseMouseDispatcher;
 };
 
 UT_NAMESPACE_END
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "inversemousedispatcher_p.h"
+
+#include <QtGui/QMouseEvent>
+#include <QtGui/QTouchEvent>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/private/qquickitem_p.h>
+
+#include "inversemouseareatype_p.h"
+
+UT_NAMESPACE_BEGIN
+
+static const QQuickItemPrivate::ChangeTypes watchedChanges =
+        QQuickItemPrivate::Geometry | QQuickItemPrivate::Rotation
+        | QQuickItemPrivate::Parent | QQuickItemPrivate::Destroyed;
+
+// the cached scene rectangles only follow geometry, rotation and scale changes
+static bool hasPlainGeometry(QQuickItem *item)
+{
+    if (item->containmentMask()) {
+        return false;
+    }
+    for (QQuickItem *i = item; i; i = i->parentItem()) {
+        if (!QQuickItemPrivate::get(i)->transforms.isEmpty()) {
+            return false;
+        }
+    }
+    return QQuickItemPrivate::get(item)->itemToWindowTransform().type() <= QTransform::TxScale;
+}
+
+static QRectF sceneRect(QQuickItem *item)
+{
+    return item->mapRectToScene(QRectF(0, 0, item->width(), item->height()));
+}
+
+InverseMouseDispatcher::InverseMouseDispatcher(QQuickWindow *window)
+    : QObject(window)
+    , m_window(window)
+    , m_geometryValid(false)
+    , m_watchedItemsValid(true)
+{
+}
+
+InverseMouseDispatcher::~InverseMouseDispatcher()
+{
+    Q_FOREACH(QQuickItem *item, m_watchedItems) {
+        QQuickItemPrivate::get(item)->removeItemChangeListener(this, watchedChanges);
+    }
+}
+
+InverseMouseDispatcher *InverseMouseDispatcher::forWindow(QQuickWindow *window)
+{
+    InverseMouseDispatcher *dispatcher = window->findChild<InverseMouseDispatcher*>(QString(), Qt::FindDirectChildrenOnly);
+    if (!dispatcher) {
+        dispatcher = new InverseMouseDispatcher(window);
+    }
+    return dispatcher;
+}
+
+void InverseMouseDispatcher::registerArea(InverseMouseAreaType *area)
+{
+    for (const Entry &entry : qAsConst(m_entries)) {
+        if (entry.area == area) {
+            return;
+        }
+    }
+    if (m_entries.isEmpty()) {
+        m_window->installEventFilter(this);
+    }
+    Entry entry;
+    entry.area = area;
+    entry.exact = false;
+    m_entries.prepend(entry);
+    m_geometryValid = false;
+    updateWatchedItems();
+}
+
+void InverseMouseDispatcher::unregisterArea(InverseMouseAreaType *area)
+{
+    for (int i = 0; i < m_entries.size(); i++) {
+        if (m_entries[i].area == area) {
+            m_entries.remove(i);
+            break;
+        }
+    }
+    if (m_entries.isEmpty()) {
+        m_window->removeEventFilter(this);
+    }
+    updateWatchedItems();
+}
+
+void InverseMouseDispatcher::itemGeometryChanged(QQuickItem *item, QQuickGeometryChange change, const QRectF &oldGeometry)
+{
+    Q_UNUSED(item);
+    Q_UNUSED(change);
+    Q_UNUSED(oldGeometry);
+    m_geometryValid = false;
+}
+
+void InverseMouseDispatcher::itemRotationChanged(QQuickItem *item)
+{
+    Q_UNUSED(item);
+    m_geometryValid = false;
+}
+
+void InverseMouseDispatcher::itemParentChanged(QQuickItem *item, QQuickItem *parent)
+{
+    Q_UNUSED(item);
+    Q_UNUSED(parent);
+    m_geometryValid = false;
+    m_watchedItemsValid = false;
+}
+
+void InverseMouseDispatcher::itemDestroyed(QQuickItem *item)
+{
+    // the item drops its listeners by itself
+    m_watchedItems.remove(item);
+    m_geometryValid = false;
+    m_watchedItemsValid = false;
+}
+
+void InverseMouseDispatcher::invalidateGeometry()
+{
+    m_geometryValid = false;
+}
+
+void InverseMouseDispatcher::watch(QQuickItem *item)
+{
+    QQuickItemPrivate::get(item)->addItemChangeListener(this, watchedChanges);
+    connect(item, &QQuickItem::scaleChanged, this, &InverseMouseDispatcher::invalidateGeometry);
+    connect(item, &QQuickItem::transformOriginChanged, this, &InverseMouseDispatcher::invalidateGeometry);
+}
+
+void InverseMouseDispatcher::unwatch(QQuickItem *item)
+{
+    QQuickItemPrivate::get(item)->removeItemChangeListener(this, watchedChanges);
+    disconnect(item, Q_NULLPTR, this, Q_NULLPTR);
+}
+
+// watch the areas, their sensing areas and all their ancestors
+void InverseMouseDispatcher::updateWatchedItems()
+{
+    QSet<QQuickItem*> items;
+    for (const Entry &entry : qAsConst(m_entries)) {
+        if (!entry.area) {
+            continue;
+        }
+        for (QQuickItem *item = entry.area; item && !items.contains(item); item = item->parentItem()) {
+            items.insert(item);
+        }
+        for (QQuickItem *item = entry.area->sensingArea(); item && !items.contains(item); item = item->parentItem()) {
+            items.insert(item);
+        }
+    }
+    Q_FOREACH(QQuickItem *item, m_watchedItems - items) {
+        unwatch(item);
+    }
+    Q_FOREACH(QQuickItem *item, items - m_watchedItems) {
+        watch(item);
+    }
+    m_watchedItems = items;
+    m_watchedItemsValid = true;
+}
+
+void InverseMouseDispatcher::updateGeometry()
+{
+    for (int i = 0; i < m_entries.size(); i++) {
+        Entry &entry = m_entries[i];
+        if (!entry.area) {
+            continue;
+        }
+        QQuickItem *sensingArea = entry.area->sensingArea();
+        entry.exact = hasPlainGeometry(entry.area) && (!sensingArea || hasPlainGeometry(sensingArea));
+        entry.areaRect = sceneRect(entry.area);
+        entry.sensingRect = sensingArea ? sceneRect(sensingArea) : QRectF();
+    }
+    m_geometryValid = true;
+}
+
+/*
+ * Conservative test, the area decides on its own whether it handles and
+ * consumes the event. The rectangles are given a pixel of tolerance to stay
+ * on the safe side of the rounding done when mapping the positions.
+ */
+bool InverseMouseDispatcher::mayConcern(const Entry &entry, const QPointF &scenePos) const
+{
+    if (!entry.exact) {
+        return true;
+    }
+    if (!entry.sensingRect.adjusted(-1, -1, 1, 1).contains(scenePos)) {
+        return false;
+    }
+    const QRectF inner = entry.areaRect.adjusted(1, 1, -1, -1);
+    return inner.width() <= 0 || inner.height() <= 0 || !inner.contains(scenePos);
+}
+
+bool InverseMouseDispatcher::eventFilter(QObject *target, QEvent *event)
+{
+    enum Recipients {
+        AllAreas,
+        // the areas whose inverse region may contain the event position
+        ConcernedAreas,
+        // also the pressed areas
+        PressedAreas,
+        // also the areas following the moves of a released pointer
+        MovingAreas
+    } recipients = ConcernedAreas;
+    QPointF scenePos;
+
+    switch (event->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonDblClick:
+        scenePos = static_cast<QMouseEvent*>(event)->windowPos();
+        break;
+    case QEvent::MouseButtonRelease:
+        scenePos = static_cast<QMouseEvent*>(event)->windowPos();
+        recipients = PressedAreas;
+        break;
+    case QEvent::MouseMove:
+        scenePos = static_cast<QMouseEvent*>(event)->windowPos();
+        recipients = MovingAreas;
+        break;
+    // wheel events are reported wherever they happen
+    case QEvent::Wheel:
+    case QEvent::HoverEnter:
+    case QEvent::HoverLeave:
+    case QEvent::HoverMove:
+        recipients = AllAreas;
+        break;
+    case QEvent::TouchBegin:
+    case QEvent::TouchUpdate:
+    case QEvent::TouchEnd: {
+        const QList<QTouchEvent::TouchPoint> &points = static_cast<QTouchEvent*>(event)->touchPoints();
+        if (points.isEmpty()) {
+            return false;
+        }
+        scenePos = points.first().scenePos();
+        if (event->type() == QEvent::TouchUpdate) {
+            recipients = MovingAreas;
+        } else if (event->type() == QEvent::TouchEnd) {
+            recipients = PressedAreas;
+        }
+        } break;
+    default:
+        return false;
+    }
+    if (target != m_window || m_entries.isEmpty()) {
+        return false;
+    }
+
+    if (!m_watchedItemsValid) {
+        updateWatchedItems();
+    }
+    if (!m_geometryValid) {
+        updateGeometry();
+    }
+    // the handlers may register or unregister areas
+    const QVector<Entry> entries(m_entries);
+    for (const Entry &entry : entries) {
+        InverseMouseAreaType *area = entry.area;
+        if (!area || area->m_dispatcher != this) {
+            continue;
+        }
+        bool deliver = recipients == AllAreas
+                || (recipients >= PressedAreas && area->pressed())
+                || (recipients == MovingAreas && area->tracksMoves())
+                || mayConcern(entry, scenePos);
+        if (deliver && area->filterWindowEvent(event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+UT_NAMESPACE_END
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INVERSEMOUSEDISPATCHER_P_H
+#define INVERSEMOUSEDISPATCHER_P_H
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QRectF>
+#include <QtCore/QSet>
+#include <QtCore/QVector>
+#include <QtQuick/private/qquickitemchangelistener_p.h>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+class QQuickItem;
+class QQuickWindow;
+
+UT_NAMESPACE_BEGIN
+
+class InverseMouseAreaType;
+
+/*
+ * Single event filter of a window shared by all the topmost InverseMouseAreas
+ * shown in it. The pointer events are only delivered to the areas they may
+ * concern: the ones whose sensing area minus the area itself contains the
+ * event position, the pressed ones for moves and releases, the ones following
+ * the pointer for moves, and all of them for wheel and hover events. The scene
+ * rectangles used for that test are cached and invalidated by listening to the
+ * geometry changes of the areas, of the sensing areas and of their ancestors.
+ */
+class UBUNTUTOOLKIT_EXPORT InverseMouseDispatcher : public QObject, protected QQuickItemChangeListener
+{
+    Q_OBJECT
+public:
+    static InverseMouseDispatcher *forWindow(QQuickWindow *window);
+    ~InverseMouseDispatcher();
+
+    void registerArea(InverseMouseAreaType *area);
+    void unregisterArea(InverseMouseAreaType *area);
+
+protected:
+    bool eventFilter(QObject *target, QEvent *event) override;
+
+    // from QQuickItemChangeListener
+    void itemGeometryChanged(QQuickItem *item, QQuickGeometryChange change, const QRectF &oldGeometry) override;
+    void itemRotationChanged(QQuickItem *item) override;
+    void itemParentChanged(QQuickItem *item, QQuickItem *parent) override;
+    void itemDestroyed(QQuickItem *item) override;
+
+private Q_SLOTS:
+    void invalidateGeometry();
+
+private:
+    struct Entry {
+        QPointer<InverseMouseAreaType> area;
+        QRectF areaRect;
+        QRectF sensingRect;
+        // the rectangles cannot describe a rotated, transformed or masked area
+        bool exact;
+    };
+
+    explicit InverseMouseDispatcher(QQuickWindow *window);
+
+    void updateGeometry();
+    void updateWatchedItems();
+    void watch(QQuickItem *item);
+    void unwatch(QQuickItem *item);
+    bool mayConcern(const Entry &entry, const QPointF &scenePos) const;
+
+    QQuickWindow *m_window;
+    // most recently registered area first, same order the filters ran in
+    QVector<Entry> m_entries;
+    QSet<QQuickItem*> m_watchedItems;
+    bool m_geometryValid:1;
+    bool m_watchedItemsValid:1;
+};
+
+UT_NAMESPACE_END
+
+#endif // INVERSEMOUSEDISPATCHER_P_H
@@ -38,16 +38,16 @@ void ListItemSelection::attachToViewItems(UCViewItemsAttached *newViewItems)
     if (viewItems) {
         disconnect(viewItems.data(), &UCViewItemsAttached::selectModeChanged,
                    this, &ListItemSelection::onSelectModeChanged);
-        disconnect(viewItems.data(), &UCViewItemsAttached::selectedIndicesChanged,
-                   this, &ListItemSelection::onSelectedIndicesChanged);
+        disconnect(viewItems.data(), &UCViewItemsAttached::selectionRangesChanged,
+                   this, &ListItemSelection::onSelectionRangesChanged);
         viewItems.clear();
     }
     if (newViewItems) {
         viewItems = newViewItems;
         connect(viewItems.data(), &UCViewItemsAttached::selectModeChanged,
                this, &ListItemSelection::onSelectModeChanged);
-        connect(viewItems.data(), &UCViewItemsAttached::selectedIndicesChanged,
-                this, &ListItemSelection::onSelectedIndicesChanged);
+        connect(viewItems.data(), &UCViewItemsAttached::selectionRangesChanged,
+                this, &ListItemSelection::onSelectionRangesChanged);
         syncWithViewItems();
     }
 }
@@ -134,11 +134,11 @@ void ListItemSelection::onSelectModeChanged()
     Q_EMIT hostItem->selectModeChanged();
 }
 
-void ListItemSelection::onSelectedIndicesChanged(const QList<int> &indices)
+void ListItemSelection::onSelectionRangesChanged()
 {
-    UCListItemPrivate *d = UCListItemPrivate::get(hostItem);
-    if (selected != indices.contains(d->index())) {
-        selected = indices.contains(d->index());
+    bool isSelected = UCViewItemsAttachedPrivate::get(viewItems.data())->isItemSelected(hostItem);
+    if (selected != isSelected) {
+        selected = isSelected;
         Q_EMIT hostItem->selectedChanged();
     }
 }
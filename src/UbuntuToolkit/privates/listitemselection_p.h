@@ -41,7 +41,7 @@ public:
     void setSelected(bool selected);
 
     void onSelectModeChanged();
-    void onSelectedIndicesChanged(const QList<int> &indices);
+    void onSelectionRangesChanged();
 
 private:
     QPointer<UCViewItemsAttached> viewItems;
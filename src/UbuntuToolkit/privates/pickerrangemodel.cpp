@@ -0,0 +1,115 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "privates/pickerrangemodel_p.h"
+
+UT_NAMESPACE_BEGIN
+
+PickerRangeModel::PickerRangeModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_from(0)
+    , m_count(0)
+    , m_modulo(0)
+{
+}
+
+int PickerRangeModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_count;
+}
+
+QVariant PickerRangeModel::data(const QModelIndex &index, int role) const
+{
+    if (role != Qt::DisplayRole || index.row() < 0 || index.row() >= m_count) {
+        return QVariant();
+    }
+    return value(index.row());
+}
+
+QHash<int, QByteArray> PickerRangeModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles.insert(Qt::DisplayRole, "modelData");
+    return roles;
+}
+
+void PickerRangeModel::setModulo(int modulo)
+{
+    if (m_modulo == modulo) {
+        return;
+    }
+    m_modulo = modulo;
+    if (m_count > 0) {
+        Q_EMIT dataChanged(index(0), index(m_count - 1));
+    }
+    Q_EMIT moduloChanged();
+}
+
+// Views see the rows removed then inserted, same as a cleared and refilled
+// ListModel but with a single change each.
+void PickerRangeModel::setRange(int from, int count)
+{
+    count = qMax(0, count);
+    if (m_count > 0) {
+        beginRemoveRows(QModelIndex(), 0, m_count - 1);
+        m_count = 0;
+        endRemoveRows();
+    }
+    bool fromChange = m_from != from;
+    m_from = from;
+    if (count > 0) {
+        beginInsertRows(QModelIndex(), 0, count - 1);
+        m_count = count;
+        endInsertRows();
+    }
+    if (fromChange) {
+        Q_EMIT fromChanged();
+    }
+    Q_EMIT countChanged();
+}
+
+void PickerRangeModel::resize(int count)
+{
+    count = qMax(0, count);
+    if (count > m_count) {
+        beginInsertRows(QModelIndex(), m_count, count - 1);
+        m_count = count;
+        endInsertRows();
+    } else if (count < m_count) {
+        beginRemoveRows(QModelIndex(), count, m_count - 1);
+        m_count = count;
+        endRemoveRows();
+    } else {
+        return;
+    }
+    Q_EMIT countChanged();
+}
+
+int PickerRangeModel::value(int row) const
+{
+    return m_modulo > 0 ? (m_from + row) % m_modulo : m_from + row;
+}
+
+int PickerRangeModel::rowOf(int value) const
+{
+    int row = value - m_from;
+    if (m_modulo > 0) {
+        row = ((row % m_modulo) + m_modulo) % m_modulo;
+    }
+    return (row >= 0 && row < m_count) ? row : -1;
+}
+
+UT_NAMESPACE_END
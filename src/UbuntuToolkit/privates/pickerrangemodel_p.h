@@ -0,0 +1,79 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PICKERRANGEMODEL_P_H
+#define PICKERRANGEMODEL_P_H
+
+#include <QtCore/QAbstractListModel>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+UT_NAMESPACE_BEGIN
+
+/*
+ * List model of the consecutive values shown by the DatePicker tumblers. The
+ * value of a row is computed from the first value, wrapping around the modulo
+ * when one is set, nothing is stored per row. The only role is modelData.
+ */
+class UBUNTUTOOLKIT_EXPORT PickerRangeModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int from READ from NOTIFY fromChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int modulo READ modulo WRITE setModulo NOTIFY moduloChanged)
+public:
+    explicit PickerRangeModel(QObject *parent = 0);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int from() const
+    {
+        return m_from;
+    }
+    int count() const
+    {
+        return m_count;
+    }
+    int modulo() const
+    {
+        return m_modulo;
+    }
+    void setModulo(int modulo);
+
+    // replaces all the rows
+    Q_INVOKABLE void setRange(int from, int count);
+    // appends or removes rows at the end
+    Q_INVOKABLE void resize(int count);
+    Q_INVOKABLE int value(int row) const;
+    // row of the value, -1 if not in the model
+    Q_INVOKABLE int rowOf(int value) const;
+
+Q_SIGNALS:
+    void fromChanged();
+    void countChanged();
+    void moduloChanged();
+
+private:
+    int m_from;
+    int m_count;
+    int m_modulo;
+};
+
+UT_NAMESPACE_END
+
+#endif // PICKERRANGEMODEL_P_H
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "privates/ucpagecache_p.h"
+
+#include <QtGui/QGuiApplication>
+#include <QtQml/QQmlComponent>
+#include <QtQuick/QQuickItem>
+
+UT_NAMESPACE_BEGIN
+
+static bool sameReference(const QVariant &a, const QVariant &b)
+{
+    QQmlComponent *componentA = a.value<QQmlComponent*>();
+    QQmlComponent *componentB = b.value<QQmlComponent*>();
+    if (componentA || componentB) {
+        return componentA == componentB;
+    }
+    return a.toString() == b.toString();
+}
+
+/*!
+    \internal
+    \qmltype PageCache
+    \inqmlmodule Ubuntu.Components.Private
+    \brief Internal class keeping the pages removed from PageStack and
+    AdaptivePageLayout for reuse.
+*/
+UCPageCache::UCPageCache(QObject *parent)
+    : QObject(parent)
+    , m_capacity(0)
+{
+    // suspended applications are the first ones the system reclaims memory from
+    connect(qGuiApp, &QGuiApplication::applicationStateChanged,
+            this, &UCPageCache::onApplicationStateChanged);
+}
+
+/*!
+  \qmlproperty int PageCache::capacity
+  The maximum number of pages kept. The cache is disabled when 0, which is the
+  default.
+  */
+void UCPageCache::setCapacity(int capacity)
+{
+    capacity = qMax(0, capacity);
+    if (m_capacity == capacity) {
+        return;
+    }
+    m_capacity = capacity;
+    int oldCount = m_entries.size();
+    trim(m_capacity);
+    if (m_entries.size() != oldCount) {
+        Q_EMIT countChanged();
+    }
+    Q_EMIT capacityChanged();
+}
+
+/*!
+  \qmlproperty int PageCache::count
+  \readonly
+  The number of pages currently kept.
+  */
+
+/*!
+  Returns true if pages created from the \a reference can be cached, which is
+  the case for Components and documents. Page objects pushed as they are stay
+  owned by their creator.
+  */
+bool UCPageCache::isCacheable(const QVariant &reference)
+{
+    return reference.value<QQmlComponent*>() || reference.canConvert<QString>();
+}
+
+/*!
+  Takes the ownership of the \a page created from \a reference and \a properties.
+  The page is removed from the scene and gets its cached() signal emitted.
+  Returns false if the page cannot be cached, in which case the caller remains
+  responsible for destroying it.
+  */
+bool UCPageCache::insert(const QVariant &reference, const QVariant &properties, QQuickItem *page)
+{
+    if (!m_capacity || !page || !isCacheable(reference)) {
+        return false;
+    }
+
+    int oldCount = m_entries.size();
+    page->setParentItem(Q_NULLPTR);
+    page->setParent(this);
+    connect(page, &QObject::destroyed, this, &UCPageCache::onPageDestroyed);
+    Entry entry = { reference, properties, page };
+    m_entries.prepend(entry);
+    // notify the page before a possible eviction destroys it, only Page
+    // declares the signal
+    if (page->metaObject()->indexOfSignal("cached()") >= 0) {
+        QMetaObject::invokeMethod(page, "cached");
+    }
+    trim(m_capacity);
+    if (m_entries.size() != oldCount) {
+        Q_EMIT countChanged();
+    }
+    return true;
+}
+
+/*!
+  Returns the most recently cached page created from the same \a reference
+  and \a properties, or null if there is none. The ownership of the page goes
+  back to the caller, which is responsible for emitting its restored() signal
+  once the page is back in the scene.
+  */
+QQuickItem *UCPageCache::take(const QVariant &reference, const QVariant &properties)
+{
+    if (!isCacheable(reference)) {
+        return Q_NULLPTR;
+    }
+    for (int i = 0; i < m_entries.size(); i++) {
+        const Entry &entry = m_entries.at(i);
+        if (sameReference(entry.reference, reference) && entry.properties == properties) {
+            QQuickItem *page = entry.page;
+            m_entries.removeAt(i);
+            disconnect(page, &QObject::destroyed, this, &UCPageCache::onPageDestroyed);
+            page->setParent(Q_NULLPTR);
+            Q_EMIT countChanged();
+            return page;
+        }
+    }
+    return Q_NULLPTR;
+}
+
+/*!
+  \qmlmethod void PageCache::clear()
+  Destroys all the cached pages.
+  */
+void UCPageCache::clear()
+{
+    if (m_entries.isEmpty()) {
+        return;
+    }
+    trim(0);
+    Q_EMIT countChanged();
+}
+
+void UCPageCache::trim(int size)
+{
+    while (m_entries.size() > size) {
+        QQuickItem *page = m_entries.takeLast().page;
+        disconnect(page, &QObject::destroyed, this, &UCPageCache::onPageDestroyed);
+        page->deleteLater();
+    }
+}
+
+void UCPageCache::onApplicationStateChanged(Qt::ApplicationState state)
+{
+    if (state == Qt::ApplicationSuspended) {
+        clear();
+    }
+}
+
+void UCPageCache::onPageDestroyed(QObject *page)
+{
+    for (int i = 0; i < m_entries.size(); i++) {
+        if (m_entries.at(i).page == page) {
+            m_entries.removeAt(i);
+            Q_EMIT countChanged();
+            return;
+        }
+    }
+}
+
+UT_NAMESPACE_END
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UCPAGECACHE_P_H
+#define UCPAGECACHE_P_H
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QVariant>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+class QQuickItem;
+
+UT_NAMESPACE_BEGIN
+
+/*
+ * Keeps the page objects removed from a PageStack or an AdaptivePageLayout
+ * alive so that pushing the same Component or document with the same
+ * properties again reuses them instead of creating a new instance. The least
+ * recently cached page is destroyed when more than capacity pages are kept,
+ * and all of them are dropped when the application gets suspended.
+ */
+class UBUNTUTOOLKIT_EXPORT UCPageCache : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int capacity READ capacity WRITE setCapacity NOTIFY capacityChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+public:
+    explicit UCPageCache(QObject *parent = 0);
+
+    int capacity() const
+    {
+        return m_capacity;
+    }
+    void setCapacity(int capacity);
+    int count() const
+    {
+        return m_entries.size();
+    }
+
+    static bool isCacheable(const QVariant &reference);
+
+    bool insert(const QVariant &reference, const QVariant &properties, QQuickItem *page);
+    QQuickItem *take(const QVariant &reference, const QVariant &properties);
+    Q_INVOKABLE void clear();
+
+Q_SIGNALS:
+    void capacityChanged();
+    void countChanged();
+
+private Q_SLOTS:
+    void onApplicationStateChanged(Qt::ApplicationState state);
+    void onPageDestroyed(QObject *page);
+
+private:
+    struct Entry {
+        QVariant reference;
+        QVariant properties;
+        QQuickItem *page;
+    };
+
+    void trim(int size);
+
+    // most recently cached first
+    QList<Entry> m_entries;
+    int m_capacity;
+};
+
+UT_NAMESPACE_END
+
+#endif // UCPAGECACHE_P_H
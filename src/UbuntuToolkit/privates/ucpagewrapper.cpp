@@ -122,6 +122,45 @@ void UCPageWrapperPrivate::reset()
     m_state = Waiting;
 }
 
+/*!
+  \internal
+  Takes the page object from the page cache if one was created earlier from
+  the same reference and properties.
+ */
+bool UCPageWrapperPrivate::restoreCachedObject()
+{
+    if (!m_pageCache) {
+        return false;
+    }
+    QQuickItem *theItem = m_pageCache->take(m_reference, m_properties);
+    if (!theItem) {
+        return false;
+    }
+
+    //the object was created from the reference by a previous wrapper
+    setCanDestroy(true);
+    initItem(theItem);
+    m_state = NotifyPageLoaded;
+    nextStep();
+    if (theItem->metaObject()->indexOfSignal("restored()") >= 0) {
+        QMetaObject::invokeMethod(theItem, "restored");
+    }
+    return true;
+}
+
+/*!
+  \internal
+  Hands the page object over to the page cache, or destroys it if the cache
+  is not set, disabled or the object is not completely created.
+ */
+void UCPageWrapperPrivate::releaseObject()
+{
+    if (m_state != Ready || !m_pageCache
+            || !m_pageCache->insert(m_reference, m_properties, m_object)) {
+        m_object->deleteLater();
+    }
+}
+
 /*!
   \internal
   Create the page object if needed, and make the page object visible.
@@ -291,6 +330,10 @@ void UCPageWrapperPrivate::loadComponentState()
     Q_Q(UCPageWrapper);
     m_state = LoadingComponent;
 
+    if (restoreCachedObject()) {
+        return;
+    }
+
     if (m_reference.canConvert<QQmlComponent *>()) {
 
         //m_reference points to a Component already, make sure we do not
@@ -613,6 +656,26 @@ void UCPageWrapper::setParentPage(QQuickItem *parentPage)
     Q_EMIT parentPageChanged(parentPage);
 }
 
+/*!
+  \qmlproperty PageCache PageWrapper::pageCache
+  Cache the page object is handed over to when destroyed, and taken from
+  when the same reference is set again with the same properties.
+  */
+UCPageCache *UCPageWrapper::pageCache() const
+{
+    return d_func()->m_pageCache;
+}
+
+void UCPageWrapper::setPageCache(UCPageCache *pageCache)
+{
+    Q_D(UCPageWrapper);
+    if (d->m_pageCache == pageCache)
+        return;
+
+    d->m_pageCache = pageCache;
+    Q_EMIT pageCacheChanged(pageCache);
+}
+
 /*!
   \qmlproperty var PageWrapper::incubator
   Incubator for the asynchronous page creation
@@ -631,7 +694,7 @@ void UCPageWrapper::destroyObject()
 {
     Q_D(UCPageWrapper);
     if (d->m_canDestroy && d->m_object) {
-        d->m_object->deleteLater();
+        d->releaseObject();
         d->m_canDestroy = false;
         setObject(nullptr);
     }
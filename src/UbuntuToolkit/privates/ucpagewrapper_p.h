@@ -17,6 +17,7 @@
 #ifndef UCPAGEWRAPPER_P_H
 #define UCPAGEWRAPPER_P_H
 
+#include <UbuntuToolkit/private/ucpagecache_p.h>
 #include <UbuntuToolkit/private/ucpagetreenode_p.h>
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
 
@@ -36,6 +37,7 @@ class UBUNTUTOOLKIT_EXPORT UCPageWrapper : public UCPageTreeNode
     Q_PROPERTY(QObject* incubator READ incubator NOTIFY incubatorChanged)
     Q_PROPERTY(bool synchronous READ synchronous WRITE setSynchronous NOTIFY synchronousChanged)
     Q_PROPERTY(QVariant properties READ properties WRITE setProperties NOTIFY propertiesChanged)
+    Q_PROPERTY(UCPageCache* pageCache READ pageCache WRITE setPageCache NOTIFY pageCacheChanged)
 
     //overrides
     Q_PROPERTY(bool visible READ isVisible WRITE setVisible2 NOTIFY visibleChanged2 FINAL)
@@ -75,6 +77,9 @@ public:
     QQuickItem *parentPage() const;
     void setParentPage(QQuickItem* parentPage);
 
+    UCPageCache *pageCache() const;
+    void setPageCache(UCPageCache *pageCache);
+
     QObject *incubator() const;
 
     Q_INVOKABLE void destroyObject ();
@@ -101,6 +106,7 @@ Q_SIGNALS:
     void pageLoaded();
     void parentPageChanged(QQuickItem* parentPage);
     void incubatorChanged(QObject* incubator);
+    void pageCacheChanged(UCPageCache* pageCache);
     void visibleChanged2();
     void themeChanged2();
 
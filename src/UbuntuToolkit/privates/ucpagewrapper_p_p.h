@@ -17,6 +17,7 @@
 #ifndef UCPAGEWRAPPER_P_P_H
 #define UCPAGEWRAPPER_P_P_H
 
+#include <QtCore/QPointer>
 #include <UbuntuToolkit/private/ucpagewrapper_p.h>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
@@ -45,6 +46,8 @@ public:
 
     void initPage();
     void reset ();
+    bool restoreCachedObject();
+    void releaseObject();
     void activate   ();
     void deactivate ();
     QQuickItem *toItem (QObject *theObject, bool canDelete = true);
@@ -70,6 +73,7 @@ public:
     QQuickItem* m_parentWrapper;
     QQuickItem* m_pageHolder;
     UCPageWrapperIncubator* m_incubator;
+    QPointer<UCPageCache> m_pageCache;
     QQmlComponent *m_component;
     QQmlContext *m_itemContext;
     State m_state;
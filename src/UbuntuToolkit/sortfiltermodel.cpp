@@ -20,8 +20,291 @@
 
 #include "sortfiltermodel_p.h"
 
+#include <algorithm>
+
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEvent>
+#include <QtCore/QMutex>
+#include <QtCore/QRunnable>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
 UT_NAMESPACE_BEGIN
 
+// State shared between a model and its running jobs. The receiver is cleared
+// under the mutex when the model is destroyed, and a job only posts its
+// results if the generation it was started with is still the latest one.
+struct SortFilterJobState
+{
+    SortFilterJobState(QObject *receiver) : receiver(receiver) {}
+
+    QMutex mutex;
+    QObject *receiver;
+    QAtomicInteger<quint32> sortGeneration;
+    QAtomicInteger<quint32> filterGeneration;
+};
+
+class SortFilterResultEvent : public QEvent
+{
+public:
+    enum Kind { Sort, Filter };
+
+    SortFilterResultEvent(Kind kind, quint32 generation, quint32 sourceGeneration, int role)
+        : QEvent(eventType())
+        , kind(kind)
+        , generation(generation)
+        , sourceGeneration(sourceGeneration)
+        , role(role)
+    {}
+
+    static QEvent::Type eventType()
+    {
+        static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+        return type;
+    }
+
+    Kind kind;
+    quint32 generation;
+    quint32 sourceGeneration;
+    int role;
+    QVector<int> ranks;
+    QVector<qint8> accepted;
+};
+
+// Same ordering as the one QSortFilterProxyModel uses for non string values.
+static bool variantLessThan(const QVariant &left, const QVariant &right)
+{
+    if (left.userType() == QMetaType::UnknownType) {
+        return right.isValid();
+    }
+    switch (left.userType()) {
+    case QMetaType::Int:
+        return left.toInt() < right.toInt();
+    case QMetaType::UInt:
+        return left.toUInt() < right.toUInt();
+    case QMetaType::LongLong:
+        return left.toLongLong() < right.toLongLong();
+    case QMetaType::ULongLong:
+        return left.toULongLong() < right.toULongLong();
+    case QMetaType::Float:
+        return left.toFloat() < right.toFloat();
+    case QMetaType::Double:
+        return left.toDouble() < right.toDouble();
+    case QMetaType::QChar:
+        return left.toChar() < right.toChar();
+    case QMetaType::QDate:
+        return left.toDate() < right.toDate();
+    case QMetaType::QTime:
+        return left.toTime() < right.toTime();
+    case QMetaType::QDateTime:
+        return left.toDateTime() < right.toDateTime();
+    default:
+        return left.toString().compare(right.toString()) < 0;
+    }
+}
+
+class SortFilterJob : public QRunnable
+{
+public:
+    SortFilterJob(const QSharedPointer<SortFilterJobState> &state, SortFilterResultEvent::Kind kind,
+                  quint32 generation, quint32 sourceGeneration, int role)
+        : localeAware(false)
+        , literal(false)
+        , m_state(state)
+        , m_kind(kind)
+        , m_generation(generation)
+        , m_sourceGeneration(sourceGeneration)
+        , m_role(role)
+        , m_chunkSize(1)
+    {}
+
+    void run() override;
+    void sortChunk(int chunk);
+
+    // sort input
+    QVector<QVariant> keys;
+    QVector<QString> strings;
+    QCollator collator;
+    bool localeAware;
+    // filter input, rows already rejected by a narrowed pattern are skipped
+    QVector<qint8> previouslyAccepted;
+    QRegularExpression expression;
+    QString literalText;
+    bool literal;
+
+private:
+    bool isStale() const
+    {
+        const QAtomicInteger<quint32> &latest = m_kind == SortFilterResultEvent::Sort
+            ? m_state->sortGeneration : m_state->filterGeneration;
+        return latest.loadAcquire() != m_generation;
+    }
+    bool rowLessThan(int left, int right) const;
+    const QCollatorSortKey &collationKey(int row) const
+    {
+        return m_collationKeys[row / m_chunkSize][row % m_chunkSize];
+    }
+    void sort(SortFilterResultEvent *result);
+    void filter(SortFilterResultEvent *result);
+
+    QSharedPointer<SortFilterJobState> m_state;
+    SortFilterResultEvent::Kind m_kind;
+    quint32 m_generation;
+    quint32 m_sourceGeneration;
+    int m_role;
+    // the rows are sorted in chunks of m_chunkSize rows in parallel, each
+    // chunk has its own collation keys
+    int m_chunkSize;
+    std::vector<int> m_order;
+    std::vector<std::vector<QCollatorSortKey> > m_collationKeys;
+};
+
+// sorts one chunk of the rows of a sorting job on another pool thread
+class SortChunkJob : public QRunnable
+{
+public:
+    SortChunkJob(SortFilterJob *job, int chunk, QSemaphore *done)
+        : m_job(job)
+        , m_chunk(chunk)
+        , m_done(done)
+    {}
+
+    void run() override
+    {
+        m_job->sortChunk(m_chunk);
+        m_done->release();
+    }
+
+private:
+    SortFilterJob *m_job;
+    int m_chunk;
+    QSemaphore *m_done;
+};
+
+// rows smaller than this aren't worth sorting on another thread
+static const int minimumChunkSize = 4096;
+
+void SortFilterJob::run()
+{
+    if (isStale()) {
+        return;
+    }
+    SortFilterResultEvent *result =
+        new SortFilterResultEvent(m_kind, m_generation, m_sourceGeneration, m_role);
+    if (m_kind == SortFilterResultEvent::Sort) {
+        sort(result);
+    } else {
+        filter(result);
+    }
+
+    QMutexLocker lock(&m_state->mutex);
+    if (m_state->receiver && !isStale()) {
+        QCoreApplication::postEvent(m_state->receiver, result);
+    } else {
+        delete result;
+    }
+}
+
+bool SortFilterJob::rowLessThan(int left, int right) const
+{
+    if (keys.at(left).type() == QVariant::String && keys.at(right).type() == QVariant::String) {
+        return localeAware
+            ? collationKey(left).compare(collationKey(right)) < 0
+            : strings.at(left) < strings.at(right);
+    }
+    return variantLessThan(keys.at(left), keys.at(right));
+}
+
+void SortFilterJob::sortChunk(int chunk)
+{
+    const int first = chunk * m_chunkSize;
+    const int last = qMin(first + m_chunkSize, keys.size());
+    if (localeAware) {
+        // collators are not shared between threads
+        QCollator chunkCollator(collator.locale());
+        chunkCollator.setCaseSensitivity(collator.caseSensitivity());
+        std::vector<QCollatorSortKey> &chunkKeys = m_collationKeys[chunk];
+        chunkKeys.reserve(last - first);
+        for (int row = first; row < last; row++) {
+            chunkKeys.push_back(chunkCollator.sortKey(strings.at(row)));
+        }
+    }
+    std::stable_sort(m_order.begin() + first, m_order.begin() + last,
+                     [this](int left, int right) { return rowLessThan(left, right); });
+}
+
+void SortFilterJob::sort(SortFilterResultEvent *result)
+{
+    const int count = keys.size();
+    const int chunkCount = qBound(1, count / minimumChunkSize, QThread::idealThreadCount());
+    m_chunkSize = qMax(1, (count + chunkCount - 1) / chunkCount);
+    m_collationKeys.resize(chunkCount);
+    m_order.resize(count);
+    for (int row = 0; row < count; row++) {
+        m_order[row] = row;
+    }
+
+    // the chunks no pool thread is free for are sorted by this one
+    QSemaphore done;
+    for (int chunk = 1; chunk < chunkCount; chunk++) {
+        SortChunkJob *chunkJob = new SortChunkJob(this, chunk, &done);
+        if (!QThreadPool::globalInstance()->tryStart(chunkJob)) {
+            delete chunkJob;
+            sortChunk(chunk);
+            done.release();
+        }
+    }
+    sortChunk(0);
+    done.acquire(chunkCount - 1);
+    if (isStale()) {
+        return;
+    }
+    auto lessThan = [this](int left, int right) { return rowLessThan(left, right); };
+    for (int width = m_chunkSize; width < count; width *= 2) {
+        for (int first = 0; first + width < count; first += 2 * width) {
+            const int last = qMin(first + 2 * width, count);
+            std::inplace_merge(m_order.begin() + first, m_order.begin() + first + width,
+                               m_order.begin() + last, lessThan);
+        }
+    }
+    if (isStale()) {
+        return;
+    }
+
+    // equal keys share their rank so the proxy keeps them in source order
+    // whatever the sort order
+    result->ranks.resize(count);
+    for (int i = 0; i < count; i++) {
+        const bool equal = i > 0 && !lessThan(m_order[i - 1], m_order[i]);
+        result->ranks[m_order[i]] = equal ? result->ranks[m_order[i - 1]] : i;
+    }
+}
+
+void SortFilterJob::filter(SortFilterResultEvent *result)
+{
+    const int count = strings.size();
+    const bool narrowing = previouslyAccepted.size() == count;
+    expression.optimize();
+    result->accepted.resize(count);
+    for (int row = 0; row < count; row++) {
+        if ((row & 1023) == 0 && isStale()) {
+            return;
+        }
+        if (narrowing && previouslyAccepted.at(row) == 0) {
+            result->accepted[row] = 0;
+            continue;
+        }
+        const QString &key = strings.at(row);
+        const bool accepted = literal ? key.contains(literalText) : expression.match(key).hasMatch();
+        result->accepted[row] = accepted ? 1 : 0;
+    }
+}
+
 /*!
  * \qmltype SortFilterModel
  * \inqmlmodule Ubuntu.Components
@@ -102,6 +385,12 @@ UT_NAMESPACE_BEGIN
 
 QSortFilterProxyModelQML::QSortFilterProxyModelQML(QObject *parent)
     : QSortFilterProxyModel(parent)
+    , m_filterIsLiteral(true)
+    , m_acceptedRowsFinal(false)
+    , m_jobState(new SortFilterJobState(this))
+    , m_sourceGeneration(0)
+    , m_asynchronous(false)
+    , m_sortLocaleAware(false)
 {
     // This is virtually always what you want in QML
     setDynamicSortFilter(true);
@@ -114,18 +403,266 @@ QSortFilterProxyModelQML::QSortFilterProxyModelQML(QObject *parent)
     connect(&m_filterBehavior, &FilterBehavior::patternChanged, this, &QSortFilterProxyModelQML::filterChangedInternal);
 }
 
+QSortFilterProxyModelQML::~QSortFilterProxyModelQML()
+{
+    // running jobs must not post their results anymore
+    QMutexLocker lock(&m_jobState->mutex);
+    m_jobState->receiver = Q_NULLPTR;
+}
+
 int
 QSortFilterProxyModelQML::roleByName(const QString& roleName) const
 {
-    const QByteArray roleNameByteArray = roleName.toUtf8();
-    const QHash<int, QByteArray> roles = roleNames();
-    QHashIterator<int, QByteArray> i(roles);
-    while (i.hasNext()) {
-        i.next();
-        if (i.value() == roleNameByteArray)
-            return i.key();
+    if (m_roles.isEmpty()) {
+        const QHash<int, QByteArray> roles = roleNames();
+        for (QHash<int, QByteArray>::const_iterator i = roles.constBegin(); i != roles.constEnd(); ++i) {
+            m_roles.insert(i.value(), i.key());
+        }
+    }
+    return m_roles.value(roleName.toUtf8(), 0);
+}
+
+void
+QSortFilterProxyModelQML::KeyColumn::invalidate(int first, int last)
+{
+    last = qMin(last, cached.size() - 1);
+    for (int row = first; row <= last; row++) {
+        cached[row] = false;
+    }
+}
+
+void
+QSortFilterProxyModelQML::KeyColumn::fetch(const QAbstractItemModel *model, int row)
+{
+    if (row < cached.size() && cached.at(row)) {
+        return;
+    }
+    const int rowCount = model->rowCount();
+    if (cached.size() != rowCount) {
+        keys.resize(rowCount);
+        strings.resize(rowCount);
+        cached.resize(rowCount);
+    }
+    const QVariant key = model->index(row, 0).data(role);
+    keys[row] = key;
+    strings[row] = foldCase ? key.toString().toCaseFolded() : key.toString();
+    cached[row] = true;
+}
+
+// The per row caches are either empty or sized after the source row count, so
+// they are only shifted if they were in use and complete before the change,
+// otherwise they are cleared and filled again on demand.
+template<typename Rows>
+static void insertCachedRows(Rows &rows, int first, int count, int rowCount,
+                             const typename Rows::value_type &value)
+{
+    if (rows.empty() || static_cast<int>(rows.size()) != rowCount - count) {
+        rows.clear();
+        return;
+    }
+    rows.insert(rows.begin() + first, count, value);
+}
+
+template<typename Rows>
+static void removeCachedRows(Rows &rows, int first, int count, int rowCount)
+{
+    if (static_cast<int>(rows.size()) != rowCount + count) {
+        rows.clear();
+        return;
+    }
+    rows.erase(rows.begin() + first, rows.begin() + first + count);
+}
+
+// moves the rows first to last before the row destination
+template<typename Rows>
+static void moveCachedRows(Rows &rows, int first, int last, int destination, int rowCount)
+{
+    if (static_cast<int>(rows.size()) != rowCount) {
+        rows.clear();
+        return;
+    }
+    if (destination > last) {
+        std::rotate(rows.begin() + first, rows.begin() + last + 1, rows.begin() + destination);
+    } else if (destination < first) {
+        std::rotate(rows.begin() + destination, rows.begin() + first, rows.begin() + last + 1);
+    }
+}
+
+void
+QSortFilterProxyModelQML::KeyColumn::insertRows(int first, int count, int rowCount)
+{
+    insertCachedRows(keys, first, count, rowCount, QVariant());
+    insertCachedRows(strings, first, count, rowCount, QString());
+    insertCachedRows(cached, first, count, rowCount, false);
+}
+
+void
+QSortFilterProxyModelQML::KeyColumn::removeRows(int first, int count, int rowCount)
+{
+    removeCachedRows(keys, first, count, rowCount);
+    removeCachedRows(strings, first, count, rowCount);
+    removeCachedRows(cached, first, count, rowCount);
+}
+
+void
+QSortFilterProxyModelQML::KeyColumn::moveRows(int first, int last, int destination, int rowCount)
+{
+    moveCachedRows(keys, first, last, destination, rowCount);
+    moveCachedRows(strings, first, last, destination, rowCount);
+    moveCachedRows(cached, first, last, destination, rowCount);
+}
+
+// Keys are cached per source row, the source signals are connected before the
+// proxy's so the cache is up to date when the proxy filters and sorts again.
+void
+QSortFilterProxyModelQML::connectSourceModel(QAbstractItemModel *model)
+{
+    connect(model, &QAbstractItemModel::dataChanged,
+            this, &QSortFilterProxyModelQML::sourceDataChanged);
+    connect(model, &QAbstractItemModel::rowsInserted,
+            this, &QSortFilterProxyModelQML::sourceRowsInserted);
+    connect(model, &QAbstractItemModel::rowsRemoved,
+            this, &QSortFilterProxyModelQML::sourceRowsRemoved);
+    connect(model, &QAbstractItemModel::rowsMoved,
+            this, &QSortFilterProxyModelQML::sourceRowsMoved);
+    connect(model, &QAbstractItemModel::layoutChanged,
+            this, &QSortFilterProxyModelQML::sourceLayoutChanged);
+    connect(model, &QAbstractItemModel::modelReset,
+            this, &QSortFilterProxyModelQML::sourceLayoutChanged);
+}
+
+void
+QSortFilterProxyModelQML::sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                            const QVector<int> &roles)
+{
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+    const int first = topLeft.row();
+    const int last = bottomRight.row();
+    if (roles.isEmpty() || roles.contains(m_sortKeys.role)) {
+        m_sourceGeneration++;
+        m_sortKeys.invalidate(first, last);
+        for (int row = first; row <= last && row < m_sortRanks.size(); row++) {
+            m_sortRanks[row] = -1;
+        }
+        if (!m_collationKeys.empty()) {
+            for (int row = first; row <= last && row < static_cast<int>(m_collationKeys.size()); row++) {
+                m_sortKeys.fetch(sourceModel(), row);
+                m_collationKeys[row] = m_collator.sortKey(m_sortKeys.strings.at(row));
+            }
+        }
+    }
+    if (roles.isEmpty() || roles.contains(m_filterKeys.role)) {
+        m_sourceGeneration++;
+        m_filterKeys.invalidate(first, last);
+        for (int row = first; row <= last && row < m_acceptedRows.size(); row++) {
+            m_acceptedRows[row] = -1;
+        }
+    }
+}
+
+void
+QSortFilterProxyModelQML::sourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    const QAbstractItemModel *model = sourceModel();
+    // roles of models like ListModel are only known once populated
+    if (m_roles.size() != model->roleNames().size()) {
+        m_roles.clear();
+    }
+    const int rowCount = model->rowCount();
+    const int count = last - first + 1;
+    m_sourceGeneration++;
+    m_sortKeys.insertRows(first, count, rowCount);
+    m_filterKeys.insertRows(first, count, rowCount);
+    insertCachedRows(m_acceptedRows, first, count, rowCount, qint8(-1));
+    insertCachedRows(m_sortRanks, first, count, rowCount, -1);
+    if (!m_collationKeys.empty() && static_cast<int>(m_collationKeys.size()) == rowCount - count) {
+        std::vector<QCollatorSortKey> collationKeys;
+        collationKeys.reserve(count);
+        for (int row = first; row <= last; row++) {
+            m_sortKeys.fetch(model, row);
+            collationKeys.push_back(m_collator.sortKey(m_sortKeys.strings.at(row)));
+        }
+        m_collationKeys.insert(m_collationKeys.begin() + first, collationKeys.begin(), collationKeys.end());
+    } else {
+        m_collationKeys.clear();
+    }
+}
+
+void
+QSortFilterProxyModelQML::sourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    const int rowCount = sourceModel()->rowCount();
+    const int count = last - first + 1;
+    m_sourceGeneration++;
+    m_sortKeys.removeRows(first, count, rowCount);
+    m_filterKeys.removeRows(first, count, rowCount);
+    removeCachedRows(m_acceptedRows, first, count, rowCount);
+    removeCachedRows(m_sortRanks, first, count, rowCount);
+    removeCachedRows(m_collationKeys, first, count, rowCount);
+}
+
+void
+QSortFilterProxyModelQML::sourceRowsMoved(const QModelIndex &parent, int start, int end,
+                                          const QModelIndex &destination, int row)
+{
+    if (parent.isValid() || destination.isValid()) {
+        if (parent != destination) {
+            // top level rows come from or go to another level
+            invalidateKeys();
+        }
+        return;
+    }
+    const int rowCount = sourceModel()->rowCount();
+    m_sourceGeneration++;
+    m_sortKeys.moveRows(start, end, row, rowCount);
+    m_filterKeys.moveRows(start, end, row, rowCount);
+    moveCachedRows(m_acceptedRows, start, end, row, rowCount);
+    moveCachedRows(m_sortRanks, start, end, row, rowCount);
+    moveCachedRows(m_collationKeys, start, end, row, rowCount);
+}
+
+void
+QSortFilterProxyModelQML::sourceLayoutChanged()
+{
+    // any row may have moved, and the roles may change on a reset
+    m_roles.clear();
+    invalidateKeys();
+}
+
+void
+QSortFilterProxyModelQML::invalidateKeys()
+{
+    m_sortKeys.clear();
+    m_filterKeys.clear();
+    m_collationKeys.clear();
+    m_acceptedRows.clear();
+    m_acceptedRowsFinal = false;
+    m_sortRanks.clear();
+    m_sourceGeneration++;
+}
+
+void
+QSortFilterProxyModelQML::buildCollationKeys() const
+{
+    const QAbstractItemModel *model = sourceModel();
+    const int rowCount = model->rowCount();
+    if (static_cast<int>(m_collationKeys.size()) == rowCount) {
+        return;
+    }
+    m_collationKeys.clear();
+    m_collationKeys.reserve(rowCount);
+    for (int row = 0; row < rowCount; row++) {
+        m_sortKeys.fetch(model, row);
+        m_collationKeys.push_back(m_collator.sortKey(m_sortKeys.strings.at(row)));
     }
-    return 0;
 }
 
 /*!
@@ -179,16 +716,76 @@ QSortFilterProxyModelQML::filterBehavior()
 void
 QSortFilterProxyModelQML::sortChangedInternal()
 {
-    setSortRole(roleByName(m_sortBehavior.property()));
+    const int role = roleByName(m_sortBehavior.property());
+    if (role != m_sortKeys.role) {
+        m_sortKeys.clear();
+        m_sortKeys.role = role;
+        m_collationKeys.clear();
+        m_sortRanks.clear();
+    }
+    // sorting again with complete ranks, like after an order change, is cheap
+    const bool ranked = sourceModel() && m_sortRanks.size() == sourceModel()->rowCount();
+    if (m_asynchronous && !ranked && startSortJob()) {
+        Q_EMIT sortChanged();
+        return;
+    }
+    setSortRole(role);
     sort(sortColumn() != -1 ? sortColumn() : 0, m_sortBehavior.order());
     Q_EMIT sortChanged();
 }
 
+// returns true if the pattern has no regular expression syntax
+static bool isLiteralPattern(const QString &pattern)
+{
+    static const QString specialCharacters(QStringLiteral("\\^$.|?*+()[]{}"));
+    for (const QChar &c : pattern) {
+        if (specialCharacters.contains(c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void
 QSortFilterProxyModelQML::filterChangedInternal()
 {
-    setFilterRole(roleByName(m_filterBehavior.property()));
-    setFilterRegExp(m_filterBehavior.pattern());
+    const int role = roleByName(m_filterBehavior.property());
+    const QRegExp pattern = m_filterBehavior.pattern();
+    const bool caseInsensitive = pattern.caseSensitivity() == Qt::CaseInsensitive;
+    const bool literal = isLiteralPattern(pattern.pattern());
+    // literals are matched against case folded keys
+    const bool foldCase = literal && caseInsensitive;
+    const QString literalText = foldCase ? pattern.pattern().toCaseFolded() : pattern.pattern();
+
+    // A literal containing the previous one only matches rows the previous
+    // one matched, like when typing more characters in a search field, so the
+    // rows rejected so far don't need to be matched again.
+    const bool narrowing = literal && m_filterIsLiteral && role == m_filterKeys.role
+        && foldCase == m_filterKeys.foldCase && literalText.contains(m_filterLiteral);
+    if (role != m_filterKeys.role || foldCase != m_filterKeys.foldCase) {
+        m_filterKeys.clear();
+        m_filterKeys.role = role;
+        m_filterKeys.foldCase = foldCase;
+    }
+    if (!narrowing) {
+        m_acceptedRows.clear();
+    }
+    m_acceptedRowsFinal = false;
+    m_filterIsLiteral = literal;
+    m_filterLiteral = literalText;
+    m_filterExpression = QRegularExpression(pattern.pattern(), caseInsensitive
+        ? QRegularExpression::CaseInsensitiveOption : QRegularExpression::NoPatternOption);
+    m_filterExpression.optimize();
+
+    if (m_asynchronous && startFilterJob()) {
+        Q_EMIT filterChanged();
+        return;
+    }
+    if (filterRole() != role) {
+        setFilterRole(role);
+    } else {
+        invalidateFilter();
+    }
     Q_EMIT filterChanged();
 }
 
@@ -214,10 +811,15 @@ QSortFilterProxyModelQML::setModel(QAbstractItemModel *itemModel)
             sourceModel()->disconnect(this);
         }
 
+        m_roles.clear();
+        invalidateKeys();
+        connectSourceModel(itemModel);
         setSourceModel(itemModel);
         // Roles mapping to role names may change
-        setSortRole(roleByName(m_sortBehavior.property()));
-        setFilterRole(roleByName(m_filterBehavior.property()));
+        m_sortKeys.role = roleByName(m_sortBehavior.property());
+        m_filterKeys.role = roleByName(m_filterBehavior.property());
+        setSortRole(m_sortKeys.role);
+        setFilterRole(m_filterKeys.role);
         Q_EMIT modelChanged();
     }
 }
@@ -226,15 +828,31 @@ QVariantMap
 QSortFilterProxyModelQML::get(int row)
 {
     QVariantMap res;
+    const QModelIndex rowIndex = index(row, 0);
     const QHash<int, QByteArray> roles = roleNames();
     QHashIterator<int, QByteArray> i(roles);
     while (i.hasNext()) {
         i.next();
-        res.insert(QString::fromUtf8(i.value()), index(row, 0).data(i.key()));
+        res.insert(QString::fromUtf8(i.value()), rowIndex.data(i.key()));
     }
     return res;
 }
 
+/*!
+ * \qmlmethod var SortFilterModel::value(int row, string role)
+ * Returns the value of the given \a role at \a row, or undefined if the role
+ * doesn't exist. Cheaper than \c get(row) when only a few roles are needed.
+ */
+QVariant
+QSortFilterProxyModelQML::value(int row, const QString& role)
+{
+    const int roleIndex = roleByName(role);
+    if (!m_roles.contains(role.toUtf8())) {
+        return QVariant();
+    }
+    return index(row, 0).data(roleIndex);
+}
+
 int
 QSortFilterProxyModelQML::count()
 {
@@ -245,12 +863,274 @@ bool
 QSortFilterProxyModelQML::filterAcceptsRow(int sourceRow,
                                            const QModelIndex &sourceParent) const
 {
-    if (filterRegExp().isEmpty()) {
+    if (m_filterExpression.pattern().isEmpty()) {
         return true;
     }
 
-    bool result = QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
-    return result;
+    const QAbstractItemModel *model = sourceModel();
+    if (sourceParent.isValid()) {
+        // keys are only cached for flat models
+        const QString key = model->index(sourceRow, 0, sourceParent).data(filterRole()).toString();
+        return m_filterExpression.match(key).hasMatch();
+    }
+
+    if (sourceRow < m_acceptedRows.size()) {
+        const qint8 accepted = m_acceptedRows.at(sourceRow);
+        if (m_acceptedRowsFinal && accepted != -1) {
+            return accepted == 1;
+        }
+        // rejected by the pattern the current one narrows
+        if (accepted == 0) {
+            return false;
+        }
+    }
+    m_filterKeys.fetch(model, sourceRow);
+    const QString &key = m_filterKeys.strings.at(sourceRow);
+    const bool accepted = m_filterIsLiteral
+        ? key.contains(m_filterLiteral) : m_filterExpression.match(key).hasMatch();
+
+    const int rowCount = model->rowCount();
+    if (m_acceptedRows.size() != rowCount) {
+        m_acceptedRows.fill(-1, rowCount);
+    }
+    m_acceptedRows[sourceRow] = accepted ? 1 : 0;
+    return accepted;
+}
+
+bool
+QSortFilterProxyModelQML::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const QAbstractItemModel *model = sourceModel();
+    if (left.parent().isValid() || sortRole() != m_sortKeys.role) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+    updateSortKeyFolding();
+
+    const int leftRow = left.row();
+    const int rightRow = right.row();
+    // ranks computed by a sorting job
+    if (leftRow < m_sortRanks.size() && rightRow < m_sortRanks.size()) {
+        const int leftRank = m_sortRanks.at(leftRow);
+        const int rightRank = m_sortRanks.at(rightRow);
+        if (leftRank != -1 && rightRank != -1) {
+            return leftRank < rightRank;
+        }
+    }
+    m_sortKeys.fetch(model, leftRow);
+    m_sortKeys.fetch(model, rightRow);
+    if (m_sortKeys.keys.at(leftRow).type() != QVariant::String
+            || m_sortKeys.keys.at(rightRow).type() != QVariant::String) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+    if (isSortLocaleAware()) {
+        buildCollationKeys();
+        return m_collationKeys[leftRow].compare(m_collationKeys[rightRow]) < 0;
+    }
+    return m_sortKeys.strings.at(leftRow) < m_sortKeys.strings.at(rightRow);
+}
+
+void
+QSortFilterProxyModelQML::updateSortKeyFolding() const
+{
+    // plain strings are folded, the collator compares them with the case
+    // sensitivity itself
+    const Qt::CaseSensitivity caseSensitivity = sortCaseSensitivity();
+    const bool localeAware = isSortLocaleAware();
+    const bool foldCase = !localeAware && caseSensitivity == Qt::CaseInsensitive;
+    if (foldCase == m_sortKeys.foldCase && localeAware == m_sortLocaleAware
+            && caseSensitivity == m_collator.caseSensitivity()) {
+        return;
+    }
+    if (foldCase != m_sortKeys.foldCase) {
+        m_sortKeys.clear();
+        m_sortKeys.foldCase = foldCase;
+        m_collationKeys.clear();
+    }
+    if (caseSensitivity != m_collator.caseSensitivity()) {
+        m_collator.setCaseSensitivity(caseSensitivity);
+        m_collationKeys.clear();
+    }
+    m_sortLocaleAware = localeAware;
+    // ranked with the previous comparison
+    m_sortRanks.clear();
+}
+
+/*!
+ * \qmlproperty bool SortFilterModel::asynchronous
+ *
+ * If set, sorting and filtering after a change of \l sort or \l filter are
+ * computed in background threads, keeping the user interface responsive with
+ * large models. The values sorted or filtered are read from \l model in short
+ * slices between the events, then the rows are sorted or matched in the
+ * thread pool, and the result is applied in a single pass which only
+ * compares the precomputed positions. The model keeps its previous content
+ * until then. A computation is dropped if the sort or filter changes again in
+ * the meantime. Defaults to false.
+ */
+bool
+QSortFilterProxyModelQML::asynchronous() const
+{
+    return m_asynchronous;
+}
+
+void
+QSortFilterProxyModelQML::setAsynchronous(bool asynchronous)
+{
+    if (asynchronous == m_asynchronous) {
+        return;
+    }
+    m_asynchronous = asynchronous;
+    // only kept up to date by the jobs
+    m_sortRanks.clear();
+    Q_EMIT asynchronousChanged();
+}
+
+// Fetches the keys of the column from row on, returns the first row left to
+// fetch, or the row count once all the keys are cached. The source model is
+// only read from this thread, so the keys are fetched in short slices and the
+// event loop runs between them.
+int
+QSortFilterProxyModelQML::fetchKeys(KeyColumn &column, int row) const
+{
+    static const qint64 fetchTimeSlice = 4;
+    const QAbstractItemModel *model = sourceModel();
+    const int rowCount = model->rowCount();
+    QElapsedTimer timer;
+    timer.start();
+    for (; row < rowCount; row++) {
+        column.fetch(model, row);
+        if ((row & 255) == 255 && timer.elapsed() >= fetchTimeSlice) {
+            return row + 1;
+        }
+    }
+    // keys fetched by an earlier slice might have been invalidated since
+    if (column.cached.contains(false)) {
+        return 0;
+    }
+    return rowCount;
+}
+
+// fetches the sort keys of all the source rows and starts sorting a snapshot
+// of them in the thread pool, returns false if there's nothing to sort
+bool
+QSortFilterProxyModelQML::startSortJob()
+{
+    const QAbstractItemModel *model = sourceModel();
+    const int rowCount = model ? model->rowCount() : 0;
+    // a change that is not applied must still cancel the pending job
+    const quint32 generation = m_jobState->sortGeneration.fetchAndAddOrdered(1) + 1;
+    if (!rowCount || m_sortKeys.role <= 0) {
+        return false;
+    }
+    updateSortKeyFolding();
+    continueSortJob(generation, 0);
+    return true;
+}
+
+void
+QSortFilterProxyModelQML::continueSortJob(quint32 generation, int row)
+{
+    const QAbstractItemModel *model = sourceModel();
+    if (!model || generation != m_jobState->sortGeneration.loadAcquire()) {
+        return;
+    }
+    row = fetchKeys(m_sortKeys, row);
+    if (row < model->rowCount()) {
+        QTimer::singleShot(0, this, [this, generation, row]() {
+            continueSortJob(generation, row);
+        });
+        return;
+    }
+
+    SortFilterJob *job = new SortFilterJob(
+        m_jobState, SortFilterResultEvent::Sort, generation, m_sourceGeneration, m_sortKeys.role);
+    job->keys = m_sortKeys.keys;
+    job->strings = m_sortKeys.strings;
+    job->localeAware = isSortLocaleAware();
+    // not shared with the collator used from this thread
+    job->collator = QCollator(m_collator.locale());
+    job->collator.setCaseSensitivity(m_collator.caseSensitivity());
+    QThreadPool::globalInstance()->start(job);
+}
+
+// fetches the filter keys of all the source rows and starts matching a
+// snapshot of them in the thread pool, returns false if there's nothing to
+// filter
+bool
+QSortFilterProxyModelQML::startFilterJob()
+{
+    const QAbstractItemModel *model = sourceModel();
+    const int rowCount = model ? model->rowCount() : 0;
+    // a change that is not applied must still cancel the pending job
+    const quint32 generation = m_jobState->filterGeneration.fetchAndAddOrdered(1) + 1;
+    if (!rowCount || m_filterExpression.pattern().isEmpty()) {
+        return false;
+    }
+    continueFilterJob(generation, 0);
+    return true;
+}
+
+void
+QSortFilterProxyModelQML::continueFilterJob(quint32 generation, int row)
+{
+    const QAbstractItemModel *model = sourceModel();
+    if (!model || generation != m_jobState->filterGeneration.loadAcquire()) {
+        return;
+    }
+    row = fetchKeys(m_filterKeys, row);
+    if (row < model->rowCount()) {
+        QTimer::singleShot(0, this, [this, generation, row]() {
+            continueFilterJob(generation, row);
+        });
+        return;
+    }
+
+    SortFilterJob *job = new SortFilterJob(
+        m_jobState, SortFilterResultEvent::Filter, generation, m_sourceGeneration, m_filterKeys.role);
+    job->strings = m_filterKeys.strings;
+    job->previouslyAccepted = m_acceptedRows;
+    // not shared with the expression used from this thread
+    job->expression = QRegularExpression(m_filterExpression.pattern(), m_filterExpression.patternOptions());
+    job->literal = m_filterIsLiteral;
+    job->literalText = m_filterLiteral;
+    QThreadPool::globalInstance()->start(job);
+}
+
+void
+QSortFilterProxyModelQML::customEvent(QEvent *event)
+{
+    if (event->type() != SortFilterResultEvent::eventType()) {
+        QSortFilterProxyModel::customEvent(event);
+        return;
+    }
+    SortFilterResultEvent *result = static_cast<SortFilterResultEvent*>(event);
+    const bool upToDate = result->sourceGeneration == m_sourceGeneration;
+
+    if (result->kind == SortFilterResultEvent::Sort) {
+        if (result->generation != m_jobState->sortGeneration.loadAcquire() || result->role != m_sortKeys.role) {
+            return;
+        }
+        // the source changed since the keys were taken, sort synchronously
+        if (upToDate) {
+            m_sortRanks = result->ranks;
+        }
+        // both re-sort in a single layout change if the role or order changed
+        setSortRole(m_sortKeys.role);
+        sort(sortColumn() != -1 ? sortColumn() : 0, m_sortBehavior.order());
+    } else {
+        if (result->generation != m_jobState->filterGeneration.loadAcquire() || result->role != m_filterKeys.role) {
+            return;
+        }
+        if (upToDate) {
+            m_acceptedRows = result->accepted;
+            m_acceptedRowsFinal = true;
+        }
+        if (filterRole() != m_filterKeys.role) {
+            setFilterRole(m_filterKeys.role);
+        } else {
+            invalidateFilter();
+        }
+    }
 }
 
 UT_NAMESPACE_END
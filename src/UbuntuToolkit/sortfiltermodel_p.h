@@ -21,19 +21,27 @@
 #ifndef SORTFILTERMODEL_P_H
 #define SORTFILTERMODEL_P_H
 
+#include <QtCore/QCollator>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QVector>
+
+#include <vector>
 
 #include <UbuntuToolkit/private/sortbehavior_p.h>
 #include <UbuntuToolkit/private/filterbehavior_p.h>
 
 UT_NAMESPACE_BEGIN
 
+struct SortFilterJobState;
 class Q_DECL_EXPORT QSortFilterProxyModelQML : public QSortFilterProxyModel
 {
     Q_OBJECT
 
     Q_PROPERTY(QAbstractItemModel* model READ sourceModel WRITE setModel NOTIFY modelChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
 #ifndef Q_QDOC
     Q_PROPERTY(UT_PREPEND_NAMESPACE(SortBehavior)* sort READ sortBehavior NOTIFY sortChanged)
     Q_PROPERTY(UT_PREPEND_NAMESPACE(FilterBehavior)* filter READ filterBehavior NOTIFY filterChanged)
@@ -44,25 +52,55 @@ class Q_DECL_EXPORT QSortFilterProxyModelQML : public QSortFilterProxyModel
 
 public:
     explicit QSortFilterProxyModelQML(QObject *parent = 0);
+    ~QSortFilterProxyModelQML();
 
     Q_INVOKABLE QVariantMap get(int row);
+    Q_INVOKABLE QVariant value(int row, const QString& role);
     Q_INVOKABLE int count();
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
 
     /* getters */
     QHash<int, QByteArray> roleNames() const override;
 
+    bool asynchronous() const;
+
     /* setters */
     void setFilterProperty(const QString& property);
     void setModel(QAbstractItemModel *model);
+    void setAsynchronous(bool asynchronous);
 
 Q_SIGNALS:
     void countChanged();
     void modelChanged();
+    void asynchronousChanged();
     void sortChanged();
     void filterChanged();
 
 private:
+    // Values of one role for every source row, fetched on first use. Strings
+    // are stored case folded when the comparison is case insensitive.
+    struct KeyColumn {
+        KeyColumn() : role(-1), foldCase(false) {}
+        void clear()
+        {
+            keys.clear();
+            strings.clear();
+            cached.clear();
+        }
+        void invalidate(int first, int last);
+        void fetch(const QAbstractItemModel *model, int row);
+        void insertRows(int first, int count, int rowCount);
+        void removeRows(int first, int count, int rowCount);
+        void moveRows(int first, int last, int destination, int rowCount);
+
+        int role;
+        bool foldCase;
+        QVector<QVariant> keys;
+        QVector<QString> strings;
+        QVector<bool> cached;
+    };
+
     SortBehavior m_sortBehavior;
     SortBehavior* sortBehavior();
     void sortChangedInternal();
@@ -70,6 +108,52 @@ private:
     FilterBehavior* filterBehavior();
     void filterChangedInternal();
     int roleByName(const QString& roleName) const;
+    void connectSourceModel(QAbstractItemModel *model);
+    void sourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QVector<int> &roles);
+    void sourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void sourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void sourceRowsMoved(const QModelIndex &parent, int start, int end,
+                         const QModelIndex &destination, int row);
+    void sourceLayoutChanged();
+    void invalidateKeys();
+    void buildCollationKeys() const;
+    void updateSortKeyFolding() const;
+    int fetchKeys(KeyColumn &column, int row) const;
+    bool startSortJob();
+    void continueSortJob(quint32 generation, int row);
+    bool startFilterJob();
+    void continueFilterJob(quint32 generation, int row);
+
+protected:
+    void customEvent(QEvent *event) override;
+
+private:
+
+    mutable QHash<QByteArray, int> m_roles;
+    mutable KeyColumn m_sortKeys;
+    mutable KeyColumn m_filterKeys;
+    mutable std::vector<QCollatorSortKey> m_collationKeys;
+    mutable QCollator m_collator;
+    QRegularExpression m_filterExpression;
+    // pattern without regular expression syntax, matched as a substring
+    QString m_filterLiteral;
+    bool m_filterIsLiteral;
+    // last filtering result per source row: -1 unknown, 0 rejected, 1 accepted
+    mutable QVector<qint8> m_acceptedRows;
+    // set when m_acceptedRows comes from a filtering job for the current pattern
+    bool m_acceptedRowsFinal;
+
+    // asynchronous sorting and filtering, the jobs snapshot the keys and
+    // compute the sort ranks and the accepted rows on the thread pool
+    QSharedPointer<SortFilterJobState> m_jobState;
+    // position of each source row in the sorted order, -1 if unknown
+    mutable QVector<int> m_sortRanks;
+    // incremented on every source change, results computed on older keys
+    // are dropped
+    quint32 m_sourceGeneration;
+    bool m_asynchronous;
+    // locale awareness the sort keys and ranks were computed with
+    mutable bool m_sortLocaleAware;
 };
 
 UT_NAMESPACE_END
@@ -45,6 +45,8 @@
 #include "menugroup_p.h"
 #include "privates/appheaderbase_p.h"
 #include "privates/frame_p.h"
+#include "privates/pickerrangemodel_p.h"
+#include "privates/ucpagecache_p.h"
 #include "privates/ucpagewrapper_p.h"
 #include "privates/ucscrollbarutils_p.h"
 #include "qquickclipboard_p.h"
@@ -73,6 +75,7 @@
 #include "ucfontutils_p.h"
 #include "uchaptics_p.h"
 #include "ucheader_p.h"
+#include "ucicon_p.h"
 #include "ucinversemouse_p.h"
 #include "uclabel_p.h"
 #include "uclistitem_p.h"
@@ -260,8 +263,10 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
     const char *privateUri = "Ubuntu.Components.Private";
     qmlRegisterType<UCFrame>(privateUri, 1, 3, "Frame");
     qmlRegisterType<UCPageWrapper>(privateUri, 1, 3, "PageWrapper");
+    qmlRegisterType<UCPageCache>(privateUri, 1, 3, "PageCache");
     qmlRegisterType<UCAppHeaderBase>(privateUri, 1, 3, "AppHeaderBase");
     qmlRegisterType<Tree>(privateUri, 1, 3, "Tree");
+    qmlRegisterType<PickerRangeModel>(privateUri, 1, 3, "PickerRangeModel");
 
     //FIXME: move to a more generic location, i.e StyledItem or QuickUtils
     qmlRegisterSimpleSingletonType<UCScrollbarUtils>(privateUri, 1, 3, "PrivateScrollbarUtils");
@@ -271,7 +276,11 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
 
     HapticsProxy::instance(engine);
 
-    engine->addImageProvider(QLatin1String("scaling"), new UCScalingImageProvider);
+    // the asynchronous images are loaded through "scaling-async", sharing the cache
+    QSharedPointer<UCScalingImageCache> scalingImageCache(new UCScalingImageCache);
+    engine->addImageProvider(QLatin1String("scaling"), new UCScalingImageProvider(scalingImageCache));
+    engine->addImageProvider(QLatin1String("scaling-async"),
+                             new UCAsyncScalingImageProvider(scalingImageCache));
 
     // register icon provider
     engine->addImageProvider(QLatin1String("theme"), new UnityThemeIconProvider);
@@ -306,6 +315,10 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
                 filter |= UMApplicationMonitor::FrameEvent;
             } else if (filterList[i] == QStringLiteral("generic")) {
                 filter |= UMApplicationMonitor::GenericEvent;
+            } else if (filterList[i] == QStringLiteral("summary")) {
+                filter |= UMApplicationMonitor::FrameSummaryEvent;
+            } else if (filterList[i] == QStringLiteral("span")) {
+                filter |= UMApplicationMonitor::SpanEvent;
             }
         }
         applicationMonitor->setLoggingFilter(filter);
@@ -319,6 +332,10 @@ void UbuntuToolkitModule::initializeModule(QQmlEngine *engine, const QUrl &plugi
         } else if (metricsLogging == "lttng") {
             logger = new UMLTTNGLogger();
 #endif  // defined(Q_OS_LINUX)
+        } else if (metricsLogging.startsWith("binary:")) {
+            logger = new UMBinaryLogger(QString::fromLocal8Bit(metricsLogging.mid(7)));
+        } else if (metricsLogging.startsWith("trace:")) {
+            logger = new UMTraceEventLogger(QString::fromLocal8Bit(metricsLogging.mid(6)));
         } else {
             logger = new UMFileLogger(QString::fromLocal8Bit(metricsLogging));
         }
@@ -391,6 +408,7 @@ void UbuntuToolkitModule::defineModule()
     qmlRegisterType<UCListItemLayout>(uri, 1, 3, "ListItemLayout");
     qmlRegisterType<UCHeader>(uri, 1, 3, "Header");
     qmlRegisterType<UCLabel>(uri, 1, 3, "Label");
+    qmlRegisterType<UCIcon>(uri, 1, 3, "Icon");
     qmlRegisterType<UCBottomEdgeHint>(uri, 1, 3, "BottomEdgeHint");
     qmlRegisterType<UCBottomEdge>(uri, 1, 3, "BottomEdge");
     qmlRegisterType<UCBottomEdgeRegion>(uri, 1, 3, "BottomEdgeRegion");
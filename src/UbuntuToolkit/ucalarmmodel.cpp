@@ -228,6 +228,30 @@ UCAlarm* UCAlarmModel::get(int index)
     return alarm;
 }
 
+/*!
+ * \qmlmethod list<var> AlarmModel::exportAlarms()
+ * \since Ubuntu.Components 1.3
+ * Returns the data of all the alarms in the collection as an array of objects,
+ * in the format \l importAlarms() takes. Each object has the \c message,
+ * \c date, \c sound, \c type, \c days and \c enabled fields.
+ */
+QJsonArray UCAlarmModel::exportAlarms() const
+{
+    return AlarmManager::instance().exportAlarms();
+}
+
+/*!
+ * \qmlmethod int AlarmModel::importAlarms(list<var> alarms)
+ * \since Ubuntu.Components 1.3
+ * Saves the \a alarms given as an array of objects, in the format returned by
+ * \l exportAlarms(), in a single batch. Returns the number of alarms saved.
+ * The model is updated when the alarms are stored in the collection.
+ */
+int UCAlarmModel::importAlarms(const QJsonArray &alarms)
+{
+    return AlarmManager::instance().importAlarms(alarms);
+}
+
 /*!
  * \qmlproperty int AlarmModel::count
  * The number of data entries in the model.
@@ -20,6 +20,7 @@
 #define UCALARMSMODEL_P_H
 
 #include <QtCore/QAbstractListModel>
+#include <QtCore/QJsonArray>
 #include <QtQml/QQmlParserStatus>
 
 #include <UbuntuToolkit/private/ucalarm_p_p.h>
@@ -46,6 +47,8 @@ public:
 
     // invokables
     Q_INVOKABLE UT_PREPEND_NAMESPACE(UCAlarm) *get(int index);
+    Q_INVOKABLE QJsonArray exportAlarms() const;
+    Q_INVOKABLE int importAlarms(const QJsonArray &alarms);
 
     // property getters
     int count() const;
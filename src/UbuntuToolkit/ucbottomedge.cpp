@@ -58,6 +58,8 @@ UCBottomEdgePrivate::UCBottomEdgePrivate()
     , mousePressed(false)
     , preloadContent(false)
 {
+    // the panel is set up right after the style is loaded
+    asyncStyleCapable = false;
 }
 
 void UCBottomEdgePrivate::init()
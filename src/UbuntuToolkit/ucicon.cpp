@@ -0,0 +1,418 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ucicon_p.h"
+
+#include <QtCore/QCache>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QtMath>
+#include <QtQml/QQmlInfo>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGSimpleTextureNode>
+
+UT_NAMESPACE_BEGIN
+
+// colorized images, in kilobytes
+const int colorizedImageCacheSize = 4 * 1024;
+const QRgb transparentColor = qRgba(0, 0, 0, 0);
+const QRgb defaultKeyColor = qRgba(0x80, 0x80, 0x80, 0xff);
+// distance in the normalized RGB space under which a pixel matches the key color
+const float keyColorThreshold = 0.1f;
+
+/*
+ * Least recently used colorized images, keyed by the source image and the
+ * colors. Only used from the GUI thread.
+ */
+class ColorizedImageCache : public QCache<QString, QImage>
+{
+public:
+    ColorizedImageCache()
+        : QCache<QString, QImage>(colorizedImageCacheSize)
+    {}
+};
+Q_GLOBAL_STATIC(ColorizedImageCache, colorizedImageCache)
+
+/*
+ * Textures of the icon images, shared by all the icons of a window showing the
+ * same image. The textures are created with TextureCanUseAtlas, small icons
+ * then end up in the atlas of the window and get batched together. Only used
+ * from the render threads, a texture is deleted once no icon shows it anymore.
+ */
+struct IconTexture {
+    QSGTexture *texture;
+    int refCount;
+};
+typedef QHash<qint64, IconTexture> IconTextureHash;
+static QHash<QQuickWindow*, IconTextureHash> iconTextures;
+static QMutex iconTexturesMutex;
+
+static QSGTexture *acquireIconTexture(QQuickWindow *window, const QImage &image)
+{
+    QMutexLocker lock(&iconTexturesMutex);
+    IconTexture &entry = iconTextures[window][image.cacheKey()];
+    if (!entry.refCount) {
+        entry.texture = window->createTextureFromImage(image, QQuickWindow::TextureCanUseAtlas);
+    }
+    entry.refCount++;
+    return entry.texture;
+}
+
+static void releaseIconTexture(QQuickWindow *window, qint64 imageKey)
+{
+    QMutexLocker lock(&iconTexturesMutex);
+    IconTextureHash::iterator it = iconTextures[window].find(imageKey);
+    Q_ASSERT(it != iconTextures[window].end());
+    if (--it.value().refCount == 0) {
+        delete it.value().texture;
+        iconTextures[window].erase(it);
+        if (iconTextures[window].isEmpty()) {
+            iconTextures.remove(window);
+        }
+    }
+}
+
+class UCIconNode : public QSGSimpleTextureNode
+{
+public:
+    UCIconNode(QQuickWindow *window)
+        : m_window(window)
+        , m_imageKey(0)
+    {
+        setOwnsTexture(false);
+        setFiltering(QSGTexture::Linear);
+    }
+    ~UCIconNode()
+    {
+        if (m_imageKey) {
+            releaseIconTexture(m_window, m_imageKey);
+        }
+    }
+
+    void setImage(const QImage &image)
+    {
+        if (image.cacheKey() == m_imageKey) {
+            return;
+        }
+        QSGTexture *texture = acquireIconTexture(m_window, image);
+        if (m_imageKey) {
+            releaseIconTexture(m_window, m_imageKey);
+        }
+        m_imageKey = image.cacheKey();
+        setTexture(texture);
+    }
+
+private:
+    QQuickWindow *m_window;
+    qint64 m_imageKey;
+};
+
+/*!
+    \qmltype Icon
+    \instantiates UCIcon
+    \inqmlmodule Ubuntu.Components 1.3
+    \inherits Item
+    \ingroup ubuntu
+    \brief The Icon component displays an icon from the icon theme.
+
+    The icon theme contains a set of standard icons referred to by their name.
+    Using icons whenever possible enhances consistency accross applications.
+    Each icon has a name and can have different visual representations depending
+    on the size requested.
+
+    Icons can also be colorized. Setting the \l color property will make all pixels
+    with the \l keyColor (by default #808080) colored.
+
+    Example:
+    \qml
+    Icon {
+        width: 64
+        height: 64
+        name: "search"
+    }
+    \endqml
+
+    Example of colorization:
+    \qml
+    Icon {
+        width: 64
+        height: 64
+        name: "search"
+        color: UbuntuColors.warmGrey
+    }
+    \endqml
+
+    The colorized images are computed once per image and colors, and are shared
+    by all the icons showing them. Icons sharing the same image also share the
+    same texture, small icons being rendered in batches.
+
+    Icon themes are created following the
+    \l{http://standards.freedesktop.org/icon-theme-spec/icon-theme-spec-latest.html}{Freedesktop Icon Theme Specification}.
+*/
+UCIcon::UCIcon(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_color(QColor::fromRgba(transparentColor))
+    , m_keyColor(QColor::fromRgba(defaultKeyColor))
+    , m_asynchronous(false)
+    , m_sourceSet(false)
+{
+    setFlag(ItemHasContents);
+}
+
+/*!
+    \qmlproperty string Icon::name
+    The name of the icon to display.
+
+    If both name and source are set, name will be ignored.
+
+    \note The complete list of icons available in Ubuntu is not published yet.
+        For now please refer to the folders where the icon themes are installed:
+        \list
+          \li Ubuntu Touch: \l file:/usr/share/icons/suru
+          \li Ubuntu Desktop: \l file:/usr/share/icons/ubuntu-mono-dark
+        \endlist
+        These 2 separate icon themes will be merged soon.
+*/
+void UCIcon::setName(const QString &name)
+{
+    if (m_name == name) {
+        return;
+    }
+    m_name = name;
+    Q_EMIT nameChanged();
+    if (!m_sourceSet) {
+        Q_EMIT sourceChanged();
+        reload();
+    }
+}
+
+/*!
+    \qmlproperty color Icon::color
+    The color that all pixels that originally are of color \l keyColor should take.
+*/
+void UCIcon::setColor(const QColor &color)
+{
+    if (m_color == color) {
+        return;
+    }
+    m_color = color;
+    updateImage();
+    Q_EMIT colorChanged();
+}
+
+/*!
+    \qmlproperty color Icon::keyColor
+    The color of the pixels that should be colorized.
+    By default it is set to #808080.
+*/
+void UCIcon::setKeyColor(const QColor &color)
+{
+    if (m_keyColor == color) {
+        return;
+    }
+    m_keyColor = color;
+    updateImage();
+    Q_EMIT keyColorChanged();
+}
+
+/*!
+    \qmlproperty url Icon::source
+    \since Ubuntu.Components 1.1
+    The source url of the icon to display. It has precedence over name.
+
+    If both name and source are set, name will be ignored.
+*/
+QUrl UCIcon::source() const
+{
+    if (m_sourceSet) {
+        return m_source;
+    }
+    if (!isComponentComplete() || m_name.isEmpty()) {
+        return QUrl();
+    }
+    return QUrl(QStringLiteral("image://theme/") + m_name);
+}
+void UCIcon::setSource(const QUrl &source)
+{
+    if (m_sourceSet && m_source == source) {
+        return;
+    }
+    m_sourceSet = true;
+    m_source = source;
+    Q_EMIT sourceChanged();
+    reload();
+}
+
+/*!
+    \qmlproperty bool Icon::asynchronous
+    The property drives the image loading of the icon. Defaults to false.
+*/
+void UCIcon::setAsynchronous(bool asynchronous)
+{
+    if (m_asynchronous == asynchronous) {
+        return;
+    }
+    m_asynchronous = asynchronous;
+    Q_EMIT asynchronousChanged();
+}
+
+void UCIcon::componentComplete()
+{
+    QQuickItem::componentComplete();
+    if (!m_sourceSet && !m_name.isEmpty()) {
+        Q_EMIT sourceChanged();
+    }
+    reload();
+}
+
+void UCIcon::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        reload();
+    }
+}
+
+void UCIcon::itemChange(ItemChange change, const ItemChangeData &data)
+{
+    if (change == ItemDevicePixelRatioHasChanged) {
+        reload();
+    }
+    QQuickItem::itemChange(change, data);
+}
+
+// the icon is loaded before the next frame, once all the properties are set
+void UCIcon::reload()
+{
+    if (isComponentComplete()) {
+        polish();
+    }
+}
+
+void UCIcon::updatePolish()
+{
+    const QUrl url = source();
+    const qreal ratio = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    const QSize requestedSize(qCeil(width() * ratio), qCeil(height() * ratio));
+    if (url == m_pixmap.url() && requestedSize == m_requestedSize && !m_pixmap.isLoading()) {
+        return;
+    }
+    m_requestedSize = requestedSize;
+    if (url.isEmpty()) {
+        m_pixmap.clear(this);
+        pixmapLoaded();
+        return;
+    }
+    QQuickPixmap::Options options = QQuickPixmap::Cache;
+    if (m_asynchronous) {
+        options |= QQuickPixmap::Asynchronous;
+    }
+    m_pixmap.clear(this);
+    m_pixmap.load(qmlEngine(this), url, requestedSize, options);
+    if (m_pixmap.isLoading()) {
+        m_pixmap.connectFinished(this, SLOT(pixmapLoaded()));
+    } else {
+        pixmapLoaded();
+    }
+}
+
+void UCIcon::pixmapLoaded()
+{
+    if (m_pixmap.isError()) {
+        qmlWarning(this) << m_pixmap.error();
+    }
+    const qreal ratio = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    const QSize size = m_pixmap.isReady() ? m_pixmap.implicitSize() : QSize();
+    setImplicitSize(size.width() / ratio, size.height() / ratio);
+    updateImage();
+}
+
+void UCIcon::updateImage()
+{
+    const QImage image = m_pixmap.isReady() ? m_pixmap.image() : QImage();
+    if (image.isNull() || m_color.rgba() == transparentColor) {
+        m_image = image;
+    } else {
+        const QString key = QStringLiteral("%1#%2#%3").arg(image.cacheKey())
+            .arg(m_color.rgba(), 8, 16, QLatin1Char('0')).arg(m_keyColor.rgba(), 8, 16, QLatin1Char('0'));
+        QImage *cached = colorizedImageCache->object(key);
+        if (!cached) {
+            cached = new QImage(colorize(image, m_color, m_keyColor));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+            colorizedImageCache->insert(key, cached, qMax(1, static_cast<int>(cached->sizeInBytes() / 1024)));
+#else
+            colorizedImageCache->insert(key, cached, qMax(1, cached->byteCount() / 1024));
+#endif
+        }
+        m_image = *cached;
+    }
+    update();
+}
+
+/*
+ * Same as the shader used before: the pixels whose color is close enough to
+ * the key color take the color, with the source alpha.
+ */
+QImage UCIcon::colorize(const QImage &image, const QColor &color, const QColor &keyColor)
+{
+    QImage result = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const float keyRed = keyColor.redF();
+    const float keyGreen = keyColor.greenF();
+    const float keyBlue = keyColor.blueF();
+    const float threshold = keyColorThreshold * keyColorThreshold;
+    const QRgb rgba = color.rgba();
+
+    for (int y = 0; y < result.height(); y++) {
+        QRgb *line = reinterpret_cast<QRgb*>(result.scanLine(y));
+        for (int x = 0; x < result.width(); x++) {
+            const int alpha = qAlpha(line[x]);
+            if (!alpha) {
+                continue;
+            }
+            const float red = qRed(line[x]) / float(alpha) - keyRed;
+            const float green = qGreen(line[x]) / float(alpha) - keyGreen;
+            const float blue = qBlue(line[x]) / float(alpha) - keyBlue;
+            if (red * red + green * green + blue * blue < threshold) {
+                line[x] = qRgba((qRed(rgba) * alpha + 127) / 255, (qGreen(rgba) * alpha + 127) / 255,
+                                (qBlue(rgba) * alpha + 127) / 255, (qAlpha(rgba) * alpha + 127) / 255);
+            }
+        }
+    }
+    return result;
+}
+
+QSGNode *UCIcon::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data)
+{
+    Q_UNUSED(data);
+
+    if (m_image.isNull() || width() <= 0 || height() <= 0) {
+        delete oldNode;
+        return Q_NULLPTR;
+    }
+
+    UCIconNode *node = static_cast<UCIconNode*>(oldNode);
+    if (!node) {
+        node = new UCIconNode(window());
+    }
+    node->setImage(m_image);
+
+    // fit the image keeping its aspect ratio, centered
+    QSizeF size = QSizeF(m_image.size()).scaled(QSizeF(width(), height()), Qt::KeepAspectRatio);
+    node->setRect(QRectF(QPointF((width() - size.width()) / 2, (height() - size.height()) / 2), size));
+    return node;
+}
+
+UT_NAMESPACE_END
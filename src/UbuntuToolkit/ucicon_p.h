@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UCICON_P_H
+#define UCICON_P_H
+
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/private/qquickpixmapcache_p.h>
+
+#include <UbuntuToolkit/ubuntutoolkitglobal.h>
+
+UT_NAMESPACE_BEGIN
+
+class UBUNTUTOOLKIT_EXPORT UCIcon : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QString name READ name WRITE setName NOTIFY nameChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QColor keyColor READ keyColor WRITE setKeyColor NOTIFY keyColorChanged)
+    Q_PROPERTY(QUrl source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
+public:
+    explicit UCIcon(QQuickItem *parent = 0);
+
+    QString name() const
+    {
+        return m_name;
+    }
+    void setName(const QString &name);
+    QColor color() const
+    {
+        return m_color;
+    }
+    void setColor(const QColor &color);
+    QColor keyColor() const
+    {
+        return m_keyColor;
+    }
+    void setKeyColor(const QColor &color);
+    QUrl source() const;
+    void setSource(const QUrl &source);
+    bool asynchronous() const
+    {
+        return m_asynchronous;
+    }
+    void setAsynchronous(bool asynchronous);
+
+    static QImage colorize(const QImage &image, const QColor &color, const QColor &keyColor);
+
+Q_SIGNALS:
+    void nameChanged();
+    void colorChanged();
+    void keyColorChanged();
+    void sourceChanged();
+    void asynchronousChanged();
+
+protected:
+    void componentComplete() override;
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void itemChange(ItemChange change, const ItemChangeData &data) override;
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+
+private Q_SLOTS:
+    void pixmapLoaded();
+
+private:
+    void reload();
+    void updateImage();
+
+    QQuickPixmap m_pixmap;
+    // the image rendered, colorized or not, shared with the other icons
+    QImage m_image;
+    QUrl m_source;
+    QString m_name;
+    QColor m_color;
+    QColor m_keyColor;
+    QSize m_requestedSize;
+    bool m_asynchronous:1;
+    bool m_sourceSet:1;
+
+    Q_DISABLE_COPY(UCIcon)
+};
+
+UT_NAMESPACE_END
+
+#endif // UCICON_P_H
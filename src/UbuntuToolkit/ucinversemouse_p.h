@@ -28,6 +28,7 @@ class UBUNTUTOOLKIT_EXPORT UCInverseMouse : public UCMouse {
     Q_OBJECT
 public:
     explicit UCInverseMouse(QObject *parent = 0);
+    ~UCInverseMouse();
 
     static UCInverseMouse *qmlAttachedProperties(QObject *owner);
 
@@ -138,7 +138,7 @@ QSGNode *UCListItemDivider::updatePaintNode(QSGNode *node, UpdatePaintNodeData *
     }
 
     UCListItemPrivate *pListItem = UCListItemPrivate::get(d->listItem);
-    bool lastItem = pListItem->countOwner ? (pListItem->index() == (pListItem->countOwner->property("count").toInt() - 1)): false;
+    bool lastItem = pListItem->countOwner ? (pListItem->index() == (pListItem->count() - 1)): false;
     if (!lastItem && ((d->colorFrom.alphaF() >= (1.0f / 255.0f)) || (d->colorTo.alphaF() >= (1.0f / 255.0f)))) {
         dividerNode->setRect(boundingRect());
         if (d->gradient.size() > 0) {
@@ -216,6 +216,8 @@ UCListItemPrivate::UCListItemPrivate()
 {
     // the ListItem is not a focus scope
     isFocusScope = false;
+    // the panels are set up right after the style is loaded
+    asyncStyleCapable = false;
 }
 UCListItemPrivate::~UCListItemPrivate()
 {
@@ -245,9 +247,8 @@ void UCListItemPrivate::init()
     QObject::connect(q, SIGNAL(themeChanged()),
                      q, SLOT(_q_themeChanged()), Qt::DirectConnection);
 
-    // watch grid unit size change and set implicit size
-    QObject::connect(UCUnits::instance(), SIGNAL(gridUnitChanged()), q, SLOT(_q_updateSize()));
-    _q_updateSize();
+    // set implicit size, grid unit changes are followed by the ViewItems
+    updateSize();
     styleDocument = QStringLiteral("ListItemStyle");
 
     // create selection object
@@ -359,20 +360,27 @@ bool UCListItemPrivate::loadStyleItem(bool animated)
     return true;
 }
 
-// called when units size changes
-void UCListItemPrivate::_q_updateSize()
+// called when units size or the width of the view changes
+void UCListItemPrivate::updateSize()
 {
     Q_Q(UCListItem);
     // update divider thickness
     divider->setImplicitHeight(UCUnits::instance()->dp(DIVIDER_THICKNESS_DP));
-    QQuickItem *owner = qobject_cast<QQuickItem*>(q->sender());
-    if (!owner && parentAttached) {
-        owner = static_cast<QQuickItem*>(parentAttached->parent());
-    }
-    q->setImplicitWidth(owner ? owner->width() : UCUnits::instance()->gu(IMPLICIT_LISTITEM_WIDTH_GU));
+    qreal width = parentAttached ? UCViewItemsAttachedPrivate::get(parentAttached)->width : -1;
+    q->setImplicitWidth(width >= 0 ? width : UCUnits::instance()->gu(IMPLICIT_LISTITEM_WIDTH_GU));
     q->setImplicitHeight(UCUnits::instance()->gu(IMPLICIT_LISTITEM_HEIGHT_GU));
 }
 
+// the count of the view is cached by the ViewItems when that owns it
+int UCListItemPrivate::count()
+{
+    UCViewItemsAttachedPrivate *viewItems = UCViewItemsAttachedPrivate::get(parentAttached);
+    if (viewItems && viewItems->isCountOwner(countOwner)) {
+        return viewItems->count;
+    }
+    return countOwner ? countOwner->property("count").toInt() : 0;
+}
+
 // returns the index of the list item when used in model driven views,
 // and the child index in other cases
 int UCListItemPrivate::index()
@@ -1005,6 +1013,10 @@ UCListItem::UCListItem(QQuickItem *parent)
 
 UCListItem::~UCListItem()
 {
+    Q_D(UCListItem);
+    if (d->parentAttached) {
+        UCViewItemsAttachedPrivate::get(d->parentAttached)->trackListItem(this, false);
+    }
 }
 
 // override keyNavigationFocus getter
@@ -1059,8 +1071,16 @@ void UCListItem::componentComplete()
                 d->flickable :
                 (d->parentItem && d->parentItem->property("count").isValid()) ? d->parentItem : 0;
     if (d->countOwner) {
-        QObject::connect(d->countOwner.data(), SIGNAL(countChanged()),
-                         this, SLOT(_q_updateIndex()), Qt::DirectConnection);
+        UCViewItemsAttachedPrivate *viewItems = UCViewItemsAttachedPrivate::get(d->parentAttached);
+        if (viewItems && viewItems->isCountOwner(d->countOwner)) {
+            // the ViewItems updates the ListItems which become or stop being the last one
+            if (d->index() == viewItems->count - 1) {
+                viewItems->lastListItem = this;
+            }
+        } else {
+            QObject::connect(d->countOwner.data(), SIGNAL(countChanged()),
+                             this, SLOT(_q_updateIndex()), Qt::DirectConnection);
+        }
         update();
     }
 
@@ -1097,11 +1117,12 @@ void UCListItem::itemChange(ItemChange change, const ItemChangeData &data)
         }
 
         // attach ViewItems to parent item or to ListView
-        QQuickItem *parentAttachee = data.item;
+        if (d->parentAttached) {
+            UCViewItemsAttachedPrivate::get(d->parentAttached)->trackListItem(this, false);
+        }
         if (d->flickable && d->flickable->inherits("QQuickListView")) {
             // attach to ListView
             d->parentAttached = static_cast<UCViewItemsAttached*>(attachedViewItems(d->flickable, true));
-            parentAttachee = d->flickable;
         } else if (data.item) {
             d->parentAttached = static_cast<UCViewItemsAttached*>(attachedViewItems(data.item, true));
         } else {
@@ -1117,19 +1138,17 @@ void UCListItem::itemChange(ItemChange change, const ItemChangeData &data)
         }
 
         if (d->parentAttached) {
+            UCViewItemsAttachedPrivate::get(d->parentAttached)->trackListItem(this, true);
             d->selection->attachToViewItems(d->parentAttached.data());
-            connect(d->parentAttached.data(), SIGNAL(expandedIndicesChanged(QList<int>)),
-                    this, SLOT(_q_updateExpansion(QList<int>)), Qt::DirectConnection);
+            connect(d->parentAttached.data(), SIGNAL(expansionRangesChanged(QVariantList,QVariantList)),
+                    this, SLOT(_q_updateExpansion()), Qt::DirectConnection);
             // if the ViewItems is attached to a ListView, disable tab stops on the ListItem
             setActiveFocusOnTab(!d->parentAttached->isAttachedToListView());
             d->isTabFence = d->parentAttached->isAttachedToListView();
         }
 
-        if (parentAttachee) {
-            QObject::connect(parentAttachee, SIGNAL(widthChanged()), this, SLOT(_q_updateSize()), Qt::DirectConnection);
-            // update size
-            d->_q_updateSize();
-        }
+        // the ViewItems follows the width changes
+        d->updateSize();
     }
 }
 
@@ -1954,12 +1973,12 @@ UCListItemExpansion *UCListItem::expansion()
     return d->expansion;
 }
 
-void UCListItemPrivate::_q_updateExpansion(const QList<int> &indices)
+void UCListItemPrivate::_q_updateExpansion()
 {
     Q_Q(UCListItem);
     Q_EMIT q->expansion()->expandedChanged();
     // make sure the style is loaded
-    if (indices.contains(index())) {
+    if (q->expansion()->expanded()) {
         loadStyleItem();
     }
 }
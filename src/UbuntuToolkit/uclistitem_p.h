@@ -139,11 +139,10 @@ private:
     Q_PRIVATE_SLOT(d_func(), void _q_themeChanged())
     Q_PRIVATE_SLOT(d_func(), void _q_relayout())
     Q_PRIVATE_SLOT(d_func(), void _q_updateSwiping())
-    Q_PRIVATE_SLOT(d_func(), void _q_updateSize())
     Q_PRIVATE_SLOT(d_func(), void _q_updateIndex())
     Q_PRIVATE_SLOT(d_func(), void _q_contentMoving())
     Q_PRIVATE_SLOT(d_func(), void _q_syncDragMode())
-    Q_PRIVATE_SLOT(d_func(), void _q_updateExpansion(const QList<int> &indices))
+    Q_PRIVATE_SLOT(d_func(), void _q_updateExpansion())
     Q_PRIVATE_SLOT(d_func(), void _q_popoverClosed())
 };
 
@@ -222,6 +221,9 @@ public:
 private Q_SLOTS:
     void unbindItem();
     void completed();
+    void updateCount();
+    void updateItemsSize();
+    void updateModel();
 
 Q_SIGNALS:
     void selectModeChanged();
@@ -234,6 +236,9 @@ Q_SIGNALS:
     void expandedIndicesChanged(const QList<int> &indices);
     void expansionFlagsChanged();
     void effectiveCurrentIndexChanged();
+
+    void selectionRangesChanged(const QVariantList &added, const QVariantList &removed);
+    void expansionRangesChanged(const QVariantList &added, const QVariantList &removed);
 private:
     Q_DECLARE_PRIVATE(UCViewItemsAttached)
 };
@@ -19,10 +19,15 @@
 
 #include <UbuntuToolkit/private/uclistitem_p.h>
 
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QHash>
+#include <QtCore/QMetaProperty>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
 #include <QtCore/QBasicTimer>
 #include <QtQuick/private/qquickrectangle_p.h>
 
+#include <UbuntuToolkit/private/indexranges_p.h>
 #include <UbuntuToolkit/private/uclistitemstyle_p.h>
 #include <UbuntuToolkit/private/ucstyleditembase_p_p.h>
 
@@ -60,12 +65,13 @@ public:
     void _q_relayout();
     void _q_updateSwiping();
     void setSwiped(bool swiped);
-    void _q_updateSize();
+    void updateSize();
     void _q_updateIndex();
     void _q_contentMoving();
     void _q_syncDragMode();
-    void _q_updateExpansion(const QList<int> &indices);
+    void _q_updateExpansion();
     int index();
+    int count();
     bool canHighlight();
     void setHighlighted(bool pressed);
     void listenToRebind(bool listen);
@@ -160,15 +166,39 @@ public:
     void leaveDragMode();
     bool isDragUpdatedConnected();
     void updateSelectedIndices(int fromIndex, int toIndex);
+    void attachToModel();
+    void shiftIndices(int removedAt, int insertedAt, int count);
+    void selectionChanged(const IndexRanges::RangeList &added, const IndexRanges::RangeList &removed);
 
     // expansion
     void expand(int index, UCListItem *listItem, bool emitChangeSignal = true);
     void collapse(int index, bool emitChangeSignal = true);
-    void collapseAll();
+    void collapseAll(bool emitChangeSignal = true);
     void toggleExpansionFlags(bool enable);
+    void expansionChanged(const IndexRanges::RangeList &added, const IndexRanges::RangeList &removed);
 
-    QSet<int> selectedList;
-    QMap<int, QPointer<UCListItem> > expansionList;
+    // ListItems tracking
+    void trackListItem(UCListItem *item, bool track);
+    bool isCountOwner(QObject *owner) const
+    {
+        return countProperty.isValid() && owner == parent;
+    }
+
+    IndexRanges selectedList;
+    IndexRanges expansionList;
+    // the ListItems expanded interactively
+    QHash<int, QPointer<UCListItem> > expandedItems;
+    // materialized on read
+    mutable QList<int> selectedIndices;
+    mutable QList<int> expandedIndices;
+    // the ListItems attached, with the count and width of the view cached
+    QSet<UCListItem*> listItems;
+    QPointer<UCListItem> lastListItem;
+    // the ListView model the indices follow
+    QPointer<QAbstractItemModel> model;
+    QMetaProperty countProperty;
+    int count;
+    qreal width;
     QList< QPointer<QQuickFlickable> > flickables;
     QPointer<UCListItem> boundItem;
     ListViewProxy *listView;
@@ -177,6 +207,8 @@ public:
     bool selectable:1;
     bool draggable:1;
     bool ready:1;
+    mutable bool selectedIndicesDirty:1;
+    mutable bool expandedIndicesDirty:1;
 };
 
 UT_NAMESPACE_END
@@ -1038,11 +1038,95 @@ void UCMouse::setPriority(Priority priority)
    events captured by the filter are not forwarded to the owner, hence forwarding
    those events first to the owner will not have any effect.
  */
+/*
+ * Application event filter shared by the enabled InverseMouse filters, the
+ * events none of them is interested in are rejected once instead of once per
+ * filter. The filters are called in the order they would be called if each of
+ * them had been installed on the application.
+ */
+class InverseMouseFilterHost : public QObject
+{
+public:
+    static void addFilter(UCInverseMouse *filter)
+    {
+        if (!m_instance) {
+            m_instance = new InverseMouseFilterHost(QGuiApplication::instance());
+        }
+        m_instance->m_filters.removeAll(QPointer<UCInverseMouse>());
+        if (m_instance->m_filters.isEmpty()) {
+            QGuiApplication::instance()->installEventFilter(m_instance);
+        }
+        m_instance->m_filters.prepend(filter);
+    }
+    static void removeFilter(UCInverseMouse *filter)
+    {
+        if (!m_instance) {
+            return;
+        }
+        m_instance->m_filters.removeAll(filter);
+        m_instance->m_filters.removeAll(QPointer<UCInverseMouse>());
+        if (m_instance->m_filters.isEmpty()) {
+            QGuiApplication::instance()->removeEventFilter(m_instance);
+        }
+    }
+
+protected:
+    explicit InverseMouseFilterHost(QObject *parent)
+        : QObject(parent)
+    {
+    }
+
+    bool eventFilter(QObject *target, QEvent *event) override
+    {
+        QEvent::Type type = event->type();
+        switch (type) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        case QEvent::HoverEnter:
+        case QEvent::HoverMove:
+        case QEvent::HoverLeave:
+            break;
+        default:
+            if (type != ForwardedEvent::baseType()) {
+                return false;
+            }
+            break;
+        }
+        // MouseArea and InverseMouseArea targets are excluded by all filters
+        if (qobject_cast<QQuickMouseArea*>(target)) {
+            return false;
+        }
+        // the filters may get enabled or disabled by the signal handlers
+        const QList<QPointer<UCInverseMouse> > filters(m_filters);
+        for (const QPointer<UCInverseMouse> &filter : filters) {
+            if (filter && filter->isEnabled() && static_cast<QObject*>(filter.data())->eventFilter(target, event)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static QPointer<InverseMouseFilterHost> m_instance;
+    QList<QPointer<UCInverseMouse> > m_filters;
+};
+
+QPointer<InverseMouseFilterHost> InverseMouseFilterHost::m_instance;
+
 UCInverseMouse::UCInverseMouse(QObject *parent)
     : UCMouse(parent)
 {
 }
 
+UCInverseMouse::~UCInverseMouse()
+{
+    if (m_enabled) {
+        InverseMouseFilterHost::removeFilter(this);
+    }
+}
+
 UCInverseMouse *UCInverseMouse::qmlAttachedProperties(QObject *owner)
 {
     return createAttachedFilter<UCInverseMouse>(owner, QStringLiteral("InverseMouse"));
@@ -1117,9 +1201,9 @@ void UCInverseMouse::setEnabled(bool enabled)
         if (m_enabled) {
             // FIXME: use application's main till we don't get touch events
             // forwarded to the QQuickItem
-            QGuiApplication::instance()->installEventFilter(this);
+            InverseMouseFilterHost::addFilter(this);
         } else {
-            QGuiApplication::instance()->removeEventFilter(this);
+            InverseMouseFilterHost::removeFilter(this);
         }
         Q_EMIT enabledChanged();
     }
@@ -18,9 +18,12 @@
 
 #include "ucqquickimageextension_p.h"
 
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDir>
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QTemporaryDir>
 #include <QtGui/QGuiApplication>
 #include <QtQuick/private/qquickitem_p.h>
 #include <QtQuick/private/qquickimagebase_p.h>
@@ -34,7 +37,32 @@
 
 UT_NAMESPACE_BEGIN
 
-QHash<QUrl, QSharedPointer<QTemporaryFile> > UCQQuickImageExtension::s_rewrittenSciFiles;
+/*
+ * Rewritten .sci files. BorderImage only reads .sci files from disk, so the
+ * rewritten content is written once into a temporary directory, removed when
+ * the application exits, to a file named after the hash of the content. Source
+ * files and scale factors giving the same content share that file, and a grid
+ * unit change gets a new file instead of the one rewritten at the old scale.
+ * Only used from the GUI thread.
+ */
+class RewrittenSciFileCache
+{
+public:
+    // rewritten file paths by scale factor and source .sci file path
+    QHash<QString, QString> files;
+    // rewritten file paths by content hash
+    QHash<QByteArray, QString> contents;
+    QTemporaryDir directory;
+};
+Q_GLOBAL_STATIC(RewrittenSciFileCache, rewrittenSciFileCache)
+
+// Asynchronous images are decoded in a thread pool by "scaling-async", the
+// engine never loads the images of an asynchronous provider synchronously.
+static QString scalingProviderUrl(QQuickImageBase *image)
+{
+    return image->asynchronous()
+        ? QStringLiteral("image://scaling-async/") : QStringLiteral("image://scaling/");
+}
 
 /*!
     \internal
@@ -59,6 +87,12 @@ UCQQuickImageExtension::UCQQuickImageExtension(QObject *parent) :
     if (m_image) {
         QObject::connect(m_image, &QQuickImageBase::sourceChanged,
                          this, &UCQQuickImageExtension::extendedSourceChanged);
+        // the scaled images are loaded by a different provider when asynchronous
+        QObject::connect(m_image, &QQuickImageBase::asynchronousChanged, this, [this]() {
+            if (QQuickItemPrivate::get(m_image)->componentComplete) {
+                reloadSource();
+            }
+        });
     }
 }
 
@@ -117,7 +151,8 @@ void UCQQuickImageExtension::reloadSource()
     // If the url we're trying to load is already in the cache and
     // the devicePixelRatio is 1, we save calling UCUnits::resolveResource
     // and just set that image directly.
-    // UCUnits::resolveResource is not cheap (does a stat on disk)
+    // UCUnits::resolveResource uses a cached listing of the directory but
+    // still parses the url and path and matches the grid unit variants
     if (qFuzzyCompare(qGuiApp->devicePixelRatio(), (qreal)1.0)) {
         QSize ss = m_image->sourceSize();
         if (ss.isNull() && m_image->image().isNull()) {
@@ -164,7 +199,7 @@ void UCQQuickImageExtension::reloadSource()
         } else {
             // Need to scale the pixel-based image to suit the devicePixelRatio setting ourselves.
             // If we let Qt do it, Qt will not choose the UITK-supported "@gu" scaled images.
-            m_image->setSource(QUrl("image://scaling/1/" + selectedFilePath + fragment));
+            m_image->setSource(QUrl(scalingProviderUrl(m_image) + "1/" + selectedFilePath + fragment));
             // explicitly set the source size in the QQuickImageBase, this persuades it that the
             // supplied image is suitable for the current devicePixelRatio.
             m_image->setSourceSize(m_image->sourceSize());
@@ -173,37 +208,20 @@ void UCQQuickImageExtension::reloadSource()
         // Prepend "image://scaling" for the image to be loaded by UCScalingImageProvider.
         if (!m_source.path().endsWith(QStringLiteral(".sci"))) {
           // Regular image file
-            m_image->setSource(QUrl("image://scaling/" + resolved + fragment));
+            m_image->setSource(QUrl(scalingProviderUrl(m_image) + resolved + fragment));
         } else {
-            // .sci image file. Rewrite the .sci file into a temporary file.
-            bool rewritten = true;
-            QTemporaryFile* rewrittenSciFile;
-
-            /* Ensure that only one temporary rewritten .sci file is created
-               for each source .sci file by storing the path to the temporary
-               file in a global hash.
-            */
-            rewrittenSciFile = UCQQuickImageExtension::s_rewrittenSciFiles.value(m_source).data();
-            if (rewrittenSciFile == NULL) {
-                rewrittenSciFile = new QTemporaryFile;
-                rewrittenSciFile->setFileTemplate(QDir::tempPath() + "/XXXXXX.sci");
-                rewrittenSciFile->open();
-                QTextStream output(rewrittenSciFile);
-
-                if (qFuzzyCompare(qGuiApp->devicePixelRatio(), (qreal)1.0)) {
-                    rewritten = rewriteSciFile(selectedFilePath, scaleFactor, output);
-                } else {
-                    QString scaleFactorInDevicePixels = QString::number(scaleFactor.toFloat() / qGuiApp->devicePixelRatio());
-                    rewritten = rewriteSciFile(selectedFilePath, scaleFactorInDevicePixels, output);
-                }
-                rewrittenSciFile->close();
-
-                s_rewrittenSciFiles.insert(m_source, QSharedPointer<QTemporaryFile>(rewrittenSciFile));
+            // .sci image file. Rewrite it with scaled borders and sources.
+            QString rewrittenSciFilePath;
+            if (qFuzzyCompare(qGuiApp->devicePixelRatio(), (qreal)1.0)) {
+                rewrittenSciFilePath = rewrittenSciFile(selectedFilePath, scaleFactor);
+            } else {
+                QString scaleFactorInDevicePixels = QString::number(scaleFactor.toFloat() / qGuiApp->devicePixelRatio());
+                rewrittenSciFilePath = rewrittenSciFile(selectedFilePath, scaleFactorInDevicePixels);
             }
 
-            if (rewritten) {
+            if (!rewrittenSciFilePath.isEmpty()) {
                 // Take care to pass the original fragment
-                QUrl rewrittenSciFileUrl(QUrl::fromLocalFile(rewrittenSciFile->fileName()));
+                QUrl rewrittenSciFileUrl(QUrl::fromLocalFile(rewrittenSciFilePath));
                 rewrittenSciFileUrl.setFragment(fragment);
                 m_image->setSource(rewrittenSciFileUrl);
             } else {
@@ -216,6 +234,41 @@ void UCQQuickImageExtension::reloadSource()
     }
 }
 
+/*
+    Returns the path of the file holding the .sci file at \a sciFilePath
+    rewritten for \a scaleFactor, or an empty string if it could not be
+    rewritten. Each source and scale factor is only rewritten once.
+*/
+QString UCQQuickImageExtension::rewrittenSciFile(const QString &sciFilePath, const QString &scaleFactor)
+{
+    RewrittenSciFileCache *cache = rewrittenSciFileCache();
+    const QString key = scaleFactor + "/" + sciFilePath;
+    QHash<QString, QString>::const_iterator it = cache->files.constFind(key);
+    if (it != cache->files.constEnd()) {
+        return it.value();
+    }
+
+    QString path;
+    QByteArray content;
+    QTextStream output(&content);
+    if (rewriteSciFile(sciFilePath, scaleFactor, output) && cache->directory.isValid()) {
+        output.flush();
+        const QByteArray hash = QCryptographicHash::hash(content, QCryptographicHash::Sha1).toHex();
+        path = cache->contents.value(hash);
+        if (path.isEmpty()) {
+            QFile file(cache->directory.filePath(QString::fromLatin1(hash) + ".sci"));
+            if (file.open(QIODevice::WriteOnly) && file.write(content) == content.size()) {
+                path = file.fileName();
+                cache->contents.insert(hash, path);
+            }
+        }
+        if (!path.isEmpty()) {
+            cache->files.insert(key, path);
+        }
+    }
+    return path;
+}
+
 bool UCQQuickImageExtension::rewriteSciFile(const QString &sciFilePath, const QString &scaleFactor, QTextStream& output)
 {
     QFile sciFile(sciFilePath);
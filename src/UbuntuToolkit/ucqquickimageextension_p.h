@@ -22,8 +22,6 @@
 #include <QtCore/QEvent>
 #include <QtCore/QByteArray>
 #include <QtCore/QObject>
-#include <QtCore/QSharedPointer>
-#include <QtCore/QTemporaryFile>
 #include <QtCore/QTextStream>
 #include <QtCore/QUrl>
 
@@ -52,6 +50,7 @@ protected Q_SLOTS:
     void onSourceSizeChanged();
 
 protected:
+    QString rewrittenSciFile(const QString &sciFilePath, const QString &scaleFactor);
     bool rewriteSciFile(const QString &sciFilePath, const QString &scaleFactor, QTextStream& output);
     QString scaledBorder(const QString &border, const QString &scaleFactor);
     QString scaledSource(QString source, const QString &sciFilePath, const QString &scaleFactor);
@@ -59,7 +58,6 @@ protected:
 private:
     QQuickImageBase* m_image;
     QUrl m_source;
-    static QHash<QUrl, QSharedPointer<QTemporaryFile> > s_rewrittenSciFiles;
 };
 
 UT_NAMESPACE_END
@@ -18,11 +18,205 @@
 
 #include "ucscalingimageprovider_p.h"
 
+#include <QtCore/QDateTime>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QRunnable>
 #include <QtGui/QImageReader>
 
 UT_NAMESPACE_BEGIN
 
+// cost of an image in the cache, in kilobytes
+static int imageCost(const QImage &image)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    return qMax(1, static_cast<int>(image.sizeInBytes() / 1024));
+#else
+    return qMax(1, image.byteCount() / 1024);
+#endif
+}
+
+class ScalingImageResponse : public QQuickImageResponse
+{
+public:
+    ScalingImageResponse(const QSharedPointer<UCScalingImageCache> &cache)
+        : m_cache(cache)
+    {}
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+    QString errorString() const override
+    {
+        return m_image.isNull() ? QStringLiteral("Cannot load image") : QString();
+    }
+    void cancel() override
+    {
+        m_cache->cancel(this);
+    }
+
+    // Must be called once, the engine deletes the response when finished. The
+    // signal is queued since the engine only connects to it once the response
+    // is returned, a cached image or a fast decoding would otherwise finish
+    // before that.
+    void finish(const QImage &image)
+    {
+        m_image = image;
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+    }
+
+private:
+    // keeps the cache alive if the engine deletes the provider first
+    QSharedPointer<UCScalingImageCache> m_cache;
+    QImage m_image;
+};
+
+// The cache waits for its jobs to be done before being deleted.
+class ScalingImageJob : public QRunnable
+{
+public:
+    ScalingImageJob(UCScalingImageCache *cache, const QString &key, const QString &id,
+                    const QSize &requestedSize)
+        : m_cache(cache)
+        , m_key(key)
+        , m_id(id)
+        , m_requestedSize(requestedSize)
+    {}
+
+    void run() override
+    {
+        QSize size;
+        const QImage image = UCScalingImageCache::decode(m_id, &size, m_requestedSize);
+        m_cache->decodingDone(m_key, image, size);
+    }
+
+private:
+    UCScalingImageCache *m_cache;
+    QString m_key;
+    QString m_id;
+    QSize m_requestedSize;
+};
+
+/*!
+    \internal
+
+    The UCScalingImageCache class keeps the scaled images in a cache bounded in
+    bytes. Asynchronous requests are decoded in a small thread pool, identical
+    requests made while an image is being decoded wait for that single
+    decoding.
+*/
+UCScalingImageCache::UCScalingImageCache()
+    : m_cache(imageCacheSize)
+{
+    m_threadPool.setMaxThreadCount(maxDecodingThreads);
+    m_clock.start();
+}
+
+UCScalingImageCache::~UCScalingImageCache()
+{
+    m_threadPool.waitForDone();
+}
+
+// The file modification time is part of the key so that an updated file is
+// loaded again. Must be called with the mutex locked.
+QString UCScalingImageCache::cacheKey(const QString &id, const QSize &requestedSize)
+{
+    int separatorPosition = id.indexOf(QStringLiteral("/"));
+    int fragmentPosition = id.lastIndexOf(QStringLiteral("#"));
+    int pathLength = fragmentPosition > -1 ? fragmentPosition - separatorPosition - 1 : -1;
+    const QString path = id.mid(separatorPosition + 1, pathLength);
+
+    // don't stat the file on each request, images are mostly requested in bursts
+    const qint64 now = m_clock.elapsed();
+    FileStamp &stamp = m_fileStamps[path];
+    if (stamp.checked == 0 || now - stamp.checked >= fileCheckInterval) {
+        stamp.modified = QFileInfo(path).lastModified().toMSecsSinceEpoch();
+        stamp.checked = qMax(now, Q_INT64_C(1));
+    }
+    return QStringLiteral("%1@%2x%3@%4").arg(id).arg(requestedSize.width()).arg(requestedSize.height())
+        .arg(stamp.modified);
+}
+
+QImage UCScalingImageCache::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    QMutexLocker lock(&m_mutex);
+    const QString key = cacheKey(id, requestedSize);
+    const CachedImage *cached = m_cache.object(key);
+    if (cached) {
+        *size = cached->size;
+        return cached->image;
+    }
+    lock.unlock();
+
+    const QImage image = decode(id, size, requestedSize);
+    if (!image.isNull()) {
+        lock.relock();
+        CachedImage *cached = new CachedImage;
+        cached->image = image;
+        cached->size = *size;
+        m_cache.insert(key, cached, imageCost(image));
+    }
+    return image;
+}
+
+void UCScalingImageCache::requestImageResponse(ScalingImageResponse *response, const QString &id,
+                                               const QSize &requestedSize)
+{
+    QMutexLocker lock(&m_mutex);
+    const QString key = cacheKey(id, requestedSize);
+    const CachedImage *cached = m_cache.object(key);
+    if (cached) {
+        const QImage image = cached->image;
+        lock.unlock();
+        response->finish(image);
+        return;
+    }
+
+    QSharedPointer<PendingDecoding> &pending = m_pending[key];
+    if (pending) {
+        pending->responses.append(response);
+        return;
+    }
+    pending.reset(new PendingDecoding);
+    pending->responses.append(response);
+    lock.unlock();
+
+    m_threadPool.start(new ScalingImageJob(this, key, id, requestedSize));
+}
+
+void UCScalingImageCache::decodingDone(const QString &key, const QImage &image, const QSize &size)
+{
+    QMutexLocker lock(&m_mutex);
+    if (!image.isNull()) {
+        CachedImage *cached = new CachedImage;
+        cached->image = image;
+        cached->size = size;
+        m_cache.insert(key, cached, imageCost(image));
+    }
+    QSharedPointer<PendingDecoding> pending = m_pending.take(key);
+    lock.unlock();
+
+    if (pending) {
+        Q_FOREACH(ScalingImageResponse *response, pending->responses) {
+            response->finish(image);
+        }
+    }
+}
+
+// The engine still waits for the finished signal of a cancelled response.
+void UCScalingImageCache::cancel(ScalingImageResponse *response)
+{
+    QMutexLocker lock(&m_mutex);
+    for (QHash<QString, QSharedPointer<PendingDecoding> >::iterator i = m_pending.begin(); i != m_pending.end(); ++i) {
+        if (i.value()->responses.removeOne(response)) {
+            lock.unlock();
+            response->finish(QImage());
+            return;
+        }
+    }
+}
+
 /*!
     \internal
 
@@ -33,12 +227,36 @@ UT_NAMESPACE_BEGIN
 
     Example:
      * image://scaling/0.5/arrow.png
+
+    The scaled images are cached, and shared with the UCAsyncScalingImageProvider
+    registered as "scaling-async" which takes the same URLs and is used for the
+    asynchronous images.
 */
-UCScalingImageProvider::UCScalingImageProvider() : QQuickImageProvider(QQuickImageProvider::Image)
+UCScalingImageProvider::UCScalingImageProvider(const QSharedPointer<UCScalingImageCache> &cache)
+    : QQuickImageProvider(QQuickImageProvider::Image)
+    , m_cache(cache ? cache : QSharedPointer<UCScalingImageCache>(new UCScalingImageCache))
 {
 }
 
 QImage UCScalingImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
+{
+    return m_cache->requestImage(id, size, requestedSize);
+}
+
+UCAsyncScalingImageProvider::UCAsyncScalingImageProvider(const QSharedPointer<UCScalingImageCache> &cache)
+    : QQuickAsyncImageProvider()
+    , m_cache(cache ? cache : QSharedPointer<UCScalingImageCache>(new UCScalingImageCache))
+{
+}
+
+QQuickImageResponse *UCAsyncScalingImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    ScalingImageResponse *response = new ScalingImageResponse(m_cache);
+    m_cache->requestImageResponse(response, id, requestedSize);
+    return response;
+}
+
+QImage UCScalingImageCache::decode(const QString &id, QSize *size, const QSize &requestedSize)
 {
     int separatorPosition = id.indexOf(QStringLiteral("/"));
     float scaleFactor = id.left(separatorPosition).toFloat();
@@ -19,6 +19,12 @@
 #ifndef UCSCALINGIMAGEPROVIDER_P_H
 #define UCSCALINGIMAGEPROVIDER_P_H
 
+#include <QtCore/QCache>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
 #include <QtGui/QImage>
 #include <QtQuick/QQuickImageProvider>
 
@@ -26,11 +32,78 @@
 
 UT_NAMESPACE_BEGIN
 
+class ScalingImageResponse;
+
+// scaled images shared by the synchronous and asynchronous providers
+class UBUNTUTOOLKIT_EXPORT UCScalingImageCache
+{
+public:
+    UCScalingImageCache();
+    ~UCScalingImageCache();
+
+    QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize);
+
+private:
+    // scaled images, in kilobytes
+    static const int imageCacheSize = 16 * 1024;
+    static const int maxDecodingThreads = 2;
+    // the modification time of a file is checked at most once per interval
+    static const int fileCheckInterval = 1000;
+
+    struct CachedImage {
+        QImage image;
+        QSize size;
+    };
+    // responses waiting for the same image to be decoded
+    struct PendingDecoding {
+        QList<ScalingImageResponse*> responses;
+    };
+    struct FileStamp {
+        qint64 modified;
+        qint64 checked;
+    };
+
+    static QImage decode(const QString &id, QSize *size, const QSize &requestedSize);
+    QString cacheKey(const QString &id, const QSize &requestedSize);
+    void requestImageResponse(ScalingImageResponse *response, const QString &id,
+                              const QSize &requestedSize);
+    void decodingDone(const QString &key, const QImage &image, const QSize &size);
+    void cancel(ScalingImageResponse *response);
+
+    QMutex m_mutex;
+    QCache<QString, CachedImage> m_cache;
+    QHash<QString, QSharedPointer<PendingDecoding> > m_pending;
+    QHash<QString, FileStamp> m_fileStamps;
+    QElapsedTimer m_clock;
+    QThreadPool m_threadPool;
+
+    friend class UCAsyncScalingImageProvider;
+    friend class ScalingImageResponse;
+    friend class ScalingImageJob;
+};
+
 class UBUNTUTOOLKIT_EXPORT UCScalingImageProvider : public QQuickImageProvider
 {
 public:
-    explicit UCScalingImageProvider();
+    explicit UCScalingImageProvider(
+        const QSharedPointer<UCScalingImageCache> &cache = QSharedPointer<UCScalingImageCache>());
     QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
+
+private:
+    QSharedPointer<UCScalingImageCache> m_cache;
+};
+
+// decodes in a thread pool, used by the asynchronous images only as the engine
+// never loads the images of an asynchronous provider synchronously
+class UBUNTUTOOLKIT_EXPORT UCAsyncScalingImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    explicit UCAsyncScalingImageProvider(
+        const QSharedPointer<UCScalingImageCache> &cache = QSharedPointer<UCScalingImageCache>());
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    QSharedPointer<UCScalingImageCache> m_cache;
 };
 
 UT_NAMESPACE_END
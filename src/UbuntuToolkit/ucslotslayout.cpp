@@ -20,6 +20,7 @@
 
 #include <QtQml/QQmlEngine>
 #include <QtQml/QQmlInfo>
+#include <UbuntuMetrics/span.h>
 
 #include "ucunits_p.h"
 
@@ -35,8 +36,12 @@ UCSlotsLayoutPrivate::UCSlotsLayoutPrivate()
     , mainSlotHeight(0)
     , maxSlotsHeight(0)
     , _q_cachedHeight(-1)
+    , layoutMode(UCSlotsLayout::Anchored)
+    , coalescedRelayouts(0)
+    , pendingCoalescedRelayouts(0)
     , maxNumberOfLeadingSlots(1)
     , maxNumberOfTrailingSlots(2)
+    , relayoutPending(false)
 {
 }
 
@@ -96,6 +101,18 @@ void UCSlotsLayoutPrivate::updateTopBottomPaddingIfNeeded()
     return;
 }
 
+UCSlotsAttached *UCSlotsLayoutPrivate::attachedSlot(QQuickItem *item)
+{
+    UCSlotsAttached *attached = attachedSlots.value(item);
+    if (!attached) {
+        attached = qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(item));
+        if (attached) {
+            attachedSlots.insert(item, attached);
+        }
+    }
+    return attached;
+}
+
 bool UCSlotsLayoutPrivate::skipSlot(QQuickItem *slot)
 {
     if (slot == Q_NULLPTR) {
@@ -122,8 +139,7 @@ void UCSlotsLayoutPrivate::insertSlotIntoSortedList(QQuickItem *slot,
     int i = 0;
     const int size = slotsList.length();
     for (i = 0; i < size; ++i) {
-        UCSlotsAttached *attachedProperty =
-                qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(slotsList.at(i)));
+        UCSlotsAttached *attachedProperty = attachedSlot(slotsList.at(i));
 
         if (!attachedProperty) {
             Q_Q(UCSlotsLayout);
@@ -146,8 +162,7 @@ void UCSlotsLayoutPrivate::addSlot(QQuickItem *slot)
     }
 
     Q_Q(UCSlotsLayout);
-    UCSlotsAttached *attachedProperty =
-            qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(slot));
+    UCSlotsAttached *attachedProperty = attachedSlot(slot);
     if (!attachedProperty) {
         qmlWarning(q) << "Invalid attached property!";
         return;
@@ -167,8 +182,7 @@ void UCSlotsLayoutPrivate::removeSlot(QQuickItem *slot)
     }
 
     Q_Q(UCSlotsLayout);
-    UCSlotsAttached *attachedProperty =
-            qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(slot));
+    UCSlotsAttached *attachedProperty = attachedSlot(slot);
     if (!attachedProperty) {
         qmlWarning(q) << "Invalid attached property!";
         return;
@@ -192,7 +206,8 @@ void UCSlotsLayoutPrivate::_q_updateCachedHeight()
 {
     Q_Q(UCSlotsLayout);
     if (_q_cachedHeight != q->height()) {
-        if (qIsNull(_q_cachedHeight)) {
+        //slots are not anchored to the layout in Deferred mode, follow every height change
+        if (qIsNull(_q_cachedHeight) || layoutMode == UCSlotsLayout::Deferred) {
             _q_relayout();
         }
         _q_cachedHeight = q->height();
@@ -224,8 +239,7 @@ void UCSlotsLayoutPrivate::_q_updateCachedMainSlotHeight()
     Q_Q(UCSlotsLayout);
 
     if (mainSlot) {
-        UCSlotsAttached *attachedProperty =
-                qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(mainSlot));
+        UCSlotsAttached *attachedProperty = attachedSlot(mainSlot);
 
         if (!attachedProperty) {
             qmlWarning(q) << "Invalid attached property!";
@@ -277,8 +291,7 @@ void UCSlotsLayoutPrivate::_q_updateSlotsBBoxHeight()
             }
         }
         if (!skipSlotFlag) {
-            UCSlotsAttached *attachedProperty =
-                    qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(child));
+            UCSlotsAttached *attachedProperty = attachedSlot(child);
 
             if (!attachedProperty) {
                 qmlWarning(q) << "Invalid attached property!";
@@ -392,7 +405,7 @@ void UCSlotsLayoutPrivate::setupSlotsVerticalPositioning(QQuickItem *slot, UCSlo
 
     UCSlotsAttached* attachedProps = attached;
     if (attached == Q_NULLPTR) {
-        attachedProps = qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(slot));
+        attachedProps = attachedSlot(slot);
 
         if (attachedProps == Q_NULLPTR) {
             Q_Q(UCSlotsLayout);
@@ -431,8 +444,7 @@ void UCSlotsLayoutPrivate::layoutInRow(qreal siblingAnchorMargin, QQuickAnchorLi
         QQuickItem *item = items.at(i);
         QQuickAnchors *itemAnchors = QQuickItemPrivate::get(item)->anchors();
 
-        UCSlotsAttached *attached =
-                qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(item));
+        UCSlotsAttached *attached = attachedSlot(item);
 
         if (!attached) {
             qmlWarning(q) << "Invalid attached property!";
@@ -451,8 +463,7 @@ void UCSlotsLayoutPrivate::layoutInRow(qreal siblingAnchorMargin, QQuickAnchorLi
             itemAnchors->setLeft(siblingAnchor);
             itemAnchors->setLeftMargin(attached->padding()->leading() + siblingAnchorMargin);
         } else {
-            UCSlotsAttached *attachedPreviousItem =
-                    qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(items.at(i - 1)));
+            UCSlotsAttached *attachedPreviousItem = attachedSlot(items.at(i - 1));
 
             if (!attachedPreviousItem) {
                 qmlWarning(q) << "Invalid attached property!";
@@ -464,14 +475,95 @@ void UCSlotsLayoutPrivate::layoutInRow(qreal siblingAnchorMargin, QQuickAnchorLi
     }
 }
 
-void UCSlotsLayoutPrivate::_q_relayout()
+void UCSlotsLayoutPrivate::positionInRow(QList<QQuickItem *> &items)
 {
     Q_Q(UCSlotsLayout);
 
+    const bool alignToTop = (getVerticalPositioningMode() == UCSlotPositioningMode::AlignToTop);
+    qreal x = padding.leading();
+    const int size = items.length();
+    for (int i = 0; i < size; i++) {
+        QQuickItem *item = items.at(i);
+        UCSlotsAttached *attached = attachedSlot(item);
+        if (!attached) {
+            qmlWarning(q) << "Invalid attached property!";
+            continue;
+        }
+
+        x += attached->padding()->leading();
+        item->setX(effectiveLayoutMirror ? q->width() - x - item->width() : x);
+        x += item->width() + attached->padding()->trailing();
+
+        if (!attached->overrideVerticalPositioning()) {
+            if (alignToTop) {
+                item->setY(padding.top() + attached->padding()->top());
+            } else {
+                //same as centering with the offset used by setupSlotsVerticalPositioning
+                item->setY((q->height() - item->height() + padding.top() - padding.bottom()
+                            + attached->padding()->top() - attached->padding()->bottom()) / 2.0);
+            }
+        }
+    }
+}
+
+void UCSlotsLayoutPrivate::resetSlotsAnchors()
+{
+    QList<QQuickItem *> slotsList = leadingSlots + trailingSlots;
+    if (mainSlot) {
+        slotsList.append(mainSlot);
+    }
+    Q_FOREACH(QQuickItem *item, slotsList) {
+        QQuickAnchors *itemAnchors = QQuickItemPrivate::get(item)->anchors();
+        itemAnchors->resetLeft();
+        itemAnchors->setLeftMargin(0);
+
+        UCSlotsAttached *attached = attachedSlot(item);
+        if (attached && !attached->overrideVerticalPositioning()) {
+            itemAnchors->resetTop();
+            itemAnchors->setTopMargin(0);
+            itemAnchors->resetVerticalCenter();
+            itemAnchors->setVerticalCenterOffset(0);
+        }
+    }
+}
+
+//In Deferred mode the requests are merged into a single layout pass done when polishing
+void UCSlotsLayoutPrivate::_q_relayout()
+{
     //only relayout after the component has been initialized
     if (!componentComplete)
         return;
 
+    if (layoutMode == UCSlotsLayout::Deferred) {
+        if (relayoutPending) {
+            pendingCoalescedRelayouts++;
+        } else {
+            Q_Q(UCSlotsLayout);
+            relayoutPending = true;
+            q->polish();
+        }
+        return;
+    }
+    relayout();
+}
+
+void UCSlotsLayoutPrivate::mirrorChange()
+{
+    if (layoutMode == UCSlotsLayout::Deferred) {
+        _q_relayout();
+    }
+}
+
+void UCSlotsLayoutPrivate::relayout()
+{
+    Q_Q(UCSlotsLayout);
+
+    if (!componentComplete)
+        return;
+
+    // covers both the immediate and the deferred (polish) relayouts
+    UMSpan span("SlotsLayout.relayout");
+
     if (q->width() <= 0 || q->height() <= 0
             || !q->isVisible() || !q->opacity()) {
         return;
@@ -518,8 +610,7 @@ void UCSlotsLayoutPrivate::_q_relayout()
         }
         if (!skipSlotFlag) {
             itemsToLayout.append(child);
-            UCSlotsAttached *attached =
-                    qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(child));
+            UCSlotsAttached *attached = attachedSlot(child);
 
             if (!attached) {
                 qmlWarning(q) << "Invalid attached property!";
@@ -534,8 +625,7 @@ void UCSlotsLayoutPrivate::_q_relayout()
         //insert between leading and trailing
         itemsToLayout.insert(numOfLeadingToLayout, mainSlot);
 
-        UCSlotsAttached *attachedProps =
-                qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(mainSlot));
+        UCSlotsAttached *attachedProps = attachedSlot(mainSlot);
 
         if (!attachedProps) {
             qmlWarning(q) << "Invalid attached property!";
@@ -550,7 +640,11 @@ void UCSlotsLayoutPrivate::_q_relayout()
                                    - padding.leading() - padding.trailing());
     }
 
-    layoutInRow(padding.leading(), left(), itemsToLayout);
+    if (layoutMode == UCSlotsLayout::Deferred) {
+        positionInRow(itemsToLayout);
+    } else {
+        layoutInRow(padding.leading(), left(), itemsToLayout);
+    }
 }
 
 void UCSlotsLayoutPrivate::handleAttachedPropertySignals(QQuickItem *item, bool connect)
@@ -561,8 +655,7 @@ void UCSlotsLayoutPrivate::handleAttachedPropertySignals(QQuickItem *item, bool
     }
 
     Q_Q(UCSlotsLayout);
-    UCSlotsAttached *attachedSlot =
-            qobject_cast<UCSlotsAttached *>(qmlAttachedPropertiesObject<UCSlotsLayout>(item));
+    UCSlotsAttached *attachedSlot = attachedSlot(item);
     if (!attachedSlot) {
         qmlWarning(q) << "Invalid attached property!";
         return;
@@ -945,6 +1038,7 @@ void UCSlotsLayout::itemChange(ItemChange change, const ItemChangeData &data)
                 QObject::disconnect(data.item, SIGNAL(heightChanged()), this, SLOT(_q_updateCachedMainSlotHeight()));
                 d->_q_updateCachedMainSlotHeight();
             }
+            d->attachedSlots.remove(data.item);
         }
 
         break;
@@ -967,6 +1061,66 @@ void UCSlotsLayout::itemChange(ItemChange change, const ItemChangeData &data)
     QQuickItem::itemChange(change, data);
 }
 
+void UCSlotsLayout::updatePolish()
+{
+    Q_D(UCSlotsLayout);
+    d->relayoutPending = false;
+    d->relayout();
+    if (d->pendingCoalescedRelayouts > 0) {
+        d->coalescedRelayouts += d->pendingCoalescedRelayouts;
+        d->pendingCoalescedRelayouts = 0;
+        Q_EMIT coalescedRelayoutsChanged();
+    }
+}
+
+/*!
+   \qmlproperty enumeration SlotsLayout::layoutMode
+   \since Ubuntu.Components 1.3
+   This property defines how the slots are positioned.
+   \list
+   \li \b SlotsLayout.Anchored - (default) the layout is updated immediately
+        after each change affecting it, and the slots are positioned using anchors.
+   \li \b SlotsLayout.Deferred - changes only mark the layout as dirty and the
+        slots are positioned once, before the next frame is rendered, by setting
+        their x and y directly. This is cheaper when many layouts are created at
+        once, like when used as ListView delegates, but the positions of the slots
+        are only up to date after the layout is polished.
+   \endlist
+*/
+UCSlotsLayout::LayoutMode UCSlotsLayout::layoutMode() const
+{
+    Q_D(const UCSlotsLayout);
+    return d->layoutMode;
+}
+void UCSlotsLayout::setLayoutMode(LayoutMode mode)
+{
+    Q_D(UCSlotsLayout);
+    if (d->layoutMode == mode) {
+        return;
+    }
+    if (mode == Deferred) {
+        //the slots are positioned directly from now on
+        d->resetSlotsAnchors();
+    }
+    d->layoutMode = mode;
+    d->relayoutPending = false;
+    d->_q_relayout();
+    Q_EMIT layoutModeChanged();
+}
+
+/*!
+   \qmlproperty int SlotsLayout::coalescedRelayouts
+   \readonly
+   \since Ubuntu.Components 1.3
+   The number of layout updates which have been merged into an already
+   scheduled one when the layout is in \c SlotsLayout.Deferred mode.
+*/
+int UCSlotsLayout::coalescedRelayouts() const
+{
+    Q_D(const UCSlotsLayout);
+    return d->coalescedRelayouts;
+}
+
 /*!
    \qmlproperty Item SlotsLayout::mainSlot
    This property represents the main slot of the layout. By default, SlotsLayout has
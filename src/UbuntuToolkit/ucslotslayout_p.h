@@ -38,8 +38,11 @@ class UBUNTUTOOLKIT_EXPORT UCSlotsLayout : public QQuickItem
 #else
     Q_PROPERTY(UT_PREPEND_NAMESPACE(UCSlotsLayoutPadding) *padding READ padding CONSTANT FINAL)
 #endif
+    Q_PROPERTY(LayoutMode layoutMode READ layoutMode WRITE setLayoutMode NOTIFY layoutModeChanged)
+    Q_PROPERTY(int coalescedRelayouts READ coalescedRelayouts NOTIFY coalescedRelayoutsChanged)
 
     Q_ENUMS(UCSlotPosition)
+    Q_ENUMS(LayoutMode)
 
 public:
     explicit UCSlotsLayout(QQuickItem *parent = 0);
@@ -57,15 +60,27 @@ public:
         Last = INT_MAX/2
     };
 
+    enum LayoutMode {
+        Anchored,
+        Deferred
+    };
+
+    LayoutMode layoutMode() const;
+    void setLayoutMode(LayoutMode mode);
+    int coalescedRelayouts() const;
+
     static UCSlotsAttached *qmlAttachedProperties(QObject *object);
 
 Q_SIGNALS:
     void mainSlotChanged();
+    void layoutModeChanged();
+    void coalescedRelayoutsChanged();
 
 protected:
     Q_DECLARE_PRIVATE(UCSlotsLayout)
     void componentComplete() override;
     void itemChange(ItemChange change, const ItemChangeData &data) override;
+    void updatePolish() override;
 
 private:
     Q_PRIVATE_SLOT(d_func(), void _q_onGuValueChanged())
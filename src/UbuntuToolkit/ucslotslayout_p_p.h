@@ -21,6 +21,7 @@
 
 #include <UbuntuToolkit/private/ucslotslayout_p.h>
 
+#include <QtCore/QHash>
 #include <QtQuick/private/qquickitem_p.h>
 
 #define IMPLICIT_SLOTSLAYOUT_WIDTH_GU                40
@@ -65,6 +66,21 @@ public:
     //The optional anchoring behaviour can be disable by passing QQuickAnchorLine()
     void layoutInRow(qreal siblingAnchorMargin, QQuickAnchorLine siblingAnchor, QList<QQuickItem *> &items);
 
+    //position "items" in a row by setting their x and y, used in Deferred layout mode
+    void positionInRow(QList<QQuickItem *> &items);
+
+    //remove the anchors set by layoutInRow() on all the slots
+    void resetSlotsAnchors();
+
+    //returns the attached properties of the slot, cached after the first query
+    UCSlotsAttached *attachedSlot(QQuickItem *item);
+
+    //does the layout, _q_relayout() calls it right away or schedules it for the next polish
+    void relayout();
+
+    //the anchors follow the layout direction, the positions set in Deferred mode don't
+    void mirrorChange() override;
+
     //this method sets up vertical anchors and paddings for a slot ("item").
     //Attached properties are taken from "attached", if not null, otherwise
     //qml engine is queried.
@@ -108,6 +124,8 @@ public:
     QList<QQuickItem *> leadingSlots;
     QList<QQuickItem *> trailingSlots;
 
+    QHash<QQuickItem *, UCSlotsAttached *> attachedSlots;
+
     QQuickItem* mainSlot;
 
     //We cache the current parent so that we can disconnect from the signals when the
@@ -121,12 +139,18 @@ public:
     //from 0 to non-0 and not viceversa
     qreal _q_cachedHeight;
 
+    UCSlotsLayout::LayoutMode layoutMode;
+    //number of relayout requests merged into a pending polish, in total and since the last polish
+    int coalescedRelayouts;
+    int pendingCoalescedRelayouts;
+
     //currently fixed, but we may allow changing this in the future
     qint32 maxNumberOfLeadingSlots;
     qint32 maxNumberOfTrailingSlots;
 
     //Show the chevron, name taken from old ListItem API to minimize changes
     bool progression : 1;
+    bool relayoutPending : 1;
 };
 
 class UCSlotsAttachedPrivate : public QObjectPrivate
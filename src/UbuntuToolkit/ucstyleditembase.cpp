@@ -18,8 +18,13 @@
 
 #include "ucstyleditembase_p_p.h"
 
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTimer>
 #include <QtQml/QQmlEngine>
+#include <QtQml/QQmlIncubationController>
+#include <QtQuick/QQuickWindow>
 #include <QtQuick/private/qquickanchors_p.h>
+#include <UbuntuMetrics/span.h>
 
 #include "ucstylehints_p.h"
 #include "uctheme_p.h"
@@ -36,9 +41,75 @@ UCStyledItemBasePrivate::UCStyledItemBasePrivate()
     , activeFocusOnPress(false)
     , wasStyleLoaded(false)
     , isFocusScope(true)
+    , styleLoader(Q_NULLPTR)
+    , styleLoaderComponent(Q_NULLPTR)
+    , styleLoadPriority(UCStyledItemBase::VisibleFirst)
+    , asyncStyle(false)
+    , asyncStyleCapable(true)
+    , styleLoadPending(false)
+    , styleAnimated(false)
 {
 }
 
+/*
+ * Starts the asynchronous style loading of the items which are not visible,
+ * one item per event loop iteration, so the visible items get the incubation
+ * time first. Owned by the application so that its timer is gone before the
+ * event dispatcher.
+ */
+class IdleStyleLoader : public QObject
+{
+public:
+    IdleStyleLoader(QObject *parent)
+        : QObject(parent)
+        , m_timer(this)
+    {
+        m_timer.setSingleShot(true);
+        m_timer.setInterval(0);
+        QObject::connect(&m_timer, &QTimer::timeout, this, [this]() { loadNext(); });
+    }
+
+    void schedule(UCStyledItemBase *item)
+    {
+        m_pending.append(item);
+        if (!m_timer.isActive()) {
+            m_timer.start();
+        }
+    }
+    void cancel(UCStyledItemBase *item)
+    {
+        m_pending.removeAll(item);
+    }
+
+private:
+    void loadNext()
+    {
+        while (!m_pending.isEmpty()) {
+            QPointer<UCStyledItemBase> item = m_pending.takeFirst();
+            if (item) {
+                UCStyledItemBasePrivate::get(item)->startStyleLoading();
+                break;
+            }
+        }
+        if (!m_pending.isEmpty()) {
+            m_timer.start();
+        }
+    }
+
+    QTimer m_timer;
+    QList< QPointer<UCStyledItemBase> > m_pending;
+};
+
+// created on first use, from the GUI thread as styled items live there
+static IdleStyleLoader *idleStyleLoader()
+{
+    static QPointer<IdleStyleLoader> loader;
+    if (!loader) {
+        loader = new IdleStyleLoader(QCoreApplication::instance());
+    }
+    return loader;
+}
+
 /*!
  * \qmlproperty string StyledItem::keyNavigationFocus
  * If \l activeFocusOnTab is true and Tab or Shift+Tab is used to focus
@@ -339,10 +410,82 @@ void UCStyledItemBasePrivate::setStyleName(const QString &name)
     loadStyleItem();
 }
 
+/*!
+ * \qmlproperty bool StyledItem::asynchronousStyle
+ * \since Ubuntu.Components 1.3
+ * When set, the style instance is created asynchronously so the component
+ * creation doesn't block on its style. Visible components are styled first,
+ * the style of the components which are not visible is created when the
+ * application is idle. Defaults to false.
+ *
+ * The \l styleLoaded signal is emitted when the style instance is ready.
+ * \note Components relying on their style right after creation, like
+ * ListItem or BottomEdge, always create their style synchronously.
+ */
+/*!
+ * \qmlsignal StyledItem::styleLoaded()
+ * \since Ubuntu.Components 1.3
+ * The signal is emitted each time a style instance is created for the component.
+ */
+bool UCStyledItemBasePrivate::asynchronousStyle() const
+{
+    return asyncStyle;
+}
+void UCStyledItemBasePrivate::setAsynchronousStyle(bool asynchronous)
+{
+    if (asyncStyle == asynchronous) {
+        return;
+    }
+    asyncStyle = asynchronous;
+    Q_EMIT q_func()->asynchronousStyleChanged();
+}
+
+/*!
+ * \qmlproperty enumeration StyledItem::stylePriority
+ * \since Ubuntu.Components 1.3
+ * Tells when the style instance is created if \l asynchronousStyle is set:
+ * \list
+ *  \li \b StyledItem.VisibleFirst - the style of visible components is
+ *      created right away, the one of the components which are not visible
+ *      when the application is idle, or as soon as they become visible.
+ *  \li \b StyledItem.Immediate - the style is created right away, even if
+ *      the component is not visible.
+ *  \li \b StyledItem.Idle - the style is created when the application is
+ *      idle, even if the component is visible.
+ * \endlist
+ * Defaults to StyledItem.VisibleFirst.
+ */
+UCStyledItemBase::StylePriority UCStyledItemBasePrivate::stylePriority() const
+{
+    return styleLoadPriority;
+}
+void UCStyledItemBasePrivate::setStylePriority(UCStyledItemBase::StylePriority priority)
+{
+    if (styleLoadPriority == priority) {
+        return;
+    }
+    styleLoadPriority = priority;
+    // promote a pending loading which shouldn't wait anymore
+    if (styleLoadPending && (priority == UCStyledItemBase::Immediate
+                             || (priority == UCStyledItemBase::VisibleFirst && isStyleVisible()))) {
+        idleStyleLoader()->cancel(q_func());
+        startStyleLoading();
+    }
+    Q_EMIT q_func()->stylePriorityChanged();
+}
+
 // performs pre-style change actions, removes style item size change
 // connections and destroys the style component
 void UCStyledItemBasePrivate::preStyleChanged()
 {
+    // abort the pending style loading, if any
+    if (styleLoadPending) {
+        idleStyleLoader()->cancel(q_func());
+        styleLoadPending = false;
+    }
+    if (styleLoader) {
+        styleLoader->reset();
+    }
     if (styleItem) {
         // make sure the context holder is reset too
         styleItemContext.clear();
@@ -357,44 +500,169 @@ void UCStyledItemBasePrivate::preStyleChanged()
 }
 
 // loads the style animated or not, depending on the loading time
-// returns true on successful style loading
+// returns true on successful style loading, false if the style is not loaded
+// or is being loaded asynchronously
 bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
 {
-    if (styleItem || (!styleComponent && styleDocument.isEmpty()) || !componentComplete) {
+    if (styleItem || isStyleLoading() || (!styleComponent && styleDocument.isEmpty()) || !componentComplete) {
         // the style loading is delayed
         return false;
     }
+    UMSpan span("StyledItem.loadStyleItem");
+    if (asyncStyle && asyncStyleCapable) {
+        styleAnimated = animated;
+        if (styleLoadPriority == UCStyledItemBase::Immediate
+            || (styleLoadPriority == UCStyledItemBase::VisibleFirst && isStyleVisible())) {
+            startStyleLoading();
+        } else {
+            styleLoadPending = true;
+            idleStyleLoader()->schedule(q_func());
+        }
+        return false;
+    }
+    return createStyleItem(animated);
+}
+
+// creates the style item synchronously
+bool UCStyledItemBasePrivate::createStyleItem(bool animated)
+{
     Q_Q(UCStyledItemBase);
     // either styleComponent or styleName is valid
     QQmlComponent *component = styleComponent;
-    UCTheme *theme = q->getTheme();
+    QPointer<UCTheme> theme = q->getTheme();
     if (!component && theme) {
-        component = theme->createStyleComponent(styleDocument + ".qml", q, styleVersion);
+        component = theme->acquireStyleComponent(styleDocument + ".qml", q, styleVersion);
     }
     if (!component) {
         return false;
     }
-    // create context
-    // use creation context as parent to create the context we load the style item with
+    QQmlContext *context = createStyleItemContext(component, animated);
+    QObject *object = context ? component->beginCreate(context) : Q_NULLPTR;
+    if (!object) {
+        delete context;
+        if (!styleComponent && theme) {
+            theme->releaseStyleComponent(component);
+        }
+        return false;
+    }
+    // link context to the style item to delete them together
+    QQml_setParent_noEvent(styleItemContext, object);
+    attachStyleItem(object);
+    if (!styleItem) {
+        delete object;
+    }
+    component->completeCreate();
+    // give the style component back to the theme
+    if (!styleComponent && theme) {
+        theme->releaseStyleComponent(component);
+    }
+
+    completeStyleItem(animated);
+    return true;
+}
+
+// starts the asynchronous creation of the style item
+void UCStyledItemBasePrivate::startStyleLoading()
+{
+    Q_Q(UCStyledItemBase);
+    styleLoadPending = false;
+    if (styleItem || (!styleComponent && styleDocument.isEmpty()) || !componentComplete) {
+        return;
+    }
+    QQmlEngine *engine = qmlEngine(q);
+    if (!engine || !engine->incubationController()) {
+        // nothing drives the incubation without a window
+        createStyleItem(styleAnimated);
+        return;
+    }
+
+    QQmlComponent *component = styleComponent;
+    QPointer<UCTheme> theme = q->getTheme();
+    if (!component && theme) {
+        component = theme->acquireStyleComponent(styleDocument + ".qml", q, styleVersion, true);
+    }
+    if (!component) {
+        return;
+    }
+    QQmlContext *context = createStyleItemContext(component, styleAnimated);
+    if (context) {
+        if (!styleLoader) {
+            styleLoader = new AsyncLoader(q);
+            QObject::connect(styleLoader, &AsyncLoader::loadingStatus, q,
+                             [this](AsyncLoader::LoadingStatus status, QObject *object) {
+                styleLoadingStatusChanged(status, object);
+            });
+        }
+        // releases the component of a previous loading, if any
+        styleLoader->reset();
+        // the loader needs the component until it's done, it is released on
+        // the Ready, Error or Reset status
+        if (!styleComponent && theme) {
+            styleLoaderTheme = theme;
+            styleLoaderComponent = component;
+        }
+        if (styleLoader->load(component, context)) {
+            return;
+        }
+        delete context;
+        releaseStyleLoaderComponent();
+        return;
+    }
+    if (!styleComponent && theme) {
+        theme->releaseStyleComponent(component, true);
+    }
+}
+
+// gives the component used by the style loader back to the theme
+void UCStyledItemBasePrivate::releaseStyleLoaderComponent()
+{
+    QQmlComponent *component = styleLoaderComponent;
+    styleLoaderComponent = Q_NULLPTR;
+    if (component && styleLoaderTheme) {
+        styleLoaderTheme->releaseStyleComponent(component, true);
+    }
+    styleLoaderTheme.clear();
+}
+
+bool UCStyledItemBasePrivate::isStyleLoading()
+{
+    return styleLoadPending || (styleLoader && styleLoader->status() < AsyncLoader::Ready);
+}
+
+// visible items get their style loaded first
+bool UCStyledItemBasePrivate::isStyleVisible() const
+{
+    Q_Q(const UCStyledItemBase);
+    return q->window() && q->isVisible();
+}
+
+// creates the context the style item is created in, null if the creation
+// context is being deleted
+QQmlContext *UCStyledItemBasePrivate::createStyleItemContext(QQmlComponent *component, bool animated)
+{
+    Q_Q(UCStyledItemBase);
+    // use creation context as parent to create the context we load the style item with,
+    // shared theme components have none so the styled item's context is used
     QQmlContext *creationContext = component->creationContext();
     if (!creationContext) {
         creationContext = qmlContext(q);
     }
     if (creationContext && !creationContext->isValid()) {
         // we are having the changes in the component being under deletion
-        return false;
+        return Q_NULLPTR;
     }
     styleItemContext = new QQmlContext(creationContext);
     styleItemContext->setContextObject(q);
     styleItemContext->setContextProperty(QStringLiteral("styledItem"), q);
     styleItemContext->setContextProperty(QStringLiteral("animated"), animated);
-    QObject *object = component->beginCreate(styleItemContext);
-    if (!object) {
-        delete styleItemContext;
-        return false;
-    }
-    // link context to the style item to delete them together
-    QQml_setParent_noEvent(styleItemContext, object);
+    return styleItemContext;
+}
+
+// sets up the style item created, styleItem remains null if the object
+// created is not an item
+void UCStyledItemBasePrivate::attachStyleItem(QObject *object)
+{
+    Q_Q(UCStyledItemBase);
     styleItem = qobject_cast<::QQuickItem*>(object);
     if (styleItem) {
         QQml_setParent_noEvent(styleItem, q);
@@ -404,17 +672,15 @@ bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
         // anchor fill to the styled component
         QQuickAnchors *styleAnchors = QQuickItemPrivate::get(styleItem)->anchors();
         styleAnchors->setFill(q);
-    } else {
-        delete object;
-    }
-    component->completeCreate();
-    // delete temporary component
-    if (!styleComponent) {
-        delete component;
     }
+}
 
+// completes the style loading once the style item is created
+void UCStyledItemBasePrivate::completeStyleItem(bool animated)
+{
+    Q_Q(UCStyledItemBase);
     // make sure we reset the animated property to true
-    if (!animated) {
+    if (!animated && styleItemContext) {
         styleItemContext->setContextProperty(QStringLiteral("animated"), true);
     }
 
@@ -422,7 +688,38 @@ bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
     _q_styleResized();
     connectStyleSizeChanges(true);
     Q_EMIT q->styleInstanceChanged();
-    return true;
+    if (styleItem) {
+        Q_EMIT q->styleLoaded();
+    }
+}
+
+void UCStyledItemBasePrivate::styleLoadingStatusChanged(AsyncLoader::LoadingStatus status, QObject *object)
+{
+    switch (status) {
+    case AsyncLoader::Initializing:
+        // link context to the style item to delete them together
+        QQml_setParent_noEvent(styleItemContext, object);
+        attachStyleItem(object);
+        break;
+    case AsyncLoader::Ready:
+        releaseStyleLoaderComponent();
+        if (!styleItem) {
+            delete object;
+            break;
+        }
+        completeStyleItem(styleAnimated);
+        break;
+    case AsyncLoader::Error:
+    case AsyncLoader::Reset:
+        releaseStyleLoaderComponent();
+        // the incubator deletes the object being created, and the context
+        // with it if it was already linked
+        styleItem = Q_NULLPTR;
+        delete styleItemContext.data();
+        break;
+    default:
+        break;
+    }
 }
 
 /*!
@@ -431,7 +728,8 @@ bool UCStyledItemBasePrivate::loadStyleItem(bool animated)
  */
 QQuickItem *UCStyledItemBasePrivate::styleInstance()
 {
-    return styleItem;
+    // the style item is not exposed until its asynchronous creation completes
+    return isStyleLoading() ? Q_NULLPTR : styleItem;
 }
 
 // connect style item implicit size changes
@@ -572,6 +870,13 @@ void UCStyledItemBase::itemChange(ItemChange change, const ItemChangeData &data)
     if (change == ItemParentHasChanged) {
         // update parentItem
         d_func()->oldParentItem = data.item;
+    } else if (change == ItemSceneChange || change == ItemVisibleHasChanged) {
+        // style the item as soon as it becomes visible
+        Q_D(UCStyledItemBase);
+        if (d->styleLoadPending && d->styleLoadPriority == VisibleFirst && d->isStyleVisible()) {
+            idleStyleLoader()->cancel(this);
+            d->startStyleLoading();
+        }
     } else if (change == ItemActiveFocusHasChanged) {
         // Children may retain focus as if it was the StyledItem itself
         if (!hasActiveFocus())
@@ -48,8 +48,17 @@ class UBUNTUTOOLKIT_EXPORT UCStyledItemBase : public QQuickItem, public UCThemin
     Q_PRIVATE_PROPERTY(UCStyledItemBase::d_func(), QQmlComponent *style READ style WRITE setStyle RESET resetStyle NOTIFY styleChanged FINAL DESIGNABLE false)
     Q_PRIVATE_PROPERTY(UCStyledItemBase::d_func(), QQuickItem *__styleInstance READ styleInstance NOTIFY styleInstanceChanged FINAL DESIGNABLE false)
     Q_PRIVATE_PROPERTY(UCStyledItemBase::d_func(), QString styleName READ styleName WRITE setStyleName NOTIFY styleNameChanged FINAL REVISION 2)
+    Q_PRIVATE_PROPERTY(UCStyledItemBase::d_func(), bool asynchronousStyle READ asynchronousStyle WRITE setAsynchronousStyle NOTIFY asynchronousStyleChanged FINAL REVISION 2)
+    Q_PRIVATE_PROPERTY(UCStyledItemBase::d_func(), StylePriority stylePriority READ stylePriority WRITE setStylePriority NOTIFY stylePriorityChanged FINAL REVISION 2)
     Q_PROPERTY(UT_PREPEND_NAMESPACE(UCTheme) *theme READ getTheme WRITE setTheme RESET resetTheme NOTIFY themeChanged FINAL REVISION 2)
+    Q_ENUMS(StylePriority)
 public:
+    enum StylePriority {
+        VisibleFirst,
+        Immediate,
+        Idle
+    };
+
     explicit UCStyledItemBase(QQuickItem *parent = 0);
 
     virtual bool keyNavigationFocus() const;
@@ -69,6 +78,9 @@ Q_SIGNALS:
     Q_REVISION(1) void activeFocusOnTabChanged2();
     Q_REVISION(2) void themeChanged();
     Q_REVISION(2) void styleNameChanged();
+    Q_REVISION(2) void asynchronousStyleChanged();
+    Q_REVISION(2) void stylePriorityChanged();
+    Q_REVISION(2) void styleLoaded();
 
 protected:
     UCStyledItemBase(UCStyledItemBasePrivate &, QQuickItem *parent);
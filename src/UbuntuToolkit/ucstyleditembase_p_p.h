@@ -23,6 +23,7 @@
 
 #include <QtQuick/private/qquickitem_p.h>
 
+#include <UbuntuToolkit/private/asyncloader_p.h>
 #include <UbuntuToolkit/private/ucthemingextension_p.h>
 #include <UbuntuToolkit/private/ucimportversionchecker_p.h>
 
@@ -58,9 +59,18 @@ public:
     QString styleName() const;
     void setStyleName(const QString &name);
 
+    bool asynchronousStyle() const;
+    void setAsynchronousStyle(bool asynchronous);
+    UCStyledItemBase::StylePriority stylePriority() const;
+    void setStylePriority(UCStyledItemBase::StylePriority priority);
+
     virtual void preStyleChanged();
     virtual void postStyleChanged() {}
     virtual bool loadStyleItem(bool animated = true);
+    bool createStyleItem(bool animated);
+    void startStyleLoading();
+    bool isStyleLoading();
+    bool isStyleVisible() const;
     virtual void completeComponentInitialization();
 
     // from UCImportVersionChecker
@@ -78,10 +88,27 @@ public:
     bool activeFocusOnPress:1;
     bool wasStyleLoaded:1;
     bool isFocusScope:1;
+    // asynchronous style loading, turned off by the items needing the style
+    // instance right after loadStyleItem()
+    AsyncLoader *styleLoader;
+    // style component acquired from the theme for the loader, released once
+    // the loading is done
+    QPointer<UCTheme> styleLoaderTheme;
+    QQmlComponent *styleLoaderComponent;
+    UCStyledItemBase::StylePriority styleLoadPriority;
+    bool asyncStyle:1;
+    bool asyncStyleCapable:1;
+    bool styleLoadPending:1;
+    bool styleAnimated:1;
 
 protected:
 
     void connectStyleSizeChanges(bool attach);
+    QQmlContext *createStyleItemContext(QQmlComponent *component, bool animated);
+    void attachStyleItem(QObject *object);
+    void completeStyleItem(bool animated);
+    void styleLoadingStatusChanged(AsyncLoader::LoadingStatus status, QObject *object);
+    void releaseStyleLoaderComponent();
 };
 
 UT_NAMESPACE_END
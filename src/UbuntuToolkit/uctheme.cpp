@@ -35,6 +35,7 @@
 #define foreach Q_FOREACH
 #include <QtQml/private/qqmlbinding_p.h>
 #undef foreach
+#include <UbuntuMetrics/span.h>
 
 #include "i18n_p.h"
 #include "listener_p.h"
@@ -459,6 +460,8 @@ void UCTheme::updateEnginePaths(QQmlEngine *engine)
     Q_FOREACH(const QString &path, paths) {
         if (QDir(path).exists() && !engine->importPathList().contains(path)) {
             engine->addImportPath(path);
+            // styles may now resolve differently
+            invalidateStyleCache();
         }
     }
 }
@@ -471,6 +474,7 @@ void UCTheme::_q_defaultThemeChanged()
 
 void UCTheme::updateThemePaths()
 {
+    invalidateStyleCache();
     m_themePaths.clear();
 
     QString themeName = name();
@@ -609,6 +613,7 @@ void UCTheme::setPalette(QObject *config)
         qmlWarning(config) << QStringLiteral("Not a Palette component.");
         return;
     }
+    invalidateStyleCache();
 
     // 1. restore original palette values
     m_config.restorePalette();
@@ -634,7 +639,24 @@ void UCTheme::resetPalette()
     setPalette(NULL);
 }
 
+// returns the style URL from the cache, looks it up in the theme paths only
+// the first time a style is requested for a given version
 QUrl UCTheme::styleUrl(const QString& styleName, quint16 version, bool *isFallback)
+{
+    const StyleKey key(styleName, version);
+    QHash<StyleKey, StyleUrlRecord>::const_iterator i = m_styleUrls.constFind(key);
+    if (i == m_styleUrls.constEnd()) {
+        bool fallback = false;
+        QUrl url = lookupStyleUrl(styleName, version, &fallback);
+        i = m_styleUrls.insert(key, StyleUrlRecord(url, fallback));
+    }
+    if (isFallback) {
+        (*isFallback) = i->fallback;
+    }
+    return i->url;
+}
+
+QUrl UCTheme::lookupStyleUrl(const QString& styleName, quint16 version, bool *isFallback)
 {
     if (isFallback) {
         (*isFallback) = false;
@@ -742,12 +764,30 @@ void UCTheme::checkMixedVersionImports(QQuickItem *item, quint16 version)
     previousVersion = version;
 }
 
+// resolves the style URL, warns on behalf of the parent if the style isn't
+// found or if it falls back to the latest version
+QUrl UCTheme::resolveStyleUrl(const QString& styleName, QObject* parent, quint16 version)
+{
+    bool fallback = false;
+    QUrl url = styleUrl(styleName, version, &fallback);
+    if (!url.isValid()) {
+        qmlWarning(parent) <<
+           QStringLiteral("Warning: Style %1 not found in theme %2").arg(styleName).arg(name());
+    } else if (fallback) {
+        qmlWarning(parent) << QStringLiteral("Theme '%1' has no '%2' style for version %3.%4, fall back to version %5.%6.")
+                           .arg(name()).arg(styleName).arg(MAJOR_VERSION(version)).arg(MINOR_VERSION(version))
+                           .arg(MAJOR_VERSION(LATEST_UITK_VERSION)).arg(MINOR_VERSION(LATEST_UITK_VERSION));
+    }
+    return url;
+}
+
 /*
  * Returns an instance of the style component named \a styleName and parented
  * to \a parent.
  */
 QQmlComponent* UCTheme::createStyleComponent(const QString& styleName, QObject* parent, quint16 version)
 {
+    UMSpan span("Theme.createStyleComponent");
     QQmlComponent *component = NULL;
     Q_ASSERT(version);
 
@@ -758,15 +798,8 @@ QQmlComponent* UCTheme::createStyleComponent(const QString& styleName, QObject*
             // so for now we return NULL
             return Q_NULLPTR;
         }
-        // make sure we have the paths
-        bool fallback = false;
-        QUrl url = styleUrl(styleName, version, &fallback);
+        QUrl url = resolveStyleUrl(styleName, parent, version);
         if (url.isValid()) {
-            if (fallback) {
-                qmlWarning(parent) << QStringLiteral("Theme '%1' has no '%2' style for version %3.%4, fall back to version %5.%6.")
-                                   .arg(name()).arg(styleName).arg(MAJOR_VERSION(version)).arg(MINOR_VERSION(version))
-                                   .arg(MAJOR_VERSION(LATEST_UITK_VERSION)).arg(MINOR_VERSION(LATEST_UITK_VERSION));
-            }
             component = new QQmlComponent(engine, url, QQmlComponent::PreferSynchronous, parent);
             if (component->isError()) {
                 qmlWarning(parent) << component->errorString();
@@ -776,15 +809,102 @@ QQmlComponent* UCTheme::createStyleComponent(const QString& styleName, QObject*
                 // set context for the component
                 QQmlEngine::setContextForObject(component, qmlContext(parent));
             }
-        } else {
-            qmlWarning(parent) <<
-               QStringLiteral("Warning: Style %1 not found in theme %2").arg(styleName).arg(name());
         }
     }
 
     return component;
 }
 
+/*
+ * Returns the style component named \a styleName compiled once per theme and
+ * shared by all the styled items. The component has no context, the caller
+ * must provide one at creation. A temporary component parented to \a parent is
+ * returned instead if the shared one is already creating an instance
+ * synchronously, which happens with nested styles. Incubations, set by
+ * \a asynchronous, don't block the component and several of them can share it.
+ */
+QQmlComponent* UCTheme::acquireStyleComponent(const QString& styleName, QObject* parent, quint16 version, bool asynchronous)
+{
+    Q_ASSERT(version);
+    QQmlEngine* engine = parent ? qmlEngine(parent) : Q_NULLPTR;
+    if (!engine) {
+        return Q_NULLPTR;
+    }
+    if (engine != m_styleEngine) {
+        invalidateStyleCache();
+        m_styleEngine = engine;
+    }
+
+    QUrl url = resolveStyleUrl(styleName, parent, version);
+    if (!url.isValid()) {
+        return Q_NULLPTR;
+    }
+
+    const StyleKey key(styleName, version);
+    QQmlComponent *component = m_styleComponents.value(key);
+    if (component && !asynchronous && m_busyStyleComponents.contains(component)) {
+        component = new QQmlComponent(engine, url, QQmlComponent::PreferSynchronous, parent);
+        if (component->isError()) {
+            qmlWarning(parent) << component->errorString();
+            delete component;
+            return Q_NULLPTR;
+        }
+        return component;
+    }
+    if (!component) {
+        component = new QQmlComponent(engine, url, QQmlComponent::PreferSynchronous, this);
+        if (component->isError()) {
+            // not cached, so the error is reported for every item using the style
+            qmlWarning(parent) << component->errorString();
+            delete component;
+            return Q_NULLPTR;
+        }
+        m_styleComponents.insert(key, component);
+    }
+    if (!asynchronous) {
+        m_busyStyleComponents.insert(component);
+    }
+    m_styleComponentUsers[component]++;
+    return component;
+}
+
+void UCTheme::releaseStyleComponent(QQmlComponent* component, bool asynchronous)
+{
+    QHash<QQmlComponent*, int>::iterator users = m_styleComponentUsers.find(component);
+    if (users == m_styleComponentUsers.end()) {
+        // temporary component of a nested style
+        delete component;
+        return;
+    }
+    if (!asynchronous) {
+        m_busyStyleComponents.remove(component);
+    }
+    if (--users.value() > 0) {
+        return;
+    }
+    m_styleComponentUsers.erase(users);
+    if (component->parent() != this) {
+        // dropped from the cache while in use
+        delete component;
+    }
+}
+
+void UCTheme::invalidateStyleCache()
+{
+    m_styleUrls.clear();
+    // components might be in use up in the stack, the ones acquired are left
+    // to be deleted by releaseStyleComponent() as asynchronous loadings might
+    // still be compiling or incubating them
+    Q_FOREACH(QQmlComponent *component, m_styleComponents) {
+        if (m_styleComponentUsers.contains(component)) {
+            component->setParent(Q_NULLPTR);
+        } else {
+            component->deleteLater();
+        }
+    }
+    m_styleComponents.clear();
+}
+
 void UCTheme::loadPalette(QQmlEngine *engine, bool notify)
 {
     if (!engine) {
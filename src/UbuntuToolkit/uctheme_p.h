@@ -20,11 +20,15 @@
 #ifndef UCTHEME_P_H
 #define UCTHEME_P_H
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QPair>
 #include <QtCore/QPointer>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
 #include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
 #include <QtQml/QQmlParserStatus>
 #include <QtQml/QQmlProperty>
 #if QT_VERSION >= QT_VERSION_CHECK(5, 6, 0)
@@ -86,6 +90,11 @@ public:
 
     // internal, used by the deprecated Theme.createStyledComponent()
     QQmlComponent* createStyleComponent(const QString& styleName, QObject* parent, quint16 version = 0);
+    // internal, returns the style component shared by all the styled items using
+    // the same style, must be given back with releaseStyleComponent() once the
+    // style instance is created, or the incubation is done when \a asynchronous
+    QQmlComponent* acquireStyleComponent(const QString& styleName, QObject* parent, quint16 version, bool asynchronous = false);
+    void releaseStyleComponent(QQmlComponent* component, bool asynchronous = false);
     void attachItem(QQuickItem *item, bool attach);
 
     // helper functions
@@ -115,6 +124,9 @@ private:
     void updateEnginePaths(QQmlEngine *engine);
     void updateThemePaths();
     QUrl styleUrl(const QString& styleName, quint16 version, bool *isFallback = NULL);
+    QUrl lookupStyleUrl(const QString& styleName, quint16 version, bool *isFallback);
+    QUrl resolveStyleUrl(const QString& styleName, QObject* parent, quint16 version);
+    void invalidateStyleCache();
     void loadPalette(QQmlEngine *engine, bool notify = true);
     void updateThemedItems();
 
@@ -167,7 +179,24 @@ private:
         QList<Data> configList;
     };
 
+    typedef QPair<QString, quint16> StyleKey;
+    struct StyleUrlRecord {
+        StyleUrlRecord() : fallback(false) {}
+        StyleUrlRecord(const QUrl &url, bool fallback) : url(url), fallback(fallback) {}
+        QUrl url;
+        bool fallback;
+    };
+
     PaletteConfig m_config;
+    // resolved style URLs and compiled style components, cleared when the
+    // theme paths, the engine or the palette change
+    QHash<StyleKey, StyleUrlRecord> m_styleUrls;
+    QHash<StyleKey, QQmlComponent*> m_styleComponents;
+    // components creating an instance synchronously, and the number of
+    // creations and incubations using each acquired component
+    QSet<QQmlComponent*> m_busyStyleComponents;
+    QHash<QQmlComponent*, int> m_styleComponentUsers;
+    QPointer<QQmlEngine> m_styleEngine;
     QString m_name;
     QPointer<UCTheme> m_parentTheme;
     QPointer<QObject> m_palette; // the palette might be from the default style if the theme doesn't define palette
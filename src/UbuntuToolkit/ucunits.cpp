@@ -20,6 +20,7 @@
 
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFileSystemWatcher>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QtMath>
 #include <QtGui/QGuiApplication>
@@ -100,7 +101,8 @@ static float getenvFloat(const char* name, float defaultValue)
 
 UCUnits::UCUnits(QWindow *parent) :
     QObject(parent),
-    m_devicePixelRatio(parent->devicePixelRatio())
+    m_devicePixelRatio(parent->devicePixelRatio()),
+    m_resourceWatcher(Q_NULLPTR)
 {
     m_gridUnit = getenvFloat(ENV_GRID_UNIT_PX, DEFAULT_GRID_UNIT_PX * m_devicePixelRatio);
     QObject::connect(parent, &QWindow::screenChanged,
@@ -133,7 +135,8 @@ UCUnits *UCUnits::m_units = nullptr;
 
 UCUnits::UCUnits(QObject *parent) :
     QObject(parent),
-    m_devicePixelRatio(qGuiApp->devicePixelRatio())
+    m_devicePixelRatio(qGuiApp->devicePixelRatio()),
+    m_resourceWatcher(Q_NULLPTR)
 {
     if (QHighDpiScaling::isActive())
       m_gridUnit = qCeil(DEFAULT_GRID_UNIT_PX * m_devicePixelRatio);
@@ -213,28 +216,29 @@ QString UCUnits::resolveResource(const QUrl& url)
     }
 
     const QFileInfo fileInfo(path);
-    if (fileInfo.exists()) {
-        if (fileInfo.isFile()) {
-            return QStringLiteral("1/") + path;
-        } else {
-            return QString();
-        }
+    const QString directoryPath = fileInfo.dir().absolutePath();
+    const ResourceDirectory directory = resourceDirectory(directoryPath);
+    const QString fileName = fileInfo.fileName();
+    if (directory.files.contains(fileName)) {
+        return QStringLiteral("1/") + path;
+    } else if (directory.others.contains(fileName)) {
+        return QString();
     }
 
-    const QString prefix = fileInfo.dir().absolutePath() + "/" + fileInfo.baseName();
+    const QString prefix = directoryPath + "/" + fileInfo.baseName();
     const QString suffix = "." + fileInfo.completeSuffix();
 
     /* Use file with expected grid unit suffix if it exists.
        For example, if m_gridUnit = 10, look for resource@10.png.
     */
 
-    path = prefix + suffixForGridUnit(m_gridUnit) + suffix;
-    if (QFile::exists(path)) {
-        return QStringLiteral("1/") + path;
+    const QString gridUnitFileName = fileInfo.baseName() + suffixForGridUnit(m_gridUnit) + suffix;
+    if (directory.files.contains(gridUnitFileName)) {
+        return QStringLiteral("1/") + prefix + suffixForGridUnit(m_gridUnit) + suffix;
     }
 
     /* No file with expected grid unit suffix exists.
-       List all the files of the form fileBaseName@[0-9]*.fileSuffix and select
+       Among the files of the form fileBaseName@[0-9]*.fileSuffix, select
        the most appropriate one privileging downscaling high resolution assets
        over upscaling low resolution assets.
 
@@ -249,21 +253,23 @@ QString UCUnits::resolveResource(const QUrl& url)
        file would be resource@14.png since it is above 10 and smaller
        than resource@18.png.
     */
-    QStringList nameFilters;
-    nameFilters << fileInfo.baseName() + "@[0-9]*" + suffix;
-    const QStringList files = fileInfo.dir().entryList(nameFilters, QDir::Files);
-
-    if (!files.empty()) {
-        float selectedGridUnitSuffix = gridUnitSuffixFromFileName(files.first());
-
-        Q_FOREACH (const QString& fileName, files) {
-            float gridUnitSuffix = gridUnitSuffixFromFileName(fileName);
-            if ((selectedGridUnitSuffix >= m_gridUnit && gridUnitSuffix >= m_gridUnit && gridUnitSuffix < selectedGridUnitSuffix)
-                || (selectedGridUnitSuffix < m_gridUnit && gridUnitSuffix > selectedGridUnitSuffix)) {
-                selectedGridUnitSuffix = gridUnitSuffix;
-            }
+    bool found = false;
+    float selectedGridUnitSuffix = 0;
+    const QVector<ResourceVariant> variants = directory.variants.value(fileInfo.baseName());
+    Q_FOREACH (const ResourceVariant &variant, variants) {
+        if (!variant.fileName.endsWith(suffix)) {
+            continue;
         }
+        const float gridUnitSuffix = variant.gridUnit;
+        if (!found
+            || (selectedGridUnitSuffix >= m_gridUnit && gridUnitSuffix >= m_gridUnit && gridUnitSuffix < selectedGridUnitSuffix)
+            || (selectedGridUnitSuffix < m_gridUnit && gridUnitSuffix > selectedGridUnitSuffix)) {
+            selectedGridUnitSuffix = gridUnitSuffix;
+            found = true;
+        }
+    }
 
+    if (found) {
         path = prefix + suffixForGridUnit(selectedGridUnitSuffix) + suffix;
         float scaleFactor = m_gridUnit / selectedGridUnitSuffix;
         return QString::number(scaleFactor) + "/" + path;
@@ -272,6 +278,73 @@ QString UCUnits::resolveResource(const QUrl& url)
     return QString();
 }
 
+/*
+ * Returns the entries of the directory at path, listed on the first call and
+ * kept until the watcher reports a change in the directory. Resource
+ * directories (qrc) never change and aren't watched. Missing directories and
+ * directories that can't be watched are listed on each call.
+ */
+UCUnits::ResourceDirectory UCUnits::resourceDirectory(const QString &path)
+{
+    QHash<QString, ResourceDirectory>::const_iterator it = m_resourceDirectories.constFind(path);
+    if (it != m_resourceDirectories.constEnd()) {
+        return it.value();
+    }
+
+    // watch before listing so that no change gets missed
+    const QDir dir(path);
+    bool cacheable = dir.exists();
+    if (cacheable && !path.startsWith(QLatin1Char(':'))) {
+        if (!m_resourceWatcher) {
+            m_resourceWatcher = new QFileSystemWatcher(this);
+            QObject::connect(m_resourceWatcher, &QFileSystemWatcher::directoryChanged,
+                             this, &UCUnits::resourceDirectoryChanged);
+        }
+        cacheable = m_resourceWatcher->addPath(path);
+    }
+
+    ResourceDirectory directory;
+    const QFileInfoList entries =
+        dir.entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+    Q_FOREACH (const QFileInfo &entry, entries) {
+        const QString fileName = entry.fileName();
+        if (!entry.isFile()) {
+            directory.others.insert(fileName);
+            continue;
+        }
+        directory.files.insert(fileName);
+        // the grid unit suffix starts with a digit after the last '@' of the
+        // base name, which stops at the first dot
+        const int dot = fileName.indexOf(QLatin1Char('.'));
+        const int at = dot > 0 ? fileName.lastIndexOf(QLatin1Char('@'), dot - 1)
+                               : (dot == -1 ? fileName.lastIndexOf(QLatin1Char('@')) : -1);
+        if (at == -1) {
+            continue;
+        }
+        int digits = at + 1;
+        while (digits < fileName.size()
+               && fileName.at(digits) >= QLatin1Char('0') && fileName.at(digits) <= QLatin1Char('9')) {
+            digits++;
+        }
+        if (digits > at + 1) {
+            ResourceVariant variant = { fileName, fileName.midRef(at + 1, digits - at - 1).toFloat() };
+            directory.variants[fileName.left(at)].append(variant);
+        }
+    }
+
+    if (cacheable) {
+        m_resourceDirectories.insert(path, directory);
+    }
+    return directory;
+}
+
+void UCUnits::resourceDirectoryChanged(const QString &path)
+{
+    // listed again and watched again on the next lookup
+    m_resourceDirectories.remove(path);
+    m_resourceWatcher->removePath(path);
+}
+
 QString UCUnits::suffixForGridUnit(float gridUnit)
 {
     return "@" + QString::number(gridUnit);
@@ -279,7 +352,7 @@ QString UCUnits::suffixForGridUnit(float gridUnit)
 
 float UCUnits::gridUnitSuffixFromFileName(const QString& fileName)
 {
-    QRegularExpression re(QStringLiteral("^.*@([0-9]*).*$"));
+    static const QRegularExpression re(QStringLiteral("^.*@([0-9]*).*$"));
     QRegularExpressionMatch match = re.match(fileName);
     if (match.hasMatch()) {
         return match.captured(1).toFloat();
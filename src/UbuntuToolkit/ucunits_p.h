@@ -21,12 +21,15 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QObject>
+#include <QtCore/QSet>
 #include <QtCore/QString>
 #include <QtCore/QUrl>
+#include <QtCore/QVector>
 #include <QtGui/QWindow>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
 
+class QFileSystemWatcher;
 class QPlatformWindow;
 
 UT_NAMESPACE_BEGIN
@@ -72,12 +75,30 @@ private Q_SLOTS:
     void windowPropertyChanged(QPlatformWindow *window, const QString &propertyName);
     void screenChanged(QScreen *screen);
     void devicePixelRatioChanged(qreal dpi);
+    void resourceDirectoryChanged(const QString &path);
 
 private:
+    struct ResourceVariant {
+        QString fileName;
+        float gridUnit;
+    };
+    // Entries of a resource directory. The files with a grid unit suffix
+    // (name@[0-9]*.suffix) are indexed by the name before the '@'.
+    struct ResourceDirectory {
+        QSet<QString> files;
+        QSet<QString> others;
+        QHash<QString, QVector<ResourceVariant> > variants;
+    };
+
+    ResourceDirectory resourceDirectory(const QString &path);
+
     static UCUnits *m_units;
     float m_devicePixelRatio;
     QScreen *m_screen;
     float m_gridUnit;
+    // indexed resource directories, dropped when the watcher reports a change
+    QHash<QString, ResourceDirectory> m_resourceDirectories;
+    QFileSystemWatcher *m_resourceWatcher;
 };
 
 UT_NAMESPACE_END
@@ -110,12 +110,16 @@ UT_NAMESPACE_BEGIN
  */
 UCViewItemsAttachedPrivate::UCViewItemsAttachedPrivate()
     : QObjectPrivate()
+    , count(0)
+    , width(-1)
     , listView(0)
     , dragArea(0)
     , expansionFlags(UCViewItemsAttached::Exclusive)
     , selectable(false)
     , draggable(false)
     , ready(false)
+    , selectedIndicesDirty(false)
+    , expandedIndicesDirty(false)
 {
 }
 
@@ -134,10 +138,40 @@ void UCViewItemsAttachedPrivate::init()
         listView->view()->setActiveFocusOnTab(true);
         // filter ListView events to override up/down focus handling
         listView->overrideItemNavigation(true);
+
+        // the selected and expanded indices follow the model changes
+        attachToModel();
+        QObject::connect(listView->view(), SIGNAL(modelChanged()), q, SLOT(updateModel()));
     }
     // listen readyness
     QQmlComponentAttached *attached = QQmlComponent::qmlAttachedProperties(parent);
     QObject::connect(attached, &QQmlComponentAttached::completed, q, &UCViewItemsAttached::completed);
+
+    // the view count, width and grid unit changes are followed here for all the ListItems
+    QQuickItem *owner = qobject_cast<QQuickItem*>(parent);
+    if (owner) {
+        width = owner->width();
+        QObject::connect(owner, &QQuickItem::widthChanged, q, &UCViewItemsAttached::updateItemsSize);
+        QObject::connect(UCUnits::instance(), &UCUnits::gridUnitChanged, q, &UCViewItemsAttached::updateItemsSize);
+    }
+    int countIndex = parent->metaObject()->indexOfProperty("count");
+    if (countIndex >= 0) {
+        countProperty = parent->metaObject()->property(countIndex);
+        count = countProperty.read(parent).toInt();
+        if (countProperty.hasNotifySignal()) {
+            static int updateCountIndex = UCViewItemsAttached::staticMetaObject.indexOfSlot("updateCount()");
+            QMetaObject::connect(parent, countProperty.notifySignalIndex(), q, updateCountIndex, Qt::DirectConnection);
+        }
+    }
+}
+
+void UCViewItemsAttachedPrivate::trackListItem(UCListItem *item, bool track)
+{
+    if (track) {
+        listItems.insert(item);
+    } else {
+        listItems.remove(item);
+    }
 }
 
 // disconnect all flickables
@@ -261,6 +295,50 @@ void UCViewItemsAttached::unbindItem()
     d->clearFlickablesList();
 }
 
+// only the dividers of the previous and the new last ListItem need repainting
+void UCViewItemsAttached::updateCount()
+{
+    Q_D(UCViewItemsAttached);
+    int count = d->countProperty.read(parent()).toInt();
+    if (count == d->count) {
+        return;
+    }
+    d->count = count;
+
+    UCListItem *lastItem = Q_NULLPTR;
+    Q_FOREACH(UCListItem *item, d->listItems) {
+        if (UCListItemPrivate::get(item)->index() == count - 1) {
+            lastItem = item;
+            break;
+        }
+    }
+    if (lastItem == d->lastListItem) {
+        return;
+    }
+    if (d->lastListItem) {
+        UCListItemPrivate::get(d->lastListItem)->divider->update();
+    }
+    d->lastListItem = lastItem;
+    if (lastItem) {
+        UCListItemPrivate::get(lastItem)->divider->update();
+    }
+}
+
+void UCViewItemsAttached::updateItemsSize()
+{
+    Q_D(UCViewItemsAttached);
+    d->width = static_cast<QQuickItem*>(parent())->width();
+    Q_FOREACH(UCListItem *item, d->listItems) {
+        UCListItemPrivate::get(item)->updateSize();
+    }
+}
+
+void UCViewItemsAttached::updateModel()
+{
+    Q_D(UCViewItemsAttached);
+    d->attachToModel();
+}
+
 // reports completion, and in case the dragMode is turned on, enters drag mode
 void UCViewItemsAttached::completed()
 {
@@ -303,40 +381,68 @@ void UCViewItemsAttached::setSelectMode(bool value)
  * indexes are model indexes when used in ListView, and child indexes in other
  * components. The property being writable, initial selection configuration
  * can be provided for a view, and provides ability to save the selection state.
+ * The indexes are sorted in ascending order.
  */
 QList<int> UCViewItemsAttached::selectedIndices() const
 {
     Q_D(const UCViewItemsAttached);
-    return d->selectedList.values();
+    if (d->selectedIndicesDirty) {
+        d->selectedIndices = d->selectedList.toList();
+        d->selectedIndicesDirty = false;
+    }
+    return d->selectedIndices;
 }
 void UCViewItemsAttached::setSelectedIndices(const QList<int> &list)
 {
     Q_D(UCViewItemsAttached);
-    if (d->selectedList.values() == list) {
+    IndexRanges selection = IndexRanges::fromList(list);
+    if (d->selectedList == selection) {
         return;
     }
-#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-    d->selectedList = QSet<int>(list.begin(), list.end());
-#else
-    d->selectedList = QSet<int>::fromList(list);
-#endif
-    Q_EMIT selectedIndicesChanged(list);
+    IndexRanges::RangeList added = selection.subtracted(d->selectedList);
+    IndexRanges::RangeList removed = d->selectedList.subtracted(selection);
+    d->selectedList = selection;
+    d->selectionChanged(added, removed);
+}
+
+/*!
+ * \qmlattachedsignal ViewItems::selectionRangesChanged(var added, var removed)
+ * \since Ubuntu.Components 1.2
+ * The signal is emitted together with \l selectedIndicesChanged and reports
+ * the indexes which got selected and deselected. Both parameters are arrays of
+ * \c {[first, last]} index intervals, so selecting all items of a view is
+ * reported as a single interval.
+ */
+// the selectedIndices list is only built if there is anyone listening to its change
+void UCViewItemsAttachedPrivate::selectionChanged(const IndexRanges::RangeList &added, const IndexRanges::RangeList &removed)
+{
+    Q_Q(UCViewItemsAttached);
+    selectedIndicesDirty = true;
+    Q_EMIT q->selectionRangesChanged(IndexRanges::toVariantList(added), IndexRanges::toVariantList(removed));
+
+    static QMetaMethod method = QMetaMethod::fromSignal(&UCViewItemsAttached::selectedIndicesChanged);
+    static int signalIdx = QMetaObjectPrivate::signalIndex(method);
+    if (QObjectPrivate::get(q)->isSignalConnected(signalIdx)) {
+        Q_EMIT q->selectedIndicesChanged(q->selectedIndices());
+    }
 }
 
 bool UCViewItemsAttachedPrivate::addSelectedItem(UCListItem *item)
 {
     int index = UCListItemPrivate::get(item)->index();
-    if (!selectedList.contains(index)) {
-        selectedList.insert(index);
-        Q_EMIT q_func()->selectedIndicesChanged(selectedList.values());
+    IndexRanges::RangeList added;
+    if (selectedList.insert(index, index, &added)) {
+        selectionChanged(added, IndexRanges::RangeList());
         return true;
     }
     return false;
 }
 bool UCViewItemsAttachedPrivate::removeSelectedItem(UCListItem *item)
 {
-    if (selectedList.remove(UCListItemPrivate::get(item)->index()) > 0) {
-        Q_EMIT q_func()->selectedIndicesChanged(selectedList.values());
+    int index = UCListItemPrivate::get(item)->index();
+    IndexRanges::RangeList removed;
+    if (selectedList.remove(index, index, &removed)) {
+        selectionChanged(IndexRanges::RangeList(), removed);
         return true;
     }
     return false;
@@ -544,37 +650,106 @@ bool UCViewItemsAttachedPrivate::isDragUpdatedConnected()
 // updates the selected indices list in ViewAttached which is changed due to dragging
 void UCViewItemsAttachedPrivate::updateSelectedIndices(int fromIndex, int toIndex)
 {
+    if (model) {
+        // the indices already followed the move of the model rows
+        return;
+    }
     if (selectedList.count() == listView->count()) {
         // all indices selected, no need to reorder
         return;
     }
 
+    IndexRanges previous = selectedList;
+    selectedList.move(fromIndex, toIndex);
+    if (selectedList != previous) {
+        selectionChanged(selectedList.subtracted(previous), previous.subtracted(selectedList));
+    }
+}
+
+// connects the rows of the ListView model, or of the model of its DelegateModel
+void UCViewItemsAttachedPrivate::attachToModel()
+{
     Q_Q(UCViewItemsAttached);
-    bool isFromSelected = selectedList.contains(fromIndex);
-    if (isFromSelected) {
-        selectedList.remove(fromIndex);
-        Q_EMIT q->selectedIndicesChanged(selectedList.values());
-    }
-    // direction is -1 (forwards) or 1 (backwards)
-    int direction = (fromIndex < toIndex) ? -1 : 1;
-    int i = (direction < 0) ? fromIndex + 1 : fromIndex - 1;
-    // loop thru the selectedIndices and fix all indices
-    while (1) {
-        if (((direction < 0) && (i > toIndex)) ||
-            ((direction > 0) && (i < toIndex))) {
-            break;
+    if (model) {
+        QObject::disconnect(model.data(), 0, q, 0);
+    }
+    QVariant data = listView->model();
+    model = data.value<QAbstractItemModel*>();
+    QQmlDelegateModel *delegateModel = data.value<QQmlDelegateModel*>();
+    if (!model && delegateModel) {
+        model = delegateModel->model().value<QAbstractItemModel*>();
+    }
+    if (!model) {
+        return;
+    }
+
+    // only the top level rows are shown
+    QObject::connect(model.data(), &QAbstractItemModel::rowsInserted,
+                     q, [this](const QModelIndex &parent, int first, int last) {
+        if (!parent.isValid()) {
+            shiftIndices(-1, first, last - first + 1);
+        }
+    });
+    QObject::connect(model.data(), &QAbstractItemModel::rowsRemoved,
+                     q, [this](const QModelIndex &parent, int first, int last) {
+        if (!parent.isValid()) {
+            shiftIndices(first, -1, last - first + 1);
         }
+    });
+    QObject::connect(model.data(), &QAbstractItemModel::rowsMoved,
+                     q, [this](const QModelIndex &parent, int first, int last, const QModelIndex &destination, int row) {
+        if (!parent.isValid() && !destination.isValid()) {
+            // row is the destination before the rows are taken out
+            int count = last - first + 1;
+            shiftIndices(first, (row > first) ? row - count : row, count);
+        }
+    });
+}
 
-        if (selectedList.contains(i)) {
-            selectedList.remove(i);
-            selectedList.insert(i + direction);
-            Q_EMIT q->selectedIndicesChanged(selectedList.values());
+// shifts the selected and expanded indices after count rows got removed at
+// removedAt and/or inserted at insertedAt; rows removed and inserted are moved
+void UCViewItemsAttachedPrivate::shiftIndices(int removedAt, int insertedAt, int count)
+{
+    IndexRanges previousSelection = selectedList;
+    IndexRanges previousExpansion = expansionList;
+    if (removedAt >= 0 && insertedAt >= 0) {
+        selectedList.move(removedAt, insertedAt, count);
+        expansionList.move(removedAt, insertedAt, count);
+    } else if (removedAt >= 0) {
+        selectedList.shiftRemoved(removedAt, count);
+        expansionList.shiftRemoved(removedAt, count);
+    } else {
+        selectedList.shiftInserted(insertedAt, count);
+        expansionList.shiftInserted(insertedAt, count);
+    }
+
+    QHash<int, QPointer<UCListItem> > items;
+    QHashIterator<int, QPointer<UCListItem> > i(expandedItems);
+    while (i.hasNext()) {
+        i.next();
+        int index = i.key();
+        if (removedAt >= 0 && index >= removedAt) {
+            if (index < removedAt + count) {
+                if (insertedAt >= 0) {
+                    items.insert(index - removedAt + insertedAt, i.value());
+                }
+                continue;
+            }
+            index -= count;
         }
-        i -= direction;
+        if (insertedAt >= 0 && index >= insertedAt) {
+            index += count;
+        }
+        items.insert(index, i.value());
+    }
+    expandedItems = items;
+
+    if (selectedList != previousSelection) {
+        selectionChanged(selectedList.subtracted(previousSelection), previousSelection.subtracted(selectedList));
     }
-    if (isFromSelected) {
-        selectedList.insert(toIndex);
-        Q_EMIT q->selectedIndicesChanged(selectedList.values());
+    if (expansionList != previousExpansion) {
+        expandedIndicesDirty = true;
+        expansionChanged(expansionList.subtracted(previousExpansion), previousExpansion.subtracted(expansionList));
     }
 }
 
@@ -592,59 +767,99 @@ void UCViewItemsAttachedPrivate::updateSelectedIndices(int fromIndex, int toInde
 QList<int> UCViewItemsAttached::expandedIndices() const
 {
     Q_D(const UCViewItemsAttached);
-    return d->expansionList.keys();
+    if (d->expandedIndicesDirty) {
+        d->expandedIndices = d->expansionList.toList();
+        d->expandedIndicesDirty = false;
+    }
+    return d->expandedIndices;
 }
 void UCViewItemsAttached::setExpandedIndices(QList<int> indices)
 {
-    Q_UNUSED(indices);
     Q_D(UCViewItemsAttached);
-    d->collapseAll();
+    IndexRanges previous = d->expansionList;
+    d->collapseAll(false);
     if (indices.size() > 0) {
         if (d->expansionFlags & UCViewItemsAttached::Exclusive) {
             // take only the last one from the list
-            d->expand(indices.last(), QPointer<UCListItem>(), false);
+            d->expand(indices.last(), Q_NULLPTR, false);
         } else {
-            for (int i = 0; i < indices.size(); i++) {
-                d->expand(indices[i], QPointer<UCListItem>(), false);
-            }
+            d->expansionList = IndexRanges::fromList(indices);
         }
     }
-    Q_EMIT expandedIndicesChanged(d->expansionList.keys());
+    d->expandedIndicesDirty = true;
+    d->expansionChanged(d->expansionList.subtracted(previous), previous.subtracted(d->expansionList));
 }
 
-// insert listItem into the expanded indices map
+/*!
+ * \qmlattachedsignal ViewItems::expansionRangesChanged(var added, var removed)
+ * \since Ubuntu.Components 1.2
+ * The signal is emitted together with \l expandedIndicesChanged and reports
+ * the indexes which got expanded and collapsed, as arrays of \c {[first, last]}
+ * index intervals.
+ */
+void UCViewItemsAttachedPrivate::expansionChanged(const IndexRanges::RangeList &added, const IndexRanges::RangeList &removed)
+{
+    Q_Q(UCViewItemsAttached);
+    Q_EMIT q->expansionRangesChanged(IndexRanges::toVariantList(added), IndexRanges::toVariantList(removed));
+
+    static QMetaMethod method = QMetaMethod::fromSignal(&UCViewItemsAttached::expandedIndicesChanged);
+    static int signalIdx = QMetaObjectPrivate::signalIndex(method);
+    if (QObjectPrivate::get(q)->isSignalConnected(signalIdx)) {
+        Q_EMIT q->expandedIndicesChanged(q->expandedIndices());
+    }
+}
+
+// insert index into the expanded indices, listItem is set when expanded interactively
 void UCViewItemsAttachedPrivate::expand(int index, UCListItem *listItem, bool emitChangeSignal)
 {
-    expansionList.insert(index, QPointer<UCListItem>(listItem));
-    if (listItem && ((expansionFlags & UCViewItemsAttached::CollapseOnOutsidePress) == UCViewItemsAttached::CollapseOnOutsidePress)) {
-        listItem->expansion()->enableClickFiltering(true);
+    IndexRanges::RangeList added;
+    expansionList.insert(index, index, &added);
+    expandedIndicesDirty = true;
+    if (listItem) {
+        expandedItems.insert(index, QPointer<UCListItem>(listItem));
+        if ((expansionFlags & UCViewItemsAttached::CollapseOnOutsidePress) == UCViewItemsAttached::CollapseOnOutsidePress) {
+            listItem->expansion()->enableClickFiltering(true);
+        }
     }
-    if (emitChangeSignal) {
-        Q_EMIT static_cast<UCViewItemsAttached*>(q_func())->expandedIndicesChanged(expansionList.keys());
+    if (emitChangeSignal && !added.isEmpty()) {
+        expansionChanged(added, IndexRanges::RangeList());
     }
 }
 
 // collapse the item at index
 void UCViewItemsAttachedPrivate::collapse(int index, bool emitChangeSignal)
 {
-    UCListItem *item = expansionList.take(index).data();
-    bool wasExpanded = item && item->expansion()->expanded();
+    UCListItem *item = expandedItems.take(index).data();
     if (item && ((expansionFlags & UCViewItemsAttached::CollapseOnOutsidePress) == UCViewItemsAttached::CollapseOnOutsidePress)) {
         item->expansion()->enableClickFiltering(false);
     }
-    if (emitChangeSignal && wasExpanded) {
-        Q_EMIT static_cast<UCViewItemsAttached*>(q_func())->expandedIndicesChanged(expansionList.keys());
+    IndexRanges::RangeList removed;
+    if (expansionList.remove(index, index, &removed)) {
+        expandedIndicesDirty = true;
+        if (emitChangeSignal) {
+            expansionChanged(IndexRanges::RangeList(), removed);
+        }
     }
 }
 
-void UCViewItemsAttachedPrivate::collapseAll()
+void UCViewItemsAttachedPrivate::collapseAll(bool emitChangeSignal)
 {
-    bool emitChangedSignal = (expansionList.keys().size() > 0);
-    while (expansionList.keys().size() > 0) {
-        collapse(expansionList.keys().last(), false);
+    if (expansionList.isEmpty()) {
+        return;
     }
-    if (emitChangedSignal) {
-        Q_EMIT static_cast<UCViewItemsAttached*>(q_func())->expandedIndicesChanged(expansionList.keys());
+    if ((expansionFlags & UCViewItemsAttached::CollapseOnOutsidePress) == UCViewItemsAttached::CollapseOnOutsidePress) {
+        Q_FOREACH(const QPointer<UCListItem> &item, expandedItems) {
+            if (item) {
+                item->expansion()->enableClickFiltering(false);
+            }
+        }
+    }
+    expandedItems.clear();
+    IndexRanges::RangeList removed = expansionList.ranges();
+    expansionList.clear();
+    expandedIndicesDirty = true;
+    if (emitChangeSignal) {
+        expansionChanged(IndexRanges::RangeList(), removed);
     }
 }
 
@@ -694,7 +909,7 @@ void UCViewItemsAttachedPrivate::toggleExpansionFlags(bool enable)
     if (!hasClickOutsideFlag) {
         return;
     }
-    QMapIterator<int, QPointer<UCListItem> > i(expansionList);
+    QHashIterator<int, QPointer<UCListItem> > i(expandedItems);
     while (i.hasNext()) {
         UCListItem *item = i.next().value().data();
         // using expansion getter we will get the group created
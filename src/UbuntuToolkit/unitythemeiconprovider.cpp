@@ -18,8 +18,14 @@
 
 #include "unitythemeiconprovider_p.h"
 
+#include <cstring>
+
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
 #include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 #include <QtCore/QSettings>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QtDebug>
@@ -33,44 +39,99 @@ class IconTheme
 public:
     typedef QSharedPointer<class IconTheme> IconThemePointer;
 
+    // Guards the themes, shared by all the providers of all the engines and
+    // indexed lazily. Must be held while calling get() and using a theme.
+    static QMutex *mutex()
+    {
+        static QMutex themesMutex;
+        return &themesMutex;
+    }
+
     // Returns the icon theme named @name, creating it if it didn't exist yet.
     static IconThemePointer get(const QString &name)
     {
-        static QHash<QString, IconThemePointer> themes;
-
-        IconThemePointer theme = themes[name];
+        IconThemePointer theme = themes()[name];
         if (theme.isNull()) {
             theme = IconThemePointer(new IconTheme(name));
-            themes[name] = theme;
+            themes()[name] = theme;
         }
 
         return theme;
     }
 
+    // Drops the themes created so far, they are loaded again on next use.
+    static void clear()
+    {
+        themes().clear();
+    }
+
+    // The file to decode for an icon, and the size to decode it at.
+    struct Match {
+        QString filename;
+        QSize size;
+    };
+
     // Does a breadth-first search for an icon with any name in @names. Parent
     // themes are only looked at if the current theme doesn't contain any icon
     // in @names.
-    QImage findBestIcon(const QStringList &names, QSize *impsize, const QSize &size, QSet<QString> *alreadySearchedThemes)
+    Match findBestIcon(const QStringList &names, const QSize &size, QSet<QString> *alreadySearchedThemes)
     {
         if (alreadySearchedThemes) {
             if (alreadySearchedThemes->contains(name))
-                return QImage();
+                return Match();
             alreadySearchedThemes->insert(name);
         }
 
         Q_FOREACH(const QString &name, names) {
-            QImage image = lookupIcon(name, impsize, size);
-            if (!image.isNull())
-                return image;
+            Match match = lookupIcon(name, size);
+            if (!match.filename.isNull())
+                return match;
         }
 
         Q_FOREACH(IconThemePointer theme, parents) {
-            QImage image = theme->findBestIcon(names, impsize, size, alreadySearchedThemes);
-            if (!image.isNull())
-                return image;
+            Match match = theme->findBestIcon(names, size, alreadySearchedThemes);
+            if (!match.filename.isNull())
+                return match;
         }
 
-        return QImage();
+        return Match();
+    }
+
+    static QImage loadIcon(const QString &filename, QSize *impsize, const QSize &requestSize)
+    {
+        QImageReader imgio(filename);
+
+        if (requestSize.width() > 0 || requestSize.height() > 0) {
+            const bool force_scale = (imgio.format() == "svg") || (imgio.format() == "svgz");
+            QSize s = imgio.size();
+            qreal ratio = 0.0;
+
+            if (requestSize.width() > 0 && (force_scale || requestSize.width() < s.width())) {
+                ratio = qreal(requestSize.width())/s.width();
+            }
+            if (requestSize.height() > 0 && (force_scale || requestSize.height() < s.height())) {
+                qreal hr = qreal(requestSize.height())/s.height();
+                if (ratio == 0.0 || hr < ratio)
+                    ratio = hr;
+            }
+            if (ratio > 0.0) {
+                s.setHeight(qRound(s.height() * ratio));
+                s.setWidth(qRound(s.width() * ratio));
+                imgio.setScaledSize(s);
+            }
+        }
+
+        if (impsize)
+            *impsize = imgio.scaledSize();
+
+        QImage image;
+        if (imgio.read(&image)) {
+            if (impsize)
+                *impsize = image.size();
+            return image;
+        } else {
+            return QImage();
+        }
     }
 
 private:
@@ -82,7 +143,84 @@ private:
         int size, minSize, maxSize, threshold;
     };
 
-    IconTheme(const QString &name): name(name)
+    // The file of an icon in one of the theme directories.
+    struct IconFile {
+        int directory;
+        QString path;
+    };
+
+    // Modification time of a file or directory the index depends on.
+    struct Stamp {
+        QString path;
+        qint64 mtime;
+        bool operator==(const Stamp &other) const
+        {
+            return path == other.path && mtime == other.mtime;
+        }
+    };
+
+    // The index cache is mapped and looked up in place. It starts with the
+    // magic, the version and the size of a QDataStream header holding the
+    // stamps, the directories and the parent themes. Then come, as native
+    // 32 bits words, the hash buckets with the first icon of each chain, the
+    // icons, the files and finally the UTF-8 names and paths.
+    struct IndexIcon {
+        quint32 nameOffset, nameLength;
+        // previous icon in the same bucket, or noEntry
+        quint32 next;
+        quint32 firstFile, fileCount;
+    };
+    struct IndexFile {
+        quint32 directory;
+        quint32 pathOffset, pathLength;
+    };
+
+    static const quint32 cacheMagic = 0x49435455;  // 'UTCI'
+    static const quint32 cacheVersion = 2;
+    static const quint32 noEntry = 0xffffffff;
+
+    // FNV-1a, stable across runs unlike qHash()
+    static quint32 nameHash(const char *name, int length)
+    {
+        quint32 hash = 2166136261u;
+        for (int i = 0; i < length; i++) {
+            hash = (hash ^ uchar(name[i])) * 16777619u;
+        }
+        return hash;
+    }
+
+    friend QDataStream &operator<<(QDataStream &stream, const Directory &dir)
+    {
+        return stream << dir.path << qint32(dir.sizeType) << qint32(dir.size) << qint32(dir.minSize)
+                      << qint32(dir.maxSize) << qint32(dir.threshold);
+    }
+    friend QDataStream &operator>>(QDataStream &stream, Directory &dir)
+    {
+        qint32 sizeType, size, minSize, maxSize, threshold;
+        stream >> dir.path >> sizeType >> size >> minSize >> maxSize >> threshold;
+        dir.sizeType = static_cast<SizeType>(sizeType);
+        dir.size = size;
+        dir.minSize = minSize;
+        dir.maxSize = maxSize;
+        dir.threshold = threshold;
+        return stream;
+    }
+    friend QDataStream &operator<<(QDataStream &stream, const Stamp &stamp)
+    {
+        return stream << stamp.path << stamp.mtime;
+    }
+    friend QDataStream &operator>>(QDataStream &stream, Stamp &stamp)
+    {
+        return stream >> stamp.path >> stamp.mtime;
+    }
+
+    IconTheme(const QString &name):
+        name(name),
+        indexBucketCount(0),
+        indexBuckets(Q_NULLPTR),
+        indexIcons(Q_NULLPTR),
+        indexFiles(Q_NULLPTR),
+        indexStrings(Q_NULLPTR)
     {
         const QStringList paths = QStandardPaths::standardLocations(QStandardPaths::GenericDataLocation);
 
@@ -92,6 +230,22 @@ private:
                 baseDirs.append(dir.absolutePath());
         }
 
+        QStringList parentNames;
+        if (!loadIndex(&parentNames)) {
+            parentNames = parseIndexTheme();
+            buildIndex();
+            saveIndex(parentNames);
+        }
+
+        Q_FOREACH(const QString &name, parentNames) {
+            parents.append(IconTheme::get(name));
+        }
+    }
+
+    // Parses the index.theme file, returns the names of the parent themes.
+    QStringList parseIndexTheme()
+    {
+        QStringList parentNames;
         Q_FOREACH(const QString &baseDir, baseDirs) {
             QString filename = baseDir + "/index.theme";
             if (QFileInfo::exists(filename)) {
@@ -115,7 +269,7 @@ private:
                     settings.value(QStringLiteral("Icon Theme/Inherits")).toStringList();
                 Q_FOREACH(const QString &name, themeInherits) {
                     if (name != QLatin1String("hicolor")) {
-                        parents.append(IconTheme::get(name));
+                        parentNames.append(name);
                     }
                 }
 
@@ -123,132 +277,298 @@ private:
                 break;
             }
         }
+        return parentNames;
     }
 
-    SizeType sizeTypeFromString(const QString &string)
+    // Lists the icons of every directory once. The first base directory
+    // containing an icon wins, and PNG files are preferred over SVG ones.
+    void buildIndex()
     {
-        if (string == QLatin1String("Fixed"))
-            return Fixed;
-        if (string == QLatin1String("Scalable"))
-            return Scalable;
-        if (string == QLatin1String("Threshold"))
-            return Threshold;
-        qWarning() << "IconTheme: unknown size type '" << string << "'. Assuming 'Fixed'.";
-        return Fixed;
+        icons.clear();
+        const QStringList pngFilter(QStringLiteral("*.png"));
+        const QStringList svgFilter(QStringLiteral("*.svg"));
+
+        for (int i = 0; i < directories.size(); i++) {
+            Q_FOREACH(const QString &baseDir, baseDirs) {
+                QDir dir(baseDir + "/" + directories[i].path);
+                if (!dir.exists())
+                    continue;
+
+                const QStringList files = dir.entryList(pngFilter, QDir::Files) + dir.entryList(svgFilter, QDir::Files);
+                Q_FOREACH(const QString &file, files) {
+                    QVector<IconFile> &entries = icons[file.left(file.size() - 4)];
+                    if (entries.isEmpty() || entries.last().directory != i) {
+                        IconFile iconFile = { i, dir.filePath(file) };
+                        entries.append(iconFile);
+                    }
+                }
+            }
+        }
     }
 
-    static QImage loadIcon(const QString &filename, QSize *impsize, const QSize &requestSize)
+    // The index is valid as long as the index.theme files and the theme
+    // directories are not modified.
+    QVector<Stamp> stamps() const
     {
-        QImageReader imgio(filename);
+        QVector<Stamp> result;
+        Q_FOREACH(const QString &baseDir, baseDirs) {
+            Stamp stamp = { baseDir, QFileInfo(baseDir).lastModified().toMSecsSinceEpoch() };
+            result.append(stamp);
+            const QFileInfo index(baseDir + "/index.theme");
+            Stamp indexStamp = { index.filePath(), index.exists() ? index.lastModified().toMSecsSinceEpoch() : -1 };
+            result.append(indexStamp);
+            Q_FOREACH(const Directory &dir, directories) {
+                const QFileInfo info(baseDir + "/" + dir.path);
+                Stamp dirStamp = { info.filePath(), info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1 };
+                result.append(dirStamp);
+            }
+        }
+        return result;
+    }
 
-        if (requestSize.width() > 0 || requestSize.height() > 0) {
-            const bool force_scale = (imgio.format() == "svg") || (imgio.format() == "svgz");
-            QSize s = imgio.size();
-            qreal ratio = 0.0;
+    QString indexCachePath() const
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+            + QStringLiteral("/ubuntu-ui-toolkit/icons/%1.cache").arg(name);
+    }
 
-            if (requestSize.width() > 0 && (force_scale || requestSize.width() < s.width())) {
-                ratio = qreal(requestSize.width())/s.width();
-            }
-            if (requestSize.height() > 0 && (force_scale || requestSize.height() < s.height())) {
-                qreal hr = qreal(requestSize.height())/s.height();
-                if (ratio == 0.0 || hr < ratio)
-                    ratio = hr;
-            }
-            if (ratio > 0.0) {
-                s.setHeight(qRound(s.height() * ratio));
-                s.setWidth(qRound(s.width() * ratio));
-                imgio.setScaledSize(s);
-            }
+    // Maps the index from the disk cache, returns false if there's no cache,
+    // if it's outdated or if it's not consistent.
+    bool loadIndex(QStringList *parentNames)
+    {
+        if (baseDirs.isEmpty())
+            return false;
+
+        indexFile.setFileName(indexCachePath());
+        if (!indexFile.open(QIODevice::ReadOnly))
+            return false;
+        const qint64 size = indexFile.size();
+        const uchar *data = size >= qint64(3 * sizeof(quint32)) ? indexFile.map(0, size) : Q_NULLPTR;
+        if (!data || !readIndex(data, size, parentNames)) {
+            directories.clear();
+            parentNames->clear();
+            indexBuckets = Q_NULLPTR;
+            indexIcons = Q_NULLPTR;
+            indexFile.close();
+            return false;
         }
+        return true;
+    }
 
-        if (impsize)
-            *impsize = imgio.scaledSize();
+    bool readIndex(const uchar *data, qint64 size, QStringList *parentNames)
+    {
+        const quint32 *words = reinterpret_cast<const quint32*>(data);
+        if (words[0] != cacheMagic || words[1] != cacheVersion)
+            return false;
+        quint64 offset = 3 * sizeof(quint32);
+        const quint64 headerSize = words[2];
+        if (offset + headerSize > quint64(size))
+            return false;
+
+        const QByteArray header = QByteArray::fromRawData(reinterpret_cast<const char*>(data + offset), headerSize);
+        QDataStream stream(header);
+        stream.setVersion(QDataStream::Qt_5_0);
+        QVector<Stamp> cachedStamps;
+        stream >> cachedStamps >> directories >> *parentNames;
+        if (stream.status() != QDataStream::Ok || cachedStamps != stamps())
+            return false;
+
+        // the tables, checked once so that lookups don't need to
+        offset = (offset + headerSize + 3) & ~quint64(3);
+        const quint32 *bucketCount = table<quint32>(data, size, &offset, 1);
+        const quint32 *buckets = bucketCount ? table<quint32>(data, size, &offset, *bucketCount) : Q_NULLPTR;
+        const quint32 *iconCount = buckets ? table<quint32>(data, size, &offset, 1) : Q_NULLPTR;
+        const IndexIcon *icons = iconCount ? table<IndexIcon>(data, size, &offset, *iconCount) : Q_NULLPTR;
+        const quint32 *fileCount = icons ? table<quint32>(data, size, &offset, 1) : Q_NULLPTR;
+        const IndexFile *files = fileCount ? table<IndexFile>(data, size, &offset, *fileCount) : Q_NULLPTR;
+        if (!files || *bucketCount == 0)
+            return false;
+        const quint64 stringsSize = size - offset;
+
+        for (quint32 i = 0; i < *bucketCount; i++) {
+            if (buckets[i] != noEntry && buckets[i] >= *iconCount)
+                return false;
+        }
+        for (quint32 i = 0; i < *iconCount; i++) {
+            const IndexIcon &icon = icons[i];
+            // chains only go backwards, so they can't loop
+            if ((icon.next != noEntry && icon.next >= i)
+                    || quint64(icon.nameOffset) + icon.nameLength > stringsSize
+                    || quint64(icon.firstFile) + icon.fileCount > *fileCount)
+                return false;
+        }
+        for (quint32 i = 0; i < *fileCount; i++) {
+            const IndexFile &file = files[i];
+            if (file.directory >= quint32(directories.size())
+                    || quint64(file.pathOffset) + file.pathLength > stringsSize)
+                return false;
+        }
 
-        QImage image;
-        if (imgio.read(&image)) {
-            if (impsize)
-                *impsize = image.size();
-            return image;
-        } else {
-            return QImage();
+        indexBucketCount = *bucketCount;
+        indexBuckets = buckets;
+        indexIcons = icons;
+        indexFiles = files;
+        indexStrings = reinterpret_cast<const char*>(data + offset);
+        return true;
+    }
+
+    // Returns the @count items at @offset and moves past them, null if they
+    // don't fit in the @size bytes of @data.
+    template<typename T>
+    static const T *table(const uchar *data, qint64 size, quint64 *offset, quint32 count)
+    {
+        const quint64 end = *offset + quint64(count) * sizeof(T);
+        if (end > quint64(size))
+            return Q_NULLPTR;
+        const T *items = reinterpret_cast<const T*>(data + *offset);
+        *offset = end;
+        return items;
+    }
+
+    void saveIndex(const QStringList &parentNames)
+    {
+        if (baseDirs.isEmpty())
+            return;
+
+        QByteArray header;
+        QDataStream stream(&header, QIODevice::WriteOnly);
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream << stamps() << directories << parentNames;
+
+        QVector<quint32> buckets(qMax(1, icons.size()), noEntry);
+        QVector<IndexIcon> iconTable;
+        QVector<IndexFile> fileTable;
+        QByteArray strings;
+        for (QHash<QString, QVector<IconFile> >::const_iterator i = icons.constBegin(); i != icons.constEnd(); ++i) {
+            const QByteArray name = i.key().toUtf8();
+            quint32 &bucket = buckets[nameHash(name.constData(), name.size()) % buckets.size()];
+            IndexIcon icon = { quint32(strings.size()), quint32(name.size()), bucket,
+                               quint32(fileTable.size()), quint32(i.value().size()) };
+            bucket = iconTable.size();
+            iconTable.append(icon);
+            strings += name;
+            Q_FOREACH(const IconFile &iconFile, i.value()) {
+                const QByteArray path = iconFile.path.toUtf8();
+                IndexFile file = { quint32(iconFile.directory), quint32(strings.size()), quint32(path.size()) };
+                fileTable.append(file);
+                strings += path;
+            }
         }
+
+        const QString path = indexCachePath();
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly))
+            return;
+
+        const quint32 prefix[] = { cacheMagic, cacheVersion, quint32(header.size()) };
+        file.write(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+        file.write(header);
+        file.write(QByteArray((4 - header.size() % 4) % 4, '\0'));
+        writeTable(&file, buckets);
+        writeTable(&file, iconTable);
+        writeTable(&file, fileTable);
+        file.write(strings);
+        file.commit();
     }
 
-    QString lookupIconFile(const QString &dir, const QString &name)
+    template<typename T>
+    static void writeTable(QSaveFile *file, const QVector<T> &items)
     {
-        QString png = QStringLiteral("%1/%2.png").arg(dir, name);
-        QString svg = QStringLiteral("%1/%2.svg").arg(dir, name);
+        const quint32 count = items.size();
+        file->write(reinterpret_cast<const char*>(&count), sizeof(count));
+        file->write(reinterpret_cast<const char*>(items.constData()), count * sizeof(T));
+    }
 
-        Q_FOREACH(const QString &baseDir, baseDirs) {
-            QString filename = baseDir + "/" + png;
-            if (QFileInfo::exists(filename))
-                return filename;
+    // The files of the icon named @iconName, ordered by directory.
+    QVector<IconFile> iconFiles(const QString &iconName) const
+    {
+        if (!indexIcons)
+            return icons.value(iconName);
+
+        const QByteArray name = iconName.toUtf8();
+        quint32 i = indexBuckets[nameHash(name.constData(), name.size()) % indexBucketCount];
+        for (; i != noEntry; i = indexIcons[i].next) {
+            const IndexIcon &icon = indexIcons[i];
+            if (icon.nameLength != quint32(name.size())
+                    || memcmp(indexStrings + icon.nameOffset, name.constData(), name.size()) != 0)
+                continue;
 
-            filename = baseDir + "/" + svg;
-            if (QFileInfo::exists(filename))
-                return filename;
+            QVector<IconFile> files;
+            files.reserve(icon.fileCount);
+            for (quint32 j = icon.firstFile; j < icon.firstFile + icon.fileCount; j++) {
+                const IndexFile &entry = indexFiles[j];
+                IconFile file = { int(entry.directory),
+                                  QString::fromUtf8(indexStrings + entry.pathOffset, entry.pathLength) };
+                files.append(file);
+            }
+            return files;
         }
+        return QVector<IconFile>();
+    }
 
-        return QString();
+    SizeType sizeTypeFromString(const QString &string)
+    {
+        if (string == QLatin1String("Fixed"))
+            return Fixed;
+        if (string == QLatin1String("Scalable"))
+            return Scalable;
+        if (string == QLatin1String("Threshold"))
+            return Threshold;
+        qWarning() << "IconTheme: unknown size type '" << string << "'. Assuming 'Fixed'.";
+        return Fixed;
     }
 
-    QImage lookupIcon(const QString &iconName, QSize *impsize, const QSize &size)
+    Match lookupIcon(const QString &iconName, const QSize &size)
     {
         const int iconSize = qMax(size.width(), size.height());
         if (iconSize > 0)
-            return lookupBestMatchingIcon(iconName, impsize, size);
+            return lookupBestMatchingIcon(iconName, size);
         else
-            return lookupLargestIcon(iconName, impsize);
+            return lookupLargestIcon(iconName);
     }
 
-    QImage lookupBestMatchingIcon(const QString &iconName, QSize *impsize, const QSize &size)
+    Match lookupBestMatchingIcon(const QString &iconName, const QSize &size)
     {
         int minDistance = 10000;
-        QString bestFilename;
+        Match match;
 
-        Q_FOREACH(const Directory &dir, directories) {
-            int dist = directorySizeDistance(dir, size);
+        const QVector<IconFile> files = iconFiles(iconName);
+        Q_FOREACH(const IconFile &file, files) {
+            int dist = directorySizeDistance(directories[file.directory], size);
             if (dist >= minDistance)
                 continue;
 
-            QString filename = lookupIconFile(dir.path, iconName);
-            if (!filename.isNull()) {
-                minDistance = dist;
-                bestFilename = filename;
+            minDistance = dist;
+            match.filename = file.path;
 
-                // bail out early if we can't get a better size match
-                if (minDistance == 0)
-                    break;
-            }
+            // bail out early if we can't get a better size match
+            if (minDistance == 0)
+                break;
         }
 
-        if (!bestFilename.isNull())
-            return loadIcon(bestFilename, impsize, size);
-
-        return QImage();
+        match.size = size;
+        return match;
     }
 
-    QImage lookupLargestIcon(const QString &iconName, QSize *impsize)
+    Match lookupLargestIcon(const QString &iconName)
     {
         int maxSize = 0;
-        QString bestFilename;
+        Match match;
 
-        Q_FOREACH(const Directory &dir, directories) {
+        const QVector<IconFile> files = iconFiles(iconName);
+        Q_FOREACH(const IconFile &file, files) {
+            const Directory &dir = directories[file.directory];
             int size = dir.sizeType == Scalable ? dir.maxSize : dir.size;
             if (size < maxSize)
                 continue;
 
-            QString filename = lookupIconFile(dir.path, iconName);
-            if (!filename.isNull()) {
-                maxSize = size;
-                bestFilename = filename;
-            }
+            maxSize = size;
+            match.filename = file.path;
         }
 
-        if (!bestFilename.isNull())
-            return loadIcon(bestFilename, impsize, QSize(maxSize, maxSize));
-
-        return QImage();
+        match.size = QSize(maxSize, maxSize);
+        return match;
     }
 
     int directorySizeDistance(const Directory &dir, const QSize &iconSize)
@@ -269,15 +589,32 @@ private:
         }
     }
 
+    static QHash<QString, IconThemePointer> &themes()
+    {
+        static QHash<QString, IconThemePointer> themes;
+        return themes;
+    }
+
     QString name;
     QStringList baseDirs;
     QList<Directory> directories;
+    // icon name to the files of that icon, ordered by directory, when the
+    // index was built rather than mapped from the cache
+    QHash<QString, QVector<IconFile> > icons;
+    // the mapped index cache
+    QFile indexFile;
+    quint32 indexBucketCount;
+    const quint32 *indexBuckets;
+    const IndexIcon *indexIcons;
+    const IndexFile *indexFiles;
+    const char *indexStrings;
     QList<IconThemePointer> parents;
 };
 
 UnityThemeIconProvider::UnityThemeIconProvider(const QString &themeName):
     QQuickImageProvider(QQuickImageProvider::Image),
-    m_themeName(themeName)
+    m_themeName(themeName),
+    m_imageCache(imageCacheSize)
 {
     if (m_themeName.isEmpty())
         // Used by the test.
@@ -296,18 +633,51 @@ QSharedPointer<class IconTheme> UnityThemeIconProvider::getTheme()
 
 QImage UnityThemeIconProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
 {
+    const QString themeName = !m_themeName.isEmpty() ? m_themeName : QIcon::themeName();
+    const QString key = QStringLiteral("%1/%2@%3x%4")
+        .arg(themeName, id).arg(requestedSize.width()).arg(requestedSize.height());
+    {
+        QMutexLocker lock(&m_imageCacheMutex);
+        const QImage *cached = m_imageCache.object(key);
+        if (cached) {
+            if (size)
+                *size = cached->size();
+            return *cached;
+        }
+    }
+
+    // only the lookup needs the themes, the decoding is done without them
+    QMutexLocker lock(IconTheme::mutex());
     // The hicolor theme will be searched last as per
     // https://specifications.freedesktop.org/icon-theme-spec/icon-theme-spec-latest.html
     QSet<QString> alreadySearchedThemes;
     const QStringList names = id.split(QLatin1Char(','), QString::SkipEmptyParts);
-    QImage image = getTheme()->findBestIcon(names, size, requestedSize, &alreadySearchedThemes);
+    IconTheme::Match match = getTheme()->findBestIcon(names, requestedSize, &alreadySearchedThemes);
 
-    if (image.isNull()) {
+    if (match.filename.isNull()) {
         IconTheme::IconThemePointer theme = IconTheme::get(QStringLiteral("hicolor"));
-        return theme->findBestIcon(names, size, requestedSize, nullptr);
+        match = theme->findBestIcon(names, requestedSize, nullptr);
     }
+    lock.unlock();
 
+    if (match.filename.isNull())
+        return QImage();
+    const QImage image = IconTheme::loadIcon(match.filename, size, match.size);
+    if (!image.isNull()) {
+        QMutexLocker lock(&m_imageCacheMutex);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+        m_imageCache.insert(key, new QImage(image), qMax(1, static_cast<int>(image.sizeInBytes() / 1024)));
+#else
+        m_imageCache.insert(key, new QImage(image), qMax(1, image.byteCount() / 1024));
+#endif
+    }
     return image;
 }
 
+void UnityThemeIconProvider::clearThemes()
+{
+    QMutexLocker lock(IconTheme::mutex());
+    IconTheme::clear();
+}
+
 UT_NAMESPACE_END
@@ -19,6 +19,8 @@
 #ifndef UNITYTHEMEICONPROVIDER_P_H
 #define UNITYTHEMEICONPROVIDER_P_H
 
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
 #include <QtQuick/QQuickImageProvider>
 
 #include <UbuntuToolkit/ubuntutoolkitglobal.h>
@@ -32,8 +34,18 @@ public:
     QImage requestImage(const QString &id, QSize *size, const QSize &requestedSize) override;
 
 private:
+    // decoded images, in kilobytes
+    static const int imageCacheSize = 8 * 1024;
+
     QString m_themeName;
     QSharedPointer<class IconTheme> getTheme();
+    // drops the themes loaded by all the providers, used by the tests
+    static void clearThemes();
+
+    // least recently used decoded images, keyed by theme, icon names and
+    // requested size
+    QCache<QString, QImage> m_imageCache;
+    QMutex m_imageCacheMutex;
 };
 
 UT_NAMESPACE_END
@@ -229,6 +229,15 @@ PageTreeNode {
       */
     property bool asynchronous: true
 
+    /*!
+      The maximum number of removed pages kept alive for reuse. When a Component
+      or a document is added again with the same properties, the page kept from
+      a previous addition is restored synchronously instead of being created
+      again, and no incubator is returned. See \l PageStack::pageCacheSize.
+      Defaults to 0, which disables the caching.
+      */
+    property int pageCacheSize: 0
+
     /*!
       \qmlproperty int columns
       \readonly
@@ -498,6 +507,7 @@ PageTreeNode {
         function createWrapper(page, properties) {
             var wrapperObject = pageWrapperComponent.createObject(hiddenPages, {synchronous: !layout.asynchronous});
             wrapperObject.pageStack = layout;
+            wrapperObject.pageCache = pageCache;
             wrapperObject.properties = properties;
             // set reference last because it will trigger creation of the object
             //  with specified properties.
@@ -709,6 +719,11 @@ PageTreeNode {
         }
     }
 
+    PageCache {
+        id: pageCache
+        capacity: layout.pageCacheSize
+    }
+
 
     // An instance will be added to each Page with
     Component {
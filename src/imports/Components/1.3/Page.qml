@@ -125,6 +125,24 @@ PageTreeNode {
     onHeaderChanged: internal.updateHeader()
     Component.onCompleted: internal.updateHeader()
 
+    /*!
+      \qmlsignal Page::cached()
+      \since Ubuntu.Components 1.3
+      The signal is emitted when the page is removed from a \l PageStack or an
+      \l AdaptivePageLayout and kept for reuse instead of being destroyed.
+      See \l PageStack::pageCacheSize.
+      */
+    signal cached()
+
+    /*!
+      \qmlsignal Page::restored()
+      \since Ubuntu.Components 1.3
+      The signal is emitted when a page kept for reuse is pushed again instead
+      of creating a new instance. The page keeps the state it had when cached,
+      and the properties given to the push are applied again.
+      */
+    signal restored()
+
     /*! \internal */
     isLeaf: true
 
@@ -155,6 +155,19 @@ PageTreeNode {
      */
     property Item currentPage: null
 
+    /*!
+      \since Ubuntu.Components 1.3
+      The maximum number of popped pages kept alive for reuse. When a Component
+      or a document is pushed again with the same properties, the page kept
+      from a previous push is restored instead of being created again. Pages
+      get their \l Page::cached() and \l Page::restored() signals emitted
+      when kept and when reused. The least recently popped pages are destroyed
+      first, and all of them are released when the application is suspended.
+      Pages pushed as Items are never kept. Defaults to 0, which disables the
+      caching.
+     */
+    property int pageCacheSize: 0
+
     /*!
       Push a page to the stack, and apply the given (optional) properties to the page.
       The pushed page may be an Item, Component or URL.
@@ -232,6 +245,11 @@ PageTreeNode {
         }
     }
 
+    PageCache {
+        id: pageCache
+        capacity: pageStack.pageCacheSize
+    }
+
     QtObject {
         id: internal
         property Item headStyle: (pageStack.__propagated
@@ -292,6 +310,7 @@ PageTreeNode {
         function createWrapper(page, properties) {
             var wrapperObject = pageWrapperComponent.createObject(pageStack);
             wrapperObject.pageStack = pageStack;
+            wrapperObject.pageCache = pageCache;
             wrapperObject.properties = properties;
             // set reference last because it will trigger creation of the object
             //  with specified properties.
@@ -22,10 +22,7 @@ PickerModelBase {
 
     function reset() {
         resetting = true;
-        clear();
-        for (var i = 0; i < date.daysInMonth(); i++) {
-            append({"day": i});
-        }
+        setRange(0, date.daysInMonth());
     }
 
     function resetLimits(label, margin) {
@@ -41,16 +38,7 @@ PickerModelBase {
     }
 
     function syncModels() {
-        var newDaysCount = mainComponent.date.daysInMonth(mainComponent.year, mainComponent.month);
-        var modelCount = count;
-        var daysDiff = newDaysCount - modelCount;
-        if (daysDiff < 0) {
-            remove(modelCount + daysDiff, -daysDiff);
-        } else if (daysDiff > 0) {
-            for (var d = modelCount; d < modelCount + daysDiff; d++) {
-                append({"day": d});
-            }
-        }
+        resize(mainComponent.date.daysInMonth(mainComponent.year, mainComponent.month));
     }
 
     function indexOf() {
@@ -18,18 +18,14 @@ import QtQuick 2.4
 import Ubuntu.Components 1.3
 
 PickerModelBase {
-    property int from
     circular: count >= 24
+    modulo: 24
 
     function reset() {
         resetting = true;
 
-        clear();
-        from = minimum.getHours();
         var distance = (!Date.prototype.isValid.call(maximum) || (minimum.daysTo(maximum) > 1)) ? 24 : minimum.hoursTo(maximum);
-        for (var i = 0; i < distance; i++) {
-            append({"hour": (from + i) % 24});
-        }
+        setRange(minimum.getHours(), distance);
 
         resetting = false;
     }
@@ -40,12 +36,7 @@ PickerModelBase {
     }
 
     function indexOf() {
-        var index = date.getHours() - from;
-        if (index >= count) {
-            index = -1;
-        }
-
-        return index;
+        return rowOf(date.getHours());
     }
 
     function dateFromIndex(index) {
@@ -18,18 +18,14 @@ import QtQuick 2.4
 import Ubuntu.Components 1.3
 
 PickerModelBase {
-    property int from
     circular: count >= 60
+    modulo: 60
 
     function reset() {
         resetting = true;
 
-        clear();
-        from = minimum.getMinutes();
         var distance = (!maximum.isValid() || (minimum.daysTo(maximum) > 1) || (minimum.minutesTo(maximum) >= 60)) ? 60 : minimum.minutesTo(maximum);
-        for (var i = 0; i < distance; i++) {
-            append({"minute": (from + i) % 60});
-        }
+        setRange(minimum.getMinutes(), distance);
 
         resetting = false;
     }
@@ -40,12 +36,7 @@ PickerModelBase {
     }
 
     function indexOf() {
-        var index = date.getMinutes() - from;
-        if (index >= count) {
-            index = -1;
-        }
-
-        return index;
+        return rowOf(date.getMinutes());
     }
 
     function dateFromIndex(index) {
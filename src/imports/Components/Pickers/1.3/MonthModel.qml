@@ -19,26 +19,14 @@ import Ubuntu.Components 1.3
 
 PickerModelBase {
     circular: (count >= 11)
-
-    // local properties
-    property int from
+    modulo: 12
 
     function reset() {
         resetting = true;
-        clear();
-        var modelDate = new Date(date);
-        modelDate.setDate(1);
-
         // if maximum is invalid, we have full model (12 months to show)
-        var distance, to;
-        distance = to = maximum.isValid() ? minimum.monthsTo(maximum) : 11;
+        var to = maximum.isValid() ? minimum.monthsTo(maximum) : 11;
         if (to < 0 || to > 11) to = 11;
-        from = (to < 11) ? minimum.getMonth() : 0;
-        // fill the model
-        for (var i = from; i <= from + to; i++) {
-            modelDate.setMonth(i);
-            append({"month": modelDate.getMonth()});
-        }
+        setRange((to < 11) ? minimum.getMonth() : 0, to + 1);
     }
 
     function resetLimits(label, margin) {
@@ -54,11 +42,7 @@ PickerModelBase {
     }
 
     function indexOf() {
-        var index = date.getMonth() - from;
-        if (index >= count) {
-            index = -1;
-        }
-        return index;
+        return rowOf(date.getMonth());
     }
 
     function dateFromIndex(index) {
@@ -70,7 +54,7 @@ PickerModelBase {
         var fromDay = newDate.getDate();
         // move the day to the 1st of the month so we don't overflow when setting the month
         newDate.setDate(1);
-        newDate.setMonth(get(index).month);
+        newDate.setMonth(value(index));
         var maxDays = newDate.daysInMonth();
         // check whether the original day would overflow
         // and trim to the mont's maximum date
@@ -15,11 +15,13 @@
  */
 
 import QtQuick 2.4
+import Ubuntu.Components.Private 1.3
 
 /*
-  Base model type for DatePicker
+  Base model type for DatePicker. The rows are computed from the range set by
+  the derivates through setRange() and resize(), see PickerRangeModel.
   */
-ListModel {
+PickerRangeModel {
 
     /*
       Holds the picker instance, the component the model is attached to. Should
@@ -18,18 +18,14 @@ import QtQuick 2.4
 import Ubuntu.Components 1.3
 
 PickerModelBase {
-    property int from
     circular: count >= 60
+    modulo: 60
 
     function reset() {
         resetting = true;
 
-        clear();
-        from = minimum.getSeconds();
         var distance = (!maximum.isValid() || (minimum.daysTo(maximum) > 1) || (minimum.secondsTo(maximum) >= 60)) ? 59 : minimum.secondsTo(maximum);
-        for (var i = 0; i <= distance; i++) {
-            append({"seconds": (from + i) % 60});
-        }
+        setRange(minimum.getSeconds(), distance + 1);
 
         resetting = false;
     }
@@ -40,12 +36,7 @@ PickerModelBase {
     }
 
     function indexOf() {
-        var index = date.getSeconds() - from;
-        if (index >= count) {
-            index = -1;
-        }
-
-        return index;
+        return rowOf(date.getSeconds());
     }
 
     function dateFromIndex(index) {
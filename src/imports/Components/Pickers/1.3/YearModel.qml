@@ -18,17 +18,18 @@ import QtQuick 2.4
 import Ubuntu.Components 1.3
 
 PickerModelBase {
-    // local properties
-    property int from
     circular: false
     autoExtend: !maximum.isValid()
 
     function reset() {
         resetting = true;
-        clear();
-        from = (minimum.getFullYear() <= 0) ? date.getFullYear() : minimum.getFullYear();
+        var first = (minimum.getFullYear() <= 0) ? date.getFullYear() : minimum.getFullYear();
         var to = (maximum < minimum) ? -1 : maximum.getFullYear();
-        extend(from, to - from);
+        var items = to - first;
+        if (items < 0) {
+            items = 50;
+        }
+        setRange(first, items + 1);
     }
 
     function resetLimits(label, margin) {
@@ -36,22 +37,12 @@ PickerModelBase {
         narrowFormatLimit = shortFormatLimit = longFormatLimit = label.paintedWidth + 2 * margin;
     }
 
-    function extend(baseYear, items) {
-        if (items === undefined || items < 0) {
-            items = 50;
-        }
-        for (var i = baseYear; i <= baseYear + items; i++) {
-            append({"modelData" : i});
-        }
+    function extend(baseYear) {
+        resize(Math.max(count, baseYear - from + 51));
     }
 
     function indexOf() {
-        var index = date.getFullYear() - from;
-        if (index >= count) {
-            index = -1;
-        }
-
-        return index;
+        return rowOf(date.getFullYear());
     }
 
     function dateFromIndex(index) {
@@ -59,7 +50,7 @@ PickerModelBase {
             return date;
         }
         var newDate = new Date(date);
-        newDate.setFullYear(index + from);
+        newDate.setFullYear(value(index));
         return newDate;
     }
 
@@ -1,4 +1,4 @@
-QT *= core-private gui-private quick-private qml-private
+QT *= core-private gui-private quick-private qml-private UbuntuMetrics
 equals(QT_MAJOR_VERSION, 5):lessThan(QT_MINOR_VERSION, 2) {
     QT *= v8-private
 }
@@ -20,6 +20,7 @@
 
 #include <QtQml/QQmlInfo>
 #include <QtQuick/private/qquickitem_p.h>
+#include <UbuntuMetrics/span.h>
 
 #include "ulitemlayout.h"
 #include "ulconditionallayout.h"
@@ -267,6 +268,8 @@ void ULLayoutsPrivate::reLayout()
         return;
     }
 
+    UMSpan span("Layouts.reLayout");
+
     // redo changes
     changes.revert();
     changes.clear();
@@ -2,6 +2,6 @@ CXX_MODULE = qml
 TARGET  = UbuntuMetrics
 TARGETPATH = Ubuntu/Metrics
 IMPORT_VERSION = 1.0
-QT += qml UbuntuMetrics
+QT += qml quick UbuntuMetrics
 SOURCES += plugin.cpp
 load(ubuntu_qml_plugin)
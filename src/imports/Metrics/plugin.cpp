@@ -15,6 +15,7 @@
 // along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
 
 #include <QtQml/QtQml>
+#include <QtQuick/QQuickWindow>
 #include <UbuntuMetrics/applicationmonitor.h>
 
 // FIXME(loicm)
@@ -33,6 +34,10 @@ class ApplicationMonitorWrapper : public QObject
                NOTIFY loggingFilterChanged)
     Q_PROPERTY(int processUpdateInterval READ processUpdateInterval
                WRITE setProcessUpdateInterval NOTIFY processUpdateIntervalChanged)
+    Q_PROPERTY(bool frameStatistics READ frameStatistics WRITE setFrameStatistics
+               NOTIFY frameStatisticsChanged)
+    Q_PROPERTY(int frameSummaryUpdateInterval READ frameSummaryUpdateInterval
+               WRITE setFrameSummaryUpdateInterval NOTIFY frameSummaryUpdateIntervalChanged)
 
 public:
     ApplicationMonitorWrapper(QObject* parent = 0)
@@ -45,6 +50,8 @@ public:
                          this, SIGNAL(loggingChanged()));
         QObject::connect(m_applicationMonitor, SIGNAL(loggingFilterChanged()),
                          this, SIGNAL(loggingFilterChanged()));
+        QObject::connect(m_applicationMonitor, SIGNAL(frameStatisticsChanged()),
+                         this, SIGNAL(frameStatisticsChanged()));
         QObject::connect(m_applicationMonitor, SIGNAL(updateIntervalChanged(UMEvent::Type)),
                          this, SLOT(updateIntervalChanged(UMEvent::Type)));
     }
@@ -55,6 +62,8 @@ public:
         WindowEvent  = UMApplicationMonitor::WindowEvent,
         FrameEvent   = UMApplicationMonitor::FrameEvent,
         GenericEvent = UMApplicationMonitor::GenericEvent,
+        FrameSummaryEvent = UMApplicationMonitor::FrameSummaryEvent,
+        SpanEvent    = UMApplicationMonitor::SpanEvent,
         AllEvents    = UMApplicationMonitor::AllEvents
     };
     Q_DECLARE_FLAGS(LoggingFilters, LoggingFilter)
@@ -80,20 +89,58 @@ public:
     void setProcessUpdateInterval(int interval) {
         m_applicationMonitor->setUpdateInterval(UMEvent::Process, interval); }
 
+    bool frameStatistics() const { return m_applicationMonitor->frameStatistics(); }
+    void setFrameStatistics(bool frameStatistics) {
+        m_applicationMonitor->setFrameStatistics(frameStatistics); }
+    int frameSummaryUpdateInterval() const {
+        return m_applicationMonitor->updateInterval(UMEvent::FrameSummary); }
+    void setFrameSummaryUpdateInterval(int interval) {
+        m_applicationMonitor->setUpdateInterval(UMEvent::FrameSummary, interval); }
+
     Q_INVOKABLE bool logEvent(Event event) {
         return m_applicationMonitor->logEvent(static_cast<UMApplicationMonitor::Event>(event)); }
 
+    // Returns an empty map if the window isn't monitored, times are in
+    // milliseconds.
+    Q_INVOKABLE QVariantMap windowFrameStatistics(QObject* window) {
+        UMFrameStatistics statistics;
+        QVariantMap map;
+        if (m_applicationMonitor->windowFrameStatistics(
+                qobject_cast<QQuickWindow*>(window), &statistics)) {
+            const char* const metricNames[] = {
+                "deltaTime", "syncTime", "renderTime", "gpuTime", "swapTime"
+            };
+            map.insert(QStringLiteral("window"), statistics.window);
+            map.insert(QStringLiteral("frameCount"), statistics.frameCount);
+            map.insert(QStringLiteral("missedVsyncCount"), statistics.missedVsyncCount);
+            for (int i = 0; i < UMFrameSummaryEvent::MetricCount; ++i) {
+                QVariantMap metric;
+                metric.insert(QStringLiteral("p50"), statistics.metrics[i].p50 / 1000000.0);
+                metric.insert(QStringLiteral("p90"), statistics.metrics[i].p90 / 1000000.0);
+                metric.insert(QStringLiteral("p99"), statistics.metrics[i].p99 / 1000000.0);
+                metric.insert(QStringLiteral("max"), statistics.metrics[i].max / 1000000.0);
+                map.insert(QLatin1String(metricNames[i]), metric);
+            }
+        }
+        return map;
+    }
+    Q_INVOKABLE void resetFrameStatistics() { m_applicationMonitor->resetFrameStatistics(); }
+
 Q_SIGNALS:
     void overlayChanged();
     void loggingChanged();
     void loggingFilterChanged();
     void processUpdateIntervalChanged();
+    void frameStatisticsChanged();
+    void frameSummaryUpdateIntervalChanged();
 
 private Q_SLOTS:
     void updateIntervalChanged(UMEvent::Type type)
     {
         if (type == UMEvent::Process) {
             Q_EMIT processUpdateIntervalChanged();
+        } else if (type == UMEvent::FrameSummary) {
+            Q_EMIT frameSummaryUpdateIntervalChanged();
         }
     }
 
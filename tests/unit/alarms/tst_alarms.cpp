@@ -17,7 +17,12 @@
  */
 
 #include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStandardPaths>
 #include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QTextCodec>
 #include <QtCore/QTimeZone>
 #include <QtQml/QQmlEngine>
@@ -89,6 +94,49 @@ private:
         cancelSpy->clear();
     }
 
+    // cancels the alarms whose message starts with prefix
+    void cancelAlarms(const QString &prefix)
+    {
+        int i = 0;
+        while (i < AlarmManager::instance().alarmCount()) {
+            const UCAlarm *element = AlarmManager::instance().alarmAt(i);
+            if (element->message().startsWith(prefix)) {
+                UCAlarm alarm;
+                UCAlarmPrivate::get(&alarm)->copyAlarmData(*element);
+                alarm.cancel();
+                waitForRemove();
+                i = 0;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    int countAlarms(const QJsonArray &alarms, const QString &prefix)
+    {
+        int count = 0;
+        Q_FOREACH(const QJsonValue &value, alarms) {
+            if (value.toObject()["message"].toString().startsWith(prefix)) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    QJsonArray createAlarms(const QString &prefix, int count)
+    {
+        QJsonArray alarms;
+        for (int i = 0; i < count; i++) {
+            QJsonObject object;
+            object["message"] = QString("%1_%2").arg(prefix).arg(i);
+            object["date"] = QDateTime::currentDateTime().addDays(i + 1).toString();
+            object["type"] = UCAlarm::OneTime;
+            object["enabled"] = true;
+            alarms.append(object);
+        }
+        return alarms;
+    }
+
     bool containsAlarm(UCAlarm *alarm, bool trace = false)
     {
         for (int i = 0; i < AlarmManager::instance().alarmCount(); i++) {
@@ -588,6 +636,104 @@ private Q_SLOTS:
         // check the tags
         QVERIFY(AlarmManager::instance().verifyChange(&alarm, AlarmManager::Enabled, enabled));
     }
+
+    void test_importExportAlarms()
+    {
+        UCAlarmModel model;
+        QCOMPARE(model.importAlarms(createAlarms("test_importExportAlarms", 3)), 3);
+        QTRY_COMPARE_WITH_TIMEOUT(countAlarms(model.exportAlarms(), "test_importExportAlarms_"), 3, 1000);
+
+        cancelAlarms("test_importExportAlarms_");
+        QCOMPARE(countAlarms(model.exportAlarms(), "test_importExportAlarms_"), 0);
+    }
+
+    void test_readAlarms_data()
+    {
+        QTest::addColumn<QByteArray>("database");
+        QTest::addColumn<QByteArray>("journal");
+        QTest::addColumn<QStringList>("alarms");
+
+        QByteArray database("[{\"id\":\"a\",\"message\":\"a\"},{\"id\":\"b\",\"message\":\"b\"}]");
+        QByteArray journal("{\"id\":\"a\",\"message\":\"a2\"}\n"
+                           "{\"id\":\"b\",\"removed\":true}\n"
+                           "{\"id\":\"c\",\"message\":\"c\"}\n");
+        QTest::newRow("journal replay") << database << journal
+            << (QStringList() << "a:a2" << "c:c");
+        // the journal couldn't be truncated after the compaction re-keyed the
+        // alarms, its entries refer to the ids of the previous session
+        QByteArray compacted("{\"generation\":2,\"alarms\":["
+                             "{\"id\":\"x\",\"message\":\"a2\"},{\"id\":\"y\",\"message\":\"c\"}]}");
+        QByteArray staleJournal("{\"generation\":1,\"id\":\"a\",\"message\":\"a2\"}\n"
+                                "{\"generation\":1,\"id\":\"y\",\"removed\":true}\n"
+                                "{\"generation\":1,\"id\":\"c\",\"message\":\"c\"}\n");
+        QTest::newRow("stale journal after compaction") << compacted << staleJournal
+            << (QStringList() << "x:a2" << "y:c");
+        QTest::newRow("stale journal then new entries") << compacted
+            << QByteArray(staleJournal + "{\"generation\":2,\"id\":\"x\",\"removed\":true}\n"
+                                         "{\"generation\":2,\"id\":\"z\",\"message\":\"d\"}\n")
+            << (QStringList() << "y:c" << "z:d");
+        QTest::newRow("database without ids")
+            << QByteArray("[{\"message\":\"x\"},{\"message\":\"y\"}]") << QByteArray()
+            << (QStringList() << "0:x" << "1:y");
+        QTest::newRow("crash while appending")
+            << database << QByteArray("{\"id\":\"c\",\"message\":\"c\"}\n{\"id\":\"a\",\"remo")
+            << (QStringList() << "a:a" << "b:b" << "c:c");
+        QTest::newRow("journal only") << QByteArray() << journal
+            << (QStringList() << "a:a2" << "c:c");
+    }
+    void test_readAlarms()
+    {
+        QFETCH(QByteArray, database);
+        QFETCH(QByteArray, journal);
+        QFETCH(QStringList, alarms);
+
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        if (!database.isEmpty()) {
+            QFile file(dir.path() + "/alarms.json");
+            QVERIFY(file.open(QFile::WriteOnly));
+            file.write(database);
+        }
+        if (!journal.isEmpty()) {
+            QFile file(dir.path() + "/alarms.journal");
+            QVERIFY(file.open(QFile::WriteOnly));
+            file.write(journal);
+        }
+
+        QStringList result;
+        QHash<QString, QJsonObject> data = AlarmsAdapter::readAlarms(dir.path());
+        for (QHash<QString, QJsonObject>::const_iterator i = data.constBegin(); i != data.constEnd(); ++i) {
+            result << i.key() + ":" + i.value()["message"].toString();
+        }
+        result.sort();
+        QCOMPARE(result, alarms);
+    }
+
+    void test_journalCompaction()
+    {
+        if (AlarmsAdapter::get()->manager->managerName() != "memory") {
+            QSKIP("alarms are journaled by the fallback manager only");
+        }
+        const QString location = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
+        const int count = 260;
+
+        UCAlarmModel model;
+        QCOMPARE(model.importAlarms(createAlarms("test_journalCompaction", count)), count);
+        QTRY_COMPARE_WITH_TIMEOUT(countAlarms(model.exportAlarms(), "test_journalCompaction_"), count, 5000);
+        cancelAlarms("test_journalCompaction_");
+
+        // the journal got folded into the database while cancelling
+        QFile journal(location + "/alarms.journal");
+        QVERIFY(journal.open(QFile::ReadOnly));
+        QVERIFY(journal.readAll().count('\n') < count);
+
+        // the stored data matches the alarms in the collection
+        QHash<QString, QJsonObject> data = AlarmsAdapter::readAlarms(location);
+        QCOMPARE(data.count(), AlarmManager::instance().alarmCount());
+        Q_FOREACH(const QJsonObject &object, data) {
+            QVERIFY(!object["message"].toString().startsWith("test_journalCompaction_"));
+        }
+    }
 };
 
 QTEST_MAIN(tst_UCAlarms)
@@ -235,13 +235,28 @@ private Q_SLOTS:
             component.reset(new QQmlComponent(view->engine(), QUrl::fromLocalFile(document), (QQmlComponent::CompilationMode)mode));
             loader.load(component.data(), view->rootContext());
         }
-        if (loader.status() < AsyncLoader::Loading) {
-            // cannot reset yet!
-            QVERIFY(!loader.reset());
-        }
         QTRY_VERIFY(spy.m_reset);
     }
 
+    void test_reset_while_compiling()
+    {
+        QScopedPointer<UbuntuTestCase> view(new UbuntuTestCase("TestApp.qml"));
+        AsyncLoader loader;
+        LoaderSpy spy(&loader);
+
+        QVERIFY(loader.load(QUrl::fromLocalFile("HeavyDocument.qml"), view->rootContext()));
+        if (loader.status() != AsyncLoader::Compiling) {
+            QSKIP("The document was compiled synchronously");
+        }
+        QVERIFY(loader.reset());
+        QCOMPARE(loader.status(), AsyncLoader::Reset);
+
+        // the aborted compilation doesn't block the next loading
+        QVERIFY(loader.load(QUrl::fromLocalFile("Document.qml"), view->rootContext()));
+        QTRY_VERIFY(spy.m_done);
+        QVERIFY(spy.m_object != nullptr);
+    }
+
     void test_second_load_scenarios_data()
     {
         QTest::addColumn<QString> ("doc1");
@@ -251,7 +266,7 @@ private Q_SLOTS:
 
         QTest::newRow("status = Compiling")
                 << "Document.qml" << "HeavyDocument.qml"
-                << (int)AsyncLoader::Compiling << false;
+                << (int)AsyncLoader::Compiling << true;
         QTest::newRow("status = Loading")
                 << "Document.qml" << "HeavyDocument.qml"
                 << (int)AsyncLoader::Loading << true;
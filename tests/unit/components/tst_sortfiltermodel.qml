@@ -79,6 +79,47 @@ TestCase {
         filter.pattern: /bar/i
     }
 
+    SortFilterModel {
+        id: narrowing
+        model: things
+        filter.property: "foo"
+        filter.pattern: /b/i
+    }
+
+    ListModel {
+        id: dynamicThings
+        ListElement { name: "cat" }
+        ListElement { name: "Bar" }
+    }
+
+    SortFilterModel {
+        id: dynamicFilter
+        model: dynamicThings
+        filter.property: "name"
+        filter.pattern: /ba/i
+    }
+
+    ListModel {
+        id: changingThings
+        ListElement { name: "bee" }
+        ListElement { name: "Bar" }
+        ListElement { name: "cow" }
+    }
+
+    SortFilterModel {
+        id: changingSortFilter
+        model: changingThings
+        sort.property: "name"
+        filter.property: "name"
+        filter.pattern: /b/i
+    }
+
+    SortFilterModel {
+        id: asyncModel
+        model: things
+        asynchronous: true
+    }
+
     function test_passthrough() {
         compare(unmodified.count, things.count)
     }
@@ -131,4 +172,91 @@ TestCase {
     function test_case_sensitivity() {
         compare(caseSensitivity.get(0).foo, "Bar")
     }
+
+    function test_value() {
+        compare(alphabetic.value(0, "alpha"), alphabetic.get(0).alpha)
+        compare(alphabetic.value(0, "bogus"), undefined)
+    }
+
+    function test_narrowing_filter() {
+        narrowing.filter.pattern = /b/i
+        compare(narrowing.count, 2)
+        narrowing.filter.pattern = /ba/i
+        compare(narrowing.count, 1)
+        compare(narrowing.get(0).foo, "Bar")
+        // widening again must bring the rejected rows back
+        narrowing.filter.pattern = /u/
+        compare(narrowing.count, 1)
+        compare(narrowing.get(0).foo, "pub")
+        // regular expressions are still supported
+        narrowing.filter.pattern = /^(d|p)/
+        compare(narrowing.count, 2)
+    }
+
+    function test_filter_follows_data_changes() {
+        dynamicThings.setProperty(0, "name", "Bat")
+        compare(dynamicFilter.count, 2)
+        dynamicThings.setProperty(0, "name", "cat")
+        compare(dynamicFilter.count, 1)
+    }
+
+    function test_keys_follow_row_changes() {
+        compare(changingSortFilter.count, 2)
+        compare(changingSortFilter.get(0).name, "Bar")
+        compare(changingSortFilter.get(1).name, "bee")
+
+        changingThings.insert(0, { name: "ant" })
+        changingThings.append({ name: "bat" })
+        compare(changingSortFilter.count, 3)
+        compare(changingSortFilter.get(0).name, "Bar")
+        compare(changingSortFilter.get(1).name, "bat")
+        compare(changingSortFilter.get(2).name, "bee")
+
+        // ant, bee, Bar, cow, bat
+        changingThings.move(1, 3, 2)
+        // ant, cow, bat, bee, Bar
+        changingThings.setProperty(2, "name", "abba")
+        compare(changingSortFilter.count, 3)
+        compare(changingSortFilter.get(0).name, "Bar")
+        compare(changingSortFilter.get(1).name, "abba")
+        compare(changingSortFilter.get(2).name, "bee")
+
+        changingThings.remove(0, 2)
+        // abba, bee, Bar
+        changingThings.setProperty(1, "name", "cat")
+        compare(changingSortFilter.count, 2)
+        compare(changingSortFilter.get(0).name, "Bar")
+        compare(changingSortFilter.get(1).name, "abba")
+    }
+
+    // the roles of the first row, read again each time tryCompare() checks them
+    function firstRow(model) {
+        return {
+            get alpha() { return model.get(0).alpha },
+            get foo() { return model.get(0).foo }
+        }
+    }
+
+    function test_asynchronous_sort_and_filter() {
+        asyncModel.sort.property = "alpha"
+        // the model keeps its order until the sorting job is done
+        compare(asyncModel.get(0).alpha, "bee")
+        tryCompare(firstRow(asyncModel), "alpha", "ant")
+        compare(asyncModel.count, 3)
+        compare(asyncModel.get(2).alpha, "cow")
+
+        asyncModel.sort.order = Qt.DescendingOrder
+        tryCompare(firstRow(asyncModel), "alpha", "cow")
+
+        asyncModel.filter.property = "foo"
+        asyncModel.filter.pattern = /e/
+        tryCompare(asyncModel, "count", 1)
+        compare(asyncModel.get(0).foo, "den")
+
+        // stale results are dropped when the pattern changes again
+        asyncModel.filter.pattern = /u/
+        asyncModel.filter.pattern = /a/i
+        tryCompare(firstRow(asyncModel), "foo", "Bar")
+        compare(asyncModel.count, 1)
+    }
 }
@@ -96,6 +96,39 @@ private Q_SLOTS:
         }
     }
 
+    void benchmark_creation_styled_items_data() {
+        QTest::addColumn<QString>("type");
+        QTest::addColumn<int>("count");
+
+        QTest::newRow("Button x 100") << "Button" << 100;
+        QTest::newRow("Button x 500") << "Button" << 500;
+        QTest::newRow("ListItem x 100") << "ListItem" << 100;
+        QTest::newRow("ListItem x 500") << "ListItem" << 500;
+    }
+
+    // every styled item looks up and instantiates its style, measures the cost
+    // of creating many of them at once like a long list does at startup
+    void benchmark_creation_styled_items() {
+        QFETCH(QString, type);
+        QFETCH(int, count);
+
+        QQmlComponent component(&engine);
+        component.setData(QString(
+            "import QtQuick 2.4\n"
+            "import Ubuntu.Components %1.%2\n"
+            "Column { Repeater { model: %3; %4 {} } }")
+            .arg(MAJOR_VERSION(LATEST_UITK_VERSION)).arg(MINOR_VERSION(LATEST_UITK_VERSION))
+            .arg(count).arg(type).toUtf8(), QUrl());
+        QObject *obj = component.create();
+        QVERIFY2(obj, qPrintable(component.errorString()));
+        delete obj;
+
+        QBENCHMARK {
+            QObject *obj = component.create();
+            delete obj;
+        }
+    }
+
 private:
     QQmlEngine engine;
 };
@@ -193,6 +193,61 @@ private Q_SLOTS:
         QCOMPARE(i18n->tr(QString("Count the kittens")), QString("Contar los gatitos"));
         QCOMPARE(i18n->ctr(QString("All Cats"), QString("All")), QString("Cada"));
     }
+
+    void testCase_TranslationsFlushed()
+    {
+        UbuntuI18n* i18n = UbuntuI18n::instance();
+        i18n->setDomain("localizedApp");
+        i18n->setLanguage("en_US.utf8");
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Greets"));
+
+        // The cached translation is looked up again in the new language
+        i18n->setLanguage("C");
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Welcome"));
+        i18n->setLanguage("en_US.utf8");
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Greets"));
+
+        // in the new catalog folder
+        QString localePath(QDir(QDir::currentPath() + "/localizedApp").filePath("share/locale"));
+        i18n->bindtextdomain("localizedApp", QDir::currentPath() + "/nonexistent");
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Welcome"));
+        i18n->bindtextdomain("localizedApp", localePath);
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Greets"));
+
+        // and in the new domain
+        i18n->setDomain("otherDomain");
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Welcome"));
+        i18n->setDomain("localizedApp");
+        QCOMPARE(i18n->tr(QString("Welcome")), QString("Greets"));
+    }
+
+    void benchmark_translation_data()
+    {
+        QTest::addColumn<bool>("cached");
+
+        QTest::newRow("gettext") << false;
+        QTest::newRow("i18n.tr") << true;
+    }
+
+    // 1000 lookups of the same string per iteration, compares the plain
+    // gettext lookup done by i18n.tr() before it had a cache with the cached one
+    void benchmark_translation()
+    {
+        QFETCH(bool, cached);
+        UbuntuI18n* i18n = UbuntuI18n::instance();
+        const QString text("Count the kilometres");
+        QCOMPARE(i18n->tr(text), QString::fromUtf8(C::gettext(text.toUtf8())));
+
+        QBENCHMARK {
+            for (int i = 0; i < 1000; i++) {
+                if (cached) {
+                    i18n->tr(text);
+                } else {
+                    QString::fromUtf8(C::gettext(text.toUtf8()));
+                }
+            }
+        }
+    }
 };
 
 // The C++ equivalent of QTEST_MAIN(tst_I18n_LocalizedApp) with added initialization
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.4
+import Ubuntu.Components 1.3
+
+Item {
+    width: 100
+    height: 100
+
+    Icon {
+        objectName: "icon1"
+        width: 8
+        height: 8
+        source: "keycolor.png"
+        color: "#ff0000"
+    }
+    Icon {
+        objectName: "icon2"
+        x: 10
+        width: 8
+        height: 8
+        source: "keycolor.png"
+        color: "#ff0000"
+    }
+    Icon {
+        objectName: "icon3"
+        x: 20
+        width: 8
+        height: 8
+        source: "keycolor.png"
+        color: "#0000ff"
+    }
+}
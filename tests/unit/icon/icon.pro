@@ -0,0 +1,8 @@
+include(../test-include-x11.pri)
+
+SOURCES += \
+    tst_icon.cpp
+
+DISTFILES += \
+    Icons.qml \
+    keycolor.png
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#define private public
+#include <UbuntuToolkit/private/ucicon_p.h>
+#undef private
+
+#include "uctestcase.h"
+
+UT_USE_NAMESPACE
+
+// the premultiplied pixel, QImage::pixel() returns it unpremultiplied
+static QRgb rawPixel(const QImage &image, int x, int y)
+{
+    return reinterpret_cast<const QRgb*>(image.constScanLine(y))[x];
+}
+
+class tst_Icon : public QObject
+{
+    Q_OBJECT
+public:
+    tst_Icon() {}
+
+private Q_SLOTS:
+
+    void test_colorize_data()
+    {
+        QTest::addColumn<QRgb>("pixel");
+        QTest::addColumn<QColor>("keyColor");
+        QTest::addColumn<QRgb>("expected");
+
+        const QColor defaultKeyColor("#808080");
+        QTest::newRow("key color") << qRgba(0x80, 0x80, 0x80, 0xff) << defaultKeyColor << qRgba(0xff, 0, 0, 0xff);
+        QTest::newRow("close to the key color") << qRgba(0x84, 0x84, 0x84, 0xff) << defaultKeyColor << qRgba(0xff, 0, 0, 0xff);
+        QTest::newRow("translucent key color") << qRgba(0x80, 0x80, 0x80, 0x80) << defaultKeyColor << qRgba(0x80, 0, 0, 0x80);
+        QTest::newRow("far from the key color") << qRgba(0xa0, 0xa0, 0xa0, 0xff) << defaultKeyColor << qRgba(0xa0, 0xa0, 0xa0, 0xff);
+        QTest::newRow("white") << qRgba(0xff, 0xff, 0xff, 0xff) << defaultKeyColor << qRgba(0xff, 0xff, 0xff, 0xff);
+        QTest::newRow("transparent") << qRgba(0, 0, 0, 0) << defaultKeyColor << qRgba(0, 0, 0, 0);
+        QTest::newRow("custom key color") << qRgba(0, 0xff, 0, 0xff) << QColor("#00ff00") << qRgba(0xff, 0, 0, 0xff);
+        QTest::newRow("default key color with custom key") << qRgba(0x80, 0x80, 0x80, 0xff) << QColor("#00ff00") << qRgba(0x80, 0x80, 0x80, 0xff);
+    }
+    void test_colorize()
+    {
+        QFETCH(QRgb, pixel);
+        QFETCH(QColor, keyColor);
+        QFETCH(QRgb, expected);
+
+        QImage image(2, 2, QImage::Format_ARGB32);
+        image.fill(pixel);
+        QImage result = UCIcon::colorize(image, QColor("#ff0000"), keyColor);
+        QCOMPARE(result.format(), QImage::Format_ARGB32_Premultiplied);
+        QCOMPARE(result.size(), image.size());
+        for (int y = 0; y < result.height(); y++) {
+            for (int x = 0; x < result.width(); x++) {
+                QCOMPARE(rawPixel(result, x, y), expected);
+            }
+        }
+    }
+
+    void test_colorized_icons_share_image()
+    {
+        QScopedPointer<UbuntuTestCase> view(new UbuntuTestCase("Icons.qml"));
+        UCIcon *icon1 = view->findItem<UCIcon*>("icon1");
+        UCIcon *icon2 = view->findItem<UCIcon*>("icon2");
+        UCIcon *icon3 = view->findItem<UCIcon*>("icon3");
+        // the images are loaded when polishing
+        QTRY_VERIFY(!icon1->m_image.isNull() && !icon2->m_image.isNull() && !icon3->m_image.isNull());
+        QCOMPARE(rawPixel(icon1->m_image, 0, 0), qRgba(0xff, 0, 0, 0xff));
+        QCOMPARE(rawPixel(icon1->m_image, icon1->m_image.width() - 1, 0), qRgba(0xff, 0xff, 0xff, 0xff));
+
+        // same source and color, same cache entry
+        QCOMPARE(icon2->m_image.cacheKey(), icon1->m_image.cacheKey());
+        QVERIFY(icon3->m_image.cacheKey() != icon1->m_image.cacheKey());
+        QCOMPARE(rawPixel(icon3->m_image, 0, 0), qRgba(0, 0, 0xff, 0xff));
+
+        icon3->setColor(QColor("#ff0000"));
+        QCOMPARE(icon3->m_image.cacheKey(), icon1->m_image.cacheKey());
+    }
+};
+
+QTEST_MAIN(tst_Icon)
+
+#include "tst_icon.moc"
@@ -32,6 +32,8 @@ private Q_SLOTS:
     void initTestCase()
     {
         qputenv("XDG_DATA_DIRS", SRCDIR);
+        QVERIFY(m_cacheDir.isValid());
+        qputenv("XDG_CACHE_HOME", m_cacheDir.path().toLocal8Bit());
     }
 
     void test_loadIcon_data()
@@ -77,6 +79,86 @@ private Q_SLOTS:
         QCOMPARE(returnedSize, resultSize);
     }
 
+    void test_indexCached()
+    {
+        QSize returnedSize;
+        UnityThemeIconProvider provider("mockTheme");
+        QImage i = provider.requestImage("gallery-app", &returnedSize, QSize(24, 24));
+        QVERIFY(!i.isNull());
+
+        // the theme index is saved for the next runs
+        QVERIFY(QFileInfo::exists(cachePath()));
+    }
+
+    void test_iconsLoadedFromCache()
+    {
+        UnityThemeIconProvider("mockTheme").requestImage("gallery-app", Q_NULLPTR, QSize(24, 24));
+        QVERIFY(QFileInfo::exists(cachePath()));
+        const QDateTime saved = QFileInfo(cachePath()).lastModified();
+
+        // loaded again from the cache, which isn't written again
+        QTest::qSleep(1100);
+        UnityThemeIconProvider::clearThemes();
+        UnityThemeIconProvider provider("mockTheme");
+        QSize returnedSize;
+        QImage i = provider.requestImage("gallery-app", &returnedSize, QSize(24, 24));
+        QCOMPARE(i.size(), QSize(24, 24));
+        i = provider.requestImage("battery-100-charging", &returnedSize, QSize(16, -1));
+        QCOMPARE(i.size(), QSize(16, 10));
+        // through the parent themes too
+        i = provider.requestImage("myapp", &returnedSize, QSize(-1, -1));
+        QCOMPARE(QColor(i.pixel(0,0)), QColor(Qt::white));
+        QVERIFY(provider.requestImage("missing-icon", &returnedSize, QSize(24, 24)).isNull());
+        QCOMPARE(QFileInfo(cachePath()).lastModified(), saved);
+    }
+
+    void test_corruptCache_data()
+    {
+        QTest::addColumn<QByteArray>("content");
+
+        QTest::newRow("empty") << QByteArray();
+        QTest::newRow("garbage") << QByteArray(4096, '\xff');
+        QTest::newRow("wrong version") << QByteArray("UTCI\x01\0\0\0\0\0\0\0", 12);
+    }
+    void test_corruptCache()
+    {
+        QFETCH(QByteArray, content);
+
+        UnityThemeIconProvider("mockTheme").requestImage("gallery-app", Q_NULLPTR, QSize(24, 24));
+        QFile cache(cachePath());
+        QVERIFY(cache.open(QIODevice::ReadOnly));
+        const QByteArray valid = cache.readAll();
+        cache.close();
+        QVERIFY(!valid.isEmpty());
+
+        writeCache(content);
+        checkRebuiltCache(valid.size());
+
+        // a cache cut anywhere in its tables
+        for (int size = valid.size() - 1; size > valid.size() / 2; size -= 7) {
+            writeCache(valid.left(size));
+            checkRebuiltCache(valid.size());
+        }
+    }
+
+    void test_imageCached()    void test_imageCached()
+    {
+        QSize returnedSize;
+        UnityThemeIconProvider provider("mockTheme");
+        QImage first = provider.requestImage("gallery-app", &returnedSize, QSize(16, 16));
+        QVERIFY(!first.isNull());
+
+        // same decoded image for the same request
+        QSize cachedSize;
+        QImage second = provider.requestImage("gallery-app", &cachedSize, QSize(16, 16));
+        QCOMPARE(second.cacheKey(), first.cacheKey());
+        QCOMPARE(cachedSize, returnedSize);
+
+        // not for another size
+        QImage third = provider.requestImage("gallery-app", &returnedSize, QSize(24, 24));
+        QVERIFY(third.cacheKey() != first.cacheKey());
+    }
+
     void test_hicolorLast()
     {
         QSize returnedSize;
@@ -93,6 +175,36 @@ private Q_SLOTS:
         QVERIFY(!i.isNull());
         QCOMPARE(QColor(i.pixel(0,0)), QColor(Qt::black));
     }
+
+private:
+    QString cachePath() const
+    {
+        return m_cacheDir.path() + "/ubuntu-ui-toolkit/icons/mockTheme.cache";
+    }
+
+    void writeCache(const QByteArray &content)
+    {
+        // the loaded themes map the cache
+        UnityThemeIconProvider::clearThemes();
+        QFile cache(cachePath());
+        QVERIFY(cache.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        cache.write(content);
+    }
+
+    // the corrupt cache is ignored and written again
+    void checkRebuiltCache(qint64 size)
+    {
+        UnityThemeIconProvider::clearThemes();
+        UnityThemeIconProvider provider("mockTheme");
+        QSize returnedSize;
+        QImage i = provider.requestImage("gallery-app", &returnedSize, QSize(24, 24));
+        QCOMPARE(i.size(), QSize(24, 24));
+        i = provider.requestImage("battery-100-charging", &returnedSize, QSize(16, -1));
+        QCOMPARE(i.size(), QSize(16, 10));
+        QCOMPARE(QFileInfo(cachePath()).size(), size);
+    }
+
+    QTemporaryDir m_cacheDir;
 };
 
 QTEST_MAIN(tst_IconProvider)
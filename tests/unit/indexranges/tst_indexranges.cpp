@@ -0,0 +1,141 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <UbuntuToolkit/private/indexranges_p.h>
+
+UT_USE_NAMESPACE
+
+class tst_IndexRanges : public QObject
+{
+    Q_OBJECT
+
+    static IndexRanges::RangeList ranges(const QList<int> &bounds)
+    {
+        IndexRanges::RangeList list;
+        for (int i = 0; i + 1 < bounds.size(); i += 2) {
+            IndexRange range = { bounds[i], bounds[i + 1] };
+            list.append(range);
+        }
+        return list;
+    }
+
+private Q_SLOTS:
+
+    void test_fromList_data()
+    {
+        QTest::addColumn<QList<int> >("indices");
+        QTest::addColumn<QList<int> >("bounds");
+        QTest::addColumn<int>("count");
+
+        QTest::newRow("empty") << QList<int>() << QList<int>() << 0;
+        QTest::newRow("single") << (QList<int>() << 5) << (QList<int>() << 5 << 5) << 1;
+        QTest::newRow("unsorted, duplicates") << (QList<int>() << 3 << 1 << 2 << 2 << 7) << (QList<int>() << 1 << 3 << 7 << 7) << 4;
+    }
+    void test_fromList()
+    {
+        QFETCH(QList<int>, indices);
+        QFETCH(QList<int>, bounds);
+        QFETCH(int, count);
+
+        IndexRanges set = IndexRanges::fromList(indices);
+        QCOMPARE(set.ranges(), ranges(bounds));
+        QCOMPARE(set.count(), count);
+        QCOMPARE(set.toList().size(), count);
+    }
+
+    void test_insert_merges()
+    {
+        IndexRanges set;
+        IndexRanges::RangeList added;
+        QVERIFY(set.insert(0, 9, &added));
+        QVERIFY(set.insert(20, 29, &added));
+        added.clear();
+        // fills the gap and touches both ranges
+        QVERIFY(set.insert(5, 24, &added));
+        QCOMPARE(set.ranges(), ranges(QList<int>() << 0 << 29));
+        QCOMPARE(added, ranges(QList<int>() << 10 << 19));
+        QCOMPARE(set.count(), 30);
+        // nothing new
+        QVERIFY(!set.insert(3, 4));
+        QCOMPARE(set.count(), 30);
+    }
+
+    void test_remove_splits()
+    {
+        IndexRanges set;
+        set.insert(0, 99999);
+        IndexRanges::RangeList removed;
+        QVERIFY(set.remove(10, 19, &removed));
+        QCOMPARE(removed, ranges(QList<int>() << 10 << 19));
+        QCOMPARE(set.ranges(), ranges(QList<int>() << 0 << 9 << 20 << 99999));
+        QCOMPARE(set.count(), 99990);
+        QVERIFY(set.contains(9));
+        QVERIFY(!set.contains(15));
+        QVERIFY(set.contains(20));
+        QVERIFY(!set.remove(10, 19));
+    }
+
+    void test_subtracted()
+    {
+        IndexRanges a = IndexRanges::fromList(QList<int>() << 1 << 2 << 3 << 4 << 8 << 9);
+        IndexRanges b = IndexRanges::fromList(QList<int>() << 2 << 3 << 9 << 10);
+        QCOMPARE(a.subtracted(b), ranges(QList<int>() << 1 << 1 << 4 << 4 << 8 << 8));
+        QCOMPARE(b.subtracted(a), ranges(QList<int>() << 10 << 10));
+    }
+
+    void test_shift()
+    {
+        IndexRanges set = IndexRanges::fromList(QList<int>() << 2 << 3 << 4 << 6);
+        set.shiftInserted(3, 2);
+        QCOMPARE(set.toList(), QList<int>() << 2 << 5 << 6 << 8);
+        set.shiftRemoved(3, 2);
+        QCOMPARE(set.toList(), QList<int>() << 2 << 3 << 4 << 6);
+        QCOMPARE(set.ranges().size(), 2);
+    }
+
+    void test_move_data()
+    {
+        QTest::addColumn<QList<int> >("selected");
+        QTest::addColumn<int>("from");
+        QTest::addColumn<int>("to");
+        QTest::addColumn<int>("count");
+        QTest::addColumn<QList<int> >("expected");
+
+        QTest::newRow("[0,1,2] selected, move 0->3") << (QList<int>() << 0 << 1 << 2) << 0 << 3 << 1 << (QList<int>() << 0 << 1 << 3);
+        QTest::newRow("[1,2] selected, move 3->0") << (QList<int>() << 1 << 2) << 3 << 0 << 1 << (QList<int>() << 2 << 3);
+        QTest::newRow("[1,2] selected, move 2->0") << (QList<int>() << 1 << 2) << 2 << 0 << 1 << (QList<int>() << 0 << 2);
+        QTest::newRow("[5] selected, move 1->2") << (QList<int>() << 5) << 1 << 2 << 1 << (QList<int>() << 5);
+        QTest::newRow("[2,3,6] selected, move 2..3->5") << (QList<int>() << 2 << 3 << 6) << 2 << 5 << 2 << (QList<int>() << 4 << 5 << 6);
+        QTest::newRow("[0,4] selected, move 3..4->0") << (QList<int>() << 0 << 4) << 3 << 0 << 2 << (QList<int>() << 1 << 2);
+    }
+    void test_move()
+    {
+        QFETCH(QList<int>, selected);
+        QFETCH(int, from);
+        QFETCH(int, to);
+        QFETCH(int, count);
+        QFETCH(QList<int>, expected);
+
+        IndexRanges set = IndexRanges::fromList(selected);
+        set.move(from, to, count);
+        QCOMPARE(set.toList(), expected);
+    }
+};
+
+QTEST_MAIN(tst_IndexRanges)
+
+#include "tst_indexranges.moc"
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.4
+import Ubuntu.Components 1.3
+
+Item {
+    width: 240
+    height: 320
+    property alias count: stack.model
+    property alias popover: popover
+
+    // stacked popovers, all covering the same area
+    Repeater {
+        id: stack
+        model: 0
+        Rectangle {
+            x: 10; y: 10
+            width: 100; height: 100
+            InverseMouseArea {
+                anchors.fill: parent
+                topmostItem: true
+            }
+        }
+    }
+
+    Rectangle {
+        id: popover
+        x: 10; y: 10
+        width: 100; height: 100
+        color: "blue"
+        InverseMouseArea {
+            anchors.fill: parent
+            objectName: "IMA"
+            topmostItem: true
+        }
+    }
+}
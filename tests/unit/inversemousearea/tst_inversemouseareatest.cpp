@@ -455,6 +455,54 @@ private Q_SLOTS:
         QCOMPARE(imaSpy.count(), 1);
     }
 
+    void test_topmostAreaMoved()
+    {
+        QScopedPointer<InverseMouseAreaTest> quickView(new InverseMouseAreaTest("InverseMouseAreaStack.qml"));
+        InverseMouseAreaType *ima = quickView->findItem<InverseMouseAreaType*>("IMA");
+        QSignalSpy imaSpy(ima, SIGNAL(pressed(QQuickMouseEvent*)));
+
+        QTest::mouseClick(quickView.data(), Qt::LeftButton, Qt::NoModifier, QPoint(50, 50));
+        QCOMPARE(imaSpy.count(), 0);
+
+        // the position is now outside of the area
+        quickView->rootObject()->property("popover").value<QQuickItem*>()->setX(120);
+        QTest::mouseClick(quickView.data(), Qt::LeftButton, Qt::NoModifier, QPoint(50, 50));
+        QCOMPARE(imaSpy.count(), 1);
+
+        imaSpy.clear();
+        QTest::mouseClick(quickView.data(), Qt::LeftButton, Qt::NoModifier, QPoint(150, 50));
+        QCOMPARE(imaSpy.count(), 0);
+    }
+
+    void benchmark_pointerMove_data()
+    {
+        QTest::addColumn<int>("areas");
+        QTest::addColumn<QPoint>("position");
+
+        QTest::newRow("1 area, inside") << 1 << QPoint(50, 50);
+        QTest::newRow("10 areas, inside") << 10 << QPoint(50, 50);
+        QTest::newRow("50 areas, inside") << 50 << QPoint(50, 50);
+        QTest::newRow("1 area, outside") << 1 << QPoint(150, 200);
+        QTest::newRow("10 areas, outside") << 10 << QPoint(150, 200);
+        QTest::newRow("50 areas, outside") << 50 << QPoint(150, 200);
+    }
+    void benchmark_pointerMove()
+    {
+        QFETCH(int, areas);
+        QFETCH(QPoint, position);
+        QScopedPointer<InverseMouseAreaTest> quickView(new InverseMouseAreaTest("InverseMouseAreaStack.qml"));
+        // the popover brings its own area
+        quickView->rootObject()->setProperty("count", areas - 1);
+        QCoreApplication::processEvents();
+
+        QPoint other(position + QPoint(1, 1));
+        QBENCHMARK {
+            QMouseEvent move(QEvent::MouseMove, position, position, quickView->mapToGlobal(position),
+                             Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+            QCoreApplication::sendEvent(quickView.data(), &move);
+            qSwap(position, other);
+        }
+    }
 };
 
 QTEST_MAIN(tst_InverseMouseAreaTest)
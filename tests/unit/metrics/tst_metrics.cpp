@@ -0,0 +1,550 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <QtTest/QtTest>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QOffscreenSurface>
+#include <QtGui/QOpenGLContext>
+
+#include <UbuntuMetrics/applicationmonitor.h>
+#include <UbuntuMetrics/events.h>
+#include <UbuntuMetrics/logger.h>
+#include <UbuntuMetrics/span.h>
+#include <UbuntuMetrics/private/gputimer_p.h>
+#include <UbuntuMetrics/private/histogram_p.h>
+#include <UbuntuMetrics/private/logger_p.h>
+
+// Keeps the span events logged, called from the logging thread.
+class SpanLogger : public UMLogger
+{
+public:
+    void log(const UMEvent& event) override
+    {
+        if (event.type == UMEvent::Span) {
+            QMutexLocker locker(&m_mutex);
+            m_spans.append(event.span);
+        }
+    }
+    bool isOpen() override { return true; }
+
+    QList<UMSpanEvent> spans()
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_spans;
+    }
+
+private:
+    QMutex m_mutex;
+    QList<UMSpanEvent> m_spans;
+};
+
+// Keeps all the events logged.
+class EventLogger : public UMLogger
+{
+public:
+    void log(const UMEvent& event) override { m_events.append(event); }
+    bool isOpen() override { return true; }
+
+    QVector<UMEvent> m_events;
+};
+
+// Fills events with frames of window 1, zeroing the padding so that events can
+// be compared with memcmp().
+static void fillEvents(UMEvent* events, int count)
+{
+    memset(events, 0, count * sizeof(UMEvent));
+    for (int i = 0; i < count; ++i) {
+        events[i].type = UMEvent::Frame;
+        events[i].timeStamp = (i + 1) * 1000000;
+        events[i].frame.window = 1;
+        events[i].frame.number = i;
+        events[i].frame.renderTime = (i + 1) * 1000;
+    }
+}
+
+static void setWindowEvent(UMEvent* event, quint16 width, quint16 height,
+                           UMWindowEvent::State state)
+{
+    memset(&event->window, 0, sizeof(UMWindowEvent));
+    event->type = UMEvent::Window;
+    event->window.id = 1;
+    event->window.width = width;
+    event->window.height = height;
+    event->window.state = state;
+}
+
+class tst_Metrics : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void test_histogram_empty()
+    {
+        Histogram histogram;
+        QCOMPARE(histogram.count(), 0u);
+        QCOMPARE(histogram.percentile(0.5f), Q_UINT64_C(0));
+        QCOMPARE(histogram.max(), Q_UINT64_C(0));
+    }
+
+    void test_histogram_percentiles()
+    {
+        // 1 to 1000 microseconds.
+        Histogram histogram;
+        for (quint64 i = 1; i <= 1000; ++i) {
+            histogram.record(i * 1000);
+        }
+        QCOMPARE(histogram.count(), 1000u);
+        QCOMPARE(histogram.max(), Q_UINT64_C(1000000));
+
+        // Percentiles must be in the ~3% precision of the histogram.
+        const quint64 p50 = histogram.percentile(0.5f);
+        QVERIFY2(p50 >= 500000 && p50 <= 500000 * 1.04, qPrintable(QString::number(p50)));
+        const quint64 p90 = histogram.percentile(0.9f);
+        QVERIFY2(p90 >= 900000 && p90 <= 900000 * 1.04, qPrintable(QString::number(p90)));
+        const quint64 p99 = histogram.percentile(0.99f);
+        QVERIFY2(p99 >= 990000 && p99 <= 1000000, qPrintable(QString::number(p99)));
+        QCOMPARE(histogram.percentile(1.0f), Q_UINT64_C(1000000));
+
+        histogram.reset();
+        QCOMPARE(histogram.count(), 0u);
+    }
+
+    void test_histogram_large_values()
+    {
+        // Values above the supported range are clamped but max stays exact.
+        Histogram histogram;
+        const quint64 hour = Q_UINT64_C(3600000000000);
+        histogram.record(hour * 2);
+        QCOMPARE(histogram.max(), hour * 2);
+        QCOMPARE(histogram.percentile(0.5f), hour * 2);
+    }
+
+    void test_frame_statistics_missed_vsyncs()
+    {
+        const quint64 vsyncInterval = 16666666;
+        UMFrameEvent frame;
+        memset(&frame, 0, sizeof(frame));
+
+        FrameStatistics statistics;
+        frame.deltaTime = vsyncInterval;
+        statistics.record(frame, vsyncInterval);
+        frame.deltaTime = vsyncInterval * 2;
+        statistics.record(frame, vsyncInterval);
+        frame.deltaTime = vsyncInterval * 4;
+        statistics.record(frame, vsyncInterval);
+
+        UMFrameSummaryEvent summary;
+        statistics.fillSummaryEvent(&summary);
+        QCOMPARE(summary.frameCount, 3u);
+        QCOMPARE(summary.missedVsyncCount, 4u);
+        QCOMPARE(summary.metrics[UMFrameSummaryEvent::DeltaTime].max,
+                 static_cast<quint32>(vsyncInterval * 4 / 1000));
+    }
+
+    void test_frame_statistics_gpu_time_lost()
+    {
+        UMFrameEvent frame;
+        memset(&frame, 0, sizeof(frame));
+
+        FrameStatistics statistics;
+        frame.gpuTime = 2000000;
+        statistics.record(frame, 0);
+        frame.gpuTime = 0;
+        statistics.record(frame, 0, true);
+        statistics.record(frame, 0, true);
+
+        UMFrameSummaryEvent summary;
+        statistics.fillSummaryEvent(&summary);
+        QCOMPARE(summary.frameCount, 3u);
+        QCOMPARE(summary.gpuTimeLostCount, 2u);
+        // Lost GPU times don't count in the GPU time percentiles.
+        QCOMPARE(summary.metrics[UMFrameSummaryEvent::GpuTime].p50, 2000u);
+
+        statistics.reset();
+        statistics.fillSummaryEvent(&summary);
+        QCOMPARE(summary.gpuTimeLostCount, 0u);
+    }
+
+    void test_gpu_timer_ring()
+    {
+        QOffscreenSurface surface;
+        surface.create();
+        QOpenGLContext context;
+        if (!context.create() || !context.makeCurrent(&surface)) {
+            QSKIP("No OpenGL context available");
+        }
+        QOpenGLFunctions* functions = context.functions();
+
+        GPUTimer timer;
+        timer.initialize();
+        for (quint32 frame = 1; frame <= GPUTimer::ringSize; ++frame) {
+            QVERIFY(timer.start(frame));
+            functions->glClear(GL_COLOR_BUFFER_BIT);
+            timer.stop();
+        }
+        QCOMPARE(timer.pendingCount(), GPUTimer::ringSize + 0);
+
+        // No more room for another measure until a result is taken.
+        QVERIFY(!timer.start(GPUTimer::ringSize + 1));
+        QCOMPARE(timer.lostCount(), 1u);
+
+        // Results come in order, once the GPU is done.
+        functions->glFinish();
+        quint32 expectedFrame = 1;
+        quint32 frame;
+        quint64 time;
+        GPUTimer::Status status;
+        QElapsedTimer elapsed;
+        elapsed.start();
+        while ((status = timer.takeResult(&frame, &time)) != GPUTimer::NoResult
+               && elapsed.elapsed() < 5000) {
+            if (status == GPUTimer::Pending) {
+                continue;
+            }
+            QCOMPARE(frame, expectedFrame++);
+        }
+        QCOMPARE(status, GPUTimer::NoResult);
+        QCOMPARE(expectedFrame, GPUTimer::ringSize + 1u);
+        QCOMPARE(timer.pendingCount(), 0);
+        QVERIFY(timer.start(GPUTimer::ringSize + 2));
+        timer.stop();
+
+        timer.finalize();
+        context.doneCurrent();
+    }
+
+    void test_span_nesting()
+    {
+        SpanLogger logger;
+        UMApplicationMonitor* monitor = UMApplicationMonitor::instance();
+        monitor->setLoggingFilter(UMApplicationMonitor::SpanEvent);
+        monitor->installLogger(&logger);
+
+        {
+            UMSpan disabled("Disabled");
+        }
+        QVERIFY(!UMSpan::isEnabled());
+
+        monitor->setLogging(true);
+        QVERIFY(UMSpan::isEnabled());
+        UMSpan detached("Detached", UMSpan::Detached);
+        {
+            UMSpan outer("Outer");
+            {
+                UMSpan inner("AVeryLongSpanNameThatDoesNotFitInTheEventAtAll_Truncated");
+            }
+        }
+        detached.end();
+        monitor->setLogging(false);
+        QVERIFY(!UMSpan::isEnabled());
+
+        // Spans are logged when they end, nested ones first.
+        QTRY_COMPARE(logger.spans().size(), 3);
+        const QList<UMSpanEvent> spans = logger.spans();
+        const UMSpanEvent& inner = spans[0];
+        const UMSpanEvent& outer = spans[1];
+        const UMSpanEvent& detachedEvent = spans[2];
+        QCOMPARE(QByteArray(outer.name), QByteArray("Outer"));
+        QCOMPARE(outer.nameSize, 6u);
+        QCOMPARE(inner.nameSize, UMSpanEvent::maxNameSize + 0);
+        QCOMPARE(qstrlen(inner.name), UMSpanEvent::maxNameSize - 1);
+        QCOMPARE(QByteArray(detachedEvent.name), QByteArray("Detached"));
+
+        // Detached spans aren't parents of the spans begun after them.
+        QCOMPARE(detachedEvent.parent, 0u);
+        QCOMPARE(detachedEvent.depth, 0u);
+        QCOMPARE(outer.parent, 0u);
+        QCOMPARE(outer.depth, 0u);
+        QCOMPARE(inner.parent, outer.id);
+        QCOMPARE(inner.depth, 1u);
+        QVERIFY(inner.id != outer.id);
+        QCOMPARE(inner.thread, outer.thread);
+        QVERIFY(inner.duration <= outer.duration);
+
+        monitor->clearLoggers(false);
+        monitor->setLoggingFilter(UMApplicationMonitor::AllEvents);
+    }
+
+    void test_process_event()
+    {
+        UMEventUtils utils;
+        UMEvent event;
+        memset(&event, 0, sizeof(event));
+        utils.updateProcessEvent(&event);
+        QCOMPARE(event.type, UMEvent::Process);
+        QVERIFY(event.process.rssMemory > 0);
+        QVERIFY(event.process.threadCount > 0);
+        if (QFile::exists(QStringLiteral("/proc/self/smaps_rollup"))) {
+            QVERIFY(event.process.pssMemory > 0);
+            QVERIFY(event.process.ussMemory > 0);
+            QVERIFY(event.process.ussMemory <= event.process.pssMemory);
+        }
+
+        // Touching each page of a fresh mapping takes a minor fault per page.
+        const long pageSize = sysconf(_SC_PAGESIZE);
+        const int pageCount = 1024;
+        void* memory = mmap(nullptr, pageCount * pageSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        QVERIFY(memory != MAP_FAILED);
+#if defined(MADV_NOHUGEPAGE)
+        madvise(memory, pageCount * pageSize, MADV_NOHUGEPAGE);
+#endif
+        volatile char* pages = static_cast<volatile char*>(memory);
+        for (int i = 0; i < pageCount; ++i) {
+            pages[i * pageSize] = 1;
+        }
+        utils.updateProcessEvent(&event);
+        munmap(memory, pageCount * pageSize);
+        QVERIFY(event.process.minorFaults >= static_cast<quint32>(pageCount));
+
+        // Counters are relative to the previous event, sleeping switches
+        // context at least once and doesn't fault on all the pages again.
+        QTest::qSleep(10);
+        utils.updateProcessEvent(&event);
+        QVERIFY(event.process.minorFaults < static_cast<quint32>(pageCount));
+        QVERIFY(event.process.voluntaryContextSwitches > 0);
+    }
+
+    void test_binary_logger()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.path() + QStringLiteral("/metrics.bin");
+        const int capacity = 4;
+        const int count = 6;
+
+        UMEvent events[count];
+        fillEvents(events, count);
+        setWindowEvent(&events[0], 800, 600, UMWindowEvent::Shown);
+        setWindowEvent(&events[3], 1024, 768, UMWindowEvent::Resized);
+
+        // The second batch wraps around the end of the ring.
+        UMBinaryLogger* logger = new UMBinaryLogger(fileName, capacity);
+        QVERIFY(logger->isOpen());
+        logger->logBatch(events, 3);
+        logger->logBatch(&events[3], 2);
+        logger->log(events[5]);
+        delete logger;
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.size(), static_cast<qint64>(sizeof(BinaryLogHeader) + capacity * sizeof(UMEvent)));
+        const uchar* data = file.map(0, file.size());
+        QVERIFY(data);
+
+        const BinaryLogHeader* header = reinterpret_cast<const BinaryLogHeader*>(data);
+        QCOMPARE(header->magic, static_cast<quint32>(BinaryLogHeader::magicNumber));
+        QCOMPARE(header->version, static_cast<quint32>(BinaryLogHeader::currentVersion));
+        QCOMPARE(header->eventSize, static_cast<quint32>(sizeof(UMEvent)));
+        QCOMPARE(header->eventCapacity, static_cast<quint32>(capacity));
+        QCOMPARE(header->eventCount, static_cast<quint64>(count));
+        QCOMPARE(header->windowCount, 1u);
+        QCOMPARE(header->windows[0].id, 1u);
+        QCOMPARE(header->windows[0].width, static_cast<quint16>(1024));
+        QCOMPARE(header->windows[0].height, static_cast<quint16>(768));
+        QCOMPARE(header->windows[0].state, static_cast<quint32>(UMWindowEvent::Resized));
+
+        // The decoder logs the ring back from the oldest event.
+        QCOMPARE(UMBinaryLoggerPrivate::validate(data, file.size()), UMBinaryLoggerPrivate::Decodable);
+        EventLogger decoded;
+        UMBinaryLoggerPrivate::decode(data, &decoded);
+        QCOMPARE(decoded.m_events.size(), capacity);
+        for (int i = 0; i < capacity; ++i) {
+            QVERIFY(!memcmp(&decoded.m_events[i], &events[count - capacity + i], sizeof(UMEvent)));
+        }
+        QCOMPARE(UMBinaryLoggerPrivate::validate(data, file.size() - 1),
+                 UMBinaryLoggerPrivate::TruncatedFile);
+        QCOMPARE(UMBinaryLoggerPrivate::validate(data, sizeof(BinaryLogHeader) - 1),
+                 UMBinaryLoggerPrivate::InvalidFile);
+        file.unmap(const_cast<uchar*>(data));
+        file.close();
+
+        // A ring that hasn't wrapped yet is decoded from its start.
+        logger = new UMBinaryLogger(fileName, capacity);
+        QVERIFY(logger->isOpen());
+        logger->logBatch(events, 2);
+        delete logger;
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        data = file.map(0, file.size());
+        QVERIFY(data);
+        QCOMPARE(UMBinaryLoggerPrivate::validate(data, file.size()), UMBinaryLoggerPrivate::Decodable);
+        decoded.m_events.clear();
+        UMBinaryLoggerPrivate::decode(data, &decoded);
+        QCOMPARE(decoded.m_events.size(), 2);
+        QVERIFY(!memcmp(decoded.m_events.constData(), events, 2 * sizeof(UMEvent)));
+    }
+
+    void test_file_logger_batch_data()
+    {
+        QTest::addColumn<bool>("parsable");
+        QTest::newRow("parsable") << true;
+        QTest::newRow("human readable") << false;
+    }
+    void test_file_logger_batch()
+    {
+        QFETCH(bool, parsable);
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString eventFileName = dir.path() + QStringLiteral("/event.log");
+        const QString batchFileName = dir.path() + QStringLiteral("/batch.log");
+        const int count = 6;
+
+        UMEvent events[count];
+        fillEvents(events, count);
+        setWindowEvent(&events[0], 800, 600, UMWindowEvent::Shown);
+        memset(&events[2].generic, 0, sizeof(UMGenericEvent));
+        events[2].type = UMEvent::Generic;
+        events[2].generic.id = 1;
+        memcpy(events[2].generic.string, "Generic", sizeof("Generic"));
+        events[2].generic.stringSize = sizeof("Generic");
+        memset(&events[4].process, 0, sizeof(UMProcessEvent));
+        events[4].type = UMEvent::Process;
+        events[4].process.cpuUsage = 50;
+        events[4].process.rssMemory = 1024;
+
+        UMFileLogger* logger = new UMFileLogger(eventFileName, parsable);
+        QVERIFY(logger->isOpen());
+        for (int i = 0; i < count; ++i) {
+            logger->log(events[i]);
+        }
+        delete logger;
+        logger = new UMFileLogger(batchFileName, parsable);
+        QVERIFY(logger->isOpen());
+        logger->logBatch(events, count);
+        delete logger;
+
+        QFile eventFile(eventFileName);
+        QFile batchFile(batchFileName);
+        QVERIFY(eventFile.open(QIODevice::ReadOnly));
+        QVERIFY(batchFile.open(QIODevice::ReadOnly));
+        const QByteArray eventData = eventFile.readAll();
+        QCOMPARE(eventData.count('\n'), count);
+        QCOMPARE(batchFile.readAll(), eventData);
+    }
+
+    void test_binary_logger_batch()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString eventFileName = dir.path() + QStringLiteral("/event.bin");
+        const QString batchFileName = dir.path() + QStringLiteral("/batch.bin");
+        const int capacity = 4;
+        const int count = 6;
+
+        UMEvent events[count];
+        fillEvents(events, count);
+        setWindowEvent(&events[1], 800, 600, UMWindowEvent::Shown);
+
+        UMBinaryLogger* logger = new UMBinaryLogger(eventFileName, capacity);
+        QVERIFY(logger->isOpen());
+        for (int i = 0; i < count; ++i) {
+            logger->log(events[i]);
+        }
+        delete logger;
+        logger = new UMBinaryLogger(batchFileName, capacity);
+        QVERIFY(logger->isOpen());
+        logger->logBatch(events, count);
+        delete logger;
+
+        // The clock base differs, everything else must be the same.
+        QFile eventFile(eventFileName);
+        QFile batchFile(batchFileName);
+        QVERIFY(eventFile.open(QIODevice::ReadOnly));
+        QVERIFY(batchFile.open(QIODevice::ReadOnly));
+        const QByteArray eventData = eventFile.readAll();
+        const QByteArray batchData = batchFile.readAll();
+        QCOMPARE(batchData.size(), eventData.size());
+        const BinaryLogHeader* eventHeader =
+            reinterpret_cast<const BinaryLogHeader*>(eventData.constData());
+        const BinaryLogHeader* batchHeader =
+            reinterpret_cast<const BinaryLogHeader*>(batchData.constData());
+        QCOMPARE(batchHeader->eventCount, static_cast<quint64>(count));
+        QCOMPARE(batchHeader->eventCount, eventHeader->eventCount);
+        QCOMPARE(batchHeader->windowCount, eventHeader->windowCount);
+        QVERIFY(!memcmp(batchHeader->windows, eventHeader->windows, sizeof(eventHeader->windows)));
+        QCOMPARE(batchData.mid(sizeof(BinaryLogHeader)), eventData.mid(sizeof(BinaryLogHeader)));
+    }
+
+    void test_trace_event_logger()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString fileName = dir.path() + QStringLiteral("/trace.json");
+
+        UMEvent events[3];
+        memset(events, 0, sizeof(events));
+        events[0].type = UMEvent::Frame;
+        events[0].timeStamp = 10000000;
+        events[0].frame.window = 1;
+        events[0].frame.number = 42;
+        events[0].frame.syncTime = 1000000;
+        events[0].frame.renderTime = 2000000;
+        events[0].frame.swapTime = 500;
+        events[1].type = UMEvent::Generic;
+        events[1].timeStamp = 12000000;
+        events[1].generic.id = 1;
+        memcpy(events[1].generic.string, "Quote\"", sizeof("Quote\""));
+        events[1].generic.stringSize = sizeof("Quote\"");
+        events[2].type = UMEvent::Process;
+        events[2].timeStamp = 13000000;
+        events[2].process.cpuUsage = 50;
+        events[2].process.guiThreadCpuUsage = 20;
+
+        UMTraceEventLogger* logger = new UMTraceEventLogger(fileName);
+        QVERIFY(logger->isOpen());
+        logger->logBatch(events, 3);
+        delete logger;
+
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QVERIFY(document.isArray());
+
+        // Process name, window track name, frame with its 3 passes, generic
+        // instant and 6 process counters.
+        const QJsonArray array = document.array();
+        QCOMPARE(array.size(), 13);
+        QCOMPARE(array[1].toObject()[QStringLiteral("args")].toObject()
+                 [QStringLiteral("name")].toString(), QStringLiteral("Window 1"));
+        const QJsonObject frame = array[2].toObject();
+        QCOMPARE(frame[QStringLiteral("ph")].toString(), QStringLiteral("X"));
+        QCOMPARE(frame[QStringLiteral("tid")].toInt(), 1);
+        QCOMPARE(frame[QStringLiteral("ts")].toDouble(), 6999.5);
+        QCOMPARE(frame[QStringLiteral("dur")].toDouble(), 3000.5);
+        const QJsonObject swap = array[5].toObject();
+        QCOMPARE(swap[QStringLiteral("name")].toString(), QStringLiteral("Swap"));
+        QCOMPARE(swap[QStringLiteral("ts")].toDouble(), 9999.5);
+        const QJsonObject generic = array[6].toObject();
+        QCOMPARE(generic[QStringLiteral("ph")].toString(), QStringLiteral("i"));
+        QCOMPARE(generic[QStringLiteral("name")].toString(), QStringLiteral("Quote\""));
+        const QJsonObject cpu = array[7].toObject();
+        QCOMPARE(cpu[QStringLiteral("ph")].toString(), QStringLiteral("C"));
+        QCOMPARE(cpu[QStringLiteral("args")].toObject()[QStringLiteral("usage")].toInt(), 50);
+        QCOMPARE(cpu[QStringLiteral("args")].toObject()[QStringLiteral("gui")].toInt(), 20);
+    }
+};
+
+QTEST_MAIN(tst_Metrics)
+
+#include "tst_metrics.moc"
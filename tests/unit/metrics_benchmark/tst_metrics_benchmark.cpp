@@ -0,0 +1,107 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+#include <QtTest/QtTest>
+
+#include <UbuntuMetrics/private/applicationmonitor_p.h>
+
+// Logger taking a given amount of microseconds per event.
+class SlowLogger : public UMLogger
+{
+public:
+    SlowLogger(unsigned long delay) : m_delay(delay) {}
+    void log(const UMEvent& event) Q_DECL_OVERRIDE { Q_UNUSED(event); QThread::usleep(m_delay); }
+    bool isOpen() Q_DECL_OVERRIDE { return true; }
+
+private:
+    unsigned long m_delay;
+};
+
+class tst_metrics_benchmark: public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void benchmark_push_latency_data() {
+        QTest::addColumn<int>("policy");
+        QTest::addColumn<int>("loggerDelay");
+
+        QTest::newRow("drop-oldest") << static_cast<int>(UMApplicationMonitor::DropOldest) << 100;
+        QTest::newRow("drop-newest") << static_cast<int>(UMApplicationMonitor::DropNewest) << 100;
+        QTest::newRow("block") << static_cast<int>(UMApplicationMonitor::Block) << 100;
+    }
+
+    // Simulates a render thread pushing a burst of events per frame to a
+    // logging thread which can't keep up, and reports the push latency
+    // percentiles.
+    void benchmark_push_latency() {
+        QFETCH(int, policy);
+        QFETCH(int, loggerDelay);
+
+        const int frameCount = 200;
+        const int eventsPerFrame = 8;
+        const int pushCount = frameCount * eventsPerFrame;
+
+        SlowLogger logger(loggerDelay);
+        UMLogger* loggers[] = { &logger };
+        LoggingThread* loggingThread =
+            new LoggingThread(static_cast<UMApplicationMonitor::OverflowPolicy>(policy));
+        loggingThread->setLoggers(loggers, 1);
+        EventQueue* queue = loggingThread->createQueue();
+        QVERIFY(queue);
+
+        UMEvent event;
+        memset(&event, 0, sizeof(event));
+        event.type = UMEvent::Frame;
+
+        QVector<qint64> latencies(pushCount);
+        QElapsedTimer timer;
+        for (int i = 0; i < frameCount; ++i) {
+            for (int j = 0; j < eventsPerFrame; ++j) {
+                event.frame.number = i * eventsPerFrame + j;
+                timer.start();
+                loggingThread->push(queue, &event);
+                latencies[i * eventsPerFrame + j] = timer.nsecsElapsed();
+            }
+            QThread::usleep(500);
+        }
+        const quint32 dropped = loggingThread->droppedEventCount();
+
+        // Remaining events are drained before the logging thread is joined.
+        loggingThread->releaseQueue(queue);
+        loggingThread->deref();
+
+        std::sort(latencies.begin(), latencies.end());
+        const qint64 p50 = latencies[pushCount / 2];
+        const qint64 p99 = latencies[(pushCount * 99) / 100];
+        qDebug("push latency p50: %lld ns, p99: %lld ns, max: %lld ns, dropped: %u/%d",
+               p50, p99, latencies.last(), dropped, pushCount);
+        QTest::setBenchmarkResult(p99, QTest::WalltimeNanoseconds);
+
+        if (policy == UMApplicationMonitor::Block) {
+            QCOMPARE(dropped, 0u);
+        }
+    }
+};
+
+QTEST_MAIN(tst_metrics_benchmark)
+
+#include "tst_metrics_benchmark.moc"
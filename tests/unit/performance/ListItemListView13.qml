@@ -0,0 +1,61 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+import QtQuick 2.3
+import Ubuntu.Components 1.3
+
+ListView {
+    width: 800
+    height: 600
+    model: ListModel {
+        id: listModel
+        Component.onCompleted: {
+            for (var i = 0; i < 1000; i++) {
+                append({"label": "Item " + i});
+            }
+        }
+    }
+    delegate: ListItem {
+    }
+
+    // replaces the rows of the model
+    function populate(rows) {
+        listModel.clear();
+        for (var i = 0; i < rows; i++) {
+            listModel.append({"label": "Item " + i});
+        }
+    }
+
+    // appends and removes rows at the end
+    function appendRow() {
+        listModel.append({"label": "Appended"});
+    }
+    function removeLastRow() {
+        listModel.remove(listModel.count - 1);
+    }
+
+    // inserts and removes rows around the visible delegates and at the end
+    function insertAndRemove(rows) {
+        for (var i = 0; i < rows; i++) {
+            listModel.insert(5, {"label": "Inserted"});
+            listModel.append({"label": "Appended"});
+        }
+        for (i = 0; i < rows; i++) {
+            listModel.remove(5);
+            listModel.remove(listModel.count - 1);
+        }
+    }
+}
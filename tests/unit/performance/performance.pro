@@ -36,6 +36,7 @@ OTHER_FILES += \
     LabelGrid13.qml \
     ListOfCaptions13.qml \
     ListItemList13.qml \
+    ListItemListView13.qml \
     ListItemWithInlineActionsAndFourContainersList.qml \
     ListItemWithInlineActionsAndFourMouseAreas.qml \
     ListOfCustomListItemLayouts.qml \
@@ -20,6 +20,11 @@
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickView>
 #include <QtTest/QtTest>
+#include <QtQuick/private/qquickitem_p.h>
+#include <UbuntuToolkit/private/uclistitem_p.h>
+#include <UbuntuToolkit/private/uclistitem_p_p.h>
+
+UT_USE_NAMESPACE
 
 class tst_Performance : public QObject
 {
@@ -40,6 +45,29 @@ private:
         return quickView->rootObject();
     }
 
+    // renders the view and checks that all the ListItems but the last one
+    // paint their divider
+    bool onlyLastDividerHidden(QQuickItem *view, int count)
+    {
+        QCoreApplication::sendPostedEvents(Q_NULLPTR, QEvent::DeferredDelete);
+        quickView->grabWindow();
+        QQuickItem *contentItem = view->property("contentItem").value<QQuickItem*>();
+        int itemCount = 0;
+        Q_FOREACH(QQuickItem *child, contentItem->childItems()) {
+            UCListItem *item = qobject_cast<UCListItem*>(child);
+            if (!item || UCListItemPrivate::get(item)->index() < 0) {
+                continue;
+            }
+            UCListItemPrivate *listItem = UCListItemPrivate::get(item);
+            bool painted = QQuickItemPrivate::get(listItem->divider)->paintNode != Q_NULLPTR;
+            if (painted == (listItem->index() == count - 1)) {
+                return false;
+            }
+            itemCount++;
+        }
+        return itemCount == count;
+    }
+
 private Q_SLOTS:
 
     void initTestCase()
@@ -151,6 +179,54 @@ private Q_SLOTS:
             delete root;
     }
 
+    void benchmark_ListItemInsertRemove_data()
+    {
+        QTest::addColumn<QString>("document");
+        QTest::addColumn<int>("rows");
+
+        QTest::newRow("ListView of ListItem 1.3, 1 row") << "ListItemListView13.qml" << 1;
+        QTest::newRow("ListView of ListItem 1.3, 50 rows") << "ListItemListView13.qml" << 50;
+    }
+
+    void benchmark_ListItemInsertRemove()
+    {
+        QFETCH(QString, document);
+        QFETCH(int, rows);
+
+        QQuickItem *root = loadDocument(document);
+        QVERIFY(root);
+        QBENCHMARK {
+            QMetaObject::invokeMethod(root, "insertAndRemove", Q_ARG(QVariant, rows));
+            QCoreApplication::processEvents();
+        }
+        delete root;
+    }
+
+    void test_ListItemInsertRemove_lastDivider()
+    {
+        QQuickItem *root = loadDocument("ListItemListView13.qml");
+        QVERIFY(root);
+        quickView->show();
+        QVERIFY(QTest::qWaitForWindowExposed(quickView));
+
+        QMetaObject::invokeMethod(root, "populate", Q_ARG(QVariant, 3));
+        QCoreApplication::processEvents();
+        QVERIFY(onlyLastDividerHidden(root, 3));
+
+        // the previous last item shows its divider again
+        QMetaObject::invokeMethod(root, "appendRow");
+        QCoreApplication::processEvents();
+        QVERIFY(onlyLastDividerHidden(root, 4));
+
+        // and the new last item hides it
+        QMetaObject::invokeMethod(root, "removeLastRow");
+        QCoreApplication::processEvents();
+        QVERIFY(onlyLastDividerHidden(root, 3));
+
+        quickView->hide();
+        delete root;
+    }
+
     void benchmark_import_data()
     {
         QTest::addColumn<QString>("document");
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <UbuntuToolkit/private/pickerrangemodel_p.h>
+
+UT_USE_NAMESPACE
+
+class tst_PickerRangeModel : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+
+    void test_values_data()
+    {
+        QTest::addColumn<int>("from");
+        QTest::addColumn<int>("count");
+        QTest::addColumn<int>("modulo");
+        QTest::addColumn<QList<int> >("values");
+
+        QTest::newRow("empty") << 5 << 0 << 0 << QList<int>();
+        QTest::newRow("years") << 2014 << 3 << 0 << (QList<int>() << 2014 << 2015 << 2016);
+        QTest::newRow("months") << 10 << 4 << 12 << (QList<int>() << 10 << 11 << 0 << 1);
+        QTest::newRow("hours") << 22 << 3 << 24 << (QList<int>() << 22 << 23 << 0);
+    }
+    void test_values()
+    {
+        QFETCH(int, from);
+        QFETCH(int, count);
+        QFETCH(int, modulo);
+        QFETCH(QList<int>, values);
+
+        PickerRangeModel model;
+        model.setModulo(modulo);
+        model.setRange(from, count);
+        QCOMPARE(model.rowCount(), values.size());
+        QCOMPARE(model.count(), values.size());
+        for (int row = 0; row < values.size(); row++) {
+            QCOMPARE(model.value(row), values[row]);
+            QCOMPARE(model.data(model.index(row), Qt::DisplayRole).toInt(), values[row]);
+            QCOMPARE(model.rowOf(values[row]), row);
+        }
+    }
+
+    void test_rowOf_data()
+    {
+        QTest::addColumn<int>("from");
+        QTest::addColumn<int>("count");
+        QTest::addColumn<int>("modulo");
+        QTest::addColumn<int>("value");
+        QTest::addColumn<int>("row");
+
+        QTest::newRow("before first") << 2014 << 10 << 0 << 2013 << -1;
+        QTest::newRow("after last") << 2014 << 10 << 0 << 2024 << -1;
+        QTest::newRow("last") << 2014 << 10 << 0 << 2023 << 9;
+        QTest::newRow("wrapped") << 20 << 10 << 24 << 3 << 7;
+        QTest::newRow("out of wrapped range") << 20 << 10 << 24 << 10 << -1;
+        QTest::newRow("full circle") << 5 << 60 << 60 << 4 << 59;
+    }
+    void test_rowOf()
+    {
+        QFETCH(int, from);
+        QFETCH(int, count);
+        QFETCH(int, modulo);
+        QFETCH(int, value);
+        QFETCH(int, row);
+
+        PickerRangeModel model;
+        model.setModulo(modulo);
+        model.setRange(from, count);
+        QCOMPARE(model.rowOf(value), row);
+    }
+
+    void test_setRange_replacesRows()
+    {
+        PickerRangeModel model;
+        model.setRange(0, 31);
+
+        QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+        QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+        QSignalSpy fromChanged(&model, SIGNAL(fromChanged()));
+        model.setRange(1, 28);
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(removed[0][1].toInt(), 0);
+        QCOMPARE(removed[0][2].toInt(), 30);
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(inserted[0][1].toInt(), 0);
+        QCOMPARE(inserted[0][2].toInt(), 27);
+        QCOMPARE(fromChanged.count(), 1);
+        QCOMPARE(model.from(), 1);
+    }
+
+    void test_resize()
+    {
+        PickerRangeModel model;
+        model.setRange(0, 28);
+
+        QSignalSpy removed(&model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+        QSignalSpy inserted(&model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+        QSignalSpy countChanged(&model, SIGNAL(countChanged()));
+
+        model.resize(31);
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(inserted[0][1].toInt(), 28);
+        QCOMPARE(inserted[0][2].toInt(), 30);
+        QCOMPARE(model.value(30), 30);
+
+        model.resize(30);
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(removed[0][1].toInt(), 30);
+        QCOMPARE(removed[0][2].toInt(), 30);
+
+        model.resize(30);
+        QCOMPARE(countChanged.count(), 2);
+        QCOMPARE(model.rowCount(), 30);
+    }
+
+    void test_roleNames()
+    {
+        PickerRangeModel model;
+        QCOMPARE(model.roleNames().values(), QList<QByteArray>() << "modelData");
+    }
+};
+
+QTEST_MAIN(tst_PickerRangeModel)
+
+#include "tst_pickerrangemodel.moc"
@@ -28,10 +28,10 @@
 
 UT_USE_NAMESPACE
 
-unsigned int numberOfTemporarySciFiles() {
+unsigned int numberOfSciFiles(const QDir &directory) {
     QStringList nameFilters;
     nameFilters << "*.sci";
-    return QDir::temp().entryList(nameFilters, QDir::Files).count();
+    return directory.entryList(nameFilters, QDir::Files).count();
 }
 
 int nFaces = 0;
@@ -115,30 +115,47 @@ private Q_SLOTS:
 
     void cachingOfRewrittenSciFiles() {
         /* This tests an internal implementation detail of UCQQuickImageExtension,
-           namely making sure that only one temporary rewritten .sci file is
-           created for each source .sci file.
+           namely making sure that only one rewritten .sci file is created for
+           each rewritten content, in a temporary directory of its own.
         */
         QQuickImageBase baseImage;
         UCQQuickImageExtension* image1 = new UCQQuickImageExtension(&baseImage);
         UCQQuickImageExtension* image2 = new UCQQuickImageExtension(&baseImage);
         QUrl sciFileUrl = QUrl::fromLocalFile("./data/test.sci");
 
-        unsigned int initialNumberOfSciFiles = numberOfTemporarySciFiles();
-
         image1->setSource(sciFileUrl);
-        QCOMPARE(numberOfTemporarySciFiles(), initialNumberOfSciFiles + 1);
+        const QString rewrittenSciFile = baseImage.source().toLocalFile();
+        QVERIFY(rewrittenSciFile.endsWith(".sci"));
+        QVERIFY(QFile::exists(rewrittenSciFile));
+        const QDir rewrittenSciDirectory = QFileInfo(rewrittenSciFile).dir();
+        QCOMPARE(numberOfSciFiles(rewrittenSciDirectory), 1u);
 
         image2->setSource(sciFileUrl);
-        QCOMPARE(numberOfTemporarySciFiles(), initialNumberOfSciFiles + 1);
-
-        delete image1;
-        QCOMPARE(numberOfTemporarySciFiles(), initialNumberOfSciFiles + 1);
+        QCOMPARE(baseImage.source().toLocalFile(), rewrittenSciFile);
+        QCOMPARE(numberOfSciFiles(rewrittenSciDirectory), 1u);
 
-        /* The temporary files will be deleted when the cache is destroyed when
+        /* The rewritten files are deleted when the cache is destroyed when
            the application exits.
         */
+        delete image1;
         delete image2;
-        QCOMPARE(numberOfTemporarySciFiles(), initialNumberOfSciFiles + 1);
+        QCOMPARE(numberOfSciFiles(rewrittenSciDirectory), 1u);
+    }
+
+    void asynchronousScaledImage() {
+        /* Asynchronous images go through the provider decoding in a thread
+           pool, the others keep being loaded synchronously.
+        */
+        QQuickImageBase baseImage;
+        baseImage.setAsynchronous(true);
+        UCQQuickImageExtension* image = new UCQQuickImageExtension(&baseImage);
+
+        image->setSource(QUrl::fromLocalFile("./data/scaled.png"));
+        QVERIFY(baseImage.source().toString().startsWith("image://scaling-async/"));
+
+        baseImage.setAsynchronous(false);
+        QVERIFY(baseImage.source().toString().startsWith("image://scaling/"));
+        delete image;
     }
 
     void onlyOneStatRepeatedImage() {
@@ -93,6 +93,78 @@ private Q_SLOTS:
         QCOMPARE(size, returnedSize);
         QCOMPARE(result.size(), resultSize);
     }
+
+    void asynchronousRequest() {
+        UCAsyncScalingImageProvider provider;
+        QImage expected("scaled_half.png");
+
+        QScopedPointer<QQuickImageResponse> response(provider.requestImageResponse("0.5/" + QDir::currentPath() + QDir::separator() + "input.png", QSize()));
+        // connected before returning to the event loop, as the engine does
+        QSignalSpy finishedSpy(response.data(), SIGNAL(finished()));
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QVERIFY(response->errorString().isEmpty());
+
+        QScopedPointer<QQuickTextureFactory> factory(response->textureFactory());
+        QCOMPARE(factory->image(), expected);
+    }
+
+    void coalescedRequests() {
+        QSharedPointer<UCScalingImageCache> cache(new UCScalingImageCache);
+        UCScalingImageProvider provider(cache);
+        UCAsyncScalingImageProvider asyncProvider(cache);
+        const QString id("0.5/" + QDir::currentPath() + QDir::separator() + "input128x256.png");
+
+        QScopedPointer<QQuickImageResponse> first(asyncProvider.requestImageResponse(id, QSize()));
+        QSignalSpy firstSpy(first.data(), SIGNAL(finished()));
+        QScopedPointer<QQuickImageResponse> second(asyncProvider.requestImageResponse(id, QSize()));
+        QSignalSpy secondSpy(second.data(), SIGNAL(finished()));
+        QTRY_COMPARE(firstSpy.count(), 1);
+        QTRY_COMPARE(secondSpy.count(), 1);
+
+        QScopedPointer<QQuickTextureFactory> firstFactory(first->textureFactory());
+        QScopedPointer<QQuickTextureFactory> secondFactory(second->textureFactory());
+        QCOMPARE(firstFactory->image().size(), QSize(64, 128));
+        QCOMPARE(firstFactory->image().cacheKey(), secondFactory->image().cacheKey());
+
+        // served from the cache shared with the synchronous provider
+        QSize size;
+        QImage cached = provider.requestImage(id, &size, QSize());
+        QCOMPARE(size, QSize(64, 128));
+        QCOMPARE(cached.cacheKey(), firstFactory->image().cacheKey());
+    }
+
+    void cachedAsynchronousRequest() {
+        UCAsyncScalingImageProvider provider;
+        const QString id("0.5/" + QDir::currentPath() + QDir::separator() + "input.png");
+
+        QScopedPointer<QQuickImageResponse> first(provider.requestImageResponse(id, QSize()));
+        QSignalSpy firstSpy(first.data(), SIGNAL(finished()));
+        QTRY_COMPARE(firstSpy.count(), 1);
+
+        // the image is cached, the response must still finish once the
+        // caller got the chance to connect
+        QScopedPointer<QQuickImageResponse> second(provider.requestImageResponse(id, QSize()));
+        QSignalSpy secondSpy(second.data(), SIGNAL(finished()));
+        QCOMPARE(secondSpy.count(), 0);
+        QTRY_COMPARE(secondSpy.count(), 1);
+        QVERIFY(second->errorString().isEmpty());
+
+        QScopedPointer<QQuickTextureFactory> firstFactory(first->textureFactory());
+        QScopedPointer<QQuickTextureFactory> secondFactory(second->textureFactory());
+        QCOMPARE(secondFactory->image().cacheKey(), firstFactory->image().cacheKey());
+    }
+
+    void responseOutlivesProvider() {
+        QScopedPointer<UCAsyncScalingImageProvider> provider(new UCAsyncScalingImageProvider);
+        QScopedPointer<QQuickImageResponse> response(provider->requestImageResponse(
+            "0.5/" + QDir::currentPath() + QDir::separator() + "input.png", QSize()));
+        QSignalSpy finishedSpy(response.data(), SIGNAL(finished()));
+        // the response keeps the cache and its decoding alive
+        provider.reset();
+        QTRY_COMPARE(finishedSpy.count(), 1);
+        QScopedPointer<QQuickTextureFactory> factory(response->textureFactory());
+        QCOMPARE(factory->image(), QImage("scaled_half.png"));
+    }
 };
 
 QTEST_MAIN(tst_UCScalingImageProvider)
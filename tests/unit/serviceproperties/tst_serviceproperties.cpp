@@ -14,8 +14,17 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <signal.h>
+#include <stdio.h>
+
 #include <QtCore/QDebug>
+#include <QtCore/QMutex>
 #include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusObjectPath>
+#include <QtDBus/QDBusVirtualObject>
+#include <QtGui/QGuiApplication>
 #include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 #include <UbuntuToolkit/private/ucserviceproperties_p_p.h>
@@ -24,16 +33,113 @@
 
 UT_USE_NAMESPACE
 
+static const QString userPath = QStringLiteral("/org/freedesktop/Accounts/User1");
+static const QString soundInterface = QStringLiteral("com.ubuntu.touch.AccountsService.Sound");
+static const QString propertiesInterface = QStringLiteral("org.freedesktop.DBus.Properties");
+// set when the private session bus is running
+static bool privateSessionBus = false;
+
+// QAtomicInt::load() is deprecated since Qt 5.14
+static int loadCount(const QAtomicInt &count)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return count.loadRelaxed();
+#else
+    return count.load();
+#endif
+}
+
+// AccountsService look-alike registered on the private session bus
+class MockAccounts : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "org.freedesktop.Accounts")
+public Q_SLOTS:
+    QDBusObjectPath FindUserById(qlonglong uid)
+    {
+        Q_UNUSED(uid);
+        return QDBusObjectPath(userPath);
+    }
+};
+
+// user object serving the sound properties, counts the property reads
+class MockUser : public QDBusVirtualObject
+{
+public:
+    QAtomicInt getAllCalls;
+    QAtomicInt getCalls;
+
+    MockUser()
+    {
+        values.insert(QStringLiteral("IncomingCallVibrate"), true);
+    }
+
+    // changes a value without notifying the watchers
+    void setValue(const QString &property, const QVariant &value)
+    {
+        QMutexLocker lock(&mutex);
+        values.insert(property, value);
+    }
+
+    QString introspect(const QString &path) const override
+    {
+        Q_UNUSED(path);
+        return QString();
+    }
+
+    bool handleMessage(const QDBusMessage &message, const QDBusConnection &connection) override
+    {
+        if (message.interface() != propertiesInterface) {
+            return false;
+        }
+        QMutexLocker lock(&mutex);
+        const QVariantList args = message.arguments();
+        if (args.isEmpty() || args[0].toString() != soundInterface) {
+            connection.send(message.createErrorReply(QDBusError::UnknownInterface, QStringLiteral("No such interface")));
+            return true;
+        }
+        if (message.member() == QStringLiteral("GetAll")) {
+            getAllCalls.ref();
+            connection.send(message.createReply(QVariant::fromValue(values)));
+        } else if (message.member() == QStringLiteral("Get") && args.count() == 2) {
+            getCalls.ref();
+            connection.send(message.createReply(QVariant::fromValue(QDBusVariant(values.value(args[1].toString())))));
+        } else if (message.member() == QStringLiteral("Set") && args.count() == 3) {
+            QVariantMap changed;
+            changed.insert(args[1].toString(), args[2].value<QDBusVariant>().variant());
+            values.insert(args[1].toString(), changed.first());
+            connection.send(message.createReply());
+            QDBusMessage signal = QDBusMessage::createSignal(userPath, propertiesInterface, QStringLiteral("PropertiesChanged"));
+            signal << soundInterface << changed << QStringList();
+            connection.send(signal);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    QMutex mutex;
+    QVariantMap values;
+};
+
 class tst_ServiceProperties : public QObject
 {
     Q_OBJECT
 
 public:
-    tst_ServiceProperties() {}
+    tst_ServiceProperties()
+        : mockAccounts(0)
+        , mockUser(0)
+    {}
 
 private:
 
     QString error;
+    QString sessionError;
+    QThread mockThread;
+    MockAccounts *mockAccounts;
+    MockUser *mockUser;
 
     // FIXME use UbuntuTestCase::ignoreWaring in Vivid
     void ignoreWarning(const QString& fileName, uint line, uint column, const QString& message, uint occurences=1)
@@ -62,6 +168,32 @@ private Q_SLOTS:
         if (watcher->status() == UCServiceProperties::ConnectionError) {
             error = "Skip test: " + watcher->error();
         }
+
+        // serve the mock service from a thread so that synchronous calls made
+        // by the watchers don't block
+        if (!privateSessionBus) {
+            sessionError = "Skip test: no private session bus";
+            return;
+        }
+        QDBusConnection bus = QDBusConnection::connectToBus(QDBusConnection::SessionBus, "mockService");
+        QVERIFY(bus.isConnected());
+        mockAccounts = new MockAccounts;
+        mockUser = new MockUser;
+        mockAccounts->moveToThread(&mockThread);
+        mockUser->moveToThread(&mockThread);
+        mockThread.start();
+        QVERIFY(bus.registerObject("/org/freedesktop/Accounts", mockAccounts, QDBusConnection::ExportAllSlots));
+        QVERIFY(bus.registerVirtualObject(userPath, mockUser));
+        QVERIFY(bus.registerService("org.freedesktop.Accounts"));
+    }
+
+    void cleanupTestCase()
+    {
+        QDBusConnection::disconnectFromBus("mockService");
+        mockThread.quit();
+        mockThread.wait();
+        delete mockAccounts;
+        delete mockUser;
     }
 
     void cleanup()
@@ -211,8 +343,107 @@ private Q_SLOTS:
         QCOMPARE(watcher->property("error").toString(), QString("Changing connection parameters forbidden."));
     }
 
+
+    // watchers of the same object share a single GetAll call
+    void test_shared_fetch()
+    {
+        if (!sessionError.isEmpty()) {
+            QSKIP(qPrintable(sessionError));
+        }
+        int getAllCalls = loadCount(mockUser->getAllCalls);
+        QScopedPointer<UbuntuTestCase> test1(new UbuntuTestCase("SessionBusWatcher.qml"));
+        QScopedPointer<UbuntuTestCase> test2(new UbuntuTestCase("SessionBusWatcher.qml"));
+        UCServiceProperties *watcher1 = static_cast<UCServiceProperties*>(test1->rootObject()->property("service").value<QObject*>());
+        UCServiceProperties *watcher2 = static_cast<UCServiceProperties*>(test2->rootObject()->property("service").value<QObject*>());
+        QVERIFY(watcher1);
+        QVERIFY(watcher2);
+        QTRY_COMPARE(watcher1->status(), UCServiceProperties::Active);
+        QTRY_COMPARE(watcher2->status(), UCServiceProperties::Active);
+
+        QCOMPARE(watcher1->property("incomingCallVibrate").toBool(), true);
+        QCOMPARE(watcher2->property("incomingCallVibrate").toBool(), true);
+        QCOMPARE(loadCount(mockUser->getAllCalls) - getAllCalls, 1);
+        QCOMPARE(loadCount(mockUser->getCalls), 0);
+    }
+
+    // changes reported by the service reach all watchers without reading the values again
+    void test_shared_change()
+    {
+        if (!sessionError.isEmpty()) {
+            QSKIP(qPrintable(sessionError));
+        }
+        QScopedPointer<UbuntuTestCase> test1(new UbuntuTestCase("SessionBusWatcher.qml"));
+        QScopedPointer<UbuntuTestCase> test2(new UbuntuTestCase("SessionBusWatcher.qml"));
+        UCServiceProperties *watcher1 = static_cast<UCServiceProperties*>(test1->rootObject()->property("service").value<QObject*>());
+        UCServiceProperties *watcher2 = static_cast<UCServiceProperties*>(test2->rootObject()->property("service").value<QObject*>());
+        QTRY_COMPARE(watcher1->status(), UCServiceProperties::Active);
+        QTRY_COMPARE(watcher2->status(), UCServiceProperties::Active);
+        bool backup = watcher1->property("incomingCallVibrate").toBool();
+        int getAllCalls = loadCount(mockUser->getAllCalls);
+
+        QVERIFY(UCServicePropertiesPrivate::get(watcher1)->testProperty("IncomingCallVibrate", !backup));
+        QTRY_COMPARE(watcher1->property("incomingCallVibrate").toBool(), !backup);
+        QTRY_COMPARE(watcher2->property("incomingCallVibrate").toBool(), !backup);
+        QCOMPARE(loadCount(mockUser->getAllCalls), getAllCalls);
+
+        UCServicePropertiesPrivate::get(watcher1)->testProperty("IncomingCallVibrate", backup);
+    }
+
+    // the values are fetched again, once, when the service changes owner
+    void test_owner_change_refetches()
+    {
+        if (!sessionError.isEmpty()) {
+            QSKIP(qPrintable(sessionError));
+        }
+        QScopedPointer<UbuntuTestCase> test1(new UbuntuTestCase("SessionBusWatcher.qml"));
+        QScopedPointer<UbuntuTestCase> test2(new UbuntuTestCase("SessionBusWatcher.qml"));
+        UCServiceProperties *watcher1 = static_cast<UCServiceProperties*>(test1->rootObject()->property("service").value<QObject*>());
+        UCServiceProperties *watcher2 = static_cast<UCServiceProperties*>(test2->rootObject()->property("service").value<QObject*>());
+        QTRY_COMPARE(watcher1->status(), UCServiceProperties::Active);
+        QTRY_COMPARE(watcher2->status(), UCServiceProperties::Active);
+        bool backup = watcher1->property("incomingCallVibrate").toBool();
+        int getAllCalls = loadCount(mockUser->getAllCalls);
+
+        // the new owner has other values, and reports no change
+        mockUser->setValue("IncomingCallVibrate", !backup);
+        QDBusConnection bus("mockService");
+        QVERIFY(bus.unregisterService("org.freedesktop.Accounts"));
+        QVERIFY(bus.registerService("org.freedesktop.Accounts"));
+        QTRY_COMPARE(watcher1->property("incomingCallVibrate").toBool(), !backup);
+        QTRY_COMPARE(watcher2->property("incomingCallVibrate").toBool(), !backup);
+        QCOMPARE(loadCount(mockUser->getAllCalls) - getAllCalls, 1);
+
+        mockUser->setValue("IncomingCallVibrate", backup);
+    }
 };
 
-QTEST_MAIN(tst_ServiceProperties)
+// The C++ equivalent of QTEST_MAIN(tst_ServiceProperties), running the session
+// bus tests against a private bus
+int main(int argc, char *argv[])
+{
+    // the address must be set before anything connects to the session bus
+    pid_t daemonPid = 0;
+    FILE *daemon = popen("dbus-daemon --session --fork --print-address=1 --print-pid=1", "r");
+    if (daemon) {
+        char address[512];
+        if (fgets(address, sizeof(address), daemon)) {
+            qputenv("DBUS_SESSION_BUS_ADDRESS", QByteArray(address).trimmed());
+            privateSessionBus = true;
+            if (fscanf(daemon, "%d", &daemonPid) != 1) {
+                daemonPid = 0;
+            }
+        }
+        pclose(daemon);
+    }
+
+    QGuiApplication app(argc, argv);
+    tst_ServiceProperties testObject;
+    int result = QTest::qExec(&testObject, argc, argv);
+
+    if (daemonPid > 0) {
+        kill(daemonPid, SIGTERM);
+    }
+    return result;
+}
 
 #include "tst_serviceproperties.moc"
@@ -0,0 +1,2 @@
+include(../test-include.pri)
+SOURCES += tst_sortfiltermodel.cpp
@@ -0,0 +1,142 @@
+/*
+ * Copyright 2016 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtCore/QCollator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QThreadPool>
+#include <QtGui/QStandardItemModel>
+#include <QtTest/QtTest>
+#define private public
+#include <UbuntuToolkit/private/sortfiltermodel_p.h>
+#undef private
+
+UT_USE_NAMESPACE
+
+class tst_SortFilterModel : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_SortFilterModel() {}
+
+private:
+    // the tool tips are in the reverse order, the status tips in order
+    void populate(QStandardItemModel *model, int rowCount)
+    {
+        for (int row = 0; row < rowCount; row++) {
+            QStandardItem *item = new QStandardItem;
+            item->setData(QStringLiteral("%1").arg(rowCount - row, 6, 10, QLatin1Char('0')), Qt::ToolTipRole);
+            item->setData(QStringLiteral("%1").arg(row, 6, 10, QLatin1Char('0')), Qt::StatusTipRole);
+            model->appendRow(item);
+        }
+    }
+
+    bool isSorted(const QSortFilterProxyModel &proxy, int role)
+    {
+        for (int row = 1; row < proxy.rowCount(); row++) {
+            if (proxy.index(row, 0).data(role).toString() < proxy.index(row - 1, 0).data(role).toString()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private Q_SLOTS:
+
+    void test_sort_computed_in_thread_pool()
+    {
+        QStandardItemModel model;
+        populate(&model, 200);
+        QSortFilterProxyModelQML proxy;
+        proxy.setModel(&model);
+        proxy.setAsynchronous(true);
+
+        proxy.m_sortBehavior.setProperty(QStringLiteral("toolTip"));
+        // the keys of a small model are fetched at once, the sorting job is
+        // done while this thread only waits for the pool
+        QVERIFY(!proxy.m_sortKeys.cached.contains(false));
+        QThreadPool::globalInstance()->waitForDone();
+        QVERIFY(proxy.m_sortRanks.isEmpty());
+        QCOMPARE(proxy.index(0, 0).data(Qt::ToolTipRole).toString(), QStringLiteral("000200"));
+
+        // and the result is applied once back in the event loop
+        QCoreApplication::sendPostedEvents(&proxy, 0);
+        QCOMPARE(proxy.m_sortRanks.size(), 200);
+        QCOMPARE(proxy.index(0, 0).data(Qt::ToolTipRole).toString(), QStringLiteral("000001"));
+        QVERIFY(isSorted(proxy, Qt::ToolTipRole));
+    }
+
+    void test_large_model_sorted_in_slices()
+    {
+        QStandardItemModel model;
+        populate(&model, 50000);
+        QSortFilterProxyModelQML proxy;
+        proxy.setModel(&model);
+        proxy.setAsynchronous(true);
+
+        proxy.m_sortBehavior.setProperty(QStringLiteral("toolTip"));
+        QTRY_COMPARE_WITH_TIMEOUT(proxy.m_sortRanks.size(), 50000, 10000);
+        QCOMPARE(proxy.index(0, 0).data(Qt::ToolTipRole).toString(), QStringLiteral("000001"));
+        QVERIFY(isSorted(proxy, Qt::ToolTipRole));
+
+        // same with the locale aware comparison
+        proxy.setSortLocaleAware(true);
+        proxy.m_sortBehavior.setProperty(QStringLiteral("statusTip"));
+        QTRY_COMPARE_WITH_TIMEOUT(proxy.m_sortRanks.size(), 50000, 10000);
+        QCOMPARE(proxy.index(0, 0).data(Qt::StatusTipRole).toString(), QStringLiteral("000000"));
+        QVERIFY(isSorted(proxy, Qt::StatusTipRole));
+    }
+
+    void benchmark_asynchronous_sort_data()
+    {
+        QTest::addColumn<int>("rowCount");
+
+        QTest::newRow("5k rows") << 5000;
+        QTest::newRow("50k rows") << 50000;
+    }
+    void benchmark_asynchronous_sort()
+    {
+        QFETCH(int, rowCount);
+
+        QStandardItemModel model;
+        populate(&model, rowCount);
+        QSortFilterProxyModelQML proxy;
+        proxy.setModel(&model);
+        proxy.setAsynchronous(true);
+
+        // the longest the event loop is blocked while re-sorting
+        qint64 longestBlock = 0;
+        bool toolTip = false;
+        QBENCHMARK {
+            toolTip = !toolTip;
+            proxy.m_sortBehavior.setProperty(toolTip ? QStringLiteral("toolTip") : QStringLiteral("statusTip"));
+            while (proxy.m_sortRanks.size() != rowCount) {
+                QElapsedTimer timer;
+                timer.start();
+                QCoreApplication::processEvents(QEventLoop::AllEvents, 5);
+                longestBlock = qMax(longestBlock, timer.elapsed());
+            }
+        }
+        qDebug() << "longest event loop block:" << longestBlock << "ms";
+    }
+};
+
+QTEST_MAIN(tst_SortFilterModel)
+
+#include "tst_sortfiltermodel.moc"
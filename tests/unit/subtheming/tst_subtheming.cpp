@@ -792,6 +792,119 @@ private Q_SLOTS:
         QVERIFY(button->findChild<QQuickItem*>("TestStyle"));
     }
 
+    void test_asynchronous_style()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("AsynchronousStyle.qml"));
+        UCStyledItemBase *visibleButton = view->findItem<UCStyledItemBase*>("VisibleButton");
+        UCStyledItemBase *hiddenButton = view->findItem<UCStyledItemBase*>("HiddenButton");
+        UCStyledItemBasePrivate *visiblePrivate = UCStyledItemBasePrivate::get(visibleButton);
+        UCStyledItemBasePrivate *hiddenPrivate = UCStyledItemBasePrivate::get(hiddenButton);
+
+        // both get their style, the hidden one when idle
+        QTRY_VERIFY(visiblePrivate->styleInstance() != Q_NULLPTR);
+        QTRY_VERIFY(hiddenPrivate->styleInstance() != Q_NULLPTR);
+        QCOMPARE(visiblePrivate->styleInstance()->parentItem(), visibleButton);
+        QCOMPARE(hiddenPrivate->styleInstance()->parentItem(), hiddenButton);
+    }
+
+    void test_asynchronous_style_priority()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("AsynchronousStyle.qml"));
+        QQmlComponent component(view->engine());
+        component.setData("import QtQuick 2.4\n"
+                          "import Ubuntu.Components 1.3\n"
+                          "Item {\n"
+                          "    Button { objectName: \"VisibleFirst\"; asynchronousStyle: true }\n"
+                          "    Button { objectName: \"Immediate\"; asynchronousStyle: true; stylePriority: StyledItem.Immediate }\n"
+                          "    Button { objectName: \"Idle\"; asynchronousStyle: true; stylePriority: StyledItem.Idle }\n"
+                          "}", QUrl());
+        QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem*>(component.create()));
+        QVERIFY(root);
+        UCStyledItemBasePrivate *visibleFirst =
+            UCStyledItemBasePrivate::get(root->findChild<UCStyledItemBase*>("VisibleFirst"));
+        UCStyledItemBasePrivate *immediate =
+            UCStyledItemBasePrivate::get(root->findChild<UCStyledItemBase*>("Immediate"));
+        UCStyledItemBasePrivate *idle =
+            UCStyledItemBasePrivate::get(root->findChild<UCStyledItemBase*>("Idle"));
+
+        // not shown yet, only the immediate one starts loading
+        QVERIFY(visibleFirst->styleLoadPending);
+        QVERIFY(!immediate->styleLoadPending);
+        QVERIFY(idle->styleLoadPending);
+
+        // once shown, the idle one still waits for the application to be idle
+        root->setParentItem(view->rootObject());
+        QVERIFY(!visibleFirst->styleLoadPending);
+        QVERIFY(idle->styleLoadPending);
+
+        QTRY_VERIFY(visibleFirst->styleInstance() != Q_NULLPTR);
+        QTRY_VERIFY(immediate->styleInstance() != Q_NULLPTR);
+        QTRY_VERIFY(idle->styleInstance() != Q_NULLPTR);
+    }
+
+    void test_asynchronous_styles_share_component()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("AsynchronousStyle.qml"));
+        QQmlComponent component(view->engine());
+        component.setData("import QtQuick 2.4\n"
+                          "import Ubuntu.Components 1.3\n"
+                          "Item {\n"
+                          "    Button { objectName: \"First\"; asynchronousStyle: true; stylePriority: StyledItem.Immediate }\n"
+                          "    Button { objectName: \"Second\"; asynchronousStyle: true; stylePriority: StyledItem.Immediate }\n"
+                          "}", QUrl());
+        QScopedPointer<QQuickItem> root(qobject_cast<QQuickItem*>(component.create()));
+        QVERIFY(root);
+        UCStyledItemBase *button = root->findChild<UCStyledItemBase*>("First");
+        UCStyledItemBasePrivate *first = UCStyledItemBasePrivate::get(button);
+        UCStyledItemBasePrivate *second =
+            UCStyledItemBasePrivate::get(root->findChild<UCStyledItemBase*>("Second"));
+
+        // both incubate the component cached by the theme
+        QQmlComponent *styleComponent = first->styleLoaderComponent;
+        QVERIFY(styleComponent);
+        QCOMPARE(second->styleLoaderComponent, styleComponent);
+        UCTheme *theme = button->getTheme();
+        QCOMPARE(styleComponent->parent(), static_cast<QObject*>(theme));
+        QVERIFY(!theme->m_busyStyleComponents.contains(styleComponent));
+
+        // and give it back once done
+        QTRY_VERIFY(first->styleInstance() != Q_NULLPTR);
+        QTRY_VERIFY(second->styleInstance() != Q_NULLPTR);
+        QTRY_VERIFY(!theme->m_styleComponentUsers.contains(styleComponent));
+    }
+
+    void test_asynchronous_style_reloaded_on_theme_change()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("AsynchronousStyle.qml"));
+        UCStyledItemBase *button = view->findItem<UCStyledItemBase*>("VisibleButton");
+        UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(button);
+        QTRY_VERIFY(d->styleInstance() != Q_NULLPTR);
+
+        QSignalSpy loadedSpy(button, SIGNAL(styleLoaded()));
+        button->getTheme()->setName("Ubuntu.Components.Themes.SuruDark");
+        QTRY_COMPARE(loadedSpy.count(), 1);
+        QVERIFY(d->styleInstance() != Q_NULLPTR);
+    }
+
+    void test_asynchronous_style_theme_change_while_loading()
+    {
+        QScopedPointer<ThemeTestCase> view(new ThemeTestCase("AsynchronousStyle.qml"));
+        UCStyledItemBase *button = view->findItem<UCStyledItemBase*>("HiddenButton");
+        UCStyledItemBasePrivate *d = UCStyledItemBasePrivate::get(button);
+
+        // the style cache is dropped while the components may still be used
+        // by the loaders, which must complete with the new theme
+        button->getTheme()->setName("Ubuntu.Components.Themes.SuruDark");
+        QTRY_VERIFY(d->styleInstance() != Q_NULLPTR);
+        QVERIFY(!d->styleLoaderComponent);
+        QCOMPARE(d->styleInstance()->parentItem(), button);
+
+        // and later loadings aren't blocked
+        button->getTheme()->setName("Ubuntu.Components.Themes.Ambiance");
+        QTRY_VERIFY(d->styleInstance() != Q_NULLPTR);
+        QVERIFY(!d->styleLoaderComponent);
+    }
+
     void test_style_reset_to_theme_style()
     {
         QScopedPointer<ThemeTestCase> view(new ThemeTestCase("StyleKept.qml"));
@@ -11,7 +11,8 @@ SUBDIRS += testparser
 #######################################
 #!contains(QMAKE_HOST.arch,armv7l) {
     SUBDIRS += components \
-        components_benchmark
+        components_benchmark \
+        metrics_benchmark
 #}
 
 SUBDIRS += \
@@ -19,7 +20,10 @@ SUBDIRS += \
     ubuntu_shape \
     page \
     test \
+    icon \
     iconprovider \
+    indexranges \
+    pickerrangemodel \
     inversemousearea \
     recreateview \
     statesaver \
@@ -48,4 +52,6 @@ SUBDIRS += \
     alarms \
     theme \
     quickutils \
-    tree
+    tree \
+    sortfiltermodel \
+    metrics
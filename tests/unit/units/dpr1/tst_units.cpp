@@ -282,6 +282,30 @@ private Q_SLOTS:
         expected = QString("0.875/" + QDir::currentPath() + QDir::separator() + "resource@8.png");
         QCOMPARE(resolved, expected);
     }
+
+    void resolveAfterDirectoryChange() {
+        UCUnits units;
+        QTemporaryDir directory;
+        QVERIFY(directory.isValid());
+        const QString path = directory.path();
+        QUrl url = QUrl::fromLocalFile(path + "/resource.png");
+
+        units.setGridUnit(12);
+        QCOMPARE(units.resolveResource(url), QString(""));
+
+        QFile lower(path + "/resource@10.png");
+        QVERIFY(lower.open(QIODevice::WriteOnly));
+        lower.close();
+        QTRY_COMPARE(units.resolveResource(url), QString("1.2/" + path + "/resource@10.png"));
+
+        QFile higher(path + "/resource@14.png");
+        QVERIFY(higher.open(QIODevice::WriteOnly));
+        higher.close();
+        QTRY_COMPARE(units.resolveResource(url), QString("0.857143/" + path + "/resource@14.png"));
+
+        QVERIFY(higher.remove());
+        QTRY_COMPARE(units.resolveResource(url), QString("1.2/" + path + "/resource@10.png"));
+    }
 };
 
 QTEST_MAIN(tst_UCUnits)
@@ -103,6 +103,25 @@ Item {
         }
     }
 
+    Component {
+        id: cachedPageComponent
+        Page {
+            objectName: header.title
+            header: PageHeader { title: "CachedPage" }
+            property int cachedCount: 0
+            property int restoredCount: 0
+            onCached: cachedCount++
+            onRestored: restoredCount++
+        }
+    }
+
+    Component {
+        id: cachedItemComponent
+        Item {
+            objectName: "CachedItem"
+        }
+    }
+
     UbuntuTestCase {
         id: testCase
         when: windowShown
@@ -169,6 +188,7 @@ Item {
             root.columns = Qt.binding(function () {return root.width >= units.gu(80) ? 2 : 1});
             // restore async
             layout.asynchronous = true;
+            layout.pageCacheSize = 0;
             wait(200);
         }
 
@@ -336,6 +356,49 @@ Item {
             verify(incubator.object, "Page object not set");
         }
 
+        function test_page_cache() {
+            layout.pageCacheSize = 1;
+            var incubator = layout.addPageToNextColumn(layout.primaryPage, cachedPageComponent);
+            verify(incubator, "Page added synchronously!");
+            incubator.onStatusChanged = function (status) {
+                if (status == Component.Ready) {
+                    testCase.pageLoaded();
+                }
+            }
+            loadedSpy.wait(1500);
+            var page = incubator.object;
+            verify(findPageFromLayout(layout, "CachedPage"), "page not added");
+
+            layout.removePages(page);
+            tryCompare(page, "cachedCount", 1, 1000, "Removed page was not cached");
+            verify(!findPageFromLayout(layout, "CachedPage"), "cached page still in the view");
+
+            // the cached page is restored synchronously even if the loading is asynchronous
+            incubator = layout.addPageToNextColumn(layout.primaryPage, cachedPageComponent);
+            compare(incubator, null, "Incubator returned for a restored page");
+            compare(page.restoredCount, 1, "Restored page was not notified");
+            compare(findPageFromLayout(layout, "CachedPage"), page, "Cached page was not reused");
+
+            // items which are not a Page are cached without the notifications
+            layout.removePages(page);
+            tryCompare(page, "cachedCount", 2, 1000, "Removed page was not cached again");
+            incubator = layout.addPageToNextColumn(layout.primaryPage, cachedItemComponent);
+            verify(incubator, "Item added synchronously!");
+            loadedSpy.clear();
+            incubator.onStatusChanged = function (status) {
+                if (status == Component.Ready) {
+                    testCase.pageLoaded();
+                }
+            }
+            loadedSpy.wait(1500);
+            var item = incubator.object;
+            verify(findPageFromLayout(layout, "CachedItem"), "item not added");
+            layout.removePages(item);
+            incubator = layout.addPageToNextColumn(layout.primaryPage, cachedItemComponent);
+            compare(incubator, null, "Incubator returned for a restored item");
+            compare(findPageFromLayout(layout, "CachedItem"), item, "Cached item was not reused");
+        }
+
         SignalSpy {
             id: widthSpy
             signalName: "widthChanged"
@@ -878,6 +878,60 @@ Item {
             selectedIndicesSpy.wait();
         }
 
+        SignalSpy {
+            id: selectionRangesSpy
+            signalName: "selectionRangesChanged"
+            target: listView.ViewItems
+        }
+
+        function test_selectionRanges_change() {
+            listView.ViewItems.selectedIndices = [];
+            selectionRangesSpy.clear();
+            listView.ViewItems.selectedIndices = [4, 2, 3, 7];
+            compare(selectionRangesSpy.count, 1, "selectionRangesChanged not emitted");
+            compare(selectionRangesSpy.signalArguments[0][0], [[2, 4], [7, 7]], "Wrong ranges added");
+            compare(selectionRangesSpy.signalArguments[0][1], [], "No range should be removed");
+            compare(listView.ViewItems.selectedIndices, [2, 3, 4, 7], "Selected indices not sorted");
+
+            selectionRangesSpy.clear();
+            listView.ViewItems.selectedIndices = [2, 7];
+            compare(selectionRangesSpy.signalArguments[0][0], [], "No range should be added");
+            compare(selectionRangesSpy.signalArguments[0][1], [[3, 4]], "Wrong ranges removed");
+
+            // same selection, no change
+            selectionRangesSpy.clear();
+            listView.ViewItems.selectedIndices = [7, 2];
+            compare(selectionRangesSpy.count, 0, "Selection should not change");
+            listView.ViewItems.selectedIndices = [];
+        }
+
+        function test_selected_and_expanded_follow_model_changes() {
+            objectModel.reset();
+            listView.positionViewAtBeginning();
+            waitForRendering(listView);
+            listView.ViewItems.selectedIndices = [2, 5];
+            listView.ViewItems.expandedIndices = [3];
+
+            // insert a row above the selected ones
+            objectModel.insert(0, {data: -1});
+            compare(listView.ViewItems.selectedIndices, [3, 6], "Selection did not follow the insertion");
+            compare(listView.ViewItems.expandedIndices, [4], "Expansion did not follow the insertion");
+            waitForRendering(listView);
+            verify(findChild(listView, "listItem3").selected, "The selected item is no longer selected");
+            verify(!findChild(listView, "listItem2").selected, "The item above the selected one got selected");
+
+            // remove the expanded row
+            objectModel.remove(4, 1);
+            compare(listView.ViewItems.selectedIndices, [3, 5], "Selection did not follow the removal");
+            compare(listView.ViewItems.expandedIndices, [], "The removed row is still expanded");
+
+            // move a selected row to the top
+            objectModel.move(5, 0, 1);
+            compare(listView.ViewItems.selectedIndices, [0, 4], "Selection did not follow the move");
+
+            listView.ViewItems.selectedIndices = [];
+        }
+
         function test_no_tug_when_selectable() {
             movingSpy.target = testItem;
             toggleSelectMode(testColumn, true);
@@ -92,6 +92,17 @@ Item {
         }
     }
 
+    Component {
+        id: cachedPageComponent
+        Page {
+            property string label
+            property int cachedCount: 0
+            property int restoredCount: 0
+            onCached: cachedCount++
+            onRestored: restoredCount++
+        }
+    }
+
     UbuntuTestCase {
         name: "PageStackAPI"
         when: windowShown
@@ -196,6 +207,30 @@ Item {
                     "PageStack.push() returns Page created from QML file");
         }
 
+        function test_page_cache() {
+            pageStack.pageCacheSize = 1;
+            var first = pageStack.push(cachedPageComponent, {label: "first"});
+            waitForHeaderAnimation(mainView);
+            pageStack.pop();
+            waitForHeaderAnimation(mainView);
+            compare(first.cachedCount, 1, "Popped page was not cached");
+
+            var other = pageStack.push(cachedPageComponent, {label: "other"});
+            waitForHeaderAnimation(mainView);
+            verify(other !== first, "Page cached with different properties was reused");
+            pageStack.pop();
+            waitForHeaderAnimation(mainView);
+
+            // the page with the "first" label got evicted by the "other" one
+            var again = pageStack.push(cachedPageComponent, {label: "other"});
+            waitForHeaderAnimation(mainView);
+            compare(again, other, "Cached page was not reused");
+            compare(again.restoredCount, 1, "Reused page was not notified");
+            compare(again.active, true, "Reused page is not active");
+            compare(pageStack.currentPage, again, "Reused page is not the current page");
+            pageStack.pageCacheSize = 0;
+        }
+
         function test_page_header_back_button_bug1565811() {
             pageStack.push(page2);
             var backButton = findChild(page2.header.leadingActionBar,
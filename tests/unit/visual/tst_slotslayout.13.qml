@@ -184,6 +184,15 @@ Item {
             }
             Item { id: layoutTestChangeSlotsSize_leading1; SlotsLayout.position: SlotsLayout.Leading; width: units.gu(10); height: 38.5/*units.gu(3.1222)*/ }
         }
+        ListItemLayout {
+            id: layoutTestDeferred
+            layoutMode: SlotsLayout.Deferred
+            readonly property var leadingSlots: [layoutTestDeferred_leading1]
+            readonly property var trailingSlots: [layoutTestDeferred_trailing1]
+            title.text: "Deferred"
+            Item { id: layoutTestDeferred_leading1; SlotsLayout.position: SlotsLayout.Leading; width: units.gu(4); height: units.gu(2) }
+            Item { id: layoutTestDeferred_trailing1; SlotsLayout.position: SlotsLayout.Trailing; width: units.gu(2); height: units.gu(2) }
+        }
         ListItemLayout {
             id: layoutTestMainSlotSize
             width: units.gu(40)
@@ -597,6 +606,41 @@ Item {
             checkImplicitSize(layoutTestChangeSlotsSize)
         }
 
+        //in deferred mode the slots are not anchored, the layout is done once per frame
+        function test_deferredLayout() {
+            var layout = layoutTestDeferred
+            var slot = layout.leadingSlots[0]
+            waitForRendering(layout)
+
+            var initialCoalesced = layout.coalescedRelayouts
+            slot.width = units.gu(5)
+            slot.width = units.gu(6)
+            slot.width = units.gu(7)
+            tryCompare(layout.mainSlot, "x", layout.padding.leading
+                       + slot.SlotsLayout.padding.leading + units.gu(7) + slot.SlotsLayout.padding.trailing
+                       + layout.mainSlot.SlotsLayout.padding.leading)
+            verify(layout.coalescedRelayouts > initialCoalesced, "Deferred layout: relayouts were not coalesced")
+            compare(slot.x, layout.padding.leading + slot.SlotsLayout.padding.leading, "Deferred layout: leading slot x")
+            compare(slot.y + slot.height / 2,
+                    layout.height / 2 + (layout.padding.top - layout.padding.bottom
+                                         + slot.SlotsLayout.padding.top - slot.SlotsLayout.padding.bottom) / 2,
+                    "Deferred layout: leading slot vertical position")
+        }
+
+        //positions set in deferred mode have to follow the layout direction changes
+        function test_deferredLayoutMirroring() {
+            var layout = layoutTestDeferred
+            var slot = layout.leadingSlots[0]
+            waitForRendering(layout)
+            var leadingX = layout.padding.leading + slot.SlotsLayout.padding.leading
+            compare(slot.x, leadingX, "Deferred layout: leading slot x")
+
+            layout.LayoutMirroring.enabled = true
+            tryCompare(slot, "x", layout.width - leadingX - slot.width)
+            layout.LayoutMirroring.enabled = false
+            tryCompare(slot, "x", leadingX)
+        }
+
         function test_mainSlotSize() {
             compare(layoutTestMainSlotSize.mainSlot.width,
                     layoutTestMainSlotSize.width
@@ -0,0 +1,103 @@
+// Copyright © 2016 Canonical Ltd.
+// Author: Loïc Molinari <loic.molinari@canonical.com>
+//
+// This file is part of Ubuntu UI Toolkit.
+//
+// Ubuntu UI Toolkit is free software: you can redistribute it and/or modify it
+// under the terms of the GNU Lesser General Public License as published by the
+// Free Software Foundation; version 3.
+//
+// Ubuntu UI Toolkit is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+// FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License
+// for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Ubuntu UI Toolkit. If not, see <http://www.gnu.org/licenses/>.
+
+// Converts the binary files written by UMBinaryLogger to the parsable text
+// format of UMFileLogger.
+
+#include <cstdio>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+
+#include <UbuntuMetrics/logger.h>
+#include <UbuntuMetrics/private/logger_p.h>
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication application(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("ubuntu-metrics-decoder"));
+
+    QCommandLineParser args;
+    QCommandLineOption headerOption(
+        QStringLiteral("header"), QStringLiteral("Print the file header to stderr"));
+    args.setApplicationDescription(
+        QStringLiteral("Convert UbuntuMetrics binary logs to the parsable text format."));
+    args.addOption(headerOption);
+    args.addPositionalArgument(QStringLiteral("input"), QStringLiteral("Binary log file"));
+    args.addPositionalArgument(
+        QStringLiteral("output"), QStringLiteral("Text log file, stdout if not set"),
+        QStringLiteral("[output]"));
+    args.addHelpOption();
+    args.process(application);
+
+    const QStringList positionalArguments = args.positionalArguments();
+    if (positionalArguments.isEmpty() || positionalArguments.size() > 2) {
+        args.showHelp(1);
+    }
+
+    QFile file(positionalArguments[0]);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fprintf(stderr, "Can't open file %s '%s'.\n", qPrintable(file.fileName()),
+                qPrintable(file.errorString()));
+        return 1;
+    }
+    const qint64 size = file.size();
+    const uchar* data = size >= static_cast<qint64>(sizeof(BinaryLogHeader))
+        ? file.map(0, size) : nullptr;
+    if (!data) {
+        fprintf(stderr, "Can't map file %s.\n", qPrintable(file.fileName()));
+        return 1;
+    }
+
+    switch (UMBinaryLoggerPrivate::validate(data, size)) {
+    case UMBinaryLoggerPrivate::InvalidFile:
+        fprintf(stderr, "Invalid binary log file.\n");
+        return 1;
+    case UMBinaryLoggerPrivate::UnsupportedVersion:
+        fprintf(stderr, "Unsupported binary log version %u.\n",
+                reinterpret_cast<const BinaryLogHeader*>(data)->version);
+        return 1;
+    case UMBinaryLoggerPrivate::TruncatedFile:
+        fprintf(stderr, "Truncated binary log file.\n");
+        return 1;
+    case UMBinaryLoggerPrivate::Decodable:
+        break;
+    }
+
+    const BinaryLogHeader* header = reinterpret_cast<const BinaryLogHeader*>(data);
+    if (args.isSet(headerOption)) {
+        fprintf(stderr, "Version: %u\nEvents: %llu (capacity %u)\nClock base: %llu ns\n",
+                header->version, static_cast<unsigned long long>(header->eventCount),
+                header->eventCapacity, static_cast<unsigned long long>(header->clockBase));
+        for (quint32 i = 0; i < header->windowCount && i < BinaryLogHeader::maxWindows; ++i) {
+            fprintf(stderr, "Window: %u %ux%u\n", header->windows[i].id,
+                    header->windows[i].width, header->windows[i].height);
+        }
+    }
+
+    UMFileLogger* logger = positionalArguments.size() == 2
+        ? new UMFileLogger(positionalArguments[1], true) : new UMFileLogger(stdout, true);
+    if (!logger->isOpen()) {
+        delete logger;
+        return 1;
+    }
+
+    UMBinaryLoggerPrivate::decode(data, logger);
+    delete logger;
+    return 0;
+}
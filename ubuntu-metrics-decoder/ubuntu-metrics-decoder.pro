@@ -0,0 +1,8 @@
+TEMPLATE = app
+QT = core UbuntuMetrics UbuntuMetrics-private
+CONFIG += c++11
+SOURCES += decoder.cpp
+installPath = $$[QT_INSTALL_PREFIX]/bin
+decoder.path = $$installPath
+decoder.files = ubuntu-metrics-decoder
+INSTALLS += decoder
@@ -11,7 +11,10 @@ load(qt_parts)
 src_uitk_launcher.subdir = ubuntu-ui-toolkit-launcher
 src_uitk_launcher.depends = sub-src
 
-SUBDIRS += po app-launch-profiler src_uitk_launcher apicheck
+src_metrics_decoder.subdir = ubuntu-metrics-decoder
+src_metrics_decoder.depends = sub-src
+
+SUBDIRS += po app-launch-profiler src_uitk_launcher src_metrics_decoder apicheck
 !CONFIG(no_docs) {
     SUBDIRS += documentation
 }
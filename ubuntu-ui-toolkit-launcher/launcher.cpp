@@ -77,10 +77,12 @@ int main(int argc, const char *argv[])
     QCommandLineOption _metricsOverlay("metrics-overlay", "Enable the metrics overlay");
     QCommandLineOption _metricsLogging(
         "metrics-logging", "Enable metrics logging, <device> can be 'stdout', 'lttng' (Linux "
-        "only), a local or absolute filename", "device");
+        "only), 'binary:' or 'trace:' followed by a filename or a local or absolute filename",
+        "device");
     QCommandLineOption _metricsLoggingFilter(
         "metrics-logging-filter", "Filter metrics logging, <filter> is a list of events separated "
-        "by a comma ('window', 'process', 'frame' or '*'), events not filtered are discarded",
+        "by a comma ('window', 'process', 'frame', 'generic', 'summary', 'span' or '*'), events not "
+        "filtered are discarded",
         "filter");
 
     args.addOption(_import);
@@ -230,6 +232,10 @@ int main(int argc, const char *argv[])
                 filter |= UMApplicationMonitor::FrameEvent;
             } else if (filterList[i] == "generic") {
                 filter |= UMApplicationMonitor::GenericEvent;
+            } else if (filterList[i] == "summary") {
+                filter |= UMApplicationMonitor::FrameSummaryEvent;
+            } else if (filterList[i] == "span") {
+                filter |= UMApplicationMonitor::SpanEvent;
             }
         }
         applicationMonitor->setLoggingFilter(filter);
@@ -243,6 +249,10 @@ int main(int argc, const char *argv[])
         } else if (device == "lttng") {
             logger = new UMLTTNGLogger();
 #endif  // defined(Q_OS_LINUX)
+        } else if (device.startsWith("binary:")) {
+            logger = new UMBinaryLogger(device.mid(7));
+        } else if (device.startsWith("trace:")) {
+            logger = new UMTraceEventLogger(device.mid(6));
         } else {
             logger = new UMFileLogger(device);
         }